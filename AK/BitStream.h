@@ -39,19 +39,18 @@ public:
     {
     }
 
+    // WARNING: read aligns to the next byte boundary before reading, the rest of a partially consumed byte is discarded
     size_t read(Bytes bytes) override
     {
         if (has_any_error())
             return 0;
 
-        size_t nread = 0;
-        if (bytes.size() >= 1) {
-            if (m_next_byte.has_value()) {
-                bytes[0] = m_next_byte.value();
-                m_next_byte.clear();
+        align_to_byte_boundary();
 
-                ++nread;
-            }
+        size_t nread = 0;
+        while (nread < bytes.size() && m_bit_count >= 8) {
+            bytes[nread++] = static_cast<u8>(m_bit_buffer);
+            discard_bits(8);
         }
 
         return nread + m_stream.read(bytes.slice(nread));
@@ -67,44 +66,63 @@ public:
         return true;
     }
 
-    bool unreliable_eof() const override { return !m_next_byte.has_value() && m_stream.unreliable_eof(); }
+    bool unreliable_eof() const override { return m_bit_count == 0 && m_stream.unreliable_eof(); }
 
     bool discard_or_error(size_t count) override
     {
-        if (count >= 1) {
-            if (m_next_byte.has_value()) {
-                m_next_byte.clear();
-                --count;
-            }
+        align_to_byte_boundary();
+
+        while (count > 0 && m_bit_count >= 8) {
+            discard_bits(8);
+            --count;
         }
 
         return m_stream.discard_or_error(count);
     }
 
-    u32 read_bits(size_t count)
+    // Makes sure that at least count bits are buffered. Only the bytes that are needed for that are read from the
+    // underlying stream, so that whatever follows the bit stream (e.g. the gzip trailer) can still be read from it.
+    bool ensure_bits(size_t count)
     {
-        u32 result = 0;
+        VERIFY(count <= 32);
 
-        size_t nread = 0;
-        while (nread < count) {
-            if (m_stream.has_any_error()) {
-                set_fatal_error();
-                return 0;
-            }
+        if (m_bit_count >= count)
+            return true;
 
-            if (m_next_byte.has_value()) {
-                const auto bit = (m_next_byte.value() >> m_bit_offset) & 1;
-                result |= bit << nread;
-                ++nread;
+        u8 bytes[sizeof(u32)];
+        const auto byte_count = (count - m_bit_count + 7) / 8;
+        if (!m_stream.read_or_error({ bytes, byte_count })) {
+            set_fatal_error();
+            return false;
+        }
 
-                if (m_bit_offset++ == 7)
-                    m_next_byte.clear();
-            } else {
-                m_stream >> m_next_byte;
-                m_bit_offset = 0;
-            }
+        for (size_t idx = 0; idx < byte_count; ++idx) {
+            m_bit_buffer |= static_cast<u64>(bytes[idx]) << m_bit_count;
+            m_bit_count += 8;
         }
 
+        return true;
+    }
+
+    // The buffered bits, lsb-first. Bits past bits_buffered() are always zero.
+    u64 peek_bits() const { return m_bit_buffer; }
+    size_t bits_buffered() const { return m_bit_count; }
+
+    void discard_bits(size_t count)
+    {
+        VERIFY(count <= m_bit_count);
+        m_bit_buffer >>= count;
+        m_bit_count -= count;
+    }
+
+    u32 read_bits(size_t count)
+    {
+        if (!ensure_bits(count))
+            return 0;
+
+        const auto result = static_cast<u32>(m_bit_buffer & ((static_cast<u64>(1) << count) - 1));
+        discard_bits(count);
+
         return result;
     }
 
@@ -112,8 +130,7 @@ public:
 
     void align_to_byte_boundary()
     {
-        if (m_next_byte.has_value())
-            m_next_byte.clear();
+        discard_bits(m_bit_count % 8);
     }
 
     bool handle_any_error() override
@@ -123,8 +140,8 @@ public:
     }
 
 private:
-    Optional<u8> m_next_byte;
-    size_t m_bit_offset { 0 };
+    u64 m_bit_buffer { 0 };
+    size_t m_bit_count { 0 };
     InputStream& m_stream;
 };
 
@@ -31,8 +31,6 @@
 
 namespace AK {
 
-// FIXME: There are a lot of raw loops here, that's not necessary an issue but it
-//        has to be verified that the optimizer is able to insert memcpy instead.
 template<size_t Capacity>
 class CircularDuplexStream : public AK::DuplexStream {
 public:
@@ -40,9 +38,9 @@ public:
     {
         const auto nwritten = min(bytes.size(), Capacity - m_queue.size());
 
-        for (size_t idx = 0; idx < nwritten; ++idx)
-            m_queue.enqueue(bytes[idx]);
+        copy_into_storage((m_queue.head_index() + m_queue.size()) % Capacity, bytes.trim(nwritten));
 
+        m_queue.m_size += nwritten;
         m_total_written += nwritten;
         return nwritten;
     }
@@ -66,8 +64,10 @@ public:
 
         const auto nread = min(bytes.size(), m_queue.size());
 
-        for (size_t idx = 0; idx < nread; ++idx)
-            bytes[idx] = m_queue.dequeue();
+        copy_from_storage(m_queue.head_index(), bytes.trim(nread));
+
+        m_queue.m_head = (m_queue.m_head + nread) % Capacity;
+        m_queue.m_size -= nread;
 
         return nread;
     }
@@ -81,10 +81,7 @@ public:
 
         const auto nread = min(bytes.size(), seekback);
 
-        for (size_t idx = 0; idx < nread; ++idx) {
-            const auto index = (m_total_written - seekback + idx) % Capacity;
-            bytes[idx] = m_queue.m_storage[index];
-        }
+        copy_from_storage((m_total_written - seekback) % Capacity, bytes.trim(nread));
 
         return nread;
     }
@@ -107,8 +104,8 @@ public:
             return false;
         }
 
-        for (size_t idx = 0; idx < count; ++idx)
-            m_queue.dequeue();
+        m_queue.m_head = (m_queue.m_head + count) % Capacity;
+        m_queue.m_size -= count;
 
         return true;
     }
@@ -134,6 +131,21 @@ public:
     }
 
 private:
+    // The storage wraps around at most once for any copy, so these can always be done with (at most) two memcpys.
+    void copy_from_storage(size_t index, Bytes bytes) const
+    {
+        const auto first_chunk = min(bytes.size(), Capacity - index);
+        __builtin_memcpy(bytes.data(), m_queue.m_storage + index, first_chunk);
+        __builtin_memcpy(bytes.data() + first_chunk, m_queue.m_storage, bytes.size() - first_chunk);
+    }
+
+    void copy_into_storage(size_t index, ReadonlyBytes bytes)
+    {
+        const auto first_chunk = min(bytes.size(), Capacity - index);
+        __builtin_memcpy(m_queue.m_storage + index, bytes.data(), first_chunk);
+        __builtin_memcpy(m_queue.m_storage, bytes.data() + first_chunk, bytes.size() - first_chunk);
+    }
+
     CircularQueue<u8, Capacity> m_queue;
     size_t m_total_written { 0 };
 };
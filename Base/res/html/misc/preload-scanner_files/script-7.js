@@ -0,0 +1 @@
+scriptsRun.push(7);
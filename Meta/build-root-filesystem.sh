@@ -7,6 +7,8 @@ phys_gid=3
 utmp_gid=5
 window_uid=13
 window_gid=13
+protocol_uid=11
+protocol_gid=11
 
 CP="cp"
 
@@ -67,12 +69,14 @@ chmod 755 mnt/res/devel/templates/*.postcreate
 echo "done"
 
 printf "creating initial filesystem structure... "
-for dir in bin etc proc mnt tmp boot mod var/run; do
+for dir in bin etc proc mnt tmp boot mod var/run var/cache/ProtocolServer; do
     mkdir -p mnt/$dir
 done
 chmod 700 mnt/boot
 chmod 700 mnt/mod
 chmod 1777 mnt/tmp
+chown $protocol_uid:$protocol_gid mnt/var/cache/ProtocolServer
+chmod 700 mnt/var/cache/ProtocolServer
 echo "done"
 
 printf "creating utmp file... "
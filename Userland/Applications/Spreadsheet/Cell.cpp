@@ -114,20 +114,18 @@ void Cell::update_data(Badge<Sheet>)
 
     if (m_dirty) {
         m_dirty = false;
+        // The formula and the conditional formats record the cells they read as they're evaluated below.
+        if (!m_evaluated_externally)
+            forget_referenced_cells();
+
         if (m_kind == Formula) {
             if (!m_evaluated_externally) {
+                TemporaryChange being_evaluated { m_is_being_evaluated, true };
                 auto [value, exception] = m_sheet->evaluate(m_data, this);
                 m_evaluated_data = value;
                 m_js_exception = move(exception);
             }
         }
-
-        for (auto& ref : m_referencing_cells) {
-            if (ref) {
-                ref->m_dirty = true;
-                ref->update();
-            }
-        }
     }
 
     m_evaluated_formats.background_color.clear();
@@ -191,6 +189,16 @@ void Cell::reference_from(Cell* other)
         return;
 
     m_referencing_cells.append(other->make_weak_ptr());
+    other->m_referenced_cells.append(make_weak_ptr());
+}
+
+void Cell::forget_referenced_cells()
+{
+    for (auto& cell : m_referenced_cells) {
+        if (cell)
+            cell->m_referencing_cells.remove_first_matching([this](const auto& ptr) { return ptr.ptr() == this; });
+    }
+    m_referenced_cells.clear();
 }
 
 void Cell::copy_from(const Cell& other)
@@ -68,6 +68,8 @@ struct Cell : public Weakable<Cell> {
     void set_data(JS::Value new_data);
     bool dirty() const { return m_dirty; }
     void clear_dirty() { m_dirty = false; }
+    void mark_dirty(Badge<Sheet>) { m_dirty = true; }
+    bool is_being_evaluated() const { return m_is_being_evaluated; }
 
     void set_exception(JS::Exception* exc) { m_js_exception = exc; }
     JS::Exception* exception() const { return m_js_exception; }
@@ -119,14 +121,18 @@ struct Cell : public Weakable<Cell> {
     void copy_from(const Cell&);
 
 private:
+    void forget_referenced_cells();
+
     bool m_dirty { false };
     bool m_evaluated_externally { false };
+    bool m_is_being_evaluated { false };
     String m_data;
     JS::Value m_evaluated_data;
     JS::Exception* m_js_exception { nullptr };
     Kind m_kind { LiteralString };
     WeakPtr<Sheet> m_sheet;
     Vector<WeakPtr<Cell>> m_referencing_cells;
+    Vector<WeakPtr<Cell>> m_referenced_cells;
     const CellType* m_type { nullptr };
     CellTypeMetadata m_type_metadata;
     Position m_position;
@@ -212,7 +212,7 @@ void CSVExportDialogPage::update_preview()
     m_previously_made_writer = make_writer();
     if (!m_previously_made_writer.has_value()) {
     fail:;
-        m_data_preview_text_editor->set_text({});
+        m_data_preview_text_editor->set_text(StringView {});
         return;
     }
 
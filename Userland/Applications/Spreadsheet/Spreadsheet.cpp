@@ -160,17 +160,71 @@ void Sheet::update()
     }
     m_visited_cells_in_update.clear();
     Vector<Cell*> cells_copy;
+    HashTable<Cell*> affected_cells;
 
     // Grab a copy as updates might insert cells into the table.
     for (auto& it : m_cells) {
         if (it.value->dirty()) {
             cells_copy.append(it.value);
+            affected_cells.set(it.value);
             m_workbook.set_dirty(true);
         }
     }
 
-    for (auto& cell : cells_copy)
-        update(*cell);
+    // Everything that (transitively) references a changed cell has to be recomputed too, but nothing else does.
+    for (size_t i = 0; i < cells_copy.size(); ++i) {
+        for (auto& ref : cells_copy[i]->referencing_cells()) {
+            if (ref && affected_cells.set(ref.ptr()) == AK::HashSetResult::InsertedNewEntry) {
+                ref.ptr()->mark_dirty({});
+                cells_copy.append(ref.ptr());
+            }
+        }
+    }
+
+    // Order the affected cells so that each one comes after the cells it references, so each is evaluated only once.
+    // The references are the ones recorded when the cells were last evaluated; if a formula now reads a cell
+    // that hasn't been updated yet, that cell is evaluated on demand (see Cell::js_data()).
+    HashMap<Cell*, size_t> unevaluated_reference_counts;
+    for (auto* cell : cells_copy) {
+        for (auto& ref : cell->referencing_cells()) {
+            if (!ref || !affected_cells.contains(ref.ptr()))
+                continue;
+            if (auto it = unevaluated_reference_counts.find(ref.ptr()); it != unevaluated_reference_counts.end())
+                ++it->value;
+            else
+                unevaluated_reference_counts.set(ref.ptr(), 1);
+        }
+    }
+
+    Vector<Cell*> cells_in_order;
+    cells_in_order.ensure_capacity(cells_copy.size());
+    for (auto* cell : cells_copy) {
+        if (!unevaluated_reference_counts.contains(cell))
+            cells_in_order.unchecked_append(cell);
+    }
+    for (size_t i = 0; i < cells_in_order.size(); ++i) {
+        for (auto& ref : cells_in_order[i]->referencing_cells()) {
+            if (!ref || !affected_cells.contains(ref.ptr()))
+                continue;
+            auto it = unevaluated_reference_counts.find(ref.ptr());
+            if (--it->value == 0)
+                cells_in_order.unchecked_append(ref.ptr());
+        }
+    }
+
+    // Whatever is left is part of, or depends on, a reference cycle. These cells still get evaluated
+    // (their references may have changed since), and a formula that reads a cell that is currently being evaluated gets a ReferenceError.
+    if (cells_in_order.size() != cells_copy.size()) {
+        dbgln("Sheet {}: {} cell(s) are part of or depend on a reference cycle", m_name, cells_copy.size() - cells_in_order.size());
+        for (auto* cell : cells_copy) {
+            auto it = unevaluated_reference_counts.find(cell);
+            if (it != unevaluated_reference_counts.end() && it->value != 0)
+                cells_in_order.unchecked_append(cell);
+        }
+    }
+
+    for (auto& cell : cells_in_order)
+        cell->update();
 
     m_visited_cells_in_update.clear();
 }
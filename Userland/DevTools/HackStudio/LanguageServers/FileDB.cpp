@@ -119,6 +119,7 @@ public:
     virtual void document_did_insert_line(size_t) override {};
     virtual void document_did_remove_line(size_t) override {};
     virtual void document_did_remove_all_lines() override {};
+    virtual void document_did_change_line(size_t) override {};
     virtual void document_did_change() override {};
     virtual void document_did_set_text() override {};
     virtual void document_did_set_cursor(const GUI::TextPosition&) override {};
@@ -28,7 +28,6 @@
 #include <AK/Array.h>
 #include <AK/Assertions.h>
 #include <AK/BinaryHeap.h>
-#include <AK/BinarySearch.h>
 #include <AK/MemoryStream.h>
 #include <string.h>
 
@@ -79,10 +78,9 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
         }
     }
     if (non_zero_symbols == 1) { // special case - only 1 symbol
-        code.m_symbol_codes.append(0b10);
-        code.m_symbol_values.append(last_non_zero);
         code.m_bit_codes[last_non_zero] = 0;
         code.m_bit_code_lengths[last_non_zero] = 1;
+        code.build_decode_table(bytes.size());
         return code;
     }
 
@@ -98,8 +96,6 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
             if (next_code > start_bit)
                 return {};
 
-            code.m_symbol_codes.append(start_bit | next_code);
-            code.m_symbol_values.append(symbol);
             code.m_bit_codes[symbol] = fast_reverse16(start_bit | next_code, code_length); // DEFLATE writes huffman encoded symbols as lsb-first
             code.m_bit_code_lengths[symbol] = code_length;
 
@@ -111,23 +107,79 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
         return {};
     }
 
+    code.build_decode_table(bytes.size());
     return code;
 }
 
-u32 CanonicalCode::read_symbol(InputBitStream& stream) const
+void CanonicalCode::build_decode_table(size_t symbol_count)
 {
-    u32 code_bits = 1;
+    Array<u8, primary_table_size> secondary_bits {};
+    for (size_t symbol = 0; symbol < symbol_count; ++symbol) {
+        const size_t code_length = m_bit_code_lengths[symbol];
+        m_max_code_length = max(m_max_code_length, code_length);
+
+        if (code_length > primary_table_bits) {
+            auto& bits = secondary_bits[m_bit_codes[symbol] & (primary_table_size - 1)];
+            bits = max<u8>(bits, code_length - primary_table_bits);
+        }
+    }
+
+    m_decode_table.clear();
+    m_decode_table.ensure_capacity(primary_table_size);
+    for (size_t idx = 0; idx < primary_table_size; ++idx)
+        m_decode_table.append(DecodeEntry {});
+
+    for (size_t prefix = 0; prefix < primary_table_size; ++prefix) {
+        if (secondary_bits[prefix] == 0)
+            continue;
+
+        m_decode_table[prefix] = { static_cast<u16>(m_decode_table.size()), primary_table_bits, secondary_bits[prefix] };
+        for (size_t idx = 0; idx < (1u << secondary_bits[prefix]); ++idx)
+            m_decode_table.append(DecodeEntry {});
+    }
+
+    // Codes are stored lsb-first, so every index whose low code_length bits match the code decodes to the symbol.
+    for (size_t symbol = 0; symbol < symbol_count; ++symbol) {
+        const size_t code_length = m_bit_code_lengths[symbol];
+        if (code_length == 0)
+            continue;
+
+        const size_t bit_code = m_bit_codes[symbol];
+        if (code_length <= primary_table_bits) {
+            for (size_t idx = bit_code; idx < primary_table_size; idx += 1 << code_length)
+                m_decode_table[idx] = { static_cast<u16>(symbol), static_cast<u8>(code_length), 0 };
+            continue;
+        }
+
+        const auto secondary = m_decode_table[bit_code & (primary_table_size - 1)];
+        for (size_t idx = bit_code >> primary_table_bits; idx < (1u << secondary.secondary_bits); idx += 1 << (code_length - primary_table_bits))
+            m_decode_table[secondary.symbol + idx] = { static_cast<u16>(symbol), static_cast<u8>(code_length), 0 };
+    }
+}
 
+u32 CanonicalCode::read_symbol(InputBitStream& stream) const
+{
+    // We look the code up with whatever bits are already buffered (the missing ones read as zero) and only pull in
+    // another byte if the code turns out to be longer than that. This never reads past the end of the deflate stream.
     for (;;) {
-        code_bits = code_bits << 1 | stream.read_bits(1);
-        if (code_bits >= (1 << 16))
-            return UINT32_MAX; // the maximum symbol in deflate is 288, so we use UINT32_MAX (an impossible value) to indicate an error
-
-        // FIXME: This is very inefficient and could greatly be improved by implementing this
-        //        algorithm: https://www.hanshq.net/zip.html#huffdec
-        size_t index;
-        if (binary_search(m_symbol_codes.span(), code_bits, &index))
-            return m_symbol_values[index];
+        const auto bits = stream.peek_bits();
+        const auto bits_buffered = stream.bits_buffered();
+
+        auto entry = m_decode_table[bits & (primary_table_size - 1)];
+        if (entry.secondary_bits != 0 && bits_buffered >= primary_table_bits)
+            entry = m_decode_table[entry.symbol + ((bits >> primary_table_bits) & ((1u << entry.secondary_bits) - 1))];
+
+        if (entry.code_length != 0 && entry.code_length <= bits_buffered) {
+            stream.discard_bits(entry.code_length);
+            return entry.symbol;
+        }
+
+        // the maximum symbol in deflate is 288, so we use UINT32_MAX (an impossible value) to indicate an error
+        if (entry.code_length == 0 && bits_buffered >= m_max_code_length)
+            return UINT32_MAX;
+
+        if (!stream.ensure_bits(bits_buffered + 1))
+            return UINT32_MAX;
     }
 }
 
@@ -148,7 +200,10 @@ bool DeflateDecompressor::CompressedBlock::try_read_more()
     if (m_eof == true)
         return false;
 
+    const auto symbol_start = m_decompressor.input_bit_offset();
     const auto symbol = m_literal_codes.read_symbol(m_decompressor.m_input_stream);
+    if (m_decompressor.wait_for_input_if_needed(symbol_start))
+        return false;
 
     if (symbol >= 286) { // invalid deflate literal/length symbol
         m_decompressor.set_fatal_error();
@@ -169,22 +224,38 @@ bool DeflateDecompressor::CompressedBlock::try_read_more()
 
         const auto length = m_decompressor.decode_length(symbol);
         const auto distance_symbol = m_distance_codes.value().read_symbol(m_decompressor.m_input_stream);
+        if (m_decompressor.wait_for_input_if_needed(symbol_start))
+            return false;
         if (distance_symbol >= 30) { // invalid deflate distance symbol
             m_decompressor.set_fatal_error();
             return false;
         }
         const auto distance = m_decompressor.decode_distance(distance_symbol);
+        if (m_decompressor.wait_for_input_if_needed(symbol_start))
+            return false;
 
-        for (size_t idx = 0; idx < length; ++idx) {
-            u8 byte = 0;
-            m_decompressor.m_output_stream.read({ &byte, sizeof(byte) }, distance);
-            if (m_decompressor.m_output_stream.handle_any_error()) {
-                m_decompressor.set_fatal_error();
-                return false; // a back reference was requested that was too far back (outside our current sliding window)
-            }
-            m_decompressor.m_output_stream << byte;
+        Array<u8, DeflateCompressor::max_match_length> match;
+        if (length > match.size()) {
+            m_decompressor.set_fatal_error();
+            return false;
+        }
+
+        auto copied = m_decompressor.m_output_stream.read({ match.data(), length }, distance);
+        if (m_decompressor.m_output_stream.handle_any_error()) {
+            m_decompressor.set_fatal_error();
+            return false; // a back reference was requested that was too far back (outside our current sliding window)
         }
 
+        // If the match overlaps with itself (distance < length) it just repeats the last distance bytes, so we can keep
+        // doubling what we have copied so far instead of going byte by byte.
+        while (copied < length) {
+            const auto count = min(copied, length - copied);
+            memcpy(match.data() + copied, match.data(), count);
+            copied += count;
+        }
+
+        m_decompressor.m_output_stream << ReadonlyBytes { match.data(), length };
+
         return true;
     }
 }
@@ -200,7 +271,14 @@ bool DeflateDecompressor::UncompressedBlock::try_read_more()
     if (m_bytes_remaining == 0)
         return false;
 
-    const auto nread = min(m_bytes_remaining, m_decompressor.m_output_stream.remaining_contigous_space());
+    auto nread = min(m_bytes_remaining, m_decompressor.m_output_stream.remaining_contigous_space());
+    if (m_decompressor.m_streaming_decompressor) {
+        nread = min(nread, m_decompressor.available_input_bytes());
+        if (nread == 0) {
+            m_decompressor.m_is_waiting_for_input = true;
+            return false;
+        }
+    }
     m_bytes_remaining -= nread;
 
     m_decompressor.m_input_stream >> m_decompressor.m_output_stream.reserve_contigous_space(nread);
@@ -223,6 +301,8 @@ DeflateDecompressor::~DeflateDecompressor()
 
 size_t DeflateDecompressor::read(Bytes bytes)
 {
+    m_is_waiting_for_input = false;
+
     size_t total_read = 0;
     while (total_read < bytes.size()) {
         if (has_any_error())
@@ -234,9 +314,21 @@ size_t DeflateDecompressor::read(Bytes bytes)
             if (m_read_final_bock)
                 break;
 
+            // If the block header hasn't fully arrived yet, we'll read all of it again later.
+            const auto block_start = input_bit_offset();
+            auto wait_for_rest_of_header = [&] {
+                if (!wait_for_input_if_needed(block_start))
+                    return false;
+                m_read_final_bock = false;
+                return true;
+            };
+
             m_read_final_bock = m_input_stream.read_bit();
             const auto block_type = m_input_stream.read_bits(2);
 
+            if (wait_for_rest_of_header())
+                break;
+
             if (m_input_stream.has_any_error()) {
                 set_fatal_error();
                 break;
@@ -248,6 +340,9 @@ size_t DeflateDecompressor::read(Bytes bytes)
                 LittleEndian<u16> length, negated_length;
                 m_input_stream >> length >> negated_length;
 
+                if (wait_for_rest_of_header())
+                    break;
+
                 if (m_input_stream.has_any_error()) {
                     set_fatal_error();
                     break;
@@ -276,6 +371,9 @@ size_t DeflateDecompressor::read(Bytes bytes)
                 Optional<CanonicalCode> distance_codes;
                 decode_codes(literal_codes, distance_codes);
 
+                if (wait_for_rest_of_header())
+                    break;
+
                 if (m_input_stream.has_any_error()) {
                     set_fatal_error();
                     break;
@@ -304,7 +402,7 @@ size_t DeflateDecompressor::read(Bytes bytes)
             }
 
             total_read += nread;
-            if (nread == slice.size())
+            if (nread == slice.size() || m_is_waiting_for_input)
                 break;
 
             m_compressed_block.~CompressedBlock();
@@ -326,7 +424,7 @@ size_t DeflateDecompressor::read(Bytes bytes)
             }
 
             total_read += nread;
-            if (nread == slice.size())
+            if (nread == slice.size() || m_is_waiting_for_input)
                 break;
 
             m_uncompressed_block.~UncompressedBlock();
@@ -393,6 +491,38 @@ Optional<ByteBuffer> DeflateDecompressor::decompress_all(ReadonlyBytes bytes)
     return output_stream.copy_into_contiguous_buffer();
 }
 
+size_t DeflateDecompressor::input_bit_offset() const
+{
+    if (!m_streaming_decompressor)
+        return 0;
+    return m_streaming_decompressor->m_input.offset * 8 - m_input_stream.bits_buffered();
+}
+
+size_t DeflateDecompressor::available_input_bytes() const
+{
+    return m_input_stream.bits_buffered() / 8 + m_streaming_decompressor->m_input.remaining();
+}
+
+// If the input has run out in the middle of something, goes back to where that started, so that it can be read again
+// once more input has arrived. Nothing is written to the output before all of a symbol has been read.
+bool DeflateDecompressor::wait_for_input_if_needed(size_t bit_offset)
+{
+    if (!m_streaming_decompressor || !m_input_stream.has_any_error())
+        return false;
+
+    // Whatever went wrong after the input ran out doesn't count either.
+    InputStream::handle_any_error();
+
+    m_input_stream.handle_any_error();
+    m_input_stream.~InputBitStream();
+    m_streaming_decompressor->m_input.offset = bit_offset / 8;
+    new (&m_input_stream) InputBitStream(m_streaming_decompressor->m_input);
+    m_input_stream.read_bits(bit_offset % 8);
+
+    m_is_waiting_for_input = true;
+    return true;
+}
+
 u32 DeflateDecompressor::decode_length(u32 symbol)
 {
     // FIXME: I can't quite follow the algorithm here, but it seems to work.
@@ -523,6 +653,75 @@ void DeflateDecompressor::decode_codes(CanonicalCode& literal_code, Optional<Can
     distance_code = distance_code_result.value();
 }
 
+StreamingDeflateDecompressor::StreamingDeflateDecompressor()
+{
+    m_deflate_stream.m_streaming_decompressor = this;
+}
+
+StreamingDeflateDecompressor::~StreamingDeflateDecompressor()
+{
+}
+
+bool StreamingDeflateDecompressor::append(ReadonlyBytes bytes, Vector<u8>& output)
+{
+    if (m_has_failed)
+        return false;
+
+    // Drop the input that has been decompressed, except for the byte the decompressor is in the middle of.
+    const auto consumed = m_deflate_stream.input_bit_offset() / 8;
+    m_input.data.remove(0, consumed);
+    m_input.offset -= consumed;
+    m_input.data.append(bytes.data(), bytes.size());
+
+    u8 buffer[4096];
+    while (!m_deflate_stream.unreliable_eof()) {
+        const auto nread = m_deflate_stream.read({ buffer, sizeof(buffer) });
+        output.append(buffer, nread);
+
+        if (m_deflate_stream.handle_any_error()) {
+            m_has_failed = true;
+            return false;
+        }
+        if (m_deflate_stream.m_is_waiting_for_input)
+            break;
+    }
+    return true;
+}
+
+size_t StreamingDeflateDecompressor::InputBuffer::read(Bytes bytes)
+{
+    if (has_any_error())
+        return 0;
+
+    const auto count = min(bytes.size(), remaining());
+    __builtin_memcpy(bytes.data(), data.data() + offset, count);
+    offset += count;
+    return count;
+}
+
+bool StreamingDeflateDecompressor::InputBuffer::read_or_error(Bytes bytes)
+{
+    if (remaining() < bytes.size()) {
+        set_recoverable_error();
+        return false;
+    }
+
+    __builtin_memcpy(bytes.data(), data.data() + offset, bytes.size());
+    offset += bytes.size();
+    return true;
+}
+
+bool StreamingDeflateDecompressor::InputBuffer::discard_or_error(size_t count)
+{
+    if (remaining() < count) {
+        set_recoverable_error();
+        return false;
+    }
+
+    offset += count;
+    return true;
+}
+
 DeflateCompressor::DeflateCompressor(OutputStream& stream, CompressionLevel compression_level)
     : m_compression_level(compression_level)
     , m_compression_constants(compression_constants[static_cast<int>(m_compression_level)])
@@ -610,7 +809,7 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             break; // no remaining candidates
 
         VERIFY(candidate < start);
-        if (start - candidate > window_size)
+        if (start - candidate > max_back_reference_distance)
             break; // outside the window
 
         auto match_length = compare_match_candidate(start, candidate, previous_match_length, maximum_match_length);
@@ -720,6 +919,11 @@ void DeflateCompressor::lz77_compress_block()
         m_hash_head[hash] = window_pos;
     };
 
+    // the history right before our block is fair game for back references as well
+    for (size_t position = block_size - m_history_size; position < block_size; position++) {
+        insert_hash(position, hash_sequence(&m_rolling_window[position]));
+    }
+
     auto emit_literal = [&](auto literal) {
         VERIFY(m_pending_symbol_size <= block_size + 1);
         auto index = m_pending_symbol_size++;
@@ -1056,13 +1260,15 @@ void DeflateCompressor::flush()
     if (m_finished)
         m_output_stream.align_to_byte_boundary();
 
+    // slide the window, so that the block we just compressed ends up right before the next one
+    memmove(m_rolling_window, m_rolling_window + m_pending_block_size, block_size);
+    m_history_size = min(m_history_size + m_pending_block_size, block_size);
+
     // reset all block specific members
     m_pending_block_size = 0;
     m_pending_symbol_size = 0;
     m_symbol_frequencies.fill(0);
     m_distance_frequencies.fill(0);
-    // On the final block this copy will potentially produce an invalid search window, but since its the final block we dont care
-    pending_block().copy_trimmed_to({ m_rolling_window, block_size });
 }
 
 void DeflateCompressor::final_flush()
@@ -1072,6 +1278,31 @@ void DeflateCompressor::final_flush()
     flush();
 }
 
+void DeflateCompressor::set_preset_dictionary(ReadonlyBytes dictionary)
+{
+    VERIFY(m_pending_block_size == 0 && m_history_size == 0);
+
+    auto size = min(dictionary.size(), block_size);
+    dictionary.slice(dictionary.size() - size).copy_to({ m_rolling_window + block_size - size, size });
+    m_history_size = size;
+}
+
+void DeflateCompressor::final_sync_flush()
+{
+    VERIFY(!m_finished);
+    if (m_pending_block_size != 0)
+        flush();
+    m_finished = true;
+
+    // an empty stored block gets us to a byte boundary without ending the deflate stream
+    m_output_stream.write_bit(false);
+    m_output_stream.write_bits(0b00, 2);
+    m_output_stream.align_to_byte_boundary();
+    LittleEndian<u16> len = 0;
+    LittleEndian<u16> nlen = 0xffff;
+    m_output_stream << len << nlen;
+}
+
 Optional<ByteBuffer> DeflateCompressor::compress_all(const ReadonlyBytes& bytes, CompressionLevel compression_level)
 {
     DuplexMemoryStream output_stream;
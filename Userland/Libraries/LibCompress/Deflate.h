@@ -36,6 +36,8 @@
 
 namespace Compress {
 
+class StreamingDeflateDecompressor;
+
 class CanonicalCode {
 public:
     CanonicalCode() = default;
@@ -48,9 +50,20 @@ public:
     static Optional<CanonicalCode> from_bytes(ReadonlyBytes);
 
 private:
-    // Decompression - indexed by code
-    Vector<u16> m_symbol_codes;
-    Vector<u16> m_symbol_values;
+    void build_decode_table(size_t symbol_count);
+
+    // Decompression - the root table is indexed by the next primary_table_bits bits of input, codes that are longer
+    // than that point to a secondary table (indexed by the remaining bits) that is appended after the root table.
+    static constexpr size_t primary_table_bits = 9;
+    static constexpr size_t primary_table_size = 1 << primary_table_bits;
+
+    struct DecodeEntry {
+        u16 symbol { 0 };       // or the index of the secondary table, if secondary_bits != 0
+        u8 code_length { 0 };   // zero if no code starts with these bits
+        u8 secondary_bits { 0 };
+    };
+    Vector<DecodeEntry> m_decode_table;
+    size_t m_max_code_length { 0 };
 
     // Compression - indexed by symbol
     Array<u16, 288> m_bit_codes {}; // deflate uses a maximum of 288 symbols (maximum of 32 for distances)
@@ -93,6 +106,7 @@ private:
 public:
     friend CompressedBlock;
     friend UncompressedBlock;
+    friend StreamingDeflateDecompressor;
 
     DeflateDecompressor(InputStream&);
     ~DeflateDecompressor();
@@ -111,6 +125,11 @@ private:
     u32 decode_distance(u32);
     void decode_codes(CanonicalCode& literal_code, Optional<CanonicalCode>& distance_code);
 
+    // These are only used for the input of a StreamingDeflateDecompressor, which can end anywhere.
+    size_t input_bit_offset() const;
+    size_t available_input_bytes() const;
+    bool wait_for_input_if_needed(size_t bit_offset);
+
     bool m_read_final_bock { false };
 
     State m_state { State::Idle };
@@ -121,6 +140,41 @@ private:
 
     InputBitStream m_input_stream;
     CircularDuplexStream<32 * KiB> m_output_stream;
+
+    StreamingDeflateDecompressor* m_streaming_decompressor { nullptr };
+    bool m_is_waiting_for_input { false };
+};
+
+// Decompresses deflate data that arrives in pieces, e.g. while it is being downloaded. Each append() decompresses as
+// much as it can and stops in front of the first symbol that hasn't fully arrived yet, which the next one picks up.
+class StreamingDeflateDecompressor {
+public:
+    StreamingDeflateDecompressor();
+    ~StreamingDeflateDecompressor();
+
+    // Appends everything that can be decompressed now to output. Returns false if the data is invalid.
+    bool append(ReadonlyBytes, Vector<u8>& output);
+    bool is_finished() const { return m_deflate_stream.unreliable_eof(); }
+
+private:
+    friend DeflateDecompressor;
+
+    class InputBuffer final : public InputStream {
+    public:
+        size_t read(Bytes) override;
+        bool read_or_error(Bytes) override;
+        bool discard_or_error(size_t) override;
+        bool unreliable_eof() const override { return remaining() == 0; }
+
+        size_t remaining() const { return data.size() - offset; }
+
+        Vector<u8> data;
+        size_t offset { 0 };
+    };
+
+    InputBuffer m_input;
+    DeflateDecompressor m_deflate_stream { m_input };
+    bool m_has_failed { false };
 };
 
 enum DeflateSpecialCodeLengths : u32 {
@@ -138,6 +192,7 @@ public:
     static constexpr size_t max_huffman_distances = 32;
     static constexpr size_t min_match_length = 4;   // matches smaller than these are not worth the size of the back reference
     static constexpr size_t max_match_length = 258; // matches longer than these cannot be encoded using huffman codes
+    static constexpr size_t max_back_reference_distance = 32 * KiB;
     static constexpr u16 empty_slot = UINT16_MAX;
 
     struct CompressionConstants {
@@ -171,6 +226,15 @@ public:
     bool write_or_error(ReadonlyBytes) override;
     void final_flush();
 
+    // Lets back references reach into data that precedes this deflate stream, which the decompressor must already have
+    // seen as well (e.g. the previous chunk when compressing the parts of a single stream in parallel). This has to be
+    // called before anything is written.
+    void set_preset_dictionary(ReadonlyBytes);
+
+    // Like final_flush(), but the last block is not marked as final. Instead, the output is padded to a byte boundary
+    // with an empty stored block, so that the output of another DeflateCompressor can simply be appended to it.
+    void final_sync_flush();
+
     static Optional<ByteBuffer> compress_all(const ReadonlyBytes& bytes, CompressionLevel = CompressionLevel::GOOD);
 
 private:
@@ -208,6 +272,7 @@ private:
 
     u8 m_rolling_window[window_size];
     size_t m_pending_block_size { 0 };
+    size_t m_history_size { 0 }; // the number of already compressed bytes right before the pending block
 
     struct [[gnu::packed]] {
         u16 distance; // back reference length
@@ -27,8 +27,11 @@
 
 #include <LibCompress/Gzip.h>
 
+#include <AK/Atomic.h>
 #include <AK/MemoryStream.h>
+#include <AK/NonnullRefPtrVector.h>
 #include <AK/String.h>
+#include <LibThread/Thread.h>
 
 namespace Compress {
 
@@ -222,7 +225,7 @@ GzipCompressor::~GzipCompressor()
 {
 }
 
-size_t GzipCompressor::write(ReadonlyBytes bytes)
+static void write_member_header(OutputStream& stream)
 {
     BlockHeader header;
     header.identification_1 = 0x1f;
@@ -232,7 +235,12 @@ size_t GzipCompressor::write(ReadonlyBytes bytes)
     header.modification_time = 0;
     header.extra_flags = 3;      // DEFLATE sets 2 for maximum compression and 4 for minimum compression
     header.operating_system = 3; // unix
-    m_output_stream << Bytes { &header, sizeof(header) };
+    stream << Bytes { &header, sizeof(header) };
+}
+
+size_t GzipCompressor::write(ReadonlyBytes bytes)
+{
+    write_member_header(m_output_stream);
     DeflateCompressor compressed_stream { m_output_stream };
     VERIFY(compressed_stream.write_or_error(bytes));
     compressed_stream.final_flush();
@@ -254,8 +262,11 @@ bool GzipCompressor::write_or_error(ReadonlyBytes bytes)
     return true;
 }
 
-Optional<ByteBuffer> GzipCompressor::compress_all(const ReadonlyBytes& bytes)
+Optional<ByteBuffer> GzipCompressor::compress_all(const ReadonlyBytes& bytes, size_t thread_count)
 {
+    if (thread_count > 1 && bytes.size() > parallel_chunk_size)
+        return compress_all_in_parallel(bytes, thread_count);
+
     DuplexMemoryStream output_stream;
     GzipCompressor gzip_stream { output_stream };
 
@@ -267,4 +278,72 @@ Optional<ByteBuffer> GzipCompressor::compress_all(const ReadonlyBytes& bytes)
     return output_stream.copy_into_contiguous_buffer();
 }
 
+Optional<ByteBuffer> GzipCompressor::compress_all_in_parallel(ReadonlyBytes bytes, size_t thread_count)
+{
+    struct Chunk {
+        ReadonlyBytes data;
+        ReadonlyBytes dictionary;
+        Optional<ByteBuffer> compressed;
+        u32 checksum { 0 };
+    };
+
+    Vector<Chunk> chunks;
+    for (size_t offset = 0; offset < bytes.size(); offset += parallel_chunk_size) {
+        auto dictionary_size = min(offset, DeflateCompressor::block_size);
+        chunks.append({ bytes.slice(offset, min(parallel_chunk_size, bytes.size() - offset)), bytes.slice(offset - dictionary_size, dictionary_size), {}, 0 });
+    }
+
+    Atomic<size_t> next_chunk { 0 };
+    auto compress_chunks = [&] {
+        for (;;) {
+            auto index = next_chunk.fetch_add(1);
+            if (index >= chunks.size())
+                return 0;
+
+            auto& chunk = chunks[index];
+
+            DuplexMemoryStream output_stream;
+            // DeflateCompressor is too big to comfortably live on a secondary thread's stack.
+            auto deflate_stream = make<DeflateCompressor>(output_stream);
+            deflate_stream->set_preset_dictionary(chunk.dictionary);
+            deflate_stream->write_or_error(chunk.data);
+            if (index == chunks.size() - 1)
+                deflate_stream->final_flush();
+            else
+                deflate_stream->final_sync_flush();
+
+            if (!deflate_stream->handle_any_error())
+                chunk.compressed = output_stream.copy_into_contiguous_buffer();
+            chunk.checksum = Crypto::Checksum::CRC32 { chunk.data }.digest();
+        }
+    };
+
+    NonnullRefPtrVector<LibThread::Thread> threads;
+    for (size_t i = 1; i < min(thread_count, chunks.size()); ++i) {
+        auto thread = LibThread::Thread::construct([&] { return compress_chunks(); }, "Gzip compressor");
+        thread->start();
+        threads.append(move(thread));
+    }
+    compress_chunks();
+    for (auto& thread : threads)
+        [[maybe_unused]] auto result = thread.join();
+
+    DuplexMemoryStream output_stream;
+    write_member_header(output_stream);
+
+    u32 checksum = 0;
+    for (auto& chunk : chunks) {
+        if (!chunk.compressed.has_value())
+            return {};
+        output_stream << chunk.compressed.value().bytes();
+        checksum = Crypto::Checksum::CRC32::combine(checksum, chunk.checksum, chunk.data.size());
+    }
+
+    LittleEndian<u32> digest = checksum;
+    LittleEndian<u32> size = bytes.size();
+    output_stream << digest << size;
+
+    return output_stream.copy_into_contiguous_buffer();
+}
+
 }
@@ -106,9 +106,15 @@ public:
     size_t write(ReadonlyBytes) override;
     bool write_or_error(ReadonlyBytes) override;
 
-    static Optional<ByteBuffer> compress_all(const ReadonlyBytes& bytes);
+    // With more than one thread, the input is split into chunks that are deflated independently (each one primed with
+    // the data of the chunk before it) and then stitched together into a single gzip member, the same way pigz does it.
+    static Optional<ByteBuffer> compress_all(const ReadonlyBytes& bytes, size_t thread_count = 1);
+
+    static constexpr size_t parallel_chunk_size = 128 * KiB;
 
 private:
+    static Optional<ByteBuffer> compress_all_in_parallel(ReadonlyBytes, size_t thread_count);
+
     OutputStream& m_output_stream;
 };
 
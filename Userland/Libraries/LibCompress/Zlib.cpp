@@ -32,6 +32,17 @@
 
 namespace Compress {
 
+static bool is_supported_header(u8 compression_info, u8 flags)
+{
+    if ((compression_info & 0xF) != 8 || (compression_info >> 4) > 7)
+        return false; // non-deflate compression
+
+    if ((flags >> 5) & 0x1)
+        return false; // we dont support pre-defined dictionaries
+
+    return (compression_info * 256 + flags) % 31 == 0;
+}
+
 Optional<Zlib> Zlib::try_create(ReadonlyBytes data)
 {
     if (data.size() < 6)
@@ -48,14 +59,8 @@ Optional<Zlib> Zlib::try_create(ReadonlyBytes data)
     zlib.m_has_dictionary = (flags >> 5) & 0x1;
     zlib.m_compression_level = (flags >> 6) & 0x3;
 
-    if (zlib.m_compression_method != 8 || zlib.m_compression_info > 7)
-        return {}; // non-deflate compression
-
-    if (zlib.m_has_dictionary)
-        return {}; // we dont support pre-defined dictionaries
-
-    if ((compression_info * 256 + flags) % 31 != 0)
-        return {}; // error correction code doesn't match
+    if (!is_supported_header(compression_info, flags))
+        return {};
 
     zlib.m_data_bytes = data.slice(2, data.size() - 2 - 4);
     return zlib;
@@ -89,4 +94,19 @@ u32 Zlib::checksum()
     return m_checksum;
 }
 
+bool StreamingZlibDecompressor::append(ReadonlyBytes bytes, Vector<u8>& output)
+{
+    while (m_header_size < sizeof(m_header) && !bytes.is_empty()) {
+        m_header[m_header_size++] = bytes[0];
+        bytes = bytes.slice(1);
+    }
+    if (m_header_size < sizeof(m_header))
+        return true;
+    if (!is_supported_header(m_header[0], m_header[1]))
+        return false;
+
+    // The checksum at the end is never looked at, the deflate stream knows where it ends by itself.
+    return m_deflate_decompressor.append(bytes, output);
+}
+
 }
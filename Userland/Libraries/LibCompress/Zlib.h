@@ -29,6 +29,7 @@
 #include <AK/ByteBuffer.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
+#include <LibCompress/Deflate.h>
 
 namespace Compress {
 
@@ -54,4 +55,17 @@ private:
     ReadonlyBytes m_data_bytes;
 };
 
+// Decompresses a zlib stream that arrives in pieces, see StreamingDeflateDecompressor.
+class StreamingZlibDecompressor {
+public:
+    // Appends everything that can be decompressed now to output. Returns false if the data is invalid.
+    bool append(ReadonlyBytes, Vector<u8>& output);
+    bool is_finished() const { return m_deflate_decompressor.is_finished(); }
+
+private:
+    u8 m_header[2];
+    size_t m_header_size { 0 };
+    StreamingDeflateDecompressor m_deflate_decompressor;
+};
+
 }
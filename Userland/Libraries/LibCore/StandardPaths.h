@@ -37,6 +37,7 @@ public:
     static String downloads_directory();
     static String tempfile_directory();
     static String config_directory();
+    static String cache_directory();
 };
 
 }
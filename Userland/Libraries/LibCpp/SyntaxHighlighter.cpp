@@ -75,31 +75,52 @@ bool SyntaxHighlighter::is_navigatable(void* token) const
     return cpp_token == Cpp::Token::Type::IncludePath;
 }
 
-void SyntaxHighlighter::rehighlight(const Palette& palette)
+Syntax::TextStyle SyntaxHighlighter::style_for_span(void* data, const Palette& palette) const
 {
-    auto text = m_client->get_text();
+    return style_for_token_type(palette, static_cast<Cpp::Token::Type>(reinterpret_cast<size_t>(data)));
+}
+
+void SyntaxHighlighter::lex_lines(const StringView& text, LexerState, Vector<Line>& lines) const
+{
+    // The lexer keeps no state between tokens, except after an #include, where the path may follow on a later line.
+    // So it can restart at any line that begins inside whitespace (or right after it), which is why whitespace
+    // is split up into one span per line.
     Cpp::Lexer lexer(text);
     auto tokens = lexer.lex();
 
-    Vector<GUI::TextDocumentSpan> spans;
-    for (auto& token : tokens) {
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        auto& token = tokens[i];
         dbgln_if(SYNTAX_HIGHLIGHTING_DEBUG, "{} @ {}:{} - {}:{}", token.to_string(), token.start().line, token.start().column, token.end().line, token.end().column);
-        GUI::TextDocumentSpan span;
-        span.range.set_start({ token.start().line, token.start().column });
-        span.range.set_end({ token.end().line, token.end().column });
-        auto style = style_for_token_type(palette, token.type());
-        span.attributes.color = style.color;
-        span.attributes.bold = style.bold;
-        span.is_skippable = token.type() == Cpp::Token::Type::Whitespace;
-        span.data = reinterpret_cast<void*>(token.type());
-        spans.append(span);
-    }
-    m_client->do_set_spans(move(spans));
+        // An empty token at the very end of the text may claim to start on the line after it.
+        if (token.start().line >= lines.size())
+            continue;
+        auto* data = reinterpret_cast<void*>(token.type());
+        auto& first_line = lines[token.start().line];
 
-    m_has_brace_buddies = false;
-    highlight_matching_token_pair();
+        if (token.type() != Cpp::Token::Type::Whitespace) {
+            first_line.spans.append({ { { 0, token.start().column }, { token.end().line - token.start().line, token.end().column } }, data, false });
+            continue;
+        }
 
-    m_client->do_update();
+        bool is_after_include = i > 0 && tokens[i - 1].type() == Cpp::Token::Type::IncludeStatement;
+        size_t line_index = token.start().line;
+        size_t column = token.start().column;
+        size_t start_column = column;
+        for (auto ch : token.text()) {
+            if (ch == '\n') {
+                lines[line_index].spans.append({ { { 0, start_column }, { 0, column } }, data, true });
+                if (!is_after_include)
+                    lines[line_index].state_at_end = 0;
+                ++line_index;
+                column = 0;
+                start_column = 0;
+                continue;
+            }
+            ++column;
+        }
+        if (column != start_column)
+            lines[line_index].spans.append({ { { 0, start_column }, { 0, column - 1 } }, data, true });
+    }
 }
 
 Vector<SyntaxHighlighter::MatchingTokenPair> SyntaxHighlighter::matching_token_pairs() const
@@ -26,11 +26,11 @@
 
 #pragma once
 
-#include <LibSyntax/Highlighter.h>
+#include <LibSyntax/IncrementalHighlighter.h>
 
 namespace Cpp {
 
-class SyntaxHighlighter final : public Syntax::Highlighter {
+class SyntaxHighlighter final : public Syntax::IncrementalHighlighter {
 public:
     SyntaxHighlighter() { }
     virtual ~SyntaxHighlighter() override;
@@ -39,11 +39,13 @@ public:
     virtual bool is_navigatable(void*) const override;
 
     virtual Syntax::Language language() const override { return Syntax::Language::Cpp; }
-    virtual void rehighlight(const Palette&) override;
 
 protected:
     virtual Vector<MatchingTokenPair> matching_token_pairs() const override;
     virtual bool token_types_equal(void*, void*) const override;
+
+    virtual void lex_lines(const StringView&, LexerState, Vector<Line>&) const override;
+    virtual Syntax::TextStyle style_for_span(void*, const Palette&) const override;
 };
 
 }
@@ -24,17 +24,57 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <AK/SIMD.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <LibCrypto/Checksum/Adler32.h>
 
 namespace Crypto::Checksum {
 
+using AK::SIMD::u32x4;
+
+static constexpr u32 modulus = 65521;
+
+// The largest number of bytes we can sum up before b could overflow 32 bits (rounded down to a multiple of 16).
+static constexpr size_t max_bytes_between_reductions = 5552 / 16 * 16;
+
 void Adler32::update(ReadonlyBytes data)
 {
-    for (size_t i = 0; i < data.size(); i++) {
-        m_state_a = (m_state_a + data.at(i)) % 65521;
-        m_state_b = (m_state_b + m_state_a) % 65521;
+    auto* bytes = data.data();
+    auto size = data.size();
+
+    // For a block of n bytes x[0..n), b grows by n * a + (n - i) * x[i] summed over all i, and a by the sum of all x[i].
+    // We accumulate these per 16-byte chunk in vectors, splitting the weight (n - i) into 16 * (chunks after this one)
+    // and (16 - i % 16), and only reduce modulo 65521 once per block.
+    while (size >= 16) {
+        auto block_size = min(size, max_bytes_between_reductions) / 16 * 16;
+
+        u32x4 sum {};
+        u32x4 sum_of_previous_sums {};
+        u32x4 weighted_sum {};
+        for (size_t offset = 0; offset < block_size; offset += 16) {
+            auto* chunk = bytes + offset;
+            u32x4 x0 { chunk[0], chunk[1], chunk[2], chunk[3] };
+            u32x4 x1 { chunk[4], chunk[5], chunk[6], chunk[7] };
+            u32x4 x2 { chunk[8], chunk[9], chunk[10], chunk[11] };
+            u32x4 x3 { chunk[12], chunk[13], chunk[14], chunk[15] };
+
+            sum_of_previous_sums += sum;
+            sum += x0 + x1 + x2 + x3;
+            weighted_sum += x0 * u32x4 { 16, 15, 14, 13 } + x1 * u32x4 { 12, 11, 10, 9 } + x2 * u32x4 { 8, 7, 6, 5 } + x3 * u32x4 { 4, 3, 2, 1 };
+        }
+
+        auto horizontal_sum = [](u32x4 vector) { return vector[0] + vector[1] + vector[2] + vector[3]; };
+        m_state_b = (m_state_b + block_size * m_state_a + 16 * horizontal_sum(sum_of_previous_sums) + horizontal_sum(weighted_sum)) % modulus;
+        m_state_a = (m_state_a + horizontal_sum(sum)) % modulus;
+
+        bytes += block_size;
+        size -= block_size;
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        m_state_a = (m_state_a + bytes[i]) % modulus;
+        m_state_b = (m_state_b + m_state_a) % modulus;
     }
 };
 
@@ -24,17 +24,165 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <AK/Platform.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <LibCrypto/Checksum/CRC32.h>
 
+#if ARCH(I386) || ARCH(X86_64)
+#    include <smmintrin.h>
+#    include <wmmintrin.h>
+#endif
+
 namespace Crypto::Checksum {
 
+// Slicing-by-8: slicing_tables.data[n][i] is the CRC of byte i followed by n zero bytes, which lets us
+// process eight bytes at a time with eight independent table lookups.
+struct SlicingTables {
+    u32 data[8][256];
+
+    constexpr SlicingTables()
+        : data()
+    {
+        for (auto i = 0; i < 256; i++)
+            data[0][i] = table[i];
+
+        for (auto n = 1; n < 8; n++) {
+            for (auto i = 0; i < 256; i++)
+                data[n][i] = (data[n - 1][i] >> 8) ^ data[0][data[n - 1][i] & 0xFF];
+        }
+    }
+};
+
+constexpr static auto slicing_tables = SlicingTables();
+
+static u32 update_by_slicing(u32 state, const u8* data, size_t size)
+{
+    auto& tables = slicing_tables.data;
+
+    while (size >= 8) {
+        u32 low = (data[0] | data[1] << 8 | data[2] << 16 | data[3] << 24) ^ state;
+        u32 high = data[4] | data[5] << 8 | data[6] << 16 | data[7] << 24;
+        state = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^ tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24]
+            ^ tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF] ^ tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+        data += 8;
+        size -= 8;
+    }
+
+    for (size_t i = 0; i < size; i++)
+        state = table[(state ^ data[i]) & 0xFF] ^ (state >> 8);
+
+    return state;
+}
+
+#if ARCH(I386) || ARCH(X86_64)
+static bool cpu_supports_carryless_multiplication()
+{
+    static bool supported = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+    }();
+    return supported;
+}
+
+[[gnu::target("pclmul,sse4.1")]] ALWAYS_INLINE static __m128i fold_into(__m128i value, __m128i next, __m128i k)
+{
+    auto low = _mm_clmulepi64_si128(value, k, 0x00);
+    auto high = _mm_clmulepi64_si128(value, k, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(high, next), low);
+}
+
+// Folds 64 bytes at a time using carry-less multiplication, as described in Intel's "Fast CRC Computation for
+// Generic Polynomials Using PCLMULQDQ Instruction" paper (the constants are the bit-reflected ones for our
+// polynomial). size must be a multiple of 16, and at least 64.
+[[gnu::target("pclmul,sse4.1")]] static u32 update_by_folding(u32 state, const u8* data, size_t size)
+{
+    alignas(16) static constexpr u64 k1k2[] = { 0x0154442bd4, 0x01c6e41596 };
+    alignas(16) static constexpr u64 k3k4[] = { 0x01751997d0, 0x00ccaa009e };
+    alignas(16) static constexpr u64 k5k0[] = { 0x0163cd6124, 0x0000000000 };
+    alignas(16) static constexpr u64 poly[] = { 0x01db710641, 0x01f7011641 };
+
+    VERIFY(size >= 64 && size % 16 == 0);
+
+    auto x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00));
+    auto x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10));
+    auto x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20));
+    auto x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(state));
+    data += 64;
+    size -= 64;
+
+    // Fold four 128-bit lanes in parallel
+    auto k = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+    while (size >= 64) {
+        auto x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+        auto x6 = _mm_clmulepi64_si128(x2, k, 0x00);
+        auto x7 = _mm_clmulepi64_si128(x3, k, 0x00);
+        auto x8 = _mm_clmulepi64_si128(x4, k, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k, 0x11);
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30)));
+
+        data += 64;
+        size -= 64;
+    }
+
+    // Fold the four lanes (and any remaining 16-byte blocks) into a single one
+    k = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+    x1 = fold_into(x1, x2, k);
+    x1 = fold_into(x1, x3, k);
+    x1 = fold_into(x1, x4, k);
+    while (size >= 16) {
+        x1 = fold_into(x1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), k);
+        data += 16;
+        size -= 16;
+    }
+
+    // Fold 128 bits down to 64 bits
+    auto mask = _mm_setr_epi32(~0, 0, ~0, 0);
+    x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+    k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask);
+    x1 = _mm_clmulepi64_si128(x1, k, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction down to 32 bits
+    k = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+    x2 = _mm_and_si128(x1, mask);
+    x2 = _mm_clmulepi64_si128(x2, k, 0x10);
+    x2 = _mm_and_si128(x2, mask);
+    x2 = _mm_clmulepi64_si128(x2, k, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return _mm_extract_epi32(x1, 1);
+}
+#endif
+
 void CRC32::update(ReadonlyBytes data)
 {
-    for (size_t i = 0; i < data.size(); i++) {
-        m_state = table[(m_state ^ data.at(i)) & 0xFF] ^ (m_state >> 8);
+    auto* bytes = data.data();
+    auto size = data.size();
+
+#if ARCH(I386) || ARCH(X86_64)
+    if (size >= 64 && cpu_supports_carryless_multiplication()) {
+        auto folded_size = size & ~static_cast<size_t>(15);
+        m_state = update_by_folding(m_state, bytes, folded_size);
+        bytes += folded_size;
+        size -= folded_size;
     }
+#endif
+
+    m_state = update_by_slicing(m_state, bytes, size);
 };
 
 u32 CRC32::digest()
@@ -42,4 +190,61 @@ u32 CRC32::digest()
     return ~m_state;
 }
 
+// The CRC of the second piece has to be "advanced" by second_length zero bytes, which is a linear operation that we
+// can express as a 32x32 matrix over GF(2). This is the same approach as zlib's crc32_combine().
+static u32 gf2_matrix_times(const u32* matrix, u32 vector)
+{
+    u32 sum = 0;
+    for (size_t i = 0; vector != 0; i++, vector >>= 1) {
+        if (vector & 1)
+            sum ^= matrix[i];
+    }
+    return sum;
+}
+
+static void gf2_matrix_square(u32* square, const u32* matrix)
+{
+    for (size_t i = 0; i < 32; i++)
+        square[i] = gf2_matrix_times(matrix, matrix[i]);
+}
+
+u32 CRC32::combine(u32 first_digest, u32 second_digest, size_t second_length)
+{
+    if (second_length == 0)
+        return first_digest;
+
+    u32 even[32]; // even-power-of-two zeros operator
+    u32 odd[32];  // odd-power-of-two zeros operator
+
+    // the operator for one zero bit
+    odd[0] = 0xEDB88320;
+    u32 row = 1;
+    for (size_t i = 1; i < 32; i++) {
+        odd[i] = row;
+        row <<= 1;
+    }
+
+    gf2_matrix_square(even, odd); // two zero bits
+    gf2_matrix_square(odd, even); // four zero bits
+
+    // apply second_length zero bytes to the first digest, the first squaring puts the operator for one zero byte in even
+    for (;;) {
+        gf2_matrix_square(even, odd);
+        if (second_length & 1)
+            first_digest = gf2_matrix_times(even, first_digest);
+        second_length >>= 1;
+        if (second_length == 0)
+            break;
+
+        gf2_matrix_square(odd, even);
+        if (second_length & 1)
+            first_digest = gf2_matrix_times(odd, first_digest);
+        second_length >>= 1;
+        if (second_length == 0)
+            break;
+    }
+
+    return first_digest ^ second_digest;
+}
+
 }
@@ -78,6 +78,9 @@ public:
     void update(ReadonlyBytes data);
     u32 digest();
 
+    // Computes the digest of two concatenated pieces of data, given just their digests and the length of the second piece.
+    static u32 combine(u32 first_digest, u32 second_digest, size_t second_length);
+
 private:
     u32 m_state { ~0u };
 };
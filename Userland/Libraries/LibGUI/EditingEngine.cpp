@@ -676,6 +676,8 @@ void EditingEngine::move_selected_lines_up()
 
     auto& lines = m_editor->document().lines();
     lines.insert((int)last_line, lines.take((int)first_line - 1));
+    for (size_t line_index = first_line - 1; line_index <= last_line; ++line_index)
+        m_editor->document().notify_did_change_line(line_index);
     m_editor->set_cursor({ first_line - 1, 0 });
 
     if (m_editor->has_selection()) {
@@ -701,6 +703,8 @@ void EditingEngine::move_selected_lines_down()
         return;
 
     lines.insert((int)first_line, lines.take((int)last_line + 1));
+    for (size_t line_index = first_line; line_index <= last_line + 1; ++line_index)
+        m_editor->document().notify_did_change_line(line_index);
     m_editor->set_cursor({ first_line + 1, 0 });
 
     if (m_editor->has_selection()) {
@@ -25,6 +25,7 @@
  */
 
 #include <AK/LexicalPath.h>
+#include <AK/MappedFile.h>
 #include <AK/NumberFormat.h>
 #include <AK/QuickSort.h>
 #include <AK/StringBuilder.h>
@@ -35,6 +36,9 @@
 #include <LibGUI/FileSystemModel.h>
 #include <LibGUI/Painter.h>
 #include <LibGfx/Bitmap.h>
+#include <LibGfx/ImageDecoder.h>
+#include <LibGfx/PNGLoader.h>
+#include <LibGfx/PNGWriter.h>
 #include <LibThread/BackgroundAction.h>
 #include <grp.h>
 #include <pwd.h>
@@ -45,6 +49,25 @@
 
 namespace GUI {
 
+// Keyed by thumbnail_key(), so that a modified file never picks up its old thumbnail.
+static HashMap<String, RefPtr<Gfx::Bitmap>> s_thumbnail_cache;
+
+static String thumbnail_key(const String& path, time_t mtime, size_t size)
+{
+    return String::formatted("{}:{}:{}", mtime, size, path);
+}
+
+static String thumbnail_cache_path(const String& path, time_t mtime, size_t size)
+{
+    return String::formatted("{}/thumbnails/{:08x}-{:x}-{:x}.png", Core::StandardPaths::cache_directory(), path.hash(), (u64)mtime, size);
+}
+
+static void invalidate_thumbnail(const String& path, time_t mtime, size_t size)
+{
+    s_thumbnail_cache.remove(thumbnail_key(path, mtime, size));
+    unlink(thumbnail_cache_path(path, mtime, size).characters());
+}
+
 ModelIndex FileSystemModel::Node::index(int column) const
 {
     if (!parent)
@@ -154,6 +177,17 @@ void FileSystemModel::Node::traverse_if_needed()
         if (!watcher_or_error.is_error()) {
             m_file_watcher = watcher_or_error.release_value();
             m_file_watcher->on_change = [this](auto) {
+                // Drop the thumbnails of children that were modified or removed, in memory and on disk.
+                for (auto& child : children) {
+                    if (!child.thumbnail)
+                        continue;
+                    auto child_path = child.full_path();
+                    struct stat st;
+                    if (lstat(child_path.characters(), &st) == 0 && st.st_mtime == child.mtime && (size_t)st.st_size == child.size)
+                        continue;
+                    invalidate_thumbnail(child_path, child.mtime, child.size);
+                }
+
                 has_traversed = false;
                 mode = 0;
                 children.clear();
@@ -510,31 +544,63 @@ Icon FileSystemModel::icon_for(const Node& node) const
     return FileIconProvider::icon_for_path(node.full_path(), node.mode);
 }
 
-static HashMap<String, RefPtr<Gfx::Bitmap>> s_thumbnail_cache;
-
 static RefPtr<Gfx::Bitmap> render_thumbnail(const StringView& path)
 {
-    auto png_bitmap = Gfx::Bitmap::load_from_file(path);
-    if (!png_bitmap)
+    auto file_or_error = MappedFile::map(path);
+    if (file_or_error.is_error())
         return nullptr;
 
-    double scale = min(32 / (double)png_bitmap->width(), 32 / (double)png_bitmap->height());
+    // Let the decoder skip most of the work for a large image, since we're only drawing it at 32x32.
+    auto decoder = Gfx::ImageDecoder::create((const u8*)file_or_error.value()->data(), file_or_error.value()->size());
+    auto bitmap = decoder->downscaled_bitmap({ 32, 32 });
+    if (!bitmap)
+        return nullptr;
+
+    double scale = min(32 / (double)bitmap->width(), 32 / (double)bitmap->height());
 
     auto thumbnail = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 32, 32 });
-    Gfx::IntRect destination = Gfx::IntRect(0, 0, (int)(png_bitmap->width() * scale), (int)(png_bitmap->height() * scale));
+    Gfx::IntRect destination = Gfx::IntRect(0, 0, (int)(bitmap->width() * scale), (int)(bitmap->height() * scale));
     destination.center_within(thumbnail->rect());
 
     Painter painter(*thumbnail);
-    painter.draw_scaled_bitmap(destination, *png_bitmap, png_bitmap->rect());
+    painter.draw_scaled_bitmap(destination, *bitmap, bitmap->rect());
+    return thumbnail;
+}
+
+static RefPtr<Gfx::Bitmap> load_cached_thumbnail(const String& cache_path)
+{
+    if (!Core::File::exists(cache_path))
+        return nullptr;
+    auto thumbnail = Gfx::load_png(cache_path);
+    if (!thumbnail || thumbnail->size() != Gfx::IntSize { 32, 32 })
+        return nullptr;
     return thumbnail;
 }
 
+static void store_cached_thumbnail(const String& cache_path, const Gfx::Bitmap& thumbnail)
+{
+    if (!Core::File::ensure_parent_directories(cache_path))
+        return;
+
+    // Write to a temporary file and rename it into place, so that other processes never see a partial thumbnail.
+    auto temporary_path = String::formatted("{}.{}", cache_path, getpid());
+    auto file_or_error = Core::File::open(temporary_path, Core::IODevice::WriteOnly, 0600);
+    if (file_or_error.is_error())
+        return;
+    auto data = Gfx::PNGWriter::encode(thumbnail);
+    bool success = file_or_error.value()->write(data.data(), data.size());
+    file_or_error.value()->close();
+    if (!success || rename(temporary_path.characters(), cache_path.characters()) < 0)
+        unlink(temporary_path.characters());
+}
+
 bool FileSystemModel::fetch_thumbnail_for(const Node& node)
 {
     // See if we already have the thumbnail
     // we're looking for in the cache.
     auto path = node.full_path();
-    auto it = s_thumbnail_cache.find(path);
+    auto key = thumbnail_key(path, node.mtime, node.size);
+    auto it = s_thumbnail_cache.find(key);
     if (it != s_thumbnail_cache.end()) {
         if (!(*it).value)
             return false;
@@ -545,18 +611,25 @@ bool FileSystemModel::fetch_thumbnail_for(const Node& node)
     // Otherwise, arrange to render the thumbnail
     // in background and make it available later.
 
-    s_thumbnail_cache.set(path, nullptr);
+    s_thumbnail_cache.set(key, nullptr);
     m_thumbnail_progress_total++;
 
     auto weak_this = make_weak_ptr();
+    auto cache_path = thumbnail_cache_path(path, node.mtime, node.size);
 
+    // The on-disk cache is only touched from the background thread, so a slow disk never blocks the GUI.
     LibThread::BackgroundAction<RefPtr<Gfx::Bitmap>>::create(
-        [path] {
-            return render_thumbnail(path);
+        [path, cache_path] {
+            if (auto thumbnail = load_cached_thumbnail(cache_path))
+                return thumbnail;
+            auto thumbnail = render_thumbnail(path);
+            if (thumbnail)
+                store_cached_thumbnail(cache_path, *thumbnail);
+            return thumbnail;
         },
 
-        [this, path, weak_this](auto thumbnail) {
-            s_thumbnail_cache.set(path, move(thumbnail));
+        [this, key, weak_this](auto thumbnail) {
+            s_thumbnail_cache.set(key, move(thumbnail));
 
             // The model was destroyed, no need to update
             // progress or call any event handlers.
@@ -83,6 +83,8 @@ void RegularEditingEngine::sort_selected_lines()
     quick_sort(start, end, [](auto& a, auto& b) {
         return strcmp_utf32(a.code_points(), b.code_points(), min(a.length(), b.length())) < 0;
     });
+    for (size_t line_index = first_line; line_index <= last_line; ++line_index)
+        m_editor->document().notify_did_change_line(line_index);
 
     m_editor->did_change();
     m_editor->update();
@@ -25,7 +25,6 @@
  */
 
 #include <AK/Badge.h>
-#include <AK/ScopeGuard.h>
 #include <AK/StringBuilder.h>
 #include <AK/Utf8View.h>
 #include <LibCore/Timer.h>
@@ -33,6 +32,7 @@
 #include <LibGUI/TextEditor.h>
 #include <LibRegex/Regex.h>
 #include <ctype.h>
+#include <string.h>
 
 namespace GUI {
 
@@ -60,46 +60,53 @@ TextDocument::~TextDocument()
 
 bool TextDocument::set_text(const StringView& text)
 {
+    return set_text(text.is_empty() ? ByteBuffer() : ByteBuffer::copy(text.characters_without_null_termination(), text.length()));
+}
+
+bool TextDocument::set_text(ByteBuffer&& text_buffer)
+{
+    // The lines point into the buffer and only decode themselves into code points once they're looked at.
+    StringView buffer_view { text_buffer };
+
+    // A UTF-8 sequence never contains a newline byte, so validating the whole text at once is the same as validating each line.
+    bool is_ascii = true;
+    size_t newline_count = 0;
+    for (auto ch : buffer_view) {
+        if (static_cast<u8>(ch) >= 0x80)
+            is_ascii = false;
+        else if (ch == '\n')
+            ++newline_count;
+    }
+    if (!is_ascii && !Utf8View(buffer_view).validate()) {
+        set_text(StringView {});
+        return false;
+    }
+
     m_client_notifications_enabled = false;
     m_spans.clear();
     remove_all_lines();
+    m_text_buffer = move(text_buffer);
 
-    ArmedScopeGuard clear_text_guard([this]() {
-        set_text({});
-    });
+    // Knowing the line count up front saves us from repeatedly growing (and moving) the line vector for big files.
+    m_lines.ensure_capacity(newline_count + 1);
 
     size_t start_of_current_line = 0;
-
-    auto add_line = [&](size_t current_position) -> bool {
-        size_t line_length = current_position - start_of_current_line;
-        auto line = make<TextDocumentLine>(*this);
-
-        bool success = true;
-        if (line_length)
-            success = line->set_text(*this, text.substring_view(start_of_current_line, current_position - start_of_current_line));
-
-        if (!success)
-            return false;
-
-        append_line(move(line));
+    auto add_line = [&](size_t current_position) {
+        auto line_text = buffer_view.substring_view(start_of_current_line, current_position - start_of_current_line);
+        if (line_text.is_empty())
+            append_line(make<TextDocumentLine>(*this));
+        else
+            append_line(adopt_own(*new TextDocumentLine({}, line_text, is_ascii ? line_text.length() : Utf8View(line_text).length())));
         start_of_current_line = current_position + 1;
-
-        return true;
     };
 
-    size_t i = 0;
-    for (i = 0; i < text.length(); ++i) {
-        if (text[i] != '\n')
-            continue;
-
-        auto success = add_line(i);
-        if (!success)
-            return false;
+    while (start_of_current_line < buffer_view.length()) {
+        auto* newline = static_cast<const char*>(memchr(buffer_view.characters_without_null_termination() + start_of_current_line, '\n', buffer_view.length() - start_of_current_line));
+        if (!newline)
+            break;
+        add_line(newline - buffer_view.characters_without_null_termination());
     }
-
-    auto success = add_line(i);
-    if (!success)
-        return false;
+    add_line(buffer_view.length());
 
     // Don't show the file's trailing newline as an actual new line.
     if (line_count() > 1 && line(line_count() - 1).is_empty())
@@ -110,7 +117,6 @@ bool TextDocument::set_text(const StringView& text)
     for (auto* client : m_clients)
         client->document_did_set_text();
 
-    clear_text_guard.disarm();
     return true;
 }
 
@@ -144,8 +150,8 @@ bool TextDocumentLine::ends_in_whitespace() const
 size_t TextDocumentLine::leading_spaces() const
 {
     size_t count = 0;
-    for (; count < m_text.size(); ++count) {
-        if (m_text[count] != ' ') {
+    for (; count < length(); ++count) {
+        if (code_points()[count] != ' ') {
             break;
         }
     }
@@ -154,6 +160,8 @@ size_t TextDocumentLine::leading_spaces() const
 
 String TextDocumentLine::to_utf8() const
 {
+    if (!is_materialized())
+        return m_utf8_text;
     StringBuilder builder;
     builder.append(view());
     return builder.to_string();
@@ -169,14 +177,39 @@ TextDocumentLine::TextDocumentLine(TextDocument& document, const StringView& tex
     set_text(document, text);
 }
 
+TextDocumentLine::TextDocumentLine(Badge<TextDocument>, const StringView& utf8_text, size_t length)
+    : m_utf8_text(utf8_text)
+    , m_utf8_length(length)
+{
+}
+
+void TextDocumentLine::materialize() const
+{
+    if (is_materialized())
+        return;
+
+    // The document validated the text when the line was created, and lengths that match the byte count are all ASCII.
+    m_text.ensure_capacity(m_utf8_length);
+    if (m_utf8_length == m_utf8_text.length()) {
+        for (auto ch : m_utf8_text)
+            m_text.unchecked_append(static_cast<u8>(ch));
+    } else {
+        for (auto code_point : Utf8View(m_utf8_text))
+            m_text.unchecked_append(code_point);
+    }
+    m_utf8_text = {};
+}
+
 void TextDocumentLine::clear(TextDocument& document)
 {
+    m_utf8_text = {};
     m_text.clear();
     document.update_views({});
 }
 
 void TextDocumentLine::set_text(TextDocument& document, const Vector<u32> text)
 {
+    m_utf8_text = {};
     m_text = move(text);
     document.update_views({});
 }
@@ -187,13 +220,31 @@ bool TextDocumentLine::set_text(TextDocument& document, const StringView& text)
         clear(document);
         return true;
     }
+    m_utf8_text = {};
     m_text.clear();
-    Utf8View utf8_view(text);
-    if (!utf8_view.validate()) {
-        return false;
+
+    // A line never has more code points than bytes, and the common all-ASCII case needs no decoding at all.
+    bool is_ascii = true;
+    for (auto ch : text) {
+        if (static_cast<u8>(ch) >= 0x80) {
+            is_ascii = false;
+            break;
+        }
+    }
+
+    if (is_ascii) {
+        m_text.ensure_capacity(text.length());
+        for (auto ch : text)
+            m_text.unchecked_append(static_cast<u8>(ch));
+    } else {
+        Utf8View utf8_view(text);
+        if (!utf8_view.validate()) {
+            return false;
+        }
+        m_text.ensure_capacity(utf8_view.length());
+        for (auto code_point : utf8_view)
+            m_text.unchecked_append(code_point);
     }
-    for (auto code_point : utf8_view)
-        m_text.append(code_point);
     document.update_views({});
     return true;
 }
@@ -202,6 +253,7 @@ void TextDocumentLine::append(TextDocument& document, const u32* code_points, si
 {
     if (length == 0)
         return;
+    materialize();
     m_text.append(code_points, length);
     document.update_views({});
 }
@@ -218,6 +270,7 @@ void TextDocumentLine::prepend(TextDocument& document, u32 code_point)
 
 void TextDocumentLine::insert(TextDocument& document, size_t index, u32 code_point)
 {
+    materialize();
     if (index == length()) {
         m_text.append(code_point);
     } else {
@@ -228,6 +281,7 @@ void TextDocumentLine::insert(TextDocument& document, size_t index, u32 code_poi
 
 void TextDocumentLine::remove(TextDocument& document, size_t index)
 {
+    materialize();
     if (index == length()) {
         m_text.take_last();
     } else {
@@ -238,20 +292,16 @@ void TextDocumentLine::remove(TextDocument& document, size_t index)
 
 void TextDocumentLine::remove_range(TextDocument& document, size_t start, size_t length)
 {
+    materialize();
     VERIFY(length <= m_text.size());
 
-    Vector<u32> new_data;
-    new_data.ensure_capacity(m_text.size() - length);
-    for (size_t i = 0; i < start; ++i)
-        new_data.append(m_text[i]);
-    for (size_t i = (start + length); i < m_text.size(); ++i)
-        new_data.append(m_text[i]);
-    m_text = move(new_data);
+    m_text.remove(start, length);
     document.update_views({});
 }
 
 void TextDocumentLine::truncate(TextDocument& document, size_t length)
 {
+    materialize();
     m_text.resize(length);
     document.update_views({});
 }
@@ -311,6 +361,14 @@ void TextDocument::update_views(Badge<TextDocumentLine>)
     notify_did_change();
 }
 
+void TextDocument::notify_did_change_line(size_t line_index)
+{
+    if (m_client_notifications_enabled) {
+        for (auto* client : m_clients)
+            client->document_did_change_line(line_index);
+    }
+}
+
 void TextDocument::notify_did_change()
 {
     if (m_client_notifications_enabled) {
@@ -331,10 +389,19 @@ void TextDocument::set_all_cursors(const TextPosition& position)
 
 String TextDocument::text() const
 {
+    return text_of_lines(0, line_count());
+}
+
+String TextDocument::text_of_lines(size_t first_line, size_t end_line) const
+{
+    VERIFY(first_line <= end_line && end_line <= line_count());
     StringBuilder builder;
-    for (size_t i = 0; i < line_count(); ++i) {
+    for (size_t i = first_line; i < end_line; ++i) {
         auto& line = this->line(i);
-        builder.append(line.view());
+        if (line.is_materialized())
+            builder.append(line.view());
+        else
+            builder.append(line.unmaterialized_text());
         if (i != line_count() - 1)
             builder.append('\n');
     }
@@ -406,8 +473,13 @@ void TextDocument::update_regex_matches(const StringView& needle)
 
         Vector<RegexStringView> views;
 
-        for (size_t line = 0; line < m_lines.size(); ++line) {
-            views.append(m_lines.at(line).view());
+        // Unmaterialized ASCII lines are matched as UTF-8, where byte columns are code point columns.
+        // Other lines still have to be decoded, since LibRegex can't map UTF-8 offsets back to code points.
+        for (auto& line : m_lines) {
+            if (!line.is_materialized() && line.unmaterialized_text().length() == line.length())
+                views.append(line.unmaterialized_text());
+            else
+                views.append(line.view());
         }
         re.search(views, m_regex_result);
         m_regex_needs_update = false;
@@ -417,6 +489,112 @@ void TextDocument::update_regex_matches(const StringView& needle)
     }
 }
 
+static Vector<u32> code_points_of(const StringView& string)
+{
+    Vector<u32> code_points;
+    Utf8View utf8_view(string);
+    if (!utf8_view.validate()) {
+        for (auto ch : string)
+            code_points.append(static_cast<u8>(ch));
+        return code_points;
+    }
+    for (auto code_point : utf8_view)
+        code_points.append(code_point);
+    return code_points;
+}
+
+static bool code_points_match(u32 a, u32 b, bool match_case)
+{
+    if (match_case || a >= 0x80 || b >= 0x80)
+        return a == b;
+    return tolower(a) == tolower(b);
+}
+
+// The code points of a line, read without materializing it. Unmaterialized ASCII lines are read straight
+// from their UTF-8, and other unmaterialized lines are decoded into a scratch buffer that the caller reuses
+// (so only one LineText per scratch buffer can be in use at a time).
+class LineText {
+public:
+    LineText(const TextDocumentLine& line, Vector<u32>& scratch)
+        : m_length(line.length())
+    {
+        if (line.is_materialized()) {
+            m_code_points = line.code_points();
+            return;
+        }
+        auto utf8_text = line.unmaterialized_text();
+        if (utf8_text.length() == m_length) {
+            m_ascii = reinterpret_cast<const u8*>(utf8_text.characters_without_null_termination());
+            return;
+        }
+        scratch.clear_with_capacity();
+        scratch.ensure_capacity(m_length);
+        for (auto code_point : Utf8View(utf8_text))
+            scratch.unchecked_append(code_point);
+        m_code_points = scratch.data();
+    }
+
+    size_t length() const { return m_length; }
+    u32 operator[](size_t index) const { return m_ascii ? m_ascii[index] : m_code_points[index]; }
+
+    bool matches_at(size_t column, const Vector<u32>& needle, bool match_case) const
+    {
+        if (column + needle.size() > m_length)
+            return false;
+        for (size_t i = 0; i < needle.size(); ++i) {
+            if (!code_points_match((*this)[column + i], needle[i], match_case))
+                return false;
+        }
+        return true;
+    }
+
+private:
+    const u32* m_code_points { nullptr };
+    const u8* m_ascii { nullptr };
+    size_t m_length { 0 };
+};
+
+// Splits the needle at its newlines, so that each part can be matched against a single line.
+static Vector<Vector<u32>> needle_lines_of(const StringView& needle)
+{
+    Vector<Vector<u32>> needle_lines;
+    needle_lines.append(Vector<u32> {});
+    for (auto code_point : code_points_of(needle)) {
+        if (code_point == '\n')
+            needle_lines.append(Vector<u32> {});
+        else
+            needle_lines.last().append(code_point);
+    }
+    return needle_lines;
+}
+
+// A needle that spans several lines can only match in one place starting on a given line: its first part
+// has to end the line, the parts in between have to be entire lines and its last part has to start a line.
+static Optional<TextRange> match_needle_lines_at(const TextDocument& document, size_t line_index, const Vector<Vector<u32>>& needle_lines, bool match_case, Vector<u32>& scratch)
+{
+    VERIFY(needle_lines.size() > 1);
+    size_t last_line_index = line_index + needle_lines.size() - 1;
+    if (last_line_index >= document.line_count())
+        return {};
+
+    auto& first_line = document.line(line_index);
+    if (first_line.length() < needle_lines.first().size())
+        return {};
+    size_t start_column = first_line.length() - needle_lines.first().size();
+    if (!LineText(first_line, scratch).matches_at(start_column, needle_lines.first(), match_case))
+        return {};
+
+    for (size_t i = 1; i < needle_lines.size() - 1; ++i) {
+        auto& line = document.line(line_index + i);
+        if (line.length() != needle_lines[i].size() || !LineText(line, scratch).matches_at(0, needle_lines[i], match_case))
+            return {};
+    }
+
+    if (!LineText(document.line(last_line_index), scratch).matches_at(0, needle_lines.last(), match_case))
+        return {};
+    return TextRange { { line_index, start_column }, { last_line_index, needle_lines.last().size() } };
+}
+
 TextRange TextDocument::find_next(const StringView& needle, const TextPosition& start, SearchShouldWrap should_wrap, bool regmatch, bool match_case)
 {
     if (needle.is_empty())
@@ -472,27 +650,46 @@ TextRange TextDocument::find_next(const StringView& needle, const TextPosition&
     }
 
     TextPosition position = start.is_valid() ? start : TextPosition(0, 0);
-    TextPosition original_position = position;
-
-    TextPosition start_of_potential_match;
-    size_t needle_index = 0;
-
-    do {
-        auto ch = code_point_at(position);
-        // FIXME: This is not the right way to use a Unicode needle!
-        if (match_case ? ch == (u32)needle[needle_index] : tolower(ch) == tolower((u32)needle[needle_index])) {
-            if (needle_index == 0)
-                start_of_potential_match = position;
-            ++needle_index;
-            if (needle_index >= needle.length())
-                return { start_of_potential_match, next_position_after(position, should_wrap) };
-        } else {
-            if (needle_index > 0)
-                position = start_of_potential_match;
-            needle_index = 0;
+    if (position.line() >= line_count())
+        return {};
+
+    // Lines are searched as they are, so that searching a freshly loaded document doesn't materialize all of it.
+    auto needle_lines = needle_lines_of(needle);
+    Vector<u32> scratch;
+
+    // Returns the first match that starts on the line, at a column in [start_column, end_column).
+    auto find_in_line = [&](size_t line_index, size_t start_column, size_t end_column) -> Optional<TextRange> {
+        if (needle_lines.size() > 1) {
+            auto range = match_needle_lines_at(*this, line_index, needle_lines, match_case, scratch);
+            if (range.has_value() && range->start().column() >= start_column && range->start().column() < end_column)
+                return range;
+            return {};
+        }
+
+        auto& needle_code_points = needle_lines.first();
+        if (line(line_index).length() < needle_code_points.size())
+            return {};
+        LineText text(line(line_index), scratch);
+        size_t last_start_column = min(end_column, text.length() - needle_code_points.size() + 1);
+        for (size_t column = start_column; column < last_start_column; ++column) {
+            if (text.matches_at(column, needle_code_points, match_case))
+                return TextRange { { line_index, column }, { line_index, column + needle_code_points.size() } };
         }
-        position = next_position_after(position, should_wrap);
-    } while (position.is_valid() && position != original_position);
+        return {};
+    };
+
+    for (size_t line_index = position.line(); line_index < line_count(); ++line_index) {
+        if (auto range = find_in_line(line_index, line_index == position.line() ? position.column() : 0, NumericLimits<size_t>::max()); range.has_value())
+            return range.release_value();
+    }
+
+    if (should_wrap == SearchShouldWrap::No)
+        return {};
+
+    for (size_t line_index = 0; line_index <= position.line(); ++line_index) {
+        if (auto range = find_in_line(line_index, 0, line_index == position.line() ? position.column() : NumericLimits<size_t>::max()); range.has_value())
+            return range.release_value();
+    }
 
     return {};
 }
@@ -553,30 +750,50 @@ TextRange TextDocument::find_previous(const StringView& needle, const TextPositi
     }
 
     TextPosition position = start.is_valid() ? start : TextPosition(0, 0);
-    position = previous_position_before(position, should_wrap);
     if (position.line() >= line_count())
         return {};
-    TextPosition original_position = position;
-
-    TextPosition end_of_potential_match;
-    size_t needle_index = needle.length() - 1;
-
-    do {
-        auto ch = code_point_at(position);
-        // FIXME: This is not the right way to use a Unicode needle!
-        if (match_case ? ch == (u32)needle[needle_index] : tolower(ch) == tolower((u32)needle[needle_index])) {
-            if (needle_index == needle.length() - 1)
-                end_of_potential_match = position;
-            if (needle_index == 0)
-                return { position, next_position_after(end_of_potential_match, should_wrap) };
-            --needle_index;
-        } else {
-            if (needle_index < needle.length() - 1)
-                position = end_of_potential_match;
-            needle_index = needle.length() - 1;
+
+    auto needle_lines = needle_lines_of(needle);
+    Vector<u32> scratch;
+
+    // Returns the last match that starts on the line and ends in (after, before].
+    auto find_in_line = [&](size_t line_index, const TextPosition& after, const TextPosition& before) -> Optional<TextRange> {
+        auto is_wanted = [&](const TextRange& range) {
+            return !(before < range.end()) && (!after.is_valid() || after < range.end());
+        };
+
+        if (needle_lines.size() > 1) {
+            auto range = match_needle_lines_at(*this, line_index, needle_lines, match_case, scratch);
+            if (range.has_value() && is_wanted(range.value()))
+                return range;
+            return {};
         }
-        position = previous_position_before(position, should_wrap);
-    } while (position.is_valid() && position != original_position);
+
+        auto& needle_code_points = needle_lines.first();
+        if (line(line_index).length() < needle_code_points.size())
+            return {};
+        LineText text(line(line_index), scratch);
+        for (size_t column = text.length() - needle_code_points.size() + 1; column-- > 0;) {
+            TextRange range { { line_index, column }, { line_index, column + needle_code_points.size() } };
+            if (is_wanted(range) && text.matches_at(column, needle_code_points, match_case))
+                return range;
+        }
+        return {};
+    };
+
+    for (size_t line_index = position.line() + 1; line_index-- > 0;) {
+        if (auto range = find_in_line(line_index, {}, position); range.has_value())
+            return range.release_value();
+    }
+
+    if (should_wrap == SearchShouldWrap::No)
+        return {};
+
+    TextPosition end_of_document { line_count() - 1, line(line_count() - 1).length() };
+    for (size_t line_index = line_count(); line_index-- > 0;) {
+        if (auto range = find_in_line(line_index, position, end_of_document); range.has_value())
+            return range.release_value();
+    }
 
     return {};
 }
@@ -809,11 +1026,13 @@ TextPosition TextDocument::insert_at(const TextPosition& position, u32 code_poin
         auto new_line = make<TextDocumentLine>(*this);
         new_line->append(*this, line(position.line()).code_points() + position.column(), line(position.line()).length() - position.column());
         line(position.line()).truncate(*this, position.column());
+        notify_did_change_line(position.line());
         insert_line(position.line() + 1, move(new_line));
         notify_did_change();
         return { position.line() + 1, 0 };
     } else {
         line(position.line()).insert(*this, position.column(), code_point);
+        notify_did_change_line(position.line());
         notify_did_change();
         return { position.line(), position.column() + 1 };
     }
@@ -842,6 +1061,7 @@ void TextDocument::remove(const TextRange& unnormalized_range)
         } else {
             line.remove_range(*this, range.start().column(), range.end().column() - range.start().column());
         }
+        notify_did_change_line(range.start().line());
     } else {
         // Delete across a newline, merging lines.
         VERIFY(range.start().line() == range.end().line() - 1);
@@ -851,6 +1071,7 @@ void TextDocument::remove(const TextRange& unnormalized_range)
         code_points.append(first_line.code_points(), range.start().column());
         code_points.append(second_line.code_points() + range.end().column(), second_line.length() - range.end().column());
         first_line.set_text(*this, move(code_points));
+        notify_did_change_line(range.start().line());
         remove_line(range.end().line());
     }
 
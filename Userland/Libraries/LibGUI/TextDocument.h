@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <AK/ByteBuffer.h>
 #include <AK/HashTable.h>
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/NonnullRefPtr.h>
@@ -64,6 +65,7 @@ public:
         virtual void document_did_insert_line(size_t) = 0;
         virtual void document_did_remove_line(size_t) = 0;
         virtual void document_did_remove_all_lines() = 0;
+        virtual void document_did_change_line(size_t) = 0;
         virtual void document_did_change() = 0;
         virtual void document_did_set_text() = 0;
         virtual void document_did_set_cursor(const TextPosition&) = 0;
@@ -82,6 +84,8 @@ public:
     void set_spans(Vector<TextDocumentSpan> spans) { m_spans = move(spans); }
 
     bool set_text(const StringView&);
+    // Takes ownership of the text instead of copying it, which is cheaper for big files that were just read into memory.
+    bool set_text(ByteBuffer&&);
 
     const NonnullOwnPtrVector<TextDocumentLine>& lines() const { return m_lines; }
     NonnullOwnPtrVector<TextDocumentLine>& lines() { return m_lines; }
@@ -105,6 +109,8 @@ public:
 
     String text() const;
     String text_in_range(const TextRange&) const;
+    // The text of the lines from first_line up to end_line, each followed by a newline unless it is the last line of the document.
+    String text_of_lines(size_t first_line, size_t end_line) const;
 
     Vector<TextRange> find_all(const StringView& needle, bool regmatch = false);
 
@@ -133,6 +139,8 @@ public:
     void redo();
 
     void notify_did_change();
+    // Code that changes a line's text or rearranges lines() directly has to tell the clients which lines it touched.
+    void notify_did_change_line(size_t line_index);
     void set_all_cursors(const TextPosition&);
 
     TextPosition insert_at(const TextPosition&, u32, const Client* = nullptr);
@@ -152,6 +160,9 @@ private:
     NonnullOwnPtrVector<TextDocumentLine> m_lines;
     Vector<TextDocumentSpan> m_spans;
 
+    // The text passed to set_text(). Lines that haven't been decoded yet point into it.
+    ByteBuffer m_text_buffer;
+
     HashTable<Client*> m_clients;
     bool m_client_notifications_enabled { true };
 
@@ -170,12 +181,19 @@ class TextDocumentLine {
 public:
     explicit TextDocumentLine(TextDocument&);
     explicit TextDocumentLine(TextDocument&, const StringView&);
+    TextDocumentLine(Badge<TextDocument>, const StringView& utf8_text, size_t length);
 
     String to_utf8() const;
 
     Utf32View view() const { return { code_points(), length() }; }
-    const u32* code_points() const { return m_text.data(); }
-    size_t length() const { return m_text.size(); }
+    const u32* code_points() const
+    {
+        materialize();
+        return m_text.data();
+    }
+    size_t length() const { return is_materialized() ? m_text.size() : m_utf8_length; }
+    bool is_materialized() const { return m_utf8_text.is_null(); }
+    const StringView& unmaterialized_text() const { return m_utf8_text; }
     bool set_text(TextDocument&, const StringView&);
     void set_text(TextDocument&, Vector<u32>);
     void append(TextDocument&, u32);
@@ -194,8 +212,15 @@ public:
     size_t leading_spaces() const;
 
 private:
+    void materialize() const;
+
     // NOTE: This vector is null terminated.
-    Vector<u32> m_text;
+    mutable Vector<u32> m_text;
+
+    // Lines created by TextDocument::set_text() keep pointing into the document's text buffer
+    // until their code points are first needed, so loading a file doesn't decode every line up front.
+    mutable StringView m_utf8_text;
+    size_t m_utf8_length { 0 };
 };
 
 class TextDocumentUndoCommand : public Command {
@@ -119,10 +119,15 @@ void TextEditor::create_actions()
 }
 
 void TextEditor::set_text(const StringView& text)
+{
+    set_text(text.is_empty() ? ByteBuffer() : ByteBuffer::copy(text.characters_without_null_termination(), text.length()));
+}
+
+void TextEditor::set_text(ByteBuffer&& text)
 {
     m_selection.clear();
 
-    document().set_text(text);
+    document().set_text(move(text));
 
     update_content_size();
     recompute_all_visual_lines();
@@ -1445,6 +1450,14 @@ void TextEditor::resize_event(ResizeEvent& event)
     ScrollableWidget::resize_event(event);
     update_content_size();
     recompute_all_visual_lines();
+    if (m_highlighter)
+        m_highlighter->visible_lines_did_change(palette());
+}
+
+void TextEditor::did_scroll()
+{
+    if (m_highlighter)
+        m_highlighter->visible_lines_did_change(palette());
 }
 
 void TextEditor::theme_change_event(ThemeChangeEvent& event)
@@ -1558,6 +1571,8 @@ void TextEditor::recompute_visual_lines(size_t line_index)
 
     if (is_wrapping_enabled())
         visual_data.visual_rect = { m_horizontal_content_padding, 0, available_width, static_cast<int>(visual_data.visual_line_breaks.size()) * line_height() };
+    else if (!line.is_materialized())
+        visual_data.visual_rect = { m_horizontal_content_padding, 0, font().width(line.unmaterialized_text()), line_height() };
     else
         visual_data.visual_rect = { m_horizontal_content_padding, 0, font().width(line.view()), line_height() };
 }
@@ -1622,6 +1637,8 @@ void TextEditor::did_change_font()
 void TextEditor::document_did_append_line()
 {
     m_line_visual_data.append(make<LineVisualData>());
+    if (m_highlighter)
+        m_highlighter->did_insert_line(line_count() - 1);
     recompute_all_visual_lines();
     update();
 }
@@ -1629,6 +1646,8 @@ void TextEditor::document_did_append_line()
 void TextEditor::document_did_remove_line(size_t line_index)
 {
     m_line_visual_data.remove(line_index);
+    if (m_highlighter)
+        m_highlighter->did_remove_line(line_index);
     recompute_all_visual_lines();
     update();
 }
@@ -1636,6 +1655,8 @@ void TextEditor::document_did_remove_line(size_t line_index)
 void TextEditor::document_did_remove_all_lines()
 {
     m_line_visual_data.clear();
+    if (m_highlighter)
+        m_highlighter->did_change_all_lines();
     recompute_all_visual_lines();
     update();
 }
@@ -1643,10 +1664,18 @@ void TextEditor::document_did_remove_all_lines()
 void TextEditor::document_did_insert_line(size_t line_index)
 {
     m_line_visual_data.insert(line_index, make<LineVisualData>());
+    if (m_highlighter)
+        m_highlighter->did_insert_line(line_index);
     recompute_all_visual_lines();
     update();
 }
 
+void TextEditor::document_did_change_line(size_t line_index)
+{
+    if (m_highlighter)
+        m_highlighter->did_change_line(line_index);
+}
+
 void TextEditor::document_did_change()
 {
     did_change();
@@ -1656,6 +1685,8 @@ void TextEditor::document_did_change()
 void TextEditor::document_did_set_text()
 {
     m_line_visual_data.clear();
+    if (m_highlighter)
+        m_highlighter->did_change_all_lines();
     for (size_t i = 0; i < m_document->line_count(); ++i)
         m_line_visual_data.append(make<LineVisualData>());
     document_did_change();
@@ -1683,6 +1714,8 @@ void TextEditor::set_document(TextDocument& document)
     recompute_all_visual_lines();
     update();
     m_document->register_client(*this);
+    if (m_highlighter)
+        m_highlighter->did_change_all_lines();
 }
 
 void TextEditor::flush_pending_change_notification_if_needed()
@@ -119,6 +119,7 @@ public:
     Function<void()> on_focusout;
 
     void set_text(const StringView&);
+    void set_text(ByteBuffer&&);
     void scroll_cursor_into_view();
     void scroll_position_into_view(const TextPosition&);
     size_t line_count() const { return document().line_count(); }
@@ -224,6 +225,7 @@ protected:
     virtual void context_menu_event(ContextMenuEvent&) override;
     virtual void resize_event(ResizeEvent&) override;
     virtual void theme_change_event(ThemeChangeEvent&) override;
+    virtual void did_scroll() override;
     virtual void cursor_did_change() { }
     Gfx::IntRect ruler_content_rect(size_t line) const;
 
@@ -240,6 +242,7 @@ private:
     virtual void document_did_insert_line(size_t) override;
     virtual void document_did_remove_line(size_t) override;
     virtual void document_did_remove_all_lines() override;
+    virtual void document_did_change_line(size_t) override;
     virtual void document_did_change() override;
     virtual void document_did_set_text() override;
     virtual void document_did_set_cursor(const TextPosition&) override;
@@ -253,6 +256,7 @@ private:
     virtual String highlighter_did_request_text() const final { return text(); }
     virtual GUI::TextDocument& highlighter_did_request_document() final { return document(); }
     virtual GUI::TextPosition highlighter_did_request_cursor() const final { return m_cursor; }
+    virtual size_t highlighter_did_request_last_visible_line() const final { return text_position_at(rect().bottom_right()).line(); }
 
     void create_actions();
     void paint_ruler(Painter&);
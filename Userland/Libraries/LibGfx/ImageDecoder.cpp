@@ -36,6 +36,20 @@
 
 namespace Gfx {
 
+int downscale_factor_for_fitting(const IntSize& image_size, const IntSize& bounding_size, int maximum_factor)
+{
+    if (image_size.is_empty() || bounding_size.is_empty())
+        return 1;
+    int factor = 1;
+    // Fitting scales both dimensions by the same amount, so the dimension that shrinks the most decides it.
+    while (factor * 2 <= maximum_factor
+        && ((i64)factor * 2 * bounding_size.width() <= image_size.width()
+            || (i64)factor * 2 * bounding_size.height() <= image_size.height())) {
+        factor *= 2;
+    }
+    return factor;
+}
+
 ImageDecoder::ImageDecoder(const u8* data, size_t size)
 {
     m_plugin = make<PNGImageDecoderPlugin>(data, size);
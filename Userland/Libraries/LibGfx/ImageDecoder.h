@@ -45,6 +45,17 @@ struct ImageFrameDescriptor {
     int duration { 0 };
 };
 
+struct PartialImageDescriptor {
+    // Always the size of the whole image. Rows past available_rows have not been decoded yet.
+    RefPtr<Bitmap> image;
+    // For interlaced images, this covers a lower-resolution preview of the rows that are not final yet.
+    int available_rows { 0 };
+};
+
+// The largest power-of-two factor, up to maximum_factor, by which an image of image_size can be scaled down
+// while still being at least as large as it would be when fitted into bounding_size.
+int downscale_factor_for_fitting(const IntSize& image_size, const IntSize& bounding_size, int maximum_factor);
+
 class ImageDecoderPlugin {
 public:
     virtual ~ImageDecoderPlugin() { }
@@ -62,6 +73,14 @@ public:
     virtual size_t frame_count() = 0;
     virtual ImageFrameDescriptor frame(size_t i) = 0;
 
+    // Decodes as much of the image as possible from data that has only been partially received. Every call gets
+    // everything received so far, which starts with the data of the previous one, and only decodes what is new.
+    virtual PartialImageDescriptor partial_bitmap(ReadonlyBytes) { return {}; }
+
+    // Decodes the image at a reduced resolution that still covers what it would be drawn at when fitted into
+    // bounding_size, without materializing the full-size bitmap. Decoders that can't do this return bitmap().
+    virtual RefPtr<Gfx::Bitmap> downscaled_bitmap(const IntSize&) { return bitmap(); }
+
 protected:
     ImageDecoderPlugin() { }
 };
@@ -89,6 +108,8 @@ public:
     size_t loop_count() const { return m_plugin ? m_plugin->loop_count() : 0; }
     size_t frame_count() const { return m_plugin ? m_plugin->frame_count() : 0; }
     ImageFrameDescriptor frame(size_t i) const { return m_plugin ? m_plugin->frame(i) : ImageFrameDescriptor(); }
+    PartialImageDescriptor partial_bitmap(ReadonlyBytes data) const { return m_plugin ? m_plugin->partial_bitmap(data) : PartialImageDescriptor(); }
+    RefPtr<Gfx::Bitmap> downscaled_bitmap(const IntSize& bounding_size) const { return m_plugin ? m_plugin->downscaled_bitmap(bounding_size) : nullptr; }
 
 private:
     ImageDecoder(const u8*, size_t);
@@ -31,6 +31,7 @@
 #include <AK/LexicalPath.h>
 #include <AK/MappedFile.h>
 #include <AK/MemoryStream.h>
+#include <AK/SIMD.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
 #include <LibGfx/Bitmap.h>
@@ -176,12 +177,20 @@ struct StartOfFrame {
     u16 width { 0 };
 };
 
+// Codes of up to this many bits are decoded with a single table lookup.
+constexpr static size_t huffman_lookahead_bits = 9;
+
 struct HuffmanTableSpec {
     u8 type { 0 };
     u8 destination_id { 0 };
     u8 code_counts[16] = { 0 };
     Vector<u8> symbols;
-    Vector<u16> codes;
+
+    // Indexed by the next huffman_lookahead_bits bits of the stream, (code length << 8) | symbol, or 0 if no code this short matches.
+    u16 lookahead[1 << huffman_lookahead_bits] = { 0 };
+    // For the longer codes: the first code of each length and the index of its symbol.
+    u16 first_codes[16] = { 0 };
+    u16 first_symbol_indices[16] = { 0 };
 };
 
 struct HuffmanStreamState {
@@ -201,6 +210,9 @@ struct JPGLoadingContext {
     State state { State::NotDecoded };
     const u8* data { nullptr };
     size_t data_size { 0 };
+    IntSize bounding_size;
+    // Each 8x8 block is decoded into (8 / scale_factor)^2 pixels.
+    u32 scale_factor { 1 };
     u32 luma_table[64] = { 0 };
     u32 chroma_table[64] = { 0 };
     StartOfFrame frame;
@@ -220,13 +232,50 @@ struct JPGLoadingContext {
 static void generate_huffman_codes(HuffmanTableSpec& table)
 {
     unsigned code = 0;
-    for (auto number_of_codes : table.code_counts) {
-        for (int i = 0; i < number_of_codes; i++)
-            table.codes.append(code++);
+    size_t symbol_index = 0;
+    for (size_t i = 0; i < 16; i++) {
+        const size_t code_length = i + 1;
+        table.first_codes[i] = code;
+        table.first_symbol_indices[i] = symbol_index;
+
+        for (int j = 0; j < table.code_counts[i]; j++) {
+            if (code_length <= huffman_lookahead_bits && symbol_index < table.symbols.size()) {
+                // Every lookahead value that starts with this code decodes to its symbol.
+                const size_t first = code << (huffman_lookahead_bits - code_length);
+                const size_t last = first + (1 << (huffman_lookahead_bits - code_length));
+                for (size_t k = first; k < last && k < (1 << huffman_lookahead_bits); k++)
+                    table.lookahead[k] = code_length << 8 | table.symbols[symbol_index];
+            }
+            code++;
+            symbol_index++;
+        }
         code <<= 1;
     }
 }
 
+// Returns the next count (at most 24) bits of the stream without consuming them, MSB first. Bits past the end of the stream read as zero.
+static u32 peek_huffman_bits(const HuffmanStreamState& hstream, size_t count)
+{
+    u32 bits = 0;
+    for (size_t i = 0; i < 4; i++) {
+        const size_t offset = hstream.byte_offset + i;
+        bits = bits << 8 | (offset < hstream.stream.size() ? hstream.stream[offset] : 0);
+    }
+    return (bits << hstream.bit_offset) >> (32 - count);
+}
+
+static bool skip_huffman_bits(HuffmanStreamState& hstream, size_t count)
+{
+    const size_t bit_position = hstream.byte_offset * 8 + hstream.bit_offset + count;
+    if (bit_position > hstream.stream.size() * 8) {
+        dbgln_if(JPG_DEBUG, "Huffman stream exhausted. This could be an error!");
+        return false;
+    }
+    hstream.byte_offset = bit_position / 8;
+    hstream.bit_offset = bit_position % 8;
+    return true;
+}
+
 static Optional<size_t> read_huffman_bits(HuffmanStreamState& hstream, size_t count = 1)
 {
     if (count > (8 * sizeof(size_t))) {
@@ -234,37 +283,37 @@ static Optional<size_t> read_huffman_bits(HuffmanStreamState& hstream, size_t co
         return {};
     }
     size_t value = 0;
-    while (count--) {
-        if (hstream.byte_offset >= hstream.stream.size()) {
-            dbgln_if(JPG_DEBUG, "Huffman stream exhausted. This could be an error!");
+    while (count > 0) {
+        const size_t chunk = min(count, (size_t)16);
+        const auto bits = peek_huffman_bits(hstream, chunk);
+        if (!skip_huffman_bits(hstream, chunk))
             return {};
-        }
-        u8 current_byte = hstream.stream[hstream.byte_offset];
-        u8 current_bit = 1u & (u32)(current_byte >> (7 - hstream.bit_offset)); // MSB first.
-        hstream.bit_offset++;
-        value = (value << 1) | (size_t)current_bit;
-        if (hstream.bit_offset == 8) {
-            hstream.byte_offset++;
-            hstream.bit_offset = 0;
-        }
+        value = (value << chunk) | bits;
+        count -= chunk;
     }
     return value;
 }
 
 static Optional<u8> get_next_symbol(HuffmanStreamState& hstream, const HuffmanTableSpec& table)
 {
-    unsigned code = 0;
-    size_t code_cursor = 0;
-    for (int i = 0; i < 16; i++) { // Codes can't be longer than 16 bits.
-        auto result = read_huffman_bits(hstream);
-        if (!result.has_value())
+    const auto lookahead = table.lookahead[peek_huffman_bits(hstream, huffman_lookahead_bits)];
+    if (lookahead != 0) {
+        if (!skip_huffman_bits(hstream, lookahead >> 8))
             return {};
-        code = (code << 1) | (i32)result.release_value();
-        for (int j = 0; j < table.code_counts[i]; j++) {
-            if (code == table.codes[code_cursor])
-                return table.symbols[code_cursor];
-            code_cursor++;
-        }
+        return lookahead & 0xFF;
+    }
+
+    // The code is longer than our lookahead, so find it the canonical way.
+    for (size_t i = huffman_lookahead_bits; i < 16; i++) { // Codes can't be longer than 16 bits.
+        const size_t code_length = i + 1;
+        const unsigned code = peek_huffman_bits(hstream, code_length);
+        if (code < table.first_codes[i] || code - table.first_codes[i] >= table.code_counts[i])
+            continue;
+
+        const size_t symbol_index = table.first_symbol_indices[i] + code - table.first_codes[i];
+        if (symbol_index >= table.symbols.size() || !skip_huffman_bits(hstream, code_length))
+            return {};
+        return table.symbols[symbol_index];
     }
 
 #if JPG_DEBUG
@@ -378,6 +427,52 @@ static bool build_macroblocks(JPGLoadingContext& context, Vector<Macroblock>& ma
     return true;
 }
 
+static void generate_huffman_codes(JPGLoadingContext& context)
+{
+    for (auto it = context.dc_tables.begin(); it != context.dc_tables.end(); ++it)
+        generate_huffman_codes(it->value);
+
+    for (auto it = context.ac_tables.begin(); it != context.ac_tables.end(); ++it)
+        generate_huffman_codes(it->value);
+}
+
+// Decodes the row of MCUs starting at the macroblock row vcursor.
+static bool decode_huffman_row(JPGLoadingContext& context, Vector<Macroblock>& macroblocks, u32 vcursor)
+{
+    for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
+        u32 i = vcursor * context.mblock_meta.hpadded_count + hcursor;
+        if (context.dc_reset_interval > 0) {
+            if (i % context.dc_reset_interval == 0) {
+                context.previous_dc_values[0] = 0;
+                context.previous_dc_values[1] = 0;
+                context.previous_dc_values[2] = 0;
+
+                // Restart markers are stored in byte boundaries. Advance the huffman stream cursor to
+                //  the 0th bit of the next byte.
+                if (context.huffman_stream.byte_offset < context.huffman_stream.stream.size()) {
+                    if (context.huffman_stream.bit_offset > 0) {
+                        context.huffman_stream.bit_offset = 0;
+                        context.huffman_stream.byte_offset++;
+                    }
+
+                    // Skip the restart marker (RSTn).
+                    context.huffman_stream.byte_offset++;
+                }
+            }
+        }
+
+        if (!build_macroblocks(context, macroblocks, hcursor, vcursor)) {
+            if constexpr (JPG_DEBUG) {
+                dbgln("Failed to build Macroblock {}", i);
+                dbgln("Huffman stream byte offset {}", context.huffman_stream.byte_offset);
+                dbgln("Huffman stream bit offset {}", context.huffman_stream.bit_offset);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
 static Optional<Vector<Macroblock>> decode_huffman_stream(JPGLoadingContext& context)
 {
     Vector<Macroblock> macroblocks;
@@ -392,44 +487,11 @@ static Optional<Vector<Macroblock>> decode_huffman_stream(JPGLoadingContext& con
     }
 
     // Compute huffman codes for DC and AC tables.
-    for (auto it = context.dc_tables.begin(); it != context.dc_tables.end(); ++it)
-        generate_huffman_codes(it->value);
-
-    for (auto it = context.ac_tables.begin(); it != context.ac_tables.end(); ++it)
-        generate_huffman_codes(it->value);
+    generate_huffman_codes(context);
 
     for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            u32 i = vcursor * context.mblock_meta.hpadded_count + hcursor;
-            if (context.dc_reset_interval > 0) {
-                if (i % context.dc_reset_interval == 0) {
-                    context.previous_dc_values[0] = 0;
-                    context.previous_dc_values[1] = 0;
-                    context.previous_dc_values[2] = 0;
-
-                    // Restart markers are stored in byte boundaries. Advance the huffman stream cursor to
-                    //  the 0th bit of the next byte.
-                    if (context.huffman_stream.byte_offset < context.huffman_stream.stream.size()) {
-                        if (context.huffman_stream.bit_offset > 0) {
-                            context.huffman_stream.bit_offset = 0;
-                            context.huffman_stream.byte_offset++;
-                        }
-
-                        // Skip the restart marker (RSTn).
-                        context.huffman_stream.byte_offset++;
-                    }
-                }
-            }
-
-            if (!build_macroblocks(context, macroblocks, hcursor, vcursor)) {
-                if constexpr (JPG_DEBUG) {
-                    dbgln("Failed to build Macroblock {}", i);
-                    dbgln("Huffman stream byte offset {}", context.huffman_stream.byte_offset);
-                    dbgln("Huffman stream bit offset {}", context.huffman_stream.bit_offset);
-                }
-                return {};
-            }
-        }
+        if (!decode_huffman_row(context, macroblocks, vcursor))
+            return {};
     }
 
     return macroblocks;
@@ -645,7 +707,7 @@ static bool read_huffman_table(InputMemoryStream& stream, JPGLoadingContext& con
             table.code_counts[i] = count;
         }
 
-        table.codes.ensure_capacity(total_codes);
+        table.symbols.ensure_capacity(total_codes);
 
         // Read symbols. Read X bytes, where X is the sum of the counts of codes read in the previous step.
         for (u32 i = 0; i < total_codes; i++) {
@@ -860,9 +922,9 @@ static bool skip_marker_with_length(InputMemoryStream& stream)
     return !stream.handle_any_error();
 }
 
-static void dequantize(JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
+static void dequantize(JPGLoadingContext& context, Vector<Macroblock>& macroblocks, u32 first_vcursor, u32 end_vcursor)
 {
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
+    for (u32 vcursor = first_vcursor; vcursor < end_vcursor; vcursor += context.vsample_factor) {
         for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
             for (auto it = context.components.begin(); it != context.components.end(); ++it) {
                 auto& component = it->value;
@@ -881,166 +943,146 @@ static void dequantize(JPGLoadingContext& context, Vector<Macroblock>& macrobloc
     }
 }
 
-static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
+// Fixed-point multipliers with 12 fractional bits, as used by the IJG "islow" IDCT.
+static constexpr i32 fixed_from_float(float value)
 {
-    static const float m0 = 2.0 * cos(1.0 / 16.0 * 2.0 * M_PI);
-    static const float m1 = 2.0 * cos(2.0 / 16.0 * 2.0 * M_PI);
-    static const float m3 = 2.0 * cos(2.0 / 16.0 * 2.0 * M_PI);
-    static const float m5 = 2.0 * cos(3.0 / 16.0 * 2.0 * M_PI);
-    static const float m2 = m0 - m5;
-    static const float m4 = m0 + m5;
-    static const float s0 = cos(0.0 / 16.0 * M_PI) / sqrt(8);
-    static const float s1 = cos(1.0 / 16.0 * M_PI) / 2.0;
-    static const float s2 = cos(2.0 / 16.0 * M_PI) / 2.0;
-    static const float s3 = cos(3.0 / 16.0 * M_PI) / 2.0;
-    static const float s4 = cos(4.0 / 16.0 * M_PI) / 2.0;
-    static const float s5 = cos(5.0 / 16.0 * M_PI) / 2.0;
-    static const float s6 = cos(6.0 / 16.0 * M_PI) / 2.0;
-    static const float s7 = cos(7.0 / 16.0 * M_PI) / 2.0;
+    return static_cast<i32>(value * 4096 + 0.5f);
+}
 
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
+// One 1D pass of the IDCT over eight independent lanes. On the first pass every lane is a column of the block, on the second a row.
+static void inverse_dct_pass(AK::SIMD::i32x8 (&rows)[8], i32 rounding, int shift)
+{
+    using AK::SIMD::i32x8;
+
+    // Even part.
+    i32x8 p1 = (rows[2] + rows[6]) * fixed_from_float(0.5411961f);
+    i32x8 t2 = p1 + rows[6] * fixed_from_float(-1.847759065f);
+    i32x8 t3 = p1 + rows[2] * fixed_from_float(0.765366865f);
+    i32x8 t0 = (rows[0] + rows[4]) << 12;
+    i32x8 t1 = (rows[0] - rows[4]) << 12;
+    const i32x8 x0 = t0 + t3 + rounding;
+    const i32x8 x3 = t0 - t3 + rounding;
+    const i32x8 x1 = t1 + t2 + rounding;
+    const i32x8 x2 = t1 - t2 + rounding;
+
+    // Odd part.
+    t0 = rows[7];
+    t1 = rows[5];
+    t2 = rows[3];
+    t3 = rows[1];
+    i32x8 p3 = t0 + t2;
+    i32x8 p4 = t1 + t3;
+    p1 = t0 + t3;
+    i32x8 p2 = t1 + t2;
+    const i32x8 p5 = (p3 + p4) * fixed_from_float(1.175875602f);
+    t0 = t0 * fixed_from_float(0.298631336f);
+    t1 = t1 * fixed_from_float(2.053119869f);
+    t2 = t2 * fixed_from_float(3.072711026f);
+    t3 = t3 * fixed_from_float(1.501321110f);
+    p1 = p5 + p1 * fixed_from_float(-0.899976223f);
+    p2 = p5 + p2 * fixed_from_float(-2.562915447f);
+    p3 = p3 * fixed_from_float(-1.961570560f);
+    p4 = p4 * fixed_from_float(-0.390180644f);
+    t3 += p1 + p4;
+    t2 += p2 + p3;
+    t1 += p2 + p4;
+    t0 += p1 + p3;
+
+    rows[0] = (x0 + t3) >> shift;
+    rows[7] = (x0 - t3) >> shift;
+    rows[1] = (x1 + t2) >> shift;
+    rows[6] = (x1 - t2) >> shift;
+    rows[2] = (x2 + t1) >> shift;
+    rows[5] = (x2 - t1) >> shift;
+    rows[3] = (x3 + t0) >> shift;
+    rows[4] = (x3 - t0) >> shift;
+}
+
+static void transpose(AK::SIMD::i32x8 (&rows)[8])
+{
+    for (size_t i = 0; i < 8; i++) {
+        for (size_t j = i + 1; j < 8; j++) {
+            const i32 value = rows[i][j];
+            rows[i][j] = rows[j][i];
+            rows[j][i] = value;
+        }
+    }
+}
+
+// Keeping only the lowest width x height frequencies of a block and running a smaller IDCT over them
+// yields the block scaled down to width x height pixels, at a fraction of the cost of the full IDCT.
+static void inverse_dct_downscaled(i32* block, u32 width, u32 height)
+{
+    // basis.values[n][x][u], with the 1 / sqrt(8 / n) normalization of the n-point pass folded in.
+    struct Basis {
+        float values[9][8][8];
+    };
+    static const Basis basis = [] {
+        Basis basis {};
+        for (u32 n = 1; n <= 8; n *= 2) {
+            for (u32 x = 0; x < n; x++) {
+                for (u32 u = 0; u < n; u++) {
+                    float c = u == 0 ? sqrtf(1.0f / n) : sqrtf(2.0f / n);
+                    basis.values[n][x][u] = c * sqrtf(n / 8.0f) * cosf((2 * x + 1) * u * M_PI / (2 * n));
+                }
+            }
+        }
+        return basis;
+    }();
+
+    float rows[8][8];
+    for (u32 v = 0; v < height; v++) {
+        for (u32 x = 0; x < width; x++) {
+            float sum = 0;
+            for (u32 u = 0; u < width; u++)
+                sum += basis.values[width][x][u] * block[v * 8 + u];
+            rows[v][x] = sum;
+        }
+    }
+    for (u32 y = 0; y < height; y++) {
+        for (u32 x = 0; x < width; x++) {
+            float sum = 0;
+            for (u32 v = 0; v < height; v++)
+                sum += basis.values[height][y][v] * rows[v][x];
+            // Clamped like the full-size IDCT's output.
+            block[y * 8 + x] = clamp(static_cast<i32>(roundf(sum)), -128, 127);
+        }
+    }
+}
+
+static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& macroblocks, u32 first_vcursor, u32 end_vcursor)
+{
+    for (u32 vcursor = first_vcursor; vcursor < end_vcursor; vcursor += context.vsample_factor) {
         for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
             for (auto it = context.components.begin(); it != context.components.end(); ++it) {
                 auto& component = it->value;
+                // Subsampled components cover more pixels per block, so they are scaled down less.
+                const u32 block_width = min<u32>(8, 8 / context.scale_factor * context.hsample_factor / component.hsample_factor);
+                const u32 block_height = min<u32>(8, 8 / context.scale_factor * context.vsample_factor / component.vsample_factor);
                 for (u8 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
                     for (u8 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
                         u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
                         Macroblock& block = macroblocks[mb_index];
                         i32* block_component = component.serial_id == 0 ? block.y : (component.serial_id == 1 ? block.cb : block.cr);
-                        for (u32 k = 0; k < 8; ++k) {
-                            const float g0 = block_component[0 * 8 + k] * s0;
-                            const float g1 = block_component[4 * 8 + k] * s4;
-                            const float g2 = block_component[2 * 8 + k] * s2;
-                            const float g3 = block_component[6 * 8 + k] * s6;
-                            const float g4 = block_component[5 * 8 + k] * s5;
-                            const float g5 = block_component[1 * 8 + k] * s1;
-                            const float g6 = block_component[7 * 8 + k] * s7;
-                            const float g7 = block_component[3 * 8 + k] * s3;
-
-                            const float f0 = g0;
-                            const float f1 = g1;
-                            const float f2 = g2;
-                            const float f3 = g3;
-                            const float f4 = g4 - g7;
-                            const float f5 = g5 + g6;
-                            const float f6 = g5 - g6;
-                            const float f7 = g4 + g7;
-
-                            const float e0 = f0;
-                            const float e1 = f1;
-                            const float e2 = f2 - f3;
-                            const float e3 = f2 + f3;
-                            const float e4 = f4;
-                            const float e5 = f5 - f7;
-                            const float e6 = f6;
-                            const float e7 = f5 + f7;
-                            const float e8 = f4 + f6;
-
-                            const float d0 = e0;
-                            const float d1 = e1;
-                            const float d2 = e2 * m1;
-                            const float d3 = e3;
-                            const float d4 = e4 * m2;
-                            const float d5 = e5 * m3;
-                            const float d6 = e6 * m4;
-                            const float d7 = e7;
-                            const float d8 = e8 * m5;
-
-                            const float c0 = d0 + d1;
-                            const float c1 = d0 - d1;
-                            const float c2 = d2 - d3;
-                            const float c3 = d3;
-                            const float c4 = d4 + d8;
-                            const float c5 = d5 + d7;
-                            const float c6 = d6 - d8;
-                            const float c7 = d7;
-                            const float c8 = c5 - c6;
-
-                            const float b0 = c0 + c3;
-                            const float b1 = c1 + c2;
-                            const float b2 = c1 - c2;
-                            const float b3 = c0 - c3;
-                            const float b4 = c4 - c8;
-                            const float b5 = c8;
-                            const float b6 = c6 - c7;
-                            const float b7 = c7;
-
-                            block_component[0 * 8 + k] = b0 + b7;
-                            block_component[1 * 8 + k] = b1 + b6;
-                            block_component[2 * 8 + k] = b2 + b5;
-                            block_component[3 * 8 + k] = b3 + b4;
-                            block_component[4 * 8 + k] = b3 - b4;
-                            block_component[5 * 8 + k] = b2 - b5;
-                            block_component[6 * 8 + k] = b1 - b6;
-                            block_component[7 * 8 + k] = b0 - b7;
+
+                        if (block_width < 8 || block_height < 8) {
+                            inverse_dct_downscaled(block_component, block_width, block_height);
+                            continue;
                         }
-                        for (u32 l = 0; l < 8; ++l) {
-                            const float g0 = block_component[l * 8 + 0] * s0;
-                            const float g1 = block_component[l * 8 + 4] * s4;
-                            const float g2 = block_component[l * 8 + 2] * s2;
-                            const float g3 = block_component[l * 8 + 6] * s6;
-                            const float g4 = block_component[l * 8 + 5] * s5;
-                            const float g5 = block_component[l * 8 + 1] * s1;
-                            const float g6 = block_component[l * 8 + 7] * s7;
-                            const float g7 = block_component[l * 8 + 3] * s3;
-
-                            const float f0 = g0;
-                            const float f1 = g1;
-                            const float f2 = g2;
-                            const float f3 = g3;
-                            const float f4 = g4 - g7;
-                            const float f5 = g5 + g6;
-                            const float f6 = g5 - g6;
-                            const float f7 = g4 + g7;
-
-                            const float e0 = f0;
-                            const float e1 = f1;
-                            const float e2 = f2 - f3;
-                            const float e3 = f2 + f3;
-                            const float e4 = f4;
-                            const float e5 = f5 - f7;
-                            const float e6 = f6;
-                            const float e7 = f5 + f7;
-                            const float e8 = f4 + f6;
-
-                            const float d0 = e0;
-                            const float d1 = e1;
-                            const float d2 = e2 * m1;
-                            const float d3 = e3;
-                            const float d4 = e4 * m2;
-                            const float d5 = e5 * m3;
-                            const float d6 = e6 * m4;
-                            const float d7 = e7;
-                            const float d8 = e8 * m5;
-
-                            const float c0 = d0 + d1;
-                            const float c1 = d0 - d1;
-                            const float c2 = d2 - d3;
-                            const float c3 = d3;
-                            const float c4 = d4 + d8;
-                            const float c5 = d5 + d7;
-                            const float c6 = d6 - d8;
-                            const float c7 = d7;
-                            const float c8 = c5 - c6;
-
-                            const float b0 = c0 + c3;
-                            const float b1 = c1 + c2;
-                            const float b2 = c1 - c2;
-                            const float b3 = c0 - c3;
-                            const float b4 = c4 - c8;
-                            const float b5 = c8;
-                            const float b6 = c6 - c7;
-                            const float b7 = c7;
-
-                            block_component[l * 8 + 0] = b0 + b7;
-                            block_component[l * 8 + 1] = b1 + b6;
-                            block_component[l * 8 + 2] = b2 + b5;
-                            block_component[l * 8 + 3] = b3 + b4;
-                            block_component[l * 8 + 4] = b3 - b4;
-                            block_component[l * 8 + 5] = b2 - b5;
-                            block_component[l * 8 + 6] = b1 - b6;
-                            block_component[l * 8 + 7] = b0 - b7;
+
+                        AK::SIMD::i32x8 rows[8];
+                        __builtin_memcpy(rows, block_component, sizeof(rows));
+                        // The column pass keeps two extra bits of precision, and the row pass removes them along with the fixed-point scale.
+                        inverse_dct_pass(rows, 1 << 9, 10);
+                        transpose(rows);
+                        inverse_dct_pass(rows, 1 << 16, 17);
+                        transpose(rows);
+                        // Samples are clamped to the 8-bit range (minus the level shift) before color conversion, as in T.81 A.3.1.
+                        for (auto& row : rows) {
+                            row = row < -128 ? -128 : row;
+                            row = row > 127 ? 127 : row;
                         }
+                        __builtin_memcpy(block_component, rows, sizeof(rows));
                     }
                 }
             }
@@ -1048,32 +1090,62 @@ static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& ma
     }
 }
 
-static void ycbcr_to_rgb(const JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
+static void ycbcr_to_rgb(const JPGLoadingContext& context, Vector<Macroblock>& macroblocks, u32 first_vcursor, u32 end_vcursor)
 {
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
+    using AK::SIMD::i32x8;
+
+    // ITU-R BT.601 coefficients with 16 fractional bits.
+    constexpr i32 cr_to_r = 91881;  // 1.402
+    constexpr i32 cb_to_g = 22554;  // 0.344136
+    constexpr i32 cr_to_g = 46802;  // 0.714136
+    constexpr i32 cb_to_b = 116130; // 1.772
+    constexpr i32 rounding = 1 << 15;
+
+    auto clamp = [](i32x8& value) {
+        value = value < 0 ? 0 : value;
+        value = value > 255 ? 255 : value;
+    };
+
+    const u32 block_size = 8 / context.scale_factor;
+    // The chroma blocks were scaled down less than the luma blocks by the sampling factors, up to their full size.
+    const u32 chroma_block_width = min<u32>(8, block_size * context.hsample_factor);
+    const u32 chroma_block_height = min<u32>(8, block_size * context.vsample_factor);
+
+    for (u32 vcursor = first_vcursor; vcursor < end_vcursor; vcursor += context.vsample_factor) {
         for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
             const u32 chroma_block_index = vcursor * context.mblock_meta.hpadded_count + hcursor;
             const Macroblock& chroma = macroblocks[chroma_block_index];
             // Overflows are intentional.
+            // The chroma block is the last one we overwrite, and its rows are read before they are overwritten.
             for (u8 vfactor_i = context.vsample_factor - 1; vfactor_i < context.vsample_factor; --vfactor_i) {
                 for (u8 hfactor_i = context.hsample_factor - 1; hfactor_i < context.hsample_factor; --hfactor_i) {
                     u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hcursor + hfactor_i);
                     i32* y = macroblocks[mb_index].y;
                     i32* cb = macroblocks[mb_index].cb;
                     i32* cr = macroblocks[mb_index].cr;
-                    for (u8 i = 7; i < 8; --i) {
-                        for (u8 j = 7; j < 8; --j) {
-                            const u8 pixel = i * 8 + j;
-                            const u32 chroma_pxrow = (i / context.vsample_factor) + 4 * vfactor_i;
-                            const u32 chroma_pxcol = (j / context.hsample_factor) + 4 * hfactor_i;
+                    for (u8 i = block_size - 1; i < block_size; --i) {
+                        const u32 chroma_pxrow = (i + block_size * vfactor_i) * chroma_block_height / (block_size * context.vsample_factor);
+                        i32x8 luma_row;
+                        i32x8 cb_row {};
+                        i32x8 cr_row {};
+                        __builtin_memcpy(&luma_row, y + i * 8, sizeof(luma_row));
+                        for (u8 j = 0; j < block_size; ++j) {
+                            const u32 chroma_pxcol = (j + block_size * hfactor_i) * chroma_block_width / (block_size * context.hsample_factor);
                             const u32 chroma_pixel = chroma_pxrow * 8 + chroma_pxcol;
-                            int r = y[pixel] + 1.402f * chroma.cr[chroma_pixel] + 128;
-                            int g = y[pixel] - 0.344f * chroma.cb[chroma_pixel] - 0.714f * chroma.cr[chroma_pixel] + 128;
-                            int b = y[pixel] + 1.772f * chroma.cb[chroma_pixel] + 128;
-                            y[pixel] = r < 0 ? 0 : (r > 255 ? 255 : r);
-                            cb[pixel] = g < 0 ? 0 : (g > 255 ? 255 : g);
-                            cr[pixel] = b < 0 ? 0 : (b > 255 ? 255 : b);
+                            cb_row[j] = chroma.cb[chroma_pixel];
+                            cr_row[j] = chroma.cr[chroma_pixel];
                         }
+
+                        luma_row += 128;
+                        i32x8 r = luma_row + ((cr_row * cr_to_r + rounding) >> 16);
+                        i32x8 g = luma_row + ((rounding - cb_row * cb_to_g - cr_row * cr_to_g) >> 16);
+                        i32x8 b = luma_row + ((cb_row * cb_to_b + rounding) >> 16);
+                        clamp(r);
+                        clamp(g);
+                        clamp(b);
+                        __builtin_memcpy(y + i * 8, &r, sizeof(r));
+                        __builtin_memcpy(cb + i * 8, &g, sizeof(g));
+                        __builtin_memcpy(cr + i * 8, &b, sizeof(b));
                     }
                 }
             }
@@ -1081,26 +1153,34 @@ static void ycbcr_to_rgb(const JPGLoadingContext& context, Vector<Macroblock>& m
     }
 }
 
-static bool compose_bitmap(JPGLoadingContext& context, const Vector<Macroblock>& macroblocks)
+static bool create_bitmap(JPGLoadingContext& context)
 {
-    context.bitmap = Bitmap::create_purgeable(BitmapFormat::BGRx8888, { context.frame.width, context.frame.height });
-    if (!context.bitmap)
-        return false;
+    const u32 width = ceil_div<u32>(context.frame.width, context.scale_factor);
+    const u32 height = ceil_div<u32>(context.frame.height, context.scale_factor);
+    context.bitmap = Bitmap::create_purgeable(BitmapFormat::BGRx8888, { static_cast<int>(width), static_cast<int>(height) });
+    return context.bitmap;
+}
 
-    for (u32 y = context.frame.height - 1; y < context.frame.height; y--) {
-        const u32 block_row = y / 8;
-        const u32 pixel_row = y % 8;
-        for (u32 x = 0; x < context.frame.width; x++) {
-            const u32 block_column = x / 8;
+// Fills in the pixels covered by the macroblock rows from first_vcursor up to end_vcursor.
+static void compose_bitmap(JPGLoadingContext& context, const Vector<Macroblock>& macroblocks, u32 first_vcursor, u32 end_vcursor)
+{
+    const u32 block_size = 8 / context.scale_factor;
+    const u32 width = context.bitmap->width();
+    const u32 first_row = first_vcursor * block_size;
+    const u32 end_row = min<u32>(end_vcursor * block_size, context.bitmap->height());
+
+    for (u32 y = end_row - 1; y >= first_row && y < end_row; y--) {
+        const u32 block_row = y / block_size;
+        const u32 pixel_row = y % block_size;
+        for (u32 x = 0; x < width; x++) {
+            const u32 block_column = x / block_size;
             auto& block = macroblocks[block_row * context.mblock_meta.hpadded_count + block_column];
-            const u32 pixel_column = x % 8;
+            const u32 pixel_column = x % block_size;
             const u32 pixel_index = pixel_row * 8 + pixel_column;
             const Color color { (u8)block.y[pixel_index], (u8)block.cb[pixel_index], (u8)block.cr[pixel_index] };
             context.bitmap->set_pixel(x, y, color);
         }
     }
-
-    return true;
 }
 
 static bool parse_header(InputMemoryStream& stream, JPGLoadingContext& context)
@@ -1170,50 +1250,70 @@ static bool parse_header(InputMemoryStream& stream, JPGLoadingContext& context)
     VERIFY_NOT_REACHED();
 }
 
-static bool scan_huffman_stream(InputMemoryStream& stream, JPGLoadingContext& context)
-{
-    u8 last_byte;
-    u8 current_byte = 0;
-    stream >> current_byte;
-    if (stream.handle_any_error())
-        return false;
+enum class ScanStatus {
+    Complete,
+    Incomplete,
+    Invalid,
+};
 
-    for (;;) {
-        last_byte = current_byte;
-        stream >> current_byte;
-        if (stream.handle_any_error()) {
-            dbgln_if(JPG_DEBUG, "{}: EOI not found!", stream.offset());
-            return false;
+// Copies the entropy-coded data of the scan that continues at data[offset] into the huffman stream, without the byte stuffing,
+// and advances offset past it. Stops in front of a marker whose second byte hasn't arrived yet, since it can't be told apart
+// from stuffing until it has.
+static ScanStatus unstuff_huffman_stream(ReadonlyBytes data, size_t& offset, HuffmanStreamState& hstream)
+{
+    while (offset < data.size()) {
+        if (data[offset] != 0xFF) {
+            hstream.stream.append(data[offset++]);
+            continue;
         }
 
-        if (last_byte == 0xFF) {
-            if (current_byte == 0xFF)
-                continue;
-            if (current_byte == 0x00) {
-                stream >> current_byte;
-                if (stream.handle_any_error())
-                    return false;
-                context.huffman_stream.stream.append(last_byte);
-                continue;
-            }
-            Marker marker = 0xFF00 | current_byte;
-            if (marker == JPG_EOI)
-                return true;
-            if (marker >= JPG_RST0 && marker <= JPG_RST7) {
-                context.huffman_stream.stream.append(marker);
-                stream >> current_byte;
-                if (stream.handle_any_error())
-                    return false;
-                continue;
-            }
-            dbgln_if(JPG_DEBUG, "{}: Invalid marker: {:x}!", stream.offset(), marker);
-            return false;
-        } else {
-            context.huffman_stream.stream.append(last_byte);
+        size_t next = offset + 1;
+        while (next < data.size() && data[next] == 0xFF)
+            next++;
+        if (next == data.size())
+            return ScanStatus::Incomplete;
+
+        Marker marker = 0xFF00 | data[next];
+        offset = next + 1;
+        if (marker == 0xFF00) {
+            hstream.stream.append(0xFF);
+            continue;
+        }
+        if (marker == JPG_EOI)
+            return ScanStatus::Complete;
+        if (marker >= JPG_RST0 && marker <= JPG_RST7) {
+            hstream.stream.append(marker);
+            continue;
         }
+        dbgln_if(JPG_DEBUG, "{}: Invalid marker: {:x}!", next, marker);
+        return ScanStatus::Invalid;
     }
+    return ScanStatus::Incomplete;
+}
 
-    VERIFY_NOT_REACHED();
+static bool scan_huffman_stream(JPGLoadingContext& context, size_t offset)
+{
+    auto status = unstuff_huffman_stream({ context.data, context.data_size }, offset, context.huffman_stream);
+    if (status == ScanStatus::Incomplete)
+        dbgln_if(JPG_DEBUG, "{}: EOI not found!", offset);
+    return status == ScanStatus::Complete;
+}
+
+// Downscaled decoding needs every component's block to scale down to a power-of-two size.
+static bool has_power_of_two_sampling_ratios(const JPGLoadingContext& context)
+{
+    auto is_power_of_two_ratio = [](u8 frame_factor, u8 component_factor) {
+        if (frame_factor % component_factor)
+            return false;
+        auto ratio = frame_factor / component_factor;
+        return (ratio & (ratio - 1)) == 0;
+    };
+    for (auto& it : context.components) {
+        auto& component = it.value;
+        if (!is_power_of_two_ratio(context.hsample_factor, component.hsample_factor) || !is_power_of_two_ratio(context.vsample_factor, component.vsample_factor))
+            return false;
+    }
+    return true;
 }
 
 static bool decode_jpg(JPGLoadingContext& context)
@@ -1222,7 +1322,9 @@ static bool decode_jpg(JPGLoadingContext& context)
 
     if (!parse_header(stream, context))
         return false;
-    if (!scan_huffman_stream(stream, context))
+    if (!context.bounding_size.is_empty() && has_power_of_two_sampling_ratios(context))
+        context.scale_factor = downscale_factor_for_fitting({ context.frame.width, context.frame.height }, context.bounding_size, 8);
+    if (!scan_huffman_stream(context, stream.offset()))
         return false;
 
     auto result = decode_huffman_stream(context);
@@ -1232,14 +1334,121 @@ static bool decode_jpg(JPGLoadingContext& context)
     }
 
     auto macroblocks = result.release_value();
-    dequantize(context, macroblocks);
-    inverse_dct(context, macroblocks);
-    ycbcr_to_rgb(context, macroblocks);
-    if (!compose_bitmap(context, macroblocks))
+    const u32 vcount = context.mblock_meta.vcount;
+    dequantize(context, macroblocks, 0, vcount);
+    inverse_dct(context, macroblocks, 0, vcount);
+    ycbcr_to_rgb(context, macroblocks, 0, vcount);
+    if (!create_bitmap(context))
         return false;
+    compose_bitmap(context, macroblocks, 0, vcount);
+    return true;
+}
+
+// What partial_bitmap() needs to carry on where it left off once more of the data has arrived.
+struct JPGStreamingContext {
+    JPGLoadingContext context;
+    bool has_parsed_header { false };
+    // Where the part of the scan starts that hasn't been added to the huffman stream yet.
+    size_t scan_offset { 0 };
+    bool scan_is_complete { false };
+    Vector<Macroblock> macroblocks;
+    // The macroblock row at which the first MCU row starts that hasn't been decoded yet.
+    u32 decoded_vcursor { 0 };
+};
+
+static bool parse_streamed_header(JPGStreamingContext& streaming_context, ReadonlyBytes data)
+{
+    // The header is small, so just try again from the start until all of it has arrived.
+    JPGLoadingContext context;
+    context.data = data.data();
+    context.data_size = data.size();
+    InputMemoryStream stream { data };
+    bool success = parse_header(stream, context);
+    stream.handle_any_error();
+    if (!success)
+        return true;
+
+    streaming_context.context = move(context);
+    streaming_context.has_parsed_header = true;
+    streaming_context.scan_offset = stream.offset();
+    streaming_context.macroblocks.resize(streaming_context.context.mblock_meta.padded_total);
+    generate_huffman_codes(streaming_context.context);
+    return create_bitmap(streaming_context.context);
+}
+
+static bool decode_streamed_rows(JPGStreamingContext& streaming_context)
+{
+    auto& context = streaming_context.context;
+    auto& hstream = context.huffman_stream;
+    const u32 first_vcursor = streaming_context.decoded_vcursor;
+
+    while (streaming_context.decoded_vcursor < context.mblock_meta.vcount) {
+        const u32 vcursor = streaming_context.decoded_vcursor;
+        const auto byte_offset = hstream.byte_offset;
+        const auto bit_offset = hstream.bit_offset;
+        i32 previous_dc_values[3];
+        __builtin_memcpy(previous_dc_values, context.previous_dc_values, sizeof(previous_dc_values));
+
+        if (!decode_huffman_row(context, streaming_context.macroblocks, vcursor)) {
+            if (streaming_context.scan_is_complete)
+                return false;
+
+            // The rest of this row hasn't arrived yet, so start it over next time.
+            hstream.byte_offset = byte_offset;
+            hstream.bit_offset = bit_offset;
+            __builtin_memcpy(context.previous_dc_values, previous_dc_values, sizeof(previous_dc_values));
+            for (u32 row = vcursor; row < vcursor + context.vsample_factor; row++) {
+                for (u32 column = 0; column < context.mblock_meta.hpadded_count; column++)
+                    streaming_context.macroblocks[row * context.mblock_meta.hpadded_count + column] = {};
+            }
+            break;
+        }
+        streaming_context.decoded_vcursor += context.vsample_factor;
+    }
+
+    const u32 end_vcursor = streaming_context.decoded_vcursor;
+    if (end_vcursor == first_vcursor)
+        return true;
+
+    dequantize(context, streaming_context.macroblocks, first_vcursor, end_vcursor);
+    inverse_dct(context, streaming_context.macroblocks, first_vcursor, end_vcursor);
+    ycbcr_to_rgb(context, streaming_context.macroblocks, first_vcursor, end_vcursor);
+    compose_bitmap(context, streaming_context.macroblocks, first_vcursor, end_vcursor);
     return true;
 }
 
+// Decodes what has arrived of an image since the last time, and returns how many of its rows are available now.
+static int decode_jpg_streamed_data(JPGStreamingContext& streaming_context, ReadonlyBytes data)
+{
+    auto& context = streaming_context.context;
+    if (context.state == JPGLoadingContext::State::Error)
+        return 0;
+
+    if (!streaming_context.has_parsed_header) {
+        if (!parse_streamed_header(streaming_context, data)) {
+            context.state = JPGLoadingContext::State::Error;
+            return 0;
+        }
+        if (!streaming_context.has_parsed_header)
+            return 0;
+    }
+
+    if (!streaming_context.scan_is_complete) {
+        auto status = unstuff_huffman_stream(data, streaming_context.scan_offset, context.huffman_stream);
+        if (status == ScanStatus::Invalid) {
+            context.state = JPGLoadingContext::State::Error;
+            return 0;
+        }
+        streaming_context.scan_is_complete = status == ScanStatus::Complete;
+    }
+
+    if (!decode_streamed_rows(streaming_context)) {
+        context.state = JPGLoadingContext::State::Error;
+        return 0;
+    }
+    return min<u32>(streaming_context.decoded_vcursor * 8, context.frame.height);
+}
+
 static RefPtr<Gfx::Bitmap> load_jpg_impl(const u8* data, size_t data_size)
 {
     JPGLoadingContext context;
@@ -1308,6 +1517,24 @@ RefPtr<Gfx::Bitmap> JPGImageDecoderPlugin::bitmap()
     return m_context->bitmap;
 }
 
+RefPtr<Gfx::Bitmap> JPGImageDecoderPlugin::downscaled_bitmap(const IntSize& bounding_size)
+{
+    if (m_context->state < JPGLoadingContext::State::BitmapDecoded)
+        m_context->bounding_size = bounding_size;
+    return bitmap();
+}
+
+PartialImageDescriptor JPGImageDecoderPlugin::partial_bitmap(ReadonlyBytes data)
+{
+    if (!m_streaming_context)
+        m_streaming_context = make<JPGStreamingContext>();
+
+    auto available_rows = decode_jpg_streamed_data(*m_streaming_context, data);
+    if (!available_rows)
+        return {};
+    return { m_streaming_context->context.bitmap, available_rows };
+}
+
 void JPGImageDecoderPlugin::set_volatile()
 {
     if (m_context->bitmap)
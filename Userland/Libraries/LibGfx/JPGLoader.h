@@ -37,6 +37,7 @@ RefPtr<Gfx::Bitmap> load_jpg(String const& path);
 RefPtr<Gfx::Bitmap> load_jpg_from_memory(const u8* data, size_t length);
 
 struct JPGLoadingContext;
+struct JPGStreamingContext;
 
 class JPGImageDecoderPlugin : public ImageDecoderPlugin {
 public:
@@ -51,8 +52,11 @@ public:
     virtual size_t loop_count() override;
     virtual size_t frame_count() override;
     virtual ImageFrameDescriptor frame(size_t i) override;
+    virtual PartialImageDescriptor partial_bitmap(ReadonlyBytes) override;
+    virtual RefPtr<Gfx::Bitmap> downscaled_bitmap(const IntSize& bounding_size) override;
 
 private:
     OwnPtr<JPGLoadingContext> m_context;
+    OwnPtr<JPGStreamingContext> m_streaming_context;
 };
 }
@@ -118,6 +118,9 @@ struct PNGLoadingContext {
     u8 interlace_method { 0 };
     u8 channels { 0 };
     bool has_seen_zlib_header { false };
+    IntSize bounding_size;
+    // Each pixel of the bitmap is the average of a scale_factor x scale_factor block of the image.
+    int scale_factor { 1 };
     bool has_alpha() const { return color_type & 4 || palette_transparency_data.size() > 0; }
     Vector<Scanline> scanlines;
     RefPtr<Gfx::Bitmap> bitmap;
@@ -181,6 +184,7 @@ public:
     }
 
     bool at_end() const { return !m_size_remaining; }
+    size_t remaining() const { return m_size_remaining; }
 
 private:
     const u8* m_data_ptr { nullptr };
@@ -361,7 +365,8 @@ ALWAYS_INLINE static void unpack_triplets_without_alpha(PNGLoadingContext& conte
     }
 }
 
-NEVER_INLINE FLATTEN static bool unfilter(PNGLoadingContext& context)
+// previous_scanline is the already unfiltered row above the first one, for images that are unfiltered a few rows at a time.
+NEVER_INLINE FLATTEN static bool unfilter(PNGLoadingContext& context, const u8* previous_scanline = nullptr)
 {
     // First unpack the scanlines to RGBA:
     switch (context.color_type) {
@@ -478,42 +483,43 @@ NEVER_INLINE FLATTEN static bool unfilter(PNGLoadingContext& context)
 
     u8 dummy_scanline[context.width * sizeof(RGBA32)];
     memset(dummy_scanline, 0, sizeof(dummy_scanline));
+    const void* first_previous_scanline = previous_scanline ? previous_scanline : dummy_scanline;
 
     for (int y = 0; y < context.height; ++y) {
         auto filter = context.scanlines[y].filter;
         if (filter == 0) {
             if (context.has_alpha())
-                unfilter_impl<true, 0>(*context.bitmap, y, dummy_scanline);
+                unfilter_impl<true, 0>(*context.bitmap, y, first_previous_scanline);
             else
-                unfilter_impl<false, 0>(*context.bitmap, y, dummy_scanline);
+                unfilter_impl<false, 0>(*context.bitmap, y, first_previous_scanline);
             continue;
         }
         if (filter == 1) {
             if (context.has_alpha())
-                unfilter_impl<true, 1>(*context.bitmap, y, dummy_scanline);
+                unfilter_impl<true, 1>(*context.bitmap, y, first_previous_scanline);
             else
-                unfilter_impl<false, 1>(*context.bitmap, y, dummy_scanline);
+                unfilter_impl<false, 1>(*context.bitmap, y, first_previous_scanline);
             continue;
         }
         if (filter == 2) {
             if (context.has_alpha())
-                unfilter_impl<true, 2>(*context.bitmap, y, dummy_scanline);
+                unfilter_impl<true, 2>(*context.bitmap, y, first_previous_scanline);
             else
-                unfilter_impl<false, 2>(*context.bitmap, y, dummy_scanline);
+                unfilter_impl<false, 2>(*context.bitmap, y, first_previous_scanline);
             continue;
         }
         if (filter == 3) {
             if (context.has_alpha())
-                unfilter_impl<true, 3>(*context.bitmap, y, dummy_scanline);
+                unfilter_impl<true, 3>(*context.bitmap, y, first_previous_scanline);
             else
-                unfilter_impl<false, 3>(*context.bitmap, y, dummy_scanline);
+                unfilter_impl<false, 3>(*context.bitmap, y, first_previous_scanline);
             continue;
         }
         if (filter == 4) {
             if (context.has_alpha())
-                unfilter_impl<true, 4>(*context.bitmap, y, dummy_scanline);
+                unfilter_impl<true, 4>(*context.bitmap, y, first_previous_scanline);
             else
-                unfilter_impl<false, 4>(*context.bitmap, y, dummy_scanline);
+                unfilter_impl<false, 4>(*context.bitmap, y, first_previous_scanline);
             continue;
         }
     }
@@ -598,11 +604,14 @@ static bool decode_png_chunks(PNGLoadingContext& context)
     return true;
 }
 
-static bool decode_png_bitmap_simple(PNGLoadingContext& context)
+// Reads the filter type and raw data of target.height rows of target.width pixels into target.scanlines.
+static bool read_scanlines(PNGLoadingContext& context, Streamer& streamer, PNGLoadingContext& target)
 {
-    Streamer streamer(context.decompression_buffer.data(), context.decompression_buffer.size());
+    auto row_size = context.compute_row_size_for_width(target.width);
+    if (row_size.has_overflow())
+        return false;
 
-    for (int y = 0; y < context.height; ++y) {
+    for (int y = 0; y < target.height; ++y) {
         u8 filter;
         if (!streamer.read(filter)) {
             context.state = PNGLoadingContext::State::Error;
@@ -615,17 +624,21 @@ static bool decode_png_bitmap_simple(PNGLoadingContext& context)
             return false;
         }
 
-        context.scanlines.append({ filter });
-        auto& scanline_buffer = context.scanlines.last().data;
-        auto row_size = context.compute_row_size_for_width(context.width);
-        if (row_size.has_overflow())
-            return false;
-
+        target.scanlines.append({ filter });
+        auto& scanline_buffer = target.scanlines.last().data;
         if (!streamer.wrap_bytes(scanline_buffer, row_size.value())) {
             context.state = PNGLoadingContext::State::Error;
             return false;
         }
     }
+    return true;
+}
+
+static bool decode_png_bitmap_simple(PNGLoadingContext& context)
+{
+    Streamer streamer(context.decompression_buffer.data(), context.decompression_buffer.size());
+    if (!read_scanlines(context, streamer, context))
+        return false;
 
     context.bitmap = Bitmap::create_purgeable(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height });
 
@@ -637,6 +650,20 @@ static bool decode_png_bitmap_simple(PNGLoadingContext& context)
     return unfilter(context);
 }
 
+// Sets up strip_context for unfiltering up to height rows of width pixels at a time.
+static bool create_strip_context(const PNGLoadingContext& context, PNGLoadingContext& strip_context, int width, int height)
+{
+    strip_context.width = width;
+    strip_context.channels = context.channels;
+    strip_context.color_type = context.color_type;
+    strip_context.palette_data = context.palette_data;
+    strip_context.palette_transparency_data = context.palette_transparency_data;
+    strip_context.bit_depth = context.bit_depth;
+    strip_context.filter_method = context.filter_method;
+    strip_context.bitmap = Bitmap::create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { width, height });
+    return strip_context.bitmap;
+}
+
 static int adam7_height(PNGLoadingContext& context, int pass)
 {
     switch (pass) {
@@ -687,6 +714,10 @@ static int adam7_startx[8] = { 0, 0, 4, 0, 2, 0, 1, 0 };
 static int adam7_stepy[8] = { 1, 8, 8, 8, 4, 4, 2, 2 };
 static int adam7_stepx[8] = { 1, 8, 8, 4, 4, 2, 2, 1 };
 
+// The area each pixel of a pass covers until the later passes have been decoded.
+static int adam7_block_height[8] = { 1, 8, 8, 4, 4, 2, 2, 1 };
+static int adam7_block_width[8] = { 1, 8, 4, 4, 2, 2, 1, 1 };
+
 static bool decode_adam7_pass(PNGLoadingContext& context, Streamer& streamer, int pass)
 {
     PNGLoadingContext subimage_context;
@@ -704,30 +735,8 @@ static bool decode_adam7_pass(PNGLoadingContext& context, Streamer& streamer, in
         return true;
 
     subimage_context.scanlines.clear_with_capacity();
-    for (int y = 0; y < subimage_context.height; ++y) {
-        u8 filter;
-        if (!streamer.read(filter)) {
-            context.state = PNGLoadingContext::State::Error;
-            return false;
-        }
-
-        if (filter > 4) {
-            dbgln_if(PNG_DEBUG, "Invalid PNG filter: {}", filter);
-            context.state = PNGLoadingContext::State::Error;
-            return false;
-        }
-
-        subimage_context.scanlines.append({ filter });
-        auto& scanline_buffer = subimage_context.scanlines.last().data;
-
-        auto row_size = context.compute_row_size_for_width(subimage_context.width);
-        if (row_size.has_overflow())
-            return false;
-        if (!streamer.wrap_bytes(scanline_buffer, row_size.value())) {
-            context.state = PNGLoadingContext::State::Error;
-            return false;
-        }
-    }
+    if (!read_scanlines(context, streamer, subimage_context))
+        return false;
 
     subimage_context.bitmap = Bitmap::create(context.bitmap->format(), { subimage_context.width, subimage_context.height });
     if (!unfilter(subimage_context)) {
@@ -737,7 +746,7 @@ static bool decode_adam7_pass(PNGLoadingContext& context, Streamer& streamer, in
 
     // Copy the subimage data into the main image according to the pass pattern
     for (int y = 0, dy = adam7_starty[pass]; y < subimage_context.height && dy < context.height; ++y, dy += adam7_stepy[pass]) {
-        for (int x = 0, dx = adam7_startx[pass]; x < subimage_context.width && dy < context.width; ++x, dx += adam7_stepx[pass]) {
+        for (int x = 0, dx = adam7_startx[pass]; x < subimage_context.width && dx < context.width; ++x, dx += adam7_stepx[pass]) {
             context.bitmap->set_pixel(dx, dy, subimage_context.bitmap->get_pixel(x, y));
         }
     }
@@ -758,6 +767,127 @@ static bool decode_png_adam7(PNGLoadingContext& context)
     return true;
 }
 
+// Inflates the image data a piece at a time as it is read, so only a few rows of it are ever in memory.
+class InflatingReader {
+public:
+    explicit InflatingReader(ReadonlyBytes compressed_data)
+        : m_compressed_data(compressed_data)
+    {
+    }
+
+    // Returns the next size bytes of image data, or an empty span if the data is invalid or ends too soon.
+    ReadonlyBytes read(size_t size)
+    {
+        m_data.remove(0, m_consumed);
+        m_consumed = 0;
+        while (m_data.size() < size && !m_compressed_data.is_empty()) {
+            auto piece = m_compressed_data.trim(4 * KiB);
+            m_compressed_data = m_compressed_data.slice(piece.size());
+            if (!m_decompressor.append(piece, m_data))
+                return {};
+        }
+        if (m_data.size() < size)
+            return {};
+        m_consumed = size;
+        return m_data.span().trim(size);
+    }
+
+private:
+    ReadonlyBytes m_compressed_data;
+    Compress::StreamingZlibDecompressor m_decompressor;
+    Vector<u8> m_data;
+    size_t m_consumed { 0 };
+};
+
+// Unfilters the rows of an Adam7 pass, or of the whole image for pass 0, a strip at a time, and adds
+// each pixel to the sums of the scale_factor x scale_factor block of the image it falls into.
+static bool accumulate_downscaled_pass(PNGLoadingContext& context, InflatingReader& reader, int pass, Vector<u32>& sums)
+{
+    int width = pass ? adam7_width(context, pass) : context.width;
+    int height = pass ? adam7_height(context, pass) : context.height;
+
+    // For small images, some passes might be empty
+    if (!width || !height)
+        return true;
+
+    auto row_size = context.compute_row_size_for_width(width);
+    if (row_size.has_overflow())
+        return false;
+    size_t scanline_size = row_size.value() + 1;
+
+    constexpr int strip_height = 8;
+    PNGLoadingContext strip_context;
+    if (!create_strip_context(context, strip_context, width, min(strip_height, height)))
+        return false;
+
+    auto factor = context.scale_factor;
+    auto bitmap_width = context.bitmap->width();
+    Vector<u8> previous_scanline;
+    previous_scanline.resize(width * sizeof(RGBA32));
+    for (int y = 0; y < height; y += strip_height) {
+        strip_context.height = min(strip_height, height - y);
+        strip_context.scanlines.clear_with_capacity();
+        auto data = reader.read(strip_context.height * scanline_size);
+        if (data.is_empty())
+            return false;
+        Streamer streamer(data.data(), data.size());
+        if (!read_scanlines(context, streamer, strip_context))
+            return false;
+        if (!unfilter(strip_context, y == 0 ? nullptr : previous_scanline.data()))
+            return false;
+        memcpy(previous_scanline.data(), strip_context.bitmap->scanline(strip_context.height - 1), previous_scanline.size());
+
+        for (int strip_y = 0; strip_y < strip_context.height; ++strip_y) {
+            int image_y = adam7_starty[pass] + (y + strip_y) * adam7_stepy[pass];
+            auto* row_sums = &sums[(image_y / factor) * bitmap_width * 4];
+            auto* pixels = reinterpret_cast<const u8*>(strip_context.bitmap->scanline(strip_y));
+            for (int x = 0; x < width; ++x) {
+                int image_x = adam7_startx[pass] + x * adam7_stepx[pass];
+                auto* pixel_sums = &row_sums[(image_x / factor) * 4];
+                for (int i = 0; i < 4; ++i)
+                    pixel_sums[i] += pixels[x * 4 + i];
+            }
+        }
+    }
+    return true;
+}
+
+// Averages each block of scale_factor x scale_factor pixels into one, decoding interlaced
+// and non-interlaced images the same way.
+static bool decode_png_bitmap_downscaled(PNGLoadingContext& context)
+{
+    auto factor = context.scale_factor;
+    context.bitmap = Bitmap::create_purgeable(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { ceil_div(context.width, factor), ceil_div(context.height, factor) });
+    if (!context.bitmap) {
+        context.state = PNGLoadingContext::State::Error;
+        return false;
+    }
+
+    Vector<u32> sums;
+    sums.resize(context.bitmap->width() * context.bitmap->height() * 4);
+    sums.span().fill(0);
+    InflatingReader reader(context.compressed_data.span());
+    int first_pass = context.interlace_method == PngInterlaceMethod::Adam7 ? 1 : 0;
+    int last_pass = context.interlace_method == PngInterlaceMethod::Adam7 ? 7 : 0;
+    for (int pass = first_pass; pass <= last_pass; ++pass) {
+        if (!accumulate_downscaled_pass(context, reader, pass, sums)) {
+            context.state = PNGLoadingContext::State::Error;
+            return false;
+        }
+    }
+
+    for (int y = 0; y < context.bitmap->height(); ++y) {
+        u32 block_height = min(factor, context.height - y * factor);
+        auto* destination = reinterpret_cast<u8*>(context.bitmap->scanline(y));
+        auto* row_sums = &sums[y * context.bitmap->width() * 4];
+        for (int x = 0; x < context.bitmap->width() * 4; ++x) {
+            u32 count = min(factor, context.width - x / 4 * factor) * block_height;
+            destination[x] = (row_sums[x] + count / 2) / count;
+        }
+    }
+    return true;
+}
+
 static bool decode_png_bitmap(PNGLoadingContext& context)
 {
     if (context.state < PNGLoadingContext::State::ChunksDecoded) {
@@ -774,6 +904,17 @@ static bool decode_png_bitmap(PNGLoadingContext& context)
     if (context.color_type == 3 && context.palette_data.is_empty())
         return false; // Didn't see a PLTE chunk for a palettized image, or it was empty.
 
+    if (!context.bounding_size.is_empty())
+        context.scale_factor = downscale_factor_for_fitting({ context.width, context.height }, context.bounding_size, 8);
+
+    if (context.scale_factor > 1) {
+        if (!decode_png_bitmap_downscaled(context))
+            return false;
+        context.compressed_data.clear();
+        context.state = PNGLoadingContext::State::BitmapDecoded;
+        return true;
+    }
+
     auto result = Compress::Zlib::decompress_all(context.compressed_data.span());
     if (!result.has_value()) {
         context.state = PNGLoadingContext::State::Error;
@@ -782,9 +923,9 @@ static bool decode_png_bitmap(PNGLoadingContext& context)
     context.decompression_buffer = result.value();
     context.compressed_data.clear();
 
-    context.scanlines.ensure_capacity(context.height);
     switch (context.interlace_method) {
     case PngInterlaceMethod::Null:
+        context.scanlines.ensure_capacity(context.height);
         if (!decode_png_bitmap_simple(context))
             return false;
         break;
@@ -924,6 +1065,19 @@ static bool process_tRNS(ReadonlyBytes data, PNGLoadingContext& context)
     return true;
 }
 
+static bool process_chunk_data(const char* chunk_type, ReadonlyBytes chunk_data, PNGLoadingContext& context)
+{
+    if (!strcmp(chunk_type, "IHDR"))
+        return process_IHDR(chunk_data, context);
+    if (!strcmp(chunk_type, "IDAT"))
+        return process_IDAT(chunk_data, context);
+    if (!strcmp(chunk_type, "PLTE"))
+        return process_PLTE(chunk_data, context);
+    if (!strcmp(chunk_type, "tRNS"))
+        return process_tRNS(chunk_data, context);
+    return true;
+}
+
 static bool process_chunk(Streamer& streamer, PNGLoadingContext& context)
 {
     u32 chunk_size;
@@ -954,17 +1108,171 @@ static bool process_chunk(Streamer& streamer, PNGLoadingContext& context)
     if constexpr (PNG_DEBUG)
         printf("Chunk type: '%s', size: %u, crc: %x\n", chunk_type, chunk_size, chunk_crc);
 
-    if (!strcmp((const char*)chunk_type, "IHDR"))
-        return process_IHDR(chunk_data, context);
-    if (!strcmp((const char*)chunk_type, "IDAT"))
-        return process_IDAT(chunk_data, context);
-    if (!strcmp((const char*)chunk_type, "PLTE"))
-        return process_PLTE(chunk_data, context);
-    if (!strcmp((const char*)chunk_type, "tRNS"))
-        return process_tRNS(chunk_data, context);
+    return process_chunk_data((const char*)chunk_type, chunk_data, context);
+}
+
+// The state of decoding an image while its data is still arriving, which partial_bitmap() picks up every time more has.
+struct PNGStreamingContext {
+    PNGLoadingContext context;
+    // Where the first chunk starts that hasn't been fully processed yet, and if it's image data, how much of it has been.
+    size_t chunk_offset { sizeof(png_header) };
+    size_t chunk_data_processed { 0 };
+    Compress::StreamingZlibDecompressor decompressor;
+    // Image data that has been decompressed, but not decoded yet.
+    Vector<u8> image_data;
+    // For non-interlaced images, the number of rows decoded so far. For interlaced ones, the number of Adam7 passes.
+    int decoded_rows { 0 };
+    int decoded_passes { 0 };
+};
+
+static bool process_streamed_image_data(PNGStreamingContext& streaming_context, ReadonlyBytes data)
+{
+    auto& context = streaming_context.context;
+    if (!context.bitmap) {
+        if (context.width <= 0 || context.height <= 0)
+            return false;
+        if (context.color_type == 3 && context.palette_data.is_empty())
+            return false;
+        context.bitmap = Bitmap::create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height });
+        if (!context.bitmap)
+            return false;
+    }
+    return streaming_context.decompressor.append(data, streaming_context.image_data);
+}
+
+// Processes the chunks that have arrived since the last time. Image data is processed as it arrives, the others once complete.
+static bool process_streamed_chunks(PNGStreamingContext& streaming_context, ReadonlyBytes data)
+{
+    if (data.size() < sizeof(png_header))
+        return true;
+    if (memcmp(data.data(), png_header, sizeof(png_header)) != 0)
+        return false;
+
+    while (!streaming_context.decompressor.is_finished()) {
+        auto chunk = data.slice(streaming_context.chunk_offset);
+        Streamer streamer(chunk.data(), chunk.size());
+        u32 chunk_size;
+        char chunk_type[5] {};
+        if (!streamer.read(chunk_size) || !streamer.read_bytes((u8*)chunk_type, 4))
+            return true;
+
+        auto chunk_data = chunk.slice(8).trim(chunk_size);
+        if (!strcmp(chunk_type, "IDAT") && chunk_data.size() > streaming_context.chunk_data_processed) {
+            if (!process_streamed_image_data(streaming_context, chunk_data.slice(streaming_context.chunk_data_processed)))
+                return false;
+            streaming_context.chunk_data_processed = chunk_data.size();
+        }
+
+        // Wait for the rest of the chunk, and its CRC.
+        if (streamer.remaining() < (size_t)chunk_size + sizeof(u32))
+            return true;
+        if (strcmp(chunk_type, "IDAT") && !process_chunk_data(chunk_type, chunk_data, streaming_context.context))
+            return false;
+        streaming_context.chunk_offset += 12 + (size_t)chunk_size;
+        streaming_context.chunk_data_processed = 0;
+    }
     return true;
 }
 
+static bool decode_streamed_rows(PNGStreamingContext& streaming_context)
+{
+    auto& context = streaming_context.context;
+    auto row_size = context.compute_row_size_for_width(context.width);
+    if (row_size.has_overflow())
+        return false;
+
+    const size_t scanline_size = row_size.value() + 1;
+    const int rows = min<size_t>(context.height - streaming_context.decoded_rows, streaming_context.image_data.size() / scanline_size);
+    if (rows == 0)
+        return true;
+
+    PNGLoadingContext strip_context;
+    if (!create_strip_context(context, strip_context, context.width, rows))
+        return false;
+    strip_context.height = rows;
+
+    Streamer streamer(streaming_context.image_data.data(), rows * scanline_size);
+    if (!read_scanlines(context, streamer, strip_context))
+        return false;
+    // The first new row may be filtered against the last one decoded before, which is in the bitmap already.
+    auto* previous_scanline = streaming_context.decoded_rows ? reinterpret_cast<const u8*>(context.bitmap->scanline(streaming_context.decoded_rows - 1)) : nullptr;
+    if (!unfilter(strip_context, previous_scanline))
+        return false;
+
+    for (int y = 0; y < rows; ++y)
+        memcpy(context.bitmap->scanline(streaming_context.decoded_rows + y), strip_context.bitmap->scanline(y), context.width * sizeof(RGBA32));
+    streaming_context.decoded_rows += rows;
+    streaming_context.image_data.remove(0, rows * scanline_size);
+    return true;
+}
+
+static bool decode_streamed_adam7_passes(PNGStreamingContext& streaming_context)
+{
+    auto& context = streaming_context.context;
+    while (streaming_context.decoded_passes < 7) {
+        const int pass = streaming_context.decoded_passes + 1;
+        size_t pass_size = 0;
+        if (adam7_width(context, pass) && adam7_height(context, pass)) {
+            auto row_size = context.compute_row_size_for_width(adam7_width(context, pass));
+            if (row_size.has_overflow())
+                return false;
+            pass_size = adam7_height(context, pass) * (row_size.value() + 1);
+        }
+        if (streaming_context.image_data.size() < pass_size)
+            return true;
+
+        Streamer streamer(streaming_context.image_data.data(), pass_size);
+        if (!decode_adam7_pass(context, streamer, pass))
+            return false;
+        streaming_context.image_data.remove(0, pass_size);
+        streaming_context.decoded_passes = pass;
+        if (pass == 7)
+            break;
+
+        // Until the later passes arrive, stretch the pixels of this one over the areas that those will fill in.
+        for (int y = adam7_starty[pass]; y < context.height; y += adam7_stepy[pass]) {
+            for (int x = adam7_startx[pass]; x < context.width; x += adam7_stepx[pass]) {
+                auto color = context.bitmap->get_pixel(x, y);
+                for (int block_y = y; block_y < min(context.height, y + adam7_block_height[pass]); ++block_y) {
+                    for (int block_x = x; block_x < min(context.width, x + adam7_block_width[pass]); ++block_x)
+                        context.bitmap->set_pixel(block_x, block_y, color);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Decodes what has arrived of an image since the last time, and returns how many of its rows are available now.
+static int decode_png_streamed_data(PNGStreamingContext& streaming_context, ReadonlyBytes data)
+{
+    auto& context = streaming_context.context;
+    if (context.state == PNGLoadingContext::State::Error)
+        return 0;
+
+    if (!process_streamed_chunks(streaming_context, data)) {
+        context.state = PNGLoadingContext::State::Error;
+        return 0;
+    }
+    if (!context.bitmap)
+        return 0;
+
+    if (context.interlace_method == PngInterlaceMethod::Adam7) {
+        if (!decode_streamed_adam7_passes(streaming_context)) {
+            context.state = PNGLoadingContext::State::Error;
+            return 0;
+        }
+        // Once the first pass is in, the whole image can be shown, if blurry.
+        return streaming_context.decoded_passes ? context.height : 0;
+    }
+
+    if (!decode_streamed_rows(streaming_context)) {
+        context.state = PNGLoadingContext::State::Error;
+        return 0;
+    }
+    return streaming_context.decoded_rows;
+}
+
 PNGImageDecoderPlugin::PNGImageDecoderPlugin(const u8* data, size_t size)
 {
     m_context = make<PNGLoadingContext>();
@@ -1006,6 +1314,24 @@ RefPtr<Gfx::Bitmap> PNGImageDecoderPlugin::bitmap()
     return m_context->bitmap;
 }
 
+RefPtr<Gfx::Bitmap> PNGImageDecoderPlugin::downscaled_bitmap(const IntSize& bounding_size)
+{
+    if (m_context->state < PNGLoadingContext::State::BitmapDecoded)
+        m_context->bounding_size = bounding_size;
+    return bitmap();
+}
+
+PartialImageDescriptor PNGImageDecoderPlugin::partial_bitmap(ReadonlyBytes data)
+{
+    if (!m_streaming_context)
+        m_streaming_context = make<PNGStreamingContext>();
+
+    auto available_rows = decode_png_streamed_data(*m_streaming_context, data);
+    if (!available_rows)
+        return {};
+    return { m_streaming_context->context.bitmap, available_rows };
+}
+
 void PNGImageDecoderPlugin::set_volatile()
 {
     if (m_context->bitmap)
@@ -35,6 +35,7 @@ RefPtr<Gfx::Bitmap> load_png(String const& path);
 RefPtr<Gfx::Bitmap> load_png_from_memory(const u8*, size_t);
 
 struct PNGLoadingContext;
+struct PNGStreamingContext;
 
 class PNGImageDecoderPlugin final : public ImageDecoderPlugin {
 public:
@@ -50,9 +51,12 @@ public:
     virtual size_t loop_count() override;
     virtual size_t frame_count() override;
     virtual ImageFrameDescriptor frame(size_t i) override;
+    virtual PartialImageDescriptor partial_bitmap(ReadonlyBytes) override;
+    virtual RefPtr<Gfx::Bitmap> downscaled_bitmap(const IntSize& bounding_size) override;
 
 private:
     OwnPtr<PNGLoadingContext> m_context;
+    OwnPtr<PNGStreamingContext> m_streaming_context;
 };
 
 }
@@ -152,7 +152,7 @@ void PNGWriter::add_chunk(PNGChunk const& png_chunk)
     combined.append(png_chunk.data());
 
     auto crc = BigEndian(Crypto::Checksum::CRC32({ (const u8*)combined.data(), combined.size() }).digest());
-    auto data_len = BigEndian(png_chunk.data().size());
+    auto data_len = BigEndian<u32>(png_chunk.data().size());
 
     ByteBuffer buf;
     buf.append(&data_len, sizeof(u32));
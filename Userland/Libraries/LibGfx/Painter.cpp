@@ -36,6 +36,7 @@
 #include <AK/Memory.h>
 #include <AK/Queue.h>
 #include <AK/QuickSort.h>
+#include <AK/SIMD.h>
 #include <AK/StdLibExtras.h>
 #include <AK/StringBuilder.h>
 #include <AK/Utf32View.h>
@@ -52,6 +53,53 @@
 
 namespace Gfx {
 
+#ifdef __SSE__
+using AK::SIMD::u32x4;
+#endif
+
+// Blends src with the given alpha over an opaque dst, for a single u32 pixel or a u32x4 of them.
+// This gives exactly the same result as Color::blend() with an opaque destination, where its division
+// by a per-pixel denominator turns into a division by 255 that can be done with shifts.
+template<typename T, typename Alpha>
+ALWAYS_INLINE static T blend_onto_opaque(T dst, T src, Alpha alpha)
+{
+    // Red and blue are blended together in two 16-bit fields, each of which holds at most 255 * 255.
+    T red_blue = (dst & 0xff00ff) * (255 - alpha) + (src & 0xff00ff) * alpha;
+    T green = ((dst >> 8) & 0xff) * (255 - alpha) + ((src >> 8) & 0xff) * alpha;
+    red_blue = ((red_blue + 0x10001 + ((red_blue >> 8) & 0xff00ff)) >> 8) & 0xff00ff;
+    green = (green + 1 + (green >> 8)) >> 8;
+    return 0xff000000 | red_blue | (green << 8);
+}
+
+ALWAYS_INLINE static bool is_opaque(u32 pixel)
+{
+    return (pixel >> 24) == 0xff;
+}
+
+#ifdef __SSE__
+ALWAYS_INLINE static bool is_opaque(u32x4 pixels)
+{
+    return is_opaque(pixels[0] & pixels[1] & pixels[2] & pixels[3]);
+}
+#endif
+
+// Replaces each pixel in a row with op(pixel), four pixels at a time where possible. op has to work on both u32 and u32x4.
+template<typename Op>
+ALWAYS_INLINE static void transform_pixels(RGBA32* pixels, int count, Op op)
+{
+    int i = 0;
+#ifdef __SSE__
+    for (; i + 4 <= count; i += 4) {
+        u32x4 vector;
+        __builtin_memcpy(&vector, pixels + i, sizeof(vector));
+        vector = op(vector);
+        __builtin_memcpy(pixels + i, &vector, sizeof(vector));
+    }
+#endif
+    for (; i < count; ++i)
+        pixels[i] = op(pixels[i]);
+}
+
 template<BitmapFormat format = BitmapFormat::Invalid>
 ALWAYS_INLINE Color get_pixel(const Gfx::Bitmap& bitmap, int x, int y)
 {
@@ -98,10 +146,21 @@ void Painter::fill_rect_with_draw_op(const IntRect& a_rect, Color color)
 
     RGBA32* dst = m_target->scanline(rect.top()) + rect.left();
     const size_t dst_skip = m_target->pitch() / sizeof(RGBA32);
+    const u32 value = color.value();
 
+    // These match set_physical_pixel_with_draw_op(), applied to whole rows.
     for (int i = rect.height() - 1; i >= 0; --i) {
-        for (int j = 0; j < rect.width(); ++j)
-            set_physical_pixel_with_draw_op(dst[j], color);
+        switch (draw_op()) {
+        case DrawOp::Copy:
+            fast_u32_fill(dst, value, rect.width());
+            break;
+        case DrawOp::Xor:
+            transform_pixels(dst, rect.width(), [value](auto pixels) { return ((pixels ^ value) & 0x00ffffff) | (value & 0xff000000); });
+            break;
+        case DrawOp::Invert:
+            transform_pixels(dst, rect.width(), [](auto pixels) { return pixels ^ 0x00ffffff; });
+            break;
+        }
         dst += dst_skip;
     }
 }
@@ -130,9 +189,26 @@ void Painter::fill_physical_rect(const IntRect& physical_rect, Color color)
     RGBA32* dst = m_target->scanline(physical_rect.top()) + physical_rect.left();
     const size_t dst_skip = m_target->pitch() / sizeof(RGBA32);
 
+    const u32 value = color.value();
+    const u32 alpha = color.alpha();
     for (int i = physical_rect.height() - 1; i >= 0; --i) {
-        for (int j = 0; j < physical_rect.width(); ++j)
-            dst[j] = Color::from_rgba(dst[j]).blend(color).value();
+        int j = 0;
+#ifdef __SSE__
+        for (; j + 4 <= physical_rect.width(); j += 4) {
+            u32x4 pixels;
+            __builtin_memcpy(&pixels, dst + j, sizeof(pixels));
+            if (!is_opaque(pixels))
+                break;
+            pixels = blend_onto_opaque(pixels, u32x4 {} + value, alpha);
+            __builtin_memcpy(dst + j, &pixels, sizeof(pixels));
+        }
+#endif
+        for (; j < physical_rect.width(); ++j) {
+            if (is_opaque(dst[j]))
+                dst[j] = blend_onto_opaque(dst[j], value, alpha);
+            else
+                dst[j] = Color::from_rgba(dst[j]).blend(color).value();
+        }
         dst += dst_skip;
     }
 }
@@ -553,20 +629,47 @@ struct BlitState {
 template<BlitState::AlphaState has_alpha>
 static void do_blit_with_opacity(BlitState& state)
 {
+    // The alpha that each source alpha value is blended with, so the float math happens once per value instead of once per pixel.
+    u8 blend_alpha[256];
+    for (int source_alpha = 0; source_alpha < 256; ++source_alpha) {
+        if constexpr (has_alpha & BlitState::SrcAlpha) {
+            float pixel_opacity = source_alpha / 255.0;
+            blend_alpha[source_alpha] = 255 * (state.opacity * pixel_opacity);
+        } else {
+            blend_alpha[source_alpha] = state.opacity * 255;
+        }
+    }
+
+    auto blend_pixel = [&](u32 dst, u32 src) -> u32 {
+        u32 alpha = blend_alpha[src >> 24];
+        if ((has_alpha & BlitState::DstAlpha) && !is_opaque(dst)) {
+            Color src_color_with_alpha = Color::from_rgb(src);
+            src_color_with_alpha.set_alpha(alpha);
+            return Color::from_rgba(dst).blend(src_color_with_alpha).value();
+        }
+        return blend_onto_opaque(dst, src, alpha);
+    };
+
     for (int row = 0; row < state.row_count; ++row) {
-        for (int x = 0; x < state.column_count; ++x) {
-            Color dest_color = (has_alpha & BlitState::DstAlpha) ? Color::from_rgba(state.dst[x]) : Color::from_rgb(state.dst[x]);
-            if constexpr (has_alpha & BlitState::SrcAlpha) {
-                Color src_color_with_alpha = Color::from_rgba(state.src[x]);
-                float pixel_opacity = src_color_with_alpha.alpha() / 255.0;
-                src_color_with_alpha.set_alpha(255 * (state.opacity * pixel_opacity));
-                state.dst[x] = dest_color.blend(src_color_with_alpha).value();
-            } else {
-                Color src_color_with_alpha = Color::from_rgb(state.src[x]);
-                src_color_with_alpha.set_alpha(state.opacity * 255);
-                state.dst[x] = dest_color.blend(src_color_with_alpha).value();
+        int x = 0;
+#ifdef __SSE__
+        for (; x + 4 <= state.column_count; x += 4) {
+            u32x4 dst;
+            u32x4 src;
+            __builtin_memcpy(&dst, state.dst + x, sizeof(dst));
+            __builtin_memcpy(&src, state.src + x, sizeof(src));
+            if ((has_alpha & BlitState::DstAlpha) && !is_opaque(dst)) {
+                for (int i = 0; i < 4; ++i)
+                    state.dst[x + i] = blend_pixel(state.dst[x + i], state.src[x + i]);
+                continue;
             }
+            u32x4 alpha = { blend_alpha[src[0] >> 24], blend_alpha[src[1] >> 24], blend_alpha[src[2] >> 24], blend_alpha[src[3] >> 24] };
+            dst = blend_onto_opaque(dst, src, alpha);
+            __builtin_memcpy(state.dst + x, &dst, sizeof(dst));
         }
+#endif
+        for (; x < state.column_count; ++x)
+            state.dst[x] = blend_pixel(state.dst[x], state.src[x]);
         state.dst += state.dst_pitch;
         state.src += state.src_pitch;
     }
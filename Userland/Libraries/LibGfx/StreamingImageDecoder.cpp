@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <LibGfx/StreamingImageDecoder.h>
+
+namespace Gfx {
+
+static constexpr size_t minimum_growth_between_updates = 16 * KiB;
+
+void StreamingImageDecoder::append(ReadonlyBytes bytes)
+{
+    VERIFY(!m_finished);
+    m_data.append(bytes.data(), bytes.size());
+}
+
+NonnullRefPtr<ImageDecoder> StreamingImageDecoder::finish()
+{
+    VERIFY(!m_finished);
+    m_finished = true;
+    m_decoder = nullptr;
+    return ImageDecoder::create(m_data.data(), m_data.size());
+}
+
+bool StreamingImageDecoder::should_update() const
+{
+    if (m_finished)
+        return false;
+    return m_data.size() - m_size_at_last_update >= max(minimum_growth_between_updates, m_size_at_last_update / 4);
+}
+
+bool StreamingImageDecoder::update()
+{
+    if (!should_update())
+        return false;
+    m_size_at_last_update = m_data.size();
+
+    // The decoder is picked based on the data at hand, but only looks at what partial_bitmap() gets after that.
+    if (!m_decoder)
+        m_decoder = ImageDecoder::create(m_data.data(), m_data.size());
+    auto partial_image = m_decoder->partial_bitmap(m_data.span());
+
+    // Don't replace what we have with something that shows less, e.g. if the new data turned out to be invalid.
+    if (!partial_image.image || partial_image.available_rows < m_partial_image.available_rows)
+        return false;
+
+    m_partial_image = move(partial_image);
+    return true;
+}
+
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/RefCounted.h>
+#include <AK/RefPtr.h>
+#include <AK/Span.h>
+#include <AK/Vector.h>
+#include <LibGfx/ImageDecoder.h>
+
+namespace Gfx {
+
+// Decodes an image while its data is still arriving, for showing partial images early.
+// The decoder keeps its state between updates, so each one only decodes the data that is new. Since every
+// update produces a whole new partial image, they only happen once the data has grown by a good fraction
+// since the last one, which keeps the total amount of work linear in the size of the image.
+class StreamingImageDecoder : public RefCounted<StreamingImageDecoder> {
+public:
+    static NonnullRefPtr<StreamingImageDecoder> create() { return adopt(*new StreamingImageDecoder); }
+
+    void append(ReadonlyBytes);
+
+    // Returns a decoder for all of the data, once it has been received. The decoder refers to data(),
+    // so this must be kept alive for as long as it's used.
+    NonnullRefPtr<ImageDecoder> finish();
+
+    bool is_finished() const { return m_finished; }
+    ReadonlyBytes data() const { return m_data.span(); }
+
+    // Decodes the data received since the last time, if enough has arrived.
+    // Returns whether partial_image() has changed.
+    bool update();
+
+    const PartialImageDescriptor& partial_image() const { return m_partial_image; }
+
+private:
+    StreamingImageDecoder() { }
+
+    bool should_update() const;
+
+    Vector<u8> m_data;
+    size_t m_size_at_last_update { 0 };
+    bool m_finished { false };
+    RefPtr<ImageDecoder> m_decoder;
+    PartialImageDescriptor m_partial_image;
+};
+
+}
+
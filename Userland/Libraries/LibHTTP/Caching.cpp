@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <AK/Time.h>
+#include <LibHTTP/Caching.h>
+#include <ctype.h>
+
+namespace HTTP {
+
+static Optional<unsigned> parse_month(const StringView& name)
+{
+    static constexpr const char* month_names[] = { "jan", "feb", "mar", "apr", "may", "jun", "jul", "aug", "sep", "oct", "nov", "dec" };
+    for (unsigned i = 0; i < 12; ++i) {
+        if (name.equals_ignoring_case(month_names[i]))
+            return i + 1;
+    }
+    return {};
+}
+
+Optional<time_t> parse_http_date(const StringView& date_string)
+{
+    unsigned year = 0;
+    unsigned month = 0;
+    unsigned day = 0;
+    unsigned hour = 0;
+    unsigned minute = 0;
+    unsigned second = 0;
+    bool found_year = false;
+    bool found_day = false;
+    bool found_time = false;
+
+    auto parse_token = [&](const StringView& token) {
+        if (token.contains(':')) {
+            auto parts = token.split_view(':', true);
+            if (parts.size() != 3)
+                return false;
+            auto hour_part = parts[0].to_uint();
+            auto minute_part = parts[1].to_uint();
+            auto second_part = parts[2].to_uint();
+            if (!hour_part.has_value() || !minute_part.has_value() || !second_part.has_value())
+                return false;
+            hour = hour_part.value();
+            minute = minute_part.value();
+            second = second_part.value();
+            found_time = true;
+            return true;
+        }
+        if (isalpha(token[0])) {
+            // The day of the week and "GMT" don't tell us anything we need.
+            if (!month)
+                month = parse_month(token).value_or(0);
+            return true;
+        }
+        auto number = token.to_uint();
+        if (!number.has_value())
+            return false;
+        if (token.length() == 4 || found_day) {
+            year = number.value();
+            found_year = true;
+        } else {
+            day = number.value();
+            found_day = true;
+        }
+        return true;
+    };
+
+    auto tokens = date_string.split_view_if([](char ch) { return ch == ' ' || ch == ',' || ch == '-'; });
+    for (auto& token : tokens) {
+        if (!parse_token(token))
+            return {};
+    }
+
+    if (!found_year || !month || !found_day || !found_time)
+        return {};
+
+    // The obsolete RFC 850 format only has two digits for the year.
+    if (year < 70)
+        year += 2000;
+    else if (year < 100)
+        year += 1900;
+
+    if (year < 1900 || day < 1 || day > (unsigned)days_in_month(year, month) || hour > 23 || minute > 59 || second > 60)
+        return {};
+
+    time_t days = years_to_days_since_epoch(year) + day_of_year(year, month, day);
+    return ((days * 24 + hour) * 60 + minute) * 60 + second;
+}
+
+CacheControl CacheControl::from_headers(const HashMap<String, String, CaseInsensitiveStringTraits>& headers)
+{
+    CacheControl cache_control;
+
+    auto header = headers.get("Cache-Control");
+    if (!header.has_value()) {
+        // https://tools.ietf.org/html/rfc7234#section-5.4
+        if (auto pragma = headers.get("Pragma"); pragma.has_value()) {
+            for (auto& directive : pragma.value().split_view(',')) {
+                if (directive.trim_whitespace().equals_ignoring_case("no-cache"))
+                    cache_control.no_cache = true;
+            }
+        }
+        return cache_control;
+    }
+
+    // must-revalidate only forbids serving a response once it has gone stale. It doesn't shorten
+    // its freshness lifetime, and stale responses are always revalidated anyway.
+    for (auto& part : header.value().split_view(',')) {
+        auto directive = part.trim_whitespace();
+        if (directive.equals_ignoring_case("no-store")) {
+            cache_control.no_store = true;
+        } else if (directive.starts_with("no-cache", CaseSensitivity::CaseInsensitive)) {
+            // This includes the field-specific form (no-cache="Set-Cookie"), which we don't distinguish.
+            cache_control.no_cache = true;
+        } else if (directive.equals_ignoring_case("private") || directive.starts_with("private=", CaseSensitivity::CaseInsensitive)) {
+            cache_control.is_private = true;
+        } else if (directive.starts_with("max-age=", CaseSensitivity::CaseInsensitive)) {
+            auto max_age = directive.substring_view(8).to_uint();
+            if (max_age.has_value())
+                cache_control.max_age = max_age.value();
+        } else if (directive.starts_with("s-maxage=", CaseSensitivity::CaseInsensitive)) {
+            auto shared_max_age = directive.substring_view(9).to_uint();
+            if (shared_max_age.has_value())
+                cache_control.shared_max_age = shared_max_age.value();
+        }
+    }
+    return cache_control;
+}
+
+static Optional<time_t> date_header(const HashMap<String, String, CaseInsensitiveStringTraits>& headers, const StringView& name)
+{
+    auto header = headers.get(name);
+    if (!header.has_value())
+        return {};
+    return parse_http_date(header.value());
+}
+
+static time_t freshness_lifetime(const HashMap<String, String, CaseInsensitiveStringTraits>& headers, const CacheControl& cache_control, CacheType cache_type, time_t date)
+{
+    // https://tools.ietf.org/html/rfc7234#section-4.2.1
+    if (cache_type == CacheType::Shared && cache_control.shared_max_age.has_value())
+        return cache_control.shared_max_age.value();
+    if (cache_control.max_age.has_value())
+        return cache_control.max_age.value();
+
+    if (auto expires = headers.get("Expires"); expires.has_value()) {
+        // Invalid dates, such as "0", mean the response has already expired.
+        auto expiry_time = parse_http_date(expires.value());
+        if (!expiry_time.has_value())
+            return 0;
+        return max<time_t>(expiry_time.value() - date, 0);
+    }
+
+    // https://tools.ietf.org/html/rfc7234#section-4.2.2
+    // Without an explicit expiration time, only responses that say when they were last modified get a
+    // heuristic lifetime: a tenth of the time since then, as is common practice.
+    if (auto last_modified = date_header(headers, "Last-Modified"); last_modified.has_value())
+        return clamp<time_t>((date - last_modified.value()) / 10, 0, max_heuristic_freshness_lifetime);
+
+    return 0;
+}
+
+time_t current_age(const HashMap<String, String, CaseInsensitiveStringTraits>& headers, time_t response_time, time_t now)
+{
+    // https://tools.ietf.org/html/rfc7234#section-4.2.3
+    auto date = date_header(headers, "Date").value_or(response_time);
+    time_t age = max<time_t>(response_time - date, 0);
+    if (auto age_header = headers.get("Age"); age_header.has_value()) {
+        if (auto age_value = age_header.value().to_uint(); age_value.has_value())
+            age = max<time_t>(age, age_value.value());
+    }
+    return age + max<time_t>(now - response_time, 0);
+}
+
+time_t fresh_until(const HashMap<String, String, CaseInsensitiveStringTraits>& headers, time_t response_time, CacheType cache_type)
+{
+    auto cache_control = CacheControl::from_headers(headers);
+    if (cache_control.no_cache)
+        return response_time;
+
+    auto date = date_header(headers, "Date").value_or(response_time);
+    return response_time + freshness_lifetime(headers, cache_control, cache_type, date) - current_age(headers, response_time, response_time);
+}
+
+}
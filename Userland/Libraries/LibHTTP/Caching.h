@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <time.h>
+
+namespace HTTP {
+
+// Parses an HTTP-date (https://tools.ietf.org/html/rfc7231#section-7.1.1.1) into seconds since the epoch.
+// All three formats are accepted: "Sun, 06 Nov 1994 08:49:37 GMT", "Sunday, 06-Nov-94 08:49:37 GMT"
+// and "Sun Nov  6 08:49:37 1994".
+Optional<time_t> parse_http_date(const StringView&);
+
+struct CacheControl {
+    bool no_store { false };
+    bool no_cache { false };
+    bool is_private { false };
+    Optional<time_t> max_age;
+    Optional<time_t> shared_max_age;
+
+    // Reads the Cache-Control header, falling back to "Pragma: no-cache" when there is none.
+    static CacheControl from_headers(const HashMap<String, String, CaseInsensitiveStringTraits>&);
+};
+
+// The longest a response with a Last-Modified but no explicit expiration time is considered fresh.
+constexpr time_t max_heuristic_freshness_lifetime = 24 * 60 * 60;
+
+// A shared cache serves more than one user, so it has to honor s-maxage.
+enum class CacheType {
+    Private,
+    Shared,
+};
+
+// Returns the time at which a response received at response_time becomes stale, following
+// https://tools.ietf.org/html/rfc7234#section-4.2. Responses that have to be revalidated before
+// they can be reused (no-cache, an expired or invalid Expires, no expiration time or Last-Modified)
+// are stale as soon as they arrive, so this returns response_time or earlier for them.
+time_t fresh_until(const HashMap<String, String, CaseInsensitiveStringTraits>& headers, time_t response_time, CacheType = CacheType::Private);
+
+// Returns how old a response received at response_time is at the given time. A cache that hands out a
+// stored response reports this in its Age header, so the next cache along doesn't think it's brand new.
+time_t current_age(const HashMap<String, String, CaseInsensitiveStringTraits>& headers, time_t response_time, time_t now);
+
+}
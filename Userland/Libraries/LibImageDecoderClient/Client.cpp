@@ -46,8 +46,26 @@ void Client::handshake()
     send_sync<Messages::ImageDecoderServer::Greet>();
 }
 
-void Client::handle(const Messages::ImageDecoderClient::Dummy&)
+void Client::handle(const Messages::ImageDecoderClient::DidDecodePartialImage& message)
 {
+    auto it = m_partial_image_callbacks.find(message.stream_id());
+    if (it == m_partial_image_callbacks.end() || !message.bitmap().is_valid())
+        return;
+    it->value({ message.bitmap().bitmap(), message.available_rows() });
+}
+
+static DecodedImage decoded_image(bool is_animated, u32 loop_count, const Vector<Gfx::ShareableBitmap>& bitmaps, const Vector<u32>& durations)
+{
+    DecodedImage image;
+    image.is_animated = is_animated;
+    image.loop_count = loop_count;
+    image.frames.resize(bitmaps.size());
+    for (size_t i = 0; i < image.frames.size(); ++i) {
+        auto& frame = image.frames[i];
+        frame.bitmap = bitmaps[i].bitmap();
+        frame.duration = durations[i];
+    }
+    return image;
 }
 
 Optional<DecodedImage> Client::decode_image(const ByteBuffer& encoded_data)
@@ -69,16 +87,53 @@ Optional<DecodedImage> Client::decode_image(const ByteBuffer& encoded_data)
         return {};
     }
 
-    DecodedImage image;
-    image.is_animated = response->is_animated();
-    image.loop_count = response->loop_count();
-    image.frames.resize(response->bitmaps().size());
-    for (size_t i = 0; i < image.frames.size(); ++i) {
-        auto& frame = image.frames[i];
-        frame.bitmap = response->bitmaps()[i].bitmap();
-        frame.duration = response->durations()[i];
+    return decoded_image(response->is_animated(), response->loop_count(), response->bitmaps(), response->durations());
+}
+
+i32 Client::start_streaming_decode(Function<void(const PartialImage&)> on_partial_image)
+{
+    // The ids are unique across clients, so that nothing can end a stream of a restarted decoder that isn't its own.
+    static i32 s_next_stream_id = 0;
+    auto stream_id = s_next_stream_id++;
+    m_partial_image_callbacks.set(stream_id, move(on_partial_image));
+    return stream_id;
+}
+
+void Client::append_streaming_data(i32 stream_id, ReadonlyBytes data)
+{
+    if (data.is_empty())
+        return;
+
+    auto encoded_buffer = Core::AnonymousBuffer::create_with_size(data.size());
+    if (!encoded_buffer.is_valid()) {
+        dbgln("Could not allocate encoded buffer");
+        return;
     }
-    return image;
+
+    memcpy(encoded_buffer.data<void>(), data.data(), data.size());
+    post_message(Messages::ImageDecoderServer::AppendStreamingData(stream_id, move(encoded_buffer)));
+}
+
+Optional<DecodedImage> Client::finish_streaming_decode(i32 stream_id)
+{
+    m_partial_image_callbacks.remove(stream_id);
+    auto response = send_sync_but_allow_failure<Messages::ImageDecoderServer::FinishStreamingDecode>(stream_id);
+
+    if (!response) {
+        dbgln("ImageDecoder died heroically");
+        return {};
+    }
+
+    if (!response->success())
+        return {};
+
+    return decoded_image(response->is_animated(), response->loop_count(), response->bitmaps(), response->durations());
+}
+
+void Client::end_streaming_decode(i32 stream_id)
+{
+    m_partial_image_callbacks.remove(stream_id);
+    post_message(Messages::ImageDecoderServer::EndStreamingDecode(stream_id));
 }
 
 }
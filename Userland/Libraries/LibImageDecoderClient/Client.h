@@ -44,6 +44,11 @@ struct DecodedImage {
     Vector<Frame> frames;
 };
 
+struct PartialImage {
+    RefPtr<Gfx::Bitmap> bitmap;
+    int available_rows { 0 };
+};
+
 class Client final
     : public IPC::ServerConnection<ImageDecoderClientEndpoint, ImageDecoderServerEndpoint>
     , public ImageDecoderClientEndpoint {
@@ -54,6 +59,14 @@ public:
 
     Optional<DecodedImage> decode_image(const ByteBuffer&);
 
+    // Decodes an image while it is still being received. on_partial_image is called whenever enough of the data
+    // passed to append_streaming_data() has arrived to show more of it. finish_streaming_decode() decodes the image
+    // from all of that data once it's complete, and end_streaming_decode() gives up on it.
+    i32 start_streaming_decode(Function<void(const PartialImage&)> on_partial_image);
+    void append_streaming_data(i32 stream_id, ReadonlyBytes);
+    Optional<DecodedImage> finish_streaming_decode(i32 stream_id);
+    void end_streaming_decode(i32 stream_id);
+
     Function<void()> on_death;
 
 private:
@@ -61,7 +74,9 @@ private:
 
     virtual void die() override;
 
-    virtual void handle(const Messages::ImageDecoderClient::Dummy&) override;
+    virtual void handle(const Messages::ImageDecoderClient::DidDecodePartialImage&) override;
+
+    HashMap<i32, Function<void(const PartialImage&)>> m_partial_image_callbacks;
 };
 
 }
@@ -25,6 +25,7 @@
  */
 
 #include <AK/Badge.h>
+#include <AK/Debug.h>
 #include <LibJS/Heap/Allocator.h>
 #include <LibJS/Heap/HeapBlock.h>
 
@@ -41,7 +42,15 @@ Allocator::~Allocator()
 
 Cell* Allocator::allocate_cell(Heap& heap)
 {
-    if (m_usable_blocks.is_empty()) {
+    while (m_usable_blocks.is_empty()) {
+        if (!m_empty_blocks.is_empty()) {
+            m_usable_blocks.append(*m_empty_blocks.first());
+            continue;
+        }
+        if (!m_unswept_blocks.is_empty()) {
+            sweep_next_block();
+            continue;
+        }
         auto block = HeapBlock::create_with_cell_size(heap, m_cell_size);
         m_usable_blocks.append(*block.leak_ptr());
     }
@@ -54,16 +63,55 @@ Cell* Allocator::allocate_cell(Heap& heap)
     return cell;
 }
 
-void Allocator::block_did_become_empty(Badge<Heap>, HeapBlock& block)
+void Allocator::begin_lazy_sweep(Badge<Heap>)
 {
-    block.m_list_node.remove();
-    delete &block;
+    VERIFY(m_unswept_blocks.is_empty());
+    while (!m_full_blocks.is_empty())
+        m_unswept_blocks.append(*m_full_blocks.first());
+    while (!m_usable_blocks.is_empty())
+        m_unswept_blocks.append(*m_usable_blocks.first());
 }
 
-void Allocator::block_did_become_usable(Badge<Heap>, HeapBlock& block)
+void Allocator::finish_sweeping(Badge<Heap>, SweepStatistics* statistics)
 {
-    VERIFY(!block.is_full());
-    m_usable_blocks.append(block);
+    while (!m_unswept_blocks.is_empty())
+        sweep_next_block(statistics);
+}
+
+void Allocator::sweep_next_block(SweepStatistics* statistics)
+{
+    auto& block = *m_unswept_blocks.first();
+    auto result = block.sweep();
+    if (statistics) {
+        statistics->live_cells += result.live_cells;
+        statistics->collected_cells += result.collected_cells;
+    }
+
+    if (result.live_cells == 0) {
+        dbgln_if(HEAP_DEBUG, " - HeapBlock empty @ {}: cell_size={}", &block, block.cell_size());
+        m_empty_blocks.append(block);
+    } else if (block.is_full()) {
+        m_full_blocks.append(block);
+    } else {
+        dbgln_if(HEAP_DEBUG, " - HeapBlock usable @ {}: cell_size={}", &block, block.cell_size());
+        m_usable_blocks.append(block);
+    }
+
+    // Empty blocks are handed back in one go once the sweep is done, since we might still
+    // want to allocate from them while we're sweeping.
+    if (m_unswept_blocks.is_empty())
+        release_empty_blocks(statistics);
+}
+
+void Allocator::release_empty_blocks(SweepStatistics* statistics)
+{
+    while (!m_empty_blocks.is_empty()) {
+        auto& block = *m_empty_blocks.first();
+        block.m_list_node.remove();
+        delete &block;
+        if (statistics)
+            ++statistics->freed_blocks;
+    }
 }
 
 }
@@ -46,26 +46,44 @@ public:
     template<typename Callback>
     IterationDecision for_each_block(Callback callback)
     {
-        for (auto& block : m_full_blocks) {
-            if (callback(block) == IterationDecision::Break)
-                return IterationDecision::Break;
-        }
-        for (auto& block : m_usable_blocks) {
-            if (callback(block) == IterationDecision::Break)
-                return IterationDecision::Break;
-        }
-        return IterationDecision::Continue;
+        auto for_each_block_in_list = [&](auto& list) {
+            for (auto& block : list) {
+                if (callback(block) == IterationDecision::Break)
+                    return IterationDecision::Break;
+            }
+            return IterationDecision::Continue;
+        };
+        if (for_each_block_in_list(m_full_blocks) == IterationDecision::Break)
+            return IterationDecision::Break;
+        if (for_each_block_in_list(m_usable_blocks) == IterationDecision::Break)
+            return IterationDecision::Break;
+        if (for_each_block_in_list(m_unswept_blocks) == IterationDecision::Break)
+            return IterationDecision::Break;
+        return for_each_block_in_list(m_empty_blocks);
     }
 
-    void block_did_become_empty(Badge<Heap>, HeapBlock&);
-    void block_did_become_usable(Badge<Heap>, HeapBlock&);
+    struct SweepStatistics {
+        size_t live_cells { 0 };
+        size_t collected_cells { 0 };
+        size_t freed_blocks { 0 };
+    };
+
+    // After marking, all blocks are queued up for sweeping. They are then swept one at a time
+    // whenever allocate_cell() runs out of usable blocks, or all at once by finish_sweeping().
+    void begin_lazy_sweep(Badge<Heap>);
+    void finish_sweeping(Badge<Heap>, SweepStatistics* = nullptr);
 
 private:
+    void sweep_next_block(SweepStatistics* = nullptr);
+    void release_empty_blocks(SweepStatistics* = nullptr);
+
     const size_t m_cell_size;
 
     typedef IntrusiveList<HeapBlock, RawPtr<HeapBlock>, &HeapBlock::m_list_node> BlockList;
     BlockList m_full_blocks;
     BlockList m_usable_blocks;
+    BlockList m_unswept_blocks;
+    BlockList m_empty_blocks;
 };
 
 }
@@ -25,6 +25,7 @@
  */
 
 #include <AK/Badge.h>
+#include <AK/Atomic.h>
 #include <AK/Debug.h>
 #include <AK/HashTable.h>
 #include <AK/StackInfo.h>
@@ -36,7 +37,9 @@
 #include <LibJS/Heap/HeapBlock.h>
 #include <LibJS/Interpreter.h>
 #include <LibJS/Runtime/Object.h>
+#include <pthread.h>
 #include <setjmp.h>
+#include <unistd.h>
 
 namespace JS {
 
@@ -94,11 +97,23 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
             m_should_gc_when_deferral_ends = true;
             return;
         }
+        // Dead cells from the previous collection may still be waiting to be swept lazily.
+        // They have to be gone before we mark, so the conservative scan can't resurrect them.
+        finish_sweeping();
         HashTable<Cell*> roots;
         gather_roots(roots);
         mark_live_cells(roots);
+    } else {
+        finish_sweeping();
     }
-    sweep_dead_cells(print_report, collection_measurement_timer);
+    bool sweep_eagerly = print_report || collection_type == CollectionType::CollectEverything;
+    sweep_dead_cells(sweep_eagerly, print_report, collection_measurement_timer);
+}
+
+void Heap::finish_sweeping()
+{
+    for (auto& allocator : m_allocators)
+        allocator->finish_sweeping({});
 }
 
 void Heap::gather_roots(HashTable<Cell*>& roots)
@@ -171,72 +186,205 @@ __attribute__((no_sanitize("address"))) void Heap::gather_conservative_roots(Has
     }
 }
 
+// Work distribution for marking with helper threads. Each marker works off its own stack, and only
+// takes the lock when it runs dry or when it notices that another marker is starving.
+struct SharedMarkingWork {
+    SharedMarkingWork(size_t marker_count)
+        : marker_count(marker_count)
+    {
+        pthread_mutex_init(&mutex, nullptr);
+        pthread_cond_init(&condition, nullptr);
+    }
+
+    ~SharedMarkingWork()
+    {
+        pthread_cond_destroy(&condition);
+        pthread_mutex_destroy(&mutex);
+    }
+
+    pthread_mutex_t mutex;
+    pthread_cond_t condition;
+    Vector<Cell*> cells;
+    const size_t marker_count;
+    Atomic<size_t> idle_markers { 0 };
+    bool done { false };
+};
+
 class MarkingVisitor final : public Cell::Visitor {
 public:
-    MarkingVisitor() { }
+    explicit MarkingVisitor(SharedMarkingWork* shared_work = nullptr)
+        : m_shared_work(shared_work)
+    {
+    }
 
     virtual void visit_impl(Cell* cell)
     {
-        if (cell->is_marked())
-            return;
+        if (m_shared_work) {
+            if (!cell->try_set_marked())
+                return;
+        } else {
+            if (cell->is_marked())
+                return;
+            cell->set_marked(true);
+        }
         dbgln_if(HEAP_DEBUG, "  ! {}", cell);
-        cell->set_marked(true);
-        cell->visit_edges(*this);
+        m_work.append(cell);
+    }
+
+    void mark_until_done()
+    {
+        for (;;) {
+            while (!m_work.is_empty()) {
+                m_work.take_last()->visit_edges(*this);
+                if (m_shared_work)
+                    share_work_if_needed();
+            }
+            if (!m_shared_work || !take_shared_work())
+                return;
+        }
+    }
+
+    void share_all_work()
+    {
+        VERIFY(m_shared_work);
+        pthread_mutex_lock(&m_shared_work->mutex);
+        m_shared_work->cells.append(move(m_work));
+        pthread_mutex_unlock(&m_shared_work->mutex);
+        m_work.clear();
+    }
+
+private:
+    static constexpr size_t min_work_to_share = 64;
+    static constexpr size_t max_work_to_take = 256;
+
+    void share_work_if_needed()
+    {
+        if (m_work.size() < min_work_to_share || m_shared_work->idle_markers.load(AK::memory_order_relaxed) == 0)
+            return;
+        auto count = m_work.size() / 2;
+        pthread_mutex_lock(&m_shared_work->mutex);
+        m_shared_work->cells.append(m_work.data(), count);
+        pthread_cond_broadcast(&m_shared_work->condition);
+        pthread_mutex_unlock(&m_shared_work->mutex);
+        m_work.remove(0, count);
+    }
+
+    bool take_shared_work()
+    {
+        auto& shared_work = *m_shared_work;
+        pthread_mutex_lock(&shared_work.mutex);
+        for (;;) {
+            if (!shared_work.cells.is_empty()) {
+                auto count = min(shared_work.cells.size(), max_work_to_take);
+                auto remaining = shared_work.cells.size() - count;
+                m_work.append(shared_work.cells.data() + remaining, count);
+                shared_work.cells.shrink(remaining, true);
+                pthread_mutex_unlock(&shared_work.mutex);
+                return true;
+            }
+            if (shared_work.done)
+                break;
+            if (shared_work.idle_markers + 1 == shared_work.marker_count) {
+                // Everyone else is waiting for work, and there's none left. We're done!
+                shared_work.done = true;
+                pthread_cond_broadcast(&shared_work.condition);
+                break;
+            }
+            ++shared_work.idle_markers;
+            pthread_cond_wait(&shared_work.condition, &shared_work.mutex);
+            --shared_work.idle_markers;
+        }
+        pthread_mutex_unlock(&shared_work.mutex);
+        return false;
     }
+
+    Vector<Cell*> m_work;
+    SharedMarkingWork* m_shared_work { nullptr };
 };
 
+size_t Heap::marking_helper_thread_count()
+{
+    // Helper threads only pay for themselves once there's a decent amount of heap to trace.
+    static constexpr size_t min_blocks_for_helper_threads = 256;
+    static constexpr size_t max_helper_threads = 3;
+
+    static size_t s_available_helper_threads = [] {
+        auto processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+        return processor_count > 1 ? min(static_cast<size_t>(processor_count - 1), max_helper_threads) : 0;
+    }();
+
+    if (!s_available_helper_threads)
+        return 0;
+
+    size_t block_count = 0;
+    for_each_block([&](auto&) {
+        ++block_count;
+        return IterationDecision::Continue;
+    });
+    return block_count >= min_blocks_for_helper_threads ? s_available_helper_threads : 0;
+}
+
 void Heap::mark_live_cells(const HashTable<Cell*>& roots)
 {
     dbgln_if(HEAP_DEBUG, "mark_live_cells:");
-    MarkingVisitor visitor;
+
+    auto helper_thread_count = marking_helper_thread_count();
+    if (!helper_thread_count) {
+        MarkingVisitor visitor;
+        for (auto* root : roots)
+            visitor.visit(root);
+        visitor.mark_until_done();
+        return;
+    }
+
+    SharedMarkingWork shared_work(helper_thread_count + 1);
+
+    MarkingVisitor visitor(&shared_work);
     for (auto* root : roots)
         visitor.visit(root);
+    visitor.share_all_work();
+
+    Vector<pthread_t, 4> helper_threads;
+    for (size_t i = 0; i < helper_thread_count; ++i) {
+        pthread_t thread;
+        int rc = pthread_create(
+            &thread, nullptr, [](void* shared_work) -> void* {
+                MarkingVisitor helper_visitor(static_cast<SharedMarkingWork*>(shared_work));
+                helper_visitor.mark_until_done();
+                return nullptr;
+            },
+            &shared_work);
+        VERIFY(rc == 0);
+        helper_threads.append(thread);
+    }
+
+    visitor.mark_until_done();
+
+    for (auto thread : helper_threads)
+        pthread_join(thread, nullptr);
 }
 
-void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measurement_timer)
+void Heap::sweep_dead_cells(bool sweep_eagerly, bool print_report, const Core::ElapsedTimer& measurement_timer)
 {
     dbgln_if(HEAP_DEBUG, "sweep_dead_cells:");
-    Vector<HeapBlock*, 32> empty_blocks;
-    Vector<HeapBlock*, 32> full_blocks_that_became_usable;
-
-    size_t collected_cells = 0;
-    size_t live_cells = 0;
-    size_t collected_cell_bytes = 0;
-    size_t live_cell_bytes = 0;
 
-    for_each_block([&](auto& block) {
-        bool block_has_live_cells = false;
-        bool block_was_full = block.is_full();
-        block.for_each_cell([&](Cell* cell) {
-            if (cell->is_live()) {
-                if (!cell->is_marked()) {
-                    dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
-                    block.deallocate(cell);
-                    ++collected_cells;
-                    collected_cell_bytes += block.cell_size();
-                } else {
-                    cell->set_marked(false);
-                    block_has_live_cells = true;
-                    ++live_cells;
-                    live_cell_bytes += block.cell_size();
-                }
-            }
-        });
-        if (!block_has_live_cells)
-            empty_blocks.append(&block);
-        else if (block_was_full != block.is_full())
-            full_blocks_that_became_usable.append(&block);
-        return IterationDecision::Continue;
-    });
+    for (auto& allocator : m_allocators)
+        allocator->begin_lazy_sweep({});
 
-    for (auto* block : empty_blocks) {
-        dbgln_if(HEAP_DEBUG, " - HeapBlock empty @ {}: cell_size={}", block, block->cell_size());
-        allocator_for_size(block->cell_size()).block_did_become_empty({}, *block);
-    }
+    if (!sweep_eagerly)
+        return;
 
-    for (auto* block : full_blocks_that_became_usable) {
-        dbgln_if(HEAP_DEBUG, " - HeapBlock usable again @ {}: cell_size={}", block, block->cell_size());
-        allocator_for_size(block->cell_size()).block_did_become_usable({}, *block);
+    Allocator::SweepStatistics statistics;
+    size_t live_cell_bytes = 0;
+    size_t collected_cell_bytes = 0;
+    for (auto& allocator : m_allocators) {
+        Allocator::SweepStatistics allocator_statistics;
+        allocator->finish_sweeping({}, &allocator_statistics);
+        statistics.live_cells += allocator_statistics.live_cells;
+        statistics.collected_cells += allocator_statistics.collected_cells;
+        statistics.freed_blocks += allocator_statistics.freed_blocks;
+        live_cell_bytes += allocator_statistics.live_cells * allocator->cell_size();
+        collected_cell_bytes += allocator_statistics.collected_cells * allocator->cell_size();
     }
 
     if constexpr (HEAP_DEBUG) {
@@ -258,10 +406,10 @@ void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measure
         dbgln("Garbage collection report");
         dbgln("=============================================");
         dbgln("     Time spent: {} ms", time_spent);
-        dbgln("     Live cells: {} ({} bytes)", live_cells, live_cell_bytes);
-        dbgln("Collected cells: {} ({} bytes)", collected_cells, collected_cell_bytes);
+        dbgln("     Live cells: {} ({} bytes)", statistics.live_cells, live_cell_bytes);
+        dbgln("Collected cells: {} ({} bytes)", statistics.collected_cells, collected_cell_bytes);
         dbgln("    Live blocks: {} ({} bytes)", live_block_count, live_block_count * HeapBlock::block_size);
-        dbgln("   Freed blocks: {} ({} bytes)", empty_blocks.size(), empty_blocks.size() * HeapBlock::block_size);
+        dbgln("   Freed blocks: {} ({} bytes)", statistics.freed_blocks, statistics.freed_blocks * HeapBlock::block_size);
         dbgln("=============================================");
     }
 }
@@ -98,7 +98,10 @@ private:
     void gather_roots(HashTable<Cell*>&);
     void gather_conservative_roots(HashTable<Cell*>&);
     void mark_live_cells(const HashTable<Cell*>& live_cells);
-    void sweep_dead_cells(bool print_report, const Core::ElapsedTimer&);
+    void sweep_dead_cells(bool sweep_eagerly, bool print_report, const Core::ElapsedTimer&);
+    void finish_sweeping();
+
+    size_t marking_helper_thread_count();
 
     Allocator& allocator_for_size(size_t);
 
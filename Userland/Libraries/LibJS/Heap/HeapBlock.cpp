@@ -25,6 +25,7 @@
  */
 
 #include <AK/Assertions.h>
+#include <AK/Debug.h>
 #include <AK/NonnullOwnPtr.h>
 #include <LibJS/Heap/HeapBlock.h>
 #include <stdio.h>
@@ -85,4 +86,22 @@ void HeapBlock::deallocate(Cell* cell)
     m_freelist = freelist_entry;
 }
 
+HeapBlock::SweepResult HeapBlock::sweep()
+{
+    SweepResult result;
+    for_each_cell([&](Cell* cell) {
+        if (!cell->is_live())
+            return;
+        if (!cell->is_marked()) {
+            dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
+            deallocate(cell);
+            ++result.collected_cells;
+        } else {
+            cell->set_marked(false);
+            ++result.live_cells;
+        }
+    });
+    return result;
+}
+
 }
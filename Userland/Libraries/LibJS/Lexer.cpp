@@ -345,6 +345,11 @@ bool Lexer::is_numeric_literal_start() const
     return isdigit(m_current_char) || (m_current_char == '.' && m_position < m_source.length() && isdigit(m_source[m_position]));
 }
 
+void Lexer::set_previous_token_type(TokenType type)
+{
+    m_current_token = Token(type, {}, StringView(nullptr), StringView(nullptr), m_filename, 0, 0);
+}
+
 bool Lexer::slash_means_division() const
 {
     auto type = m_current_token.type();
@@ -378,9 +383,10 @@ Token Lexer::next()
                     consume();
                 } while (is_line_terminator());
             } else if (isspace(m_current_char)) {
+                // Leave line terminators to the branch above, so that "-->" at the start of the next line is a comment.
                 do {
                     consume();
-                } while (isspace(m_current_char));
+                } while (isspace(m_current_char) && !is_line_terminator());
             } else if (is_line_comment_start(line_has_token_yet)) {
                 consume();
                 do {
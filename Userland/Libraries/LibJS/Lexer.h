@@ -43,6 +43,11 @@ public:
     const StringView& source() const { return m_source; };
     const StringView& filename() const { return m_filename; };
 
+    // A lexer can pick up at the start of a line that isn't inside a token, a comment or a template literal.
+    // All it needs to know there is the type of the token before, which tells a regex from a division.
+    void set_previous_token_type(TokenType);
+    bool is_in_template_literal() const { return !m_template_states.is_empty(); }
+
 private:
     void consume();
     bool consume_exponent();
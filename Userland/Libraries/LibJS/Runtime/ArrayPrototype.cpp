@@ -108,6 +108,18 @@ static Function* callback_from_args(GlobalObject& global_object, const String& n
     return &callback.as_function();
 }
 
+// Reads an element straight out of an array's packed backing storage, skipping the generic property lookup.
+// Packed storage has no holes, so the prototype chain never needs to be consulted.
+static Optional<Value> packed_array_element(const Object& object, size_t index)
+{
+    if (!object.is_array())
+        return {};
+    auto* storage = object.indexed_properties().simple_storage();
+    if (!storage || !storage->is_packed() || index >= storage->array_like_size())
+        return {};
+    return storage->get(index).value().value;
+}
+
 static void for_each_item(VM& vm, GlobalObject& global_object, const String& name, AK::Function<IterationDecision(size_t index, Value value, Value callback_result)> callback, bool skip_empty = true)
 {
     auto* this_object = vm.this_value(global_object).to_object(global_object);
@@ -125,9 +137,14 @@ static void for_each_item(VM& vm, GlobalObject& global_object, const String& nam
     auto this_value = vm.argument(1);
 
     for (size_t i = 0; i < initial_length; ++i) {
-        auto value = this_object->get(i);
-        if (vm.exception())
-            return;
+        Value value;
+        if (auto element = packed_array_element(*this_object, i); element.has_value()) {
+            value = element.value();
+        } else {
+            value = this_object->get(i);
+            if (vm.exception())
+                return;
+        }
         if (value.is_empty()) {
             if (skip_empty)
                 continue;
@@ -171,13 +188,16 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::map)
     if (vm.exception())
         return {};
     auto* new_array = Array::create(global_object);
-    new_array->indexed_properties().set_array_like_size(initial_length);
+    // The new array isn't observable until we return it, so we can fill it in order and only set its final
+    // length afterwards. This keeps its storage packed (and unboxed, if the callback returns numbers).
     for_each_item(vm, global_object, "map", [&](auto index, auto, auto callback_result) {
         if (vm.exception())
             return IterationDecision::Break;
-        new_array->define_property(index, callback_result);
+        new_array->indexed_properties().put(new_array, index, callback_result, default_attributes, false);
         return IterationDecision::Continue;
     });
+    if (new_array->indexed_properties().array_like_size() < initial_length)
+        new_array->indexed_properties().set_array_like_size(initial_length);
     return Value(new_array);
 }
 
@@ -456,6 +476,32 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::index_of)
             from_index = max(length + from_index, 0);
     }
     auto search_element = vm.argument(0);
+
+    if (search_element.is_number() && this_object->is_array()) {
+        auto* storage = this_object->indexed_properties().simple_storage();
+        if (storage && storage->is_packed() && storage->array_like_size() >= static_cast<size_t>(length)) {
+            auto search_number = search_element.as_double();
+            if (storage->element_kind() == SimpleIndexedPropertyStorage::ElementKind::PackedInt32) {
+                if (search_number < NumericLimits<i32>::min() || search_number > NumericLimits<i32>::max() || static_cast<i32>(search_number) != search_number)
+                    return Value(-1);
+                auto search_int32 = static_cast<i32>(search_number);
+                auto& elements = storage->int32_elements();
+                for (i32 i = from_index; i < length; ++i) {
+                    if (elements[i] == search_int32)
+                        return Value(i);
+                }
+            } else {
+                // NaN never compares equal and +0 == -0, which is exactly what strict equality wants.
+                auto& elements = storage->double_elements();
+                for (i32 i = from_index; i < length; ++i) {
+                    if (elements[i] == search_number)
+                        return Value(i);
+                }
+            }
+            return Value(-1);
+        }
+    }
+
     for (i32 i = from_index; i < length; ++i) {
         auto element = this_object->get(i);
         if (vm.exception())
@@ -703,6 +749,67 @@ static void array_merge_sort(VM& vm, GlobalObject& global_object, Function* comp
     }
 }
 
+static size_t int32_to_decimal(i32 value, char* buffer)
+{
+    char digits[10];
+    size_t digit_count = 0;
+    u32 magnitude = value < 0 ? -static_cast<u32>(value) : static_cast<u32>(value);
+    do {
+        digits[digit_count++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude);
+
+    size_t length = 0;
+    if (value < 0)
+        buffer[length++] = '-';
+    while (digit_count)
+        buffer[length++] = digits[--digit_count];
+    return length;
+}
+
+// Compares two int32 values the way the default sort comparator would compare their string representations.
+static bool int32_less_than_as_strings(i32 a, i32 b)
+{
+    char a_buffer[11];
+    char b_buffer[11];
+    auto a_length = int32_to_decimal(a, a_buffer);
+    auto b_length = int32_to_decimal(b, b_buffer);
+    auto result = __builtin_memcmp(a_buffer, b_buffer, min(a_length, b_length));
+    if (result != 0)
+        return result < 0;
+    return a_length < b_length;
+}
+
+// Bottom-up merge sort, so arrays with lots of duplicates don't degrade like quick sort would.
+static void int32_merge_sort_as_strings(i32* elements, size_t count)
+{
+    if (count <= 1)
+        return;
+
+    Vector<i32> buffer;
+    buffer.resize(count);
+    i32* source = elements;
+    i32* destination = buffer.data();
+
+    for (size_t width = 1; width < count; width *= 2) {
+        for (size_t left = 0; left < count; left += 2 * width) {
+            size_t middle = min(left + width, count);
+            size_t right = min(left + 2 * width, count);
+            size_t i = left, j = middle, k = left;
+            while (i < middle && j < right)
+                destination[k++] = int32_less_than_as_strings(source[j], source[i]) ? source[j++] : source[i++];
+            while (i < middle)
+                destination[k++] = source[i++];
+            while (j < right)
+                destination[k++] = source[j++];
+        }
+        swap(source, destination);
+    }
+
+    if (source != elements)
+        __builtin_memcpy(elements, source, count * sizeof(i32));
+}
+
 JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::sort)
 {
     auto* array = vm.this_value(global_object).to_object(global_object);
@@ -719,12 +826,28 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::sort)
     if (vm.exception())
         return {};
 
+    if (callback.is_undefined() && array->is_array()) {
+        // Packed int32 elements can't have side effects when stringified, so we can sort the unboxed elements in place.
+        auto* storage = array->indexed_properties().simple_storage();
+        if (storage && storage->element_kind() == SimpleIndexedPropertyStorage::ElementKind::PackedInt32 && storage->array_like_size() == original_length) {
+            auto& elements = storage->int32_elements();
+            VERIFY(elements.size() >= original_length);
+            int32_merge_sort_as_strings(elements.data(), original_length);
+            return array;
+        }
+    }
+
     MarkedValueList values_to_sort(vm.heap());
 
     for (size_t i = 0; i < original_length; ++i) {
-        auto element_val = array->get(i);
-        if (vm.exception())
-            return {};
+        Value element_val;
+        if (auto element = packed_array_element(*array, i); element.has_value()) {
+            element_val = element.value();
+        } else {
+            element_val = array->get(i);
+            if (vm.exception())
+                return {};
+        }
 
         if (!element_val.is_empty())
             values_to_sort.append(element_val);
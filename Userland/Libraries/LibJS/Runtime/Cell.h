@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Format.h>
 #include <AK/Forward.h>
 #include <AK/Noncopyable.h>
@@ -46,6 +47,9 @@ public:
     bool is_marked() const { return m_mark; }
     void set_marked(bool b) { m_mark = b; }
 
+    // Used when marking with helper threads. Returns true if this call is the one that marked the cell.
+    bool try_set_marked() { return !AK::atomic_exchange(&m_mark, true, AK::memory_order_relaxed); }
+
     bool is_live() const { return m_live; }
     void set_live(bool b) { m_live = b; }
 
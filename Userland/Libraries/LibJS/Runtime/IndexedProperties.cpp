@@ -34,76 +34,270 @@ const u32 SPARSE_ARRAY_HOLE_THRESHOLD = 200;
 
 SimpleIndexedPropertyStorage::SimpleIndexedPropertyStorage(Vector<Value>&& initial_values)
     : m_array_size(initial_values.size())
-    , m_packed_elements(move(initial_values))
 {
+    bool all_int32 = true;
+    bool all_numbers = true;
+    for (auto& value : initial_values) {
+        all_int32 = all_int32 && value.type() == Value::Type::Int32;
+        all_numbers = all_numbers && value.is_number();
+    }
+
+    if (all_int32) {
+        m_element_kind = ElementKind::PackedInt32;
+        m_int32_elements.ensure_capacity(initial_values.size());
+        for (auto& value : initial_values)
+            m_int32_elements.unchecked_append(value.as_i32());
+    } else if (all_numbers) {
+        m_element_kind = ElementKind::PackedDouble;
+        m_double_elements.ensure_capacity(initial_values.size());
+        for (auto& value : initial_values)
+            m_double_elements.unchecked_append(value.as_double());
+    } else {
+        m_element_kind = ElementKind::Values;
+        m_packed_elements = move(initial_values);
+    }
+}
+
+size_t SimpleIndexedPropertyStorage::size() const
+{
+    switch (m_element_kind) {
+    case ElementKind::PackedInt32:
+        return m_int32_elements.size();
+    case ElementKind::PackedDouble:
+    case ElementKind::HoleyDouble:
+        return m_double_elements.size();
+    case ElementKind::Values:
+        return m_packed_elements.size();
+    }
+    VERIFY_NOT_REACHED();
 }
 
 bool SimpleIndexedPropertyStorage::has_index(u32 index) const
 {
-    return index < m_array_size && !m_packed_elements[index].is_empty();
+    if (index >= m_array_size)
+        return false;
+    switch (m_element_kind) {
+    case ElementKind::PackedInt32:
+    case ElementKind::PackedDouble:
+        return true;
+    case ElementKind::HoleyDouble:
+        return !is_hole(m_double_elements[index]);
+    case ElementKind::Values:
+        return !m_packed_elements[index].is_empty();
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Value SimpleIndexedPropertyStorage::element_at(size_t index) const
+{
+    switch (m_element_kind) {
+    case ElementKind::PackedInt32:
+        return Value(m_int32_elements[index]);
+    case ElementKind::PackedDouble:
+    case ElementKind::HoleyDouble: {
+        auto element = m_double_elements[index];
+        if (is_hole(element))
+            return {};
+        return Value(element);
+    }
+    case ElementKind::Values:
+        return m_packed_elements[index];
+    }
+    VERIFY_NOT_REACHED();
 }
 
 Optional<ValueAndAttributes> SimpleIndexedPropertyStorage::get(u32 index) const
 {
     if (index >= m_array_size)
         return {};
-    return ValueAndAttributes { m_packed_elements[index], default_attributes };
+    return ValueAndAttributes { element_at(index), default_attributes };
+}
+
+void SimpleIndexedPropertyStorage::resize_storage(size_t new_size)
+{
+    switch (m_element_kind) {
+    case ElementKind::PackedInt32:
+        m_int32_elements.resize(new_size);
+        break;
+    case ElementKind::PackedDouble:
+    case ElementKind::HoleyDouble: {
+        auto old_size = m_double_elements.size();
+        m_double_elements.resize(new_size);
+        for (size_t i = old_size; i < new_size; ++i)
+            m_double_elements[i] = hole();
+        break;
+    }
+    case ElementKind::Values:
+        m_packed_elements.resize(new_size);
+        break;
+    }
 }
 
 void SimpleIndexedPropertyStorage::grow_storage_if_needed()
 {
-    if (m_array_size <= m_packed_elements.size())
+    if (m_array_size <= size())
         return;
     // Grow storage by 25% at a time.
-    m_packed_elements.resize(m_array_size + (m_array_size / 4));
+    resize_storage(m_array_size + (m_array_size / 4));
+}
+
+void SimpleIndexedPropertyStorage::transition_to(ElementKind new_kind)
+{
+    if (new_kind == m_element_kind)
+        return;
+    VERIFY(new_kind > m_element_kind);
+
+    if (m_element_kind == ElementKind::PackedInt32) {
+        if (new_kind == ElementKind::Values) {
+            m_packed_elements.ensure_capacity(m_int32_elements.size());
+            for (size_t i = 0; i < m_int32_elements.size(); ++i)
+                m_packed_elements.unchecked_append(i < m_array_size ? Value(m_int32_elements[i]) : Value());
+        } else {
+            m_double_elements.ensure_capacity(m_int32_elements.size());
+            for (size_t i = 0; i < m_int32_elements.size(); ++i)
+                m_double_elements.unchecked_append(i < m_array_size ? static_cast<double>(m_int32_elements[i]) : hole());
+        }
+        m_int32_elements.clear();
+    } else if (new_kind == ElementKind::Values) {
+        m_packed_elements.ensure_capacity(m_double_elements.size());
+        for (size_t i = 0; i < m_double_elements.size(); ++i) {
+            auto element = m_double_elements[i];
+            m_packed_elements.unchecked_append(i < m_array_size && !is_hole(element) ? Value(element) : Value());
+        }
+        m_double_elements.clear();
+    }
+
+    m_element_kind = new_kind;
+}
+
+void SimpleIndexedPropertyStorage::make_holey()
+{
+    if (m_element_kind == ElementKind::PackedInt32 || m_element_kind == ElementKind::PackedDouble)
+        transition_to(ElementKind::HoleyDouble);
+}
+
+void SimpleIndexedPropertyStorage::ensure_element_kind_can_store(Value value)
+{
+    switch (m_element_kind) {
+    case ElementKind::PackedInt32:
+        if (value.type() == Value::Type::Int32)
+            return;
+        transition_to(value.is_number() ? ElementKind::PackedDouble : ElementKind::Values);
+        return;
+    case ElementKind::PackedDouble:
+    case ElementKind::HoleyDouble:
+        if (!value.is_number())
+            transition_to(ElementKind::Values);
+        return;
+    case ElementKind::Values:
+        return;
+    }
+}
+
+void SimpleIndexedPropertyStorage::store(size_t index, Value value)
+{
+    switch (m_element_kind) {
+    case ElementKind::PackedInt32:
+        m_int32_elements[index] = value.as_i32();
+        return;
+    case ElementKind::PackedDouble:
+    case ElementKind::HoleyDouble: {
+        auto number = value.as_double();
+        m_double_elements[index] = isnan(number) ? js_nan().as_double() : number;
+        return;
+    }
+    case ElementKind::Values:
+        m_packed_elements[index] = value;
+        return;
+    }
 }
 
 void SimpleIndexedPropertyStorage::put(u32 index, Value value, PropertyAttributes attributes)
 {
     VERIFY(attributes == default_attributes);
 
+    ensure_element_kind_can_store(value);
     if (index >= m_array_size) {
+        if (index > m_array_size)
+            make_holey();
         m_array_size = index + 1;
         grow_storage_if_needed();
     }
-    m_packed_elements[index] = value;
+    store(index, value);
 }
 
 void SimpleIndexedPropertyStorage::remove(u32 index)
 {
-    if (index < m_array_size)
+    if (index >= m_array_size)
+        return;
+    make_holey();
+    if (m_element_kind == ElementKind::Values)
         m_packed_elements[index] = {};
+    else
+        m_double_elements[index] = hole();
 }
 
 void SimpleIndexedPropertyStorage::insert(u32 index, Value value, PropertyAttributes attributes)
 {
     VERIFY(attributes == default_attributes);
+    ensure_element_kind_can_store(value);
     m_array_size++;
-    m_packed_elements.insert(index, value);
+    switch (m_element_kind) {
+    case ElementKind::PackedInt32:
+        m_int32_elements.insert(index, value.as_i32());
+        break;
+    case ElementKind::PackedDouble:
+    case ElementKind::HoleyDouble:
+        m_double_elements.insert(index, 0);
+        store(index, value);
+        break;
+    case ElementKind::Values:
+        m_packed_elements.insert(index, value);
+        break;
+    }
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_first()
 {
+    auto first_element = element_at(0);
     m_array_size--;
-    return { m_packed_elements.take_first(), default_attributes };
+    switch (m_element_kind) {
+    case ElementKind::PackedInt32:
+        m_int32_elements.take_first();
+        break;
+    case ElementKind::PackedDouble:
+    case ElementKind::HoleyDouble:
+        m_double_elements.take_first();
+        break;
+    case ElementKind::Values:
+        m_packed_elements.take_first();
+        break;
+    }
+    return { first_element, default_attributes };
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_last()
 {
     m_array_size--;
-    auto last_element = m_packed_elements[m_array_size];
-    m_packed_elements[m_array_size] = {};
+    auto last_element = element_at(m_array_size);
+    if (m_element_kind == ElementKind::Values)
+        m_packed_elements[m_array_size] = {};
+    else if (m_element_kind != ElementKind::PackedInt32)
+        m_double_elements[m_array_size] = hole();
     return { last_element, default_attributes };
 }
 
 void SimpleIndexedPropertyStorage::set_array_like_size(size_t new_size)
 {
+    if (new_size > m_array_size)
+        make_holey();
     m_array_size = new_size;
-    m_packed_elements.resize(new_size);
+    resize_storage(new_size);
 }
 
 GenericIndexedPropertyStorage::GenericIndexedPropertyStorage(SimpleIndexedPropertyStorage&& storage)
 {
+    storage.transition_to(SimpleIndexedPropertyStorage::ElementKind::Values);
     m_array_size = storage.array_like_size();
     for (size_t i = 0; i < storage.m_packed_elements.size(); ++i) {
         m_sparse_elements.set(i, { storage.m_packed_elements[i], default_attributes });
@@ -350,13 +544,11 @@ void IndexedProperties::set_array_like_size(size_t new_size)
 
 Vector<u32> IndexedProperties::indices() const
 {
-    if (m_storage->is_simple_storage()) {
-        const auto& storage = static_cast<const SimpleIndexedPropertyStorage&>(*m_storage);
-        const auto& elements = storage.elements();
+    if (auto* storage = simple_storage()) {
         Vector<u32> indices;
-        indices.ensure_capacity(storage.array_like_size());
-        for (size_t i = 0; i < elements.size(); ++i) {
-            if (!elements.at(i).is_empty())
+        indices.ensure_capacity(storage->array_like_size());
+        for (size_t i = 0; i < storage->array_like_size(); ++i) {
+            if (storage->has_index(i))
                 indices.unchecked_append(i);
         }
         return indices;
@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <AK/BitCast.h>
 #include <AK/NonnullOwnPtr.h>
 #include <LibJS/Runtime/Shape.h>
 #include <LibJS/Runtime/Value.h>
@@ -63,6 +64,16 @@ public:
 
 class SimpleIndexedPropertyStorage final : public IndexedPropertyStorage {
 public:
+    // Arrays that only ever held numbers keep their elements unboxed. Storing anything
+    // else (or punching a hole into an int32 array) moves the storage one kind further
+    // down this list; it never moves back up.
+    enum class ElementKind : u8 {
+        PackedInt32,
+        PackedDouble,
+        HoleyDouble,
+        Values,
+    };
+
     SimpleIndexedPropertyStorage() = default;
     explicit SimpleIndexedPropertyStorage(Vector<Value>&& initial_values);
 
@@ -75,19 +86,42 @@ public:
     virtual ValueAndAttributes take_first() override;
     virtual ValueAndAttributes take_last() override;
 
-    virtual size_t size() const override { return m_packed_elements.size(); }
+    virtual size_t size() const override;
     virtual size_t array_like_size() const override { return m_array_size; }
     virtual void set_array_like_size(size_t new_size) override;
 
     virtual bool is_simple_storage() const override { return true; }
+
+    ElementKind element_kind() const { return m_element_kind; }
+    bool is_packed() const { return m_element_kind == ElementKind::PackedInt32 || m_element_kind == ElementKind::PackedDouble; }
+
+    // Only valid for the respective element kind, and only the first array_like_size() entries are meaningful.
+    const Vector<i32>& int32_elements() const { return m_int32_elements; }
+    Vector<i32>& int32_elements() { return m_int32_elements; }
+    const Vector<double>& double_elements() const { return m_double_elements; }
     const Vector<Value>& elements() const { return m_packed_elements; }
 
+    static bool is_hole(double value) { return bit_cast<u64>(value) == hole_bits; }
+
 private:
     friend GenericIndexedPropertyStorage;
 
+    // A NaN payload that is never produced by arithmetic; NaNs stored into the array are canonicalized.
+    static constexpr u64 hole_bits = 0x7ff8dead0000beefULL;
+    static double hole() { return bit_cast<double>(hole_bits); }
+
     void grow_storage_if_needed();
+    void resize_storage(size_t);
+    void ensure_element_kind_can_store(Value);
+    void make_holey();
+    void transition_to(ElementKind);
+    Value element_at(size_t index) const;
+    void store(size_t index, Value);
 
     size_t m_array_size { 0 };
+    ElementKind m_element_kind { ElementKind::PackedInt32 };
+    Vector<i32> m_int32_elements;
+    Vector<double> m_double_elements;
     Vector<Value> m_packed_elements;
 };
 
@@ -164,11 +198,18 @@ public:
 
     Vector<u32> indices() const;
 
+    // Gives fast paths direct access to the (possibly unboxed) elements, if we are using simple storage.
+    SimpleIndexedPropertyStorage* simple_storage() { return m_storage->is_simple_storage() ? static_cast<SimpleIndexedPropertyStorage*>(m_storage.ptr()) : nullptr; }
+    const SimpleIndexedPropertyStorage* simple_storage() const { return const_cast<IndexedProperties&>(*this).simple_storage(); }
+
     template<typename Callback>
     void for_each_value(Callback callback)
     {
-        if (m_storage->is_simple_storage()) {
-            for (auto& value : static_cast<SimpleIndexedPropertyStorage&>(*m_storage).elements())
+        if (auto* storage = simple_storage()) {
+            // Unboxed numeric elements never contain cells, so there's nothing to visit.
+            if (storage->element_kind() != SimpleIndexedPropertyStorage::ElementKind::Values)
+                return;
+            for (auto& value : storage->elements())
                 callback(value);
         } else {
             for (auto& element : static_cast<const GenericIndexedPropertyStorage&>(*m_storage).sparse_elements())
@@ -24,13 +24,30 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <AK/StringBuilder.h>
+#include <AK/Vector.h>
 #include <LibJS/Runtime/PrimitiveString.h>
 #include <LibJS/Runtime/VM.h>
 
 namespace JS {
 
+// Concatenations shorter than this are cheaper to just copy than to keep around as a rope.
+static constexpr size_t min_rope_byte_length = 32;
+
+// Substrings up to this length are handed out from the VM's short string cache.
+static constexpr size_t max_short_string_byte_length = 16;
+
 PrimitiveString::PrimitiveString(String string)
     : m_string(move(string))
+{
+    m_byte_length = m_string.length();
+}
+
+PrimitiveString::PrimitiveString(PrimitiveString& lhs, PrimitiveString& rhs)
+    : m_lhs(&lhs)
+    , m_rhs(&rhs)
+    , m_is_rope(true)
+    , m_byte_length(lhs.byte_length() + rhs.byte_length())
 {
 }
 
@@ -38,6 +55,41 @@ PrimitiveString::~PrimitiveString()
 {
 }
 
+void PrimitiveString::visit_edges(Cell::Visitor& visitor)
+{
+    Cell::visit_edges(visitor);
+    if (m_is_rope) {
+        visitor.visit(m_lhs);
+        visitor.visit(m_rhs);
+    }
+}
+
+void PrimitiveString::resolve_rope() const
+{
+    VERIFY(m_is_rope);
+
+    StringBuilder builder(m_byte_length);
+
+    // Walk the rope iteratively in left-to-right order, so deep ropes can't overflow the stack.
+    Vector<const PrimitiveString*, 32> pieces;
+    pieces.append(m_rhs);
+    pieces.append(m_lhs);
+    while (!pieces.is_empty()) {
+        auto* piece = pieces.take_last();
+        if (piece->m_is_rope) {
+            pieces.append(piece->m_rhs);
+            pieces.append(piece->m_lhs);
+            continue;
+        }
+        builder.append(piece->m_string);
+    }
+
+    m_string = builder.to_string();
+    m_is_rope = false;
+    m_lhs = nullptr;
+    m_rhs = nullptr;
+}
+
 PrimitiveString* js_string(Heap& heap, String string)
 {
     if (string.is_empty())
@@ -54,4 +106,38 @@ PrimitiveString* js_string(VM& vm, String string)
     return js_string(vm.heap(), move(string));
 }
 
+PrimitiveString* js_rope_string(VM& vm, PrimitiveString& lhs, PrimitiveString& rhs)
+{
+    if (lhs.byte_length() == 0)
+        return &rhs;
+    if (rhs.byte_length() == 0)
+        return &lhs;
+
+    auto byte_length = lhs.byte_length() + rhs.byte_length();
+    if (byte_length < min_rope_byte_length) {
+        StringBuilder builder(byte_length);
+        builder.append(lhs.string());
+        builder.append(rhs.string());
+        return js_string(vm, builder.to_string());
+    }
+
+    return vm.heap().allocate_without_global_object<PrimitiveString>(lhs, rhs);
+}
+
+PrimitiveString* js_substring(VM& vm, const String& string, size_t start, size_t length)
+{
+    if (length == 0)
+        return &vm.empty_string();
+    if (start == 0 && length == string.length())
+        return js_string(vm, string);
+
+    auto view = string.substring_view(start, length);
+    if (length == 1 && (u8)view[0] < 0x80)
+        return &vm.single_ascii_character_string(view[0]);
+    if (length <= max_short_string_byte_length)
+        return &vm.short_string(view);
+
+    return js_string(vm, view);
+}
+
 }
@@ -34,17 +34,37 @@ namespace JS {
 class PrimitiveString final : public Cell {
 public:
     explicit PrimitiveString(String);
+    PrimitiveString(PrimitiveString& lhs, PrimitiveString& rhs);
     virtual ~PrimitiveString();
 
-    const String& string() const { return m_string; }
+    const String& string() const
+    {
+        if (m_is_rope)
+            resolve_rope();
+        return m_string;
+    }
+
+    bool is_rope() const { return m_is_rope; }
+
+    // Length of the string in bytes, available without flattening a rope.
+    size_t byte_length() const { return m_byte_length; }
 
 private:
     virtual const char* class_name() const override { return "PrimitiveString"; }
+    virtual void visit_edges(Cell::Visitor&) override;
+
+    void resolve_rope() const;
 
-    String m_string;
+    mutable String m_string;
+    mutable PrimitiveString* m_lhs { nullptr };
+    mutable PrimitiveString* m_rhs { nullptr };
+    mutable bool m_is_rope { false };
+    size_t m_byte_length { 0 };
 };
 
 PrimitiveString* js_string(Heap&, String);
 PrimitiveString* js_string(VM&, String);
+PrimitiveString* js_rope_string(VM&, PrimitiveString& lhs, PrimitiveString& rhs);
+PrimitiveString* js_substring(VM&, const String&, size_t start, size_t length);
 
 }
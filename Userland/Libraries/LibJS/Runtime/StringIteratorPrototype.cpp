@@ -70,10 +70,15 @@ JS_DEFINE_NATIVE_FUNCTION(StringIteratorPrototype::next)
         return create_iterator_result_object(global_object, js_undefined(), true);
     }
 
-    StringBuilder builder;
-    builder.append_code_point(*utf8_iterator);
+    auto code_point = *utf8_iterator;
     ++utf8_iterator;
 
+    if (code_point < 0x80)
+        return create_iterator_result_object(global_object, &vm.single_ascii_character_string(code_point), false);
+
+    StringBuilder builder;
+    builder.append_code_point(code_point);
+
     return create_iterator_result_object(global_object, js_string(vm, builder.to_string()), false);
 }
 
@@ -130,7 +130,7 @@ JS_DEFINE_NATIVE_FUNCTION(StringPrototype::char_at)
     if (index < 0 || index >= static_cast<i32>(string.length()))
         return js_string(vm, String::empty());
     // FIXME: This should return a character corresponding to the i'th UTF-16 code point.
-    return js_string(vm, string.substring(index, 1));
+    return js_substring(vm, string, index, 1);
 }
 
 JS_DEFINE_NATIVE_FUNCTION(StringPrototype::char_code_at)
@@ -421,8 +421,7 @@ JS_DEFINE_NATIVE_FUNCTION(StringPrototype::substring)
     }
 
     auto part_length = index_end - index_start;
-    auto string_part = string.substring(index_start, part_length);
-    return js_string(vm, string_part);
+    return js_substring(vm, string, index_start, part_length);
 }
 
 JS_DEFINE_NATIVE_FUNCTION(StringPrototype::substr)
@@ -458,8 +457,7 @@ JS_DEFINE_NATIVE_FUNCTION(StringPrototype::substr)
     if (int_start >= int_end)
         return js_string(vm, String(""));
 
-    auto string_part = string.substring(int_start, int_end - int_start);
-    return js_string(vm, string_part);
+    return js_substring(vm, string, int_start, int_end - int_start);
 }
 
 JS_DEFINE_NATIVE_FUNCTION(StringPrototype::includes)
@@ -526,8 +524,7 @@ JS_DEFINE_NATIVE_FUNCTION(StringPrototype::slice)
         return js_string(vm, String::empty());
 
     auto part_length = index_end - index_start;
-    auto string_part = string.substring(index_start, part_length);
-    return js_string(vm, string_part);
+    return js_substring(vm, string, index_start, part_length);
 }
 
 JS_DEFINE_NATIVE_FUNCTION(StringPrototype::split)
@@ -572,7 +569,7 @@ JS_DEFINE_NATIVE_FUNCTION(StringPrototype::split)
     auto pos = start;
     if (separator_len == 0) {
         for (pos = 0; pos < len; pos++)
-            result->define_property(pos, js_string(vm, string.substring(pos, 1)));
+            result->define_property(pos, js_substring(vm, string, pos, 1));
         return result;
     }
 
@@ -583,8 +580,7 @@ JS_DEFINE_NATIVE_FUNCTION(StringPrototype::split)
             continue;
         }
 
-        auto segment = string.substring_view(start, pos - start);
-        result->define_property(result_len, js_string(vm, segment));
+        result->define_property(result_len, js_substring(vm, string, start, pos - start));
         result_len++;
         if (result_len == limit)
             return result;
@@ -592,8 +588,7 @@ JS_DEFINE_NATIVE_FUNCTION(StringPrototype::split)
         pos = start;
     }
 
-    auto rest = string.substring(start, len - start);
-    result->define_property(result_len, js_string(vm, rest));
+    result->define_property(result_len, js_substring(vm, string, start, len - start));
 
     return result;
 }
@@ -650,7 +645,7 @@ JS_DEFINE_NATIVE_FUNCTION(StringPrototype::at)
     }
     if (index.has_overflow() || index.value() >= length)
         return js_undefined();
-    return js_string(vm, String::formatted("{}", string[index.value()]));
+    return js_substring(vm, string, index.value(), 1);
 }
 
 JS_DEFINE_NATIVE_FUNCTION(StringPrototype::symbol_iterator)
@@ -103,11 +103,23 @@ VM::InterpreterExecutionScope::~InterpreterExecutionScope()
     m_interpreter.vm().pop_interpreter(m_interpreter);
 }
 
+PrimitiveString& VM::short_string(const StringView& string)
+{
+    auto*& entry = m_short_strings[string.hash() % short_string_cache_size];
+    if (!entry || entry->string() != string)
+        entry = m_heap.allocate_without_global_object<PrimitiveString>(string);
+    return *entry;
+}
+
 void VM::gather_roots(HashTable<Cell*>& roots)
 {
     roots.set(m_empty_string);
     for (auto* string : m_single_ascii_character_strings)
         roots.set(string);
+    for (auto* string : m_short_strings) {
+        if (string)
+            roots.set(string);
+    }
 
     roots.set(m_scope_object_shape);
     roots.set(m_exception);
@@ -115,6 +115,9 @@ public:
         return *m_single_ascii_character_strings[character];
     }
 
+    // Returns a string from a small cache of recently created short strings, allocating a new one on a miss.
+    PrimitiveString& short_string(const StringView&);
+
     void push_call_frame(CallFrame& call_frame, GlobalObject& global_object)
     {
         VERIFY(!exception());
@@ -277,6 +280,10 @@ private:
     PrimitiveString* m_empty_string { nullptr };
     PrimitiveString* m_single_ascii_character_strings[128] {};
 
+    // Indexed by string hash, a colliding string just replaces the previous entry.
+    static constexpr size_t short_string_cache_size = 256;
+    PrimitiveString* m_short_strings[short_string_cache_size] {};
+
 #define __JS_ENUMERATE(SymbolName, snake_name) \
     Symbol* m_well_known_symbol_##snake_name { nullptr };
     JS_ENUMERATE_WELL_KNOWN_SYMBOLS
@@ -884,16 +884,13 @@ Value add(GlobalObject& global_object, Value lhs, Value rhs)
         return {};
 
     if (lhs_primitive.is_string() || rhs_primitive.is_string()) {
-        auto lhs_string = lhs_primitive.to_string(global_object);
+        auto lhs_string = lhs_primitive.to_primitive_string(global_object);
         if (vm.exception())
             return {};
-        auto rhs_string = rhs_primitive.to_string(global_object);
+        auto rhs_string = rhs_primitive.to_primitive_string(global_object);
         if (vm.exception())
             return {};
-        StringBuilder builder(lhs_string.length() + rhs_string.length());
-        builder.append(lhs_string);
-        builder.append(rhs_string);
-        return js_string(vm.heap(), builder.to_string());
+        return js_rope_string(vm, *lhs_string, *rhs_string);
     }
 
     auto lhs_numeric = lhs_primitive.to_numeric(global_object);
@@ -31,6 +31,7 @@
 #include <LibJS/Lexer.h>
 #include <LibJS/SyntaxHighlighter.h>
 #include <LibJS/Token.h>
+#include <ctype.h>
 
 namespace JS {
 
@@ -69,67 +70,98 @@ bool SyntaxHighlighter::is_navigatable([[maybe_unused]] void* token) const
     return false;
 }
 
-void SyntaxHighlighter::rehighlight(const Palette& palette)
+Syntax::TextStyle SyntaxHighlighter::style_for_span(void* data, const Palette& palette) const
 {
-    auto text = m_client->get_text();
+    return style_for_token_type(palette, static_cast<JS::TokenType>(reinterpret_cast<size_t>(data)));
+}
 
-    JS::Lexer lexer(text);
+SyntaxHighlighter::LexerState SyntaxHighlighter::initial_lexer_state() const
+{
+    return static_cast<LexerState>(JS::TokenType::Eof);
+}
 
-    Vector<GUI::TextDocumentSpan> spans;
-    GUI::TextPosition position { 0, 0 };
-    GUI::TextPosition start { 0, 0 };
-
-    auto advance_position = [&position](char ch) {
-        if (ch == '\n') {
-            position.set_line(position.line() + 1);
-            position.set_column(0);
-        } else
-            position.set_column(position.column() + 1);
-    };
-
-    auto append_token = [&](StringView str, const JS::Token& token, bool is_trivia) {
-        if (str.is_empty())
-            return;
-
-        start = position;
-        for (size_t i = 0; i < str.length() - 1; ++i)
-            advance_position(str[i]);
-
-        GUI::TextDocumentSpan span;
-        span.range.set_start(start);
-        span.range.set_end({ position.line(), position.column() });
-        auto type = is_trivia ? JS::TokenType::Invalid : token.type();
-        auto style = style_for_token_type(palette, type);
-        span.attributes.color = style.color;
-        span.attributes.bold = style.bold;
-        span.is_skippable = is_trivia;
-        span.data = reinterpret_cast<void*>(static_cast<size_t>(type));
-        spans.append(span);
-        advance_position(str[str.length() - 1]);
-
-        dbgln_if(SYNTAX_HIGHLIGHTING_DEBUG, "{}{} @ '{}' {}:{} - {}:{}",
-            token.name(),
-            is_trivia ? " (trivia)" : "",
-            token.value(),
-            span.range.start().line(), span.range.start().column(),
-            span.range.end().line(), span.range.end().column());
-    };
-
-    bool was_eof = false;
-    for (auto token = lexer.next(); !was_eof; token = lexer.next()) {
-        append_token(token.trivia(), token, true);
-        append_token(token.value(), token, false);
+void SyntaxHighlighter::lex_lines(const StringView& text, LexerState state, Vector<Line>& lines) const
+{
+    // The lexer can restart at a line that begins in whitespace or right after a line comment, given the type of
+    // the token before it, which is our lexer state. So trivia is split up into one span per line.
+    JS::Lexer lexer(text);
+    auto previous_token_type = static_cast<JS::TokenType>(state);
+    lexer.set_previous_token_type(previous_token_type);
+
+    size_t line_index = 0;
+    size_t column = 0;
+    auto* trivia_data = reinterpret_cast<void*>(static_cast<size_t>(JS::TokenType::Invalid));
+
+    for (;;) {
+        bool is_in_template_literal = lexer.is_in_template_literal();
+        auto token = lexer.next();
+
+        auto trivia = token.trivia();
+        size_t trivia_start_column = column;
+        bool is_in_line_comment = false;
+        bool is_in_block_comment = false;
+        for (size_t i = 0; i < trivia.length(); ++i) {
+            char ch = trivia[i];
+            if (ch == '\n') {
+                lines[line_index].spans.append({ { { 0, trivia_start_column }, { 0, column } }, trivia_data, true });
+                if (!is_in_block_comment && !is_in_template_literal)
+                    lines[line_index].state_at_end = static_cast<LexerState>(previous_token_type);
+                ++line_index;
+                column = 0;
+                trivia_start_column = 0;
+                is_in_line_comment = false;
+                continue;
+            }
+            ++column;
+            auto is_followed_by = [&](char next) { return i + 1 < trivia.length() && trivia[i + 1] == next; };
+            if (is_in_block_comment) {
+                if (ch == '*' && is_followed_by('/')) {
+                    is_in_block_comment = false;
+                    ++i;
+                    ++column;
+                }
+            } else if (!is_in_line_comment && !isspace(ch)) {
+                // Trivia is only whitespace and comments, and anything but a block comment lasts until the end of the line.
+                if (ch == '/' && is_followed_by('*')) {
+                    is_in_block_comment = true;
+                    ++i;
+                    ++column;
+                } else {
+                    is_in_line_comment = true;
+                }
+            }
+        }
+        if (column != trivia_start_column)
+            lines[line_index].spans.append({ { { 0, trivia_start_column }, { 0, column - 1 } }, trivia_data, true });
 
         if (token.type() == JS::TokenType::Eof)
-            was_eof = true;
+            break;
+
+        // The lexer can't restart inside a token, so the newlines in it don't give the lines a state.
+        auto value = token.value();
+        if (!value.is_empty()) {
+            size_t start_line_index = line_index;
+            size_t start_column = column;
+            for (size_t i = 0; i < value.length() - 1; ++i) {
+                if (value[i] == '\n') {
+                    ++line_index;
+                    column = 0;
+                } else {
+                    ++column;
+                }
+            }
+            lines[start_line_index].spans.append({ { { 0, start_column }, { line_index - start_line_index, column } }, reinterpret_cast<void*>(static_cast<size_t>(token.type())), false });
+            if (value[value.length() - 1] == '\n') {
+                ++line_index;
+                column = 0;
+            } else {
+                ++column;
+            }
+        }
+
+        dbgln_if(SYNTAX_HIGHLIGHTING_DEBUG, "{} @ '{}' {}:{}", token.name(), token.value(), line_index, column);
+        previous_token_type = token.type();
     }
-
-    m_client->do_set_spans(move(spans));
-
-    m_has_brace_buddies = false;
-    highlight_matching_token_pair();
-
-    m_client->do_update();
 }
 
 Vector<Syntax::Highlighter::MatchingTokenPair> SyntaxHighlighter::matching_token_pairs() const
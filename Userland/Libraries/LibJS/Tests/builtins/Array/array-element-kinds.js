@@ -0,0 +1,116 @@
+describe("element kind transitions", () => {
+    test("int32 to double to values", () => {
+        const a = [1, 2, 3];
+        a.push(4.5);
+        expect(a).toEqual([1, 2, 3, 4.5]);
+        a.push("foo");
+        expect(a).toEqual([1, 2, 3, 4.5, "foo"]);
+        a[0] = {};
+        expect(typeof a[0]).toBe("object");
+        expect(a[3]).toBe(4.5);
+    });
+
+    test("holes in numeric arrays", () => {
+        const a = [1, 2, 3];
+        a[5] = 6;
+        expect(a).toHaveLength(6);
+        expect(3 in a).toBeFalse();
+        expect(a[3]).toBeUndefined();
+        expect(a[5]).toBe(6);
+
+        delete a[0];
+        expect(0 in a).toBeFalse();
+        expect(Object.keys(a)).toEqual(["1", "2", "5"]);
+
+        a.length = 10;
+        expect(9 in a).toBeFalse();
+        a[9] = "bar";
+        expect(a[9]).toBe("bar");
+        expect(a[5]).toBe(6);
+        expect(3 in a).toBeFalse();
+    });
+
+    test("holes fall back to the prototype", () => {
+        const a = [1.5, 2.5];
+        a[3] = 4.5;
+        Array.prototype[2] = 42;
+        try {
+            expect(a[2]).toBe(42);
+            expect(a.indexOf(42)).toBe(2);
+        } finally {
+            delete Array.prototype[2];
+        }
+    });
+
+    test("special double values survive", () => {
+        const a = [NaN, -0, Infinity, -Infinity, 0.1];
+        expect(a[0]).toBeNaN();
+        expect(Object.is(a[1], -0)).toBeTrue();
+        expect(a[2]).toBe(Infinity);
+        expect(a[3]).toBe(-Infinity);
+        expect(a[4]).toBe(0.1);
+    });
+
+    test("shift, unshift, pop and splice on unboxed elements", () => {
+        const a = [1, 2, 3, 4];
+        expect(a.shift()).toBe(1);
+        a.unshift(0.5);
+        expect(a).toEqual([0.5, 2, 3, 4]);
+        expect(a.pop()).toBe(4);
+        expect(a.splice(1, 1, "x")).toEqual([2]);
+        expect(a).toEqual([0.5, "x", 3]);
+    });
+});
+
+describe("fast paths", () => {
+    test("indexOf on int32 and double arrays", () => {
+        const ints = [5, 3, 8, 3];
+        expect(ints.indexOf(3)).toBe(1);
+        expect(ints.indexOf(3, 2)).toBe(3);
+        expect(ints.indexOf(3.5)).toBe(-1);
+        expect(ints.indexOf("3")).toBe(-1);
+        expect([0].indexOf(-0)).toBe(0);
+
+        const doubles = [1.5, NaN, -0, 2.5];
+        expect(doubles.indexOf(2.5)).toBe(3);
+        expect(doubles.indexOf(NaN)).toBe(-1);
+        expect(doubles.indexOf(0)).toBe(2);
+    });
+
+    test("map and filter keep holes and results", () => {
+        const a = [1, 2, 3];
+        a[4] = 5;
+        const mapped = a.map(x => x * 2);
+        expect(mapped).toHaveLength(5);
+        expect(3 in mapped).toBeFalse();
+        expect(mapped[4]).toBe(10);
+        expect(a.filter(x => x % 2)).toEqual([1, 3, 5]);
+    });
+
+    test("map over an array that shrinks during iteration", () => {
+        const a = [1, 2, 3, 4];
+        const mapped = a.map((x, i, array) => {
+            if (i === 1) array.length = 2;
+            return x;
+        });
+        expect(mapped).toHaveLength(4);
+        expect(mapped[1]).toBe(2);
+        expect(2 in mapped).toBeFalse();
+    });
+
+    test("default sort on int32 arrays compares as strings", () => {
+        expect([10, 9, 1, -1, -10, 100, 0, 2147483647, -2147483648].sort()).toEqual([
+            -1,
+            -10,
+            -2147483648,
+            0,
+            1,
+            10,
+            100,
+            2147483647,
+            9,
+        ]);
+        expect([3, 1, 3, 1, 2, 2].sort()).toEqual([1, 1, 2, 2, 3, 3]);
+        expect([3, 1, 2].sort((a, b) => b - a)).toEqual([3, 2, 1]);
+    });
+});
@@ -22,6 +22,8 @@ i++;
 --> i++;
 /**/ --> i++;
 j --> i++;
+j;\t
+--> i++;
 return i;`;
     expect(source).toEvalTo(2);
 });
@@ -0,0 +1,82 @@
+// These double as micro-benchmarks for string building; run test-js with -t to see timings.
+
+test("appending in a loop", () => {
+    let s = "";
+    for (let i = 0; i < 100000; ++i) s += "x";
+    expect(s).toHaveLength(100000);
+    expect(s.charAt(0)).toBe("x");
+    expect(s.charAt(99999)).toBe("x");
+});
+
+test("appending far more pieces than fit in a shallow rope", () => {
+    const alphabet = "abcdefghijklmnopqrstuvwxyz";
+    let s = "";
+    for (let i = 0; i < 200000; ++i) s += alphabet[i % 26];
+    expect(s).toHaveLength(200000);
+    expect(s).toBe(alphabet.repeat(200000 / 26) + alphabet.substring(0, 200000 % 26));
+    for (let i = 0; i < 200000; i += 9973) expect(s.charAt(i)).toBe(alphabet[i % 26]);
+    expect(s.substring(199990)).toBe("yzabcdefgh");
+});
+
+test("prepending in a loop", () => {
+    let s = "";
+    for (let i = 0; i < 20000; ++i) s = (i % 10) + s;
+    expect(s).toHaveLength(20000);
+    expect(s.substring(0, 10)).toBe("9876543210");
+    expect(s.substring(19990)).toBe("9876543210");
+});
+
+test("appending longer pieces", () => {
+    let s = "";
+    for (let i = 0; i < 10000; ++i) s += "hello friends " + i + "\n";
+    expect(s.startsWith("hello friends 0\nhello friends 1\n")).toBeTrue();
+    expect(s.endsWith("hello friends 9999\n")).toBeTrue();
+    expect(s.split("\n")).toHaveLength(10001);
+});
+
+test("concatenating concatenations", () => {
+    let a = "";
+    let b = "";
+    for (let i = 0; i < 1000; ++i) {
+        a += "abcdefghijklmnopqrstuvwxyz";
+        b = "0123456789" + b;
+    }
+    const c = a + b + a;
+    expect(c).toHaveLength(26000 + 10000 + 26000);
+    expect(c.indexOf("z0123456789")).toBe(25999);
+    expect(c === a + b + a).toBeTrue();
+});
+
+test("splitting into single characters", () => {
+    const s = "abcdefghijklmnopqrstuvwxyz".repeat(2000);
+    const parts = s.split("");
+    expect(parts).toHaveLength(52000);
+    expect(parts[0]).toBe("a");
+    expect(parts[51999]).toBe("z");
+
+    let joined = "";
+    for (const character of s) joined += character;
+    expect(joined).toBe(s);
+});
+
+test("slicing out short strings", () => {
+    const words = [];
+    for (let i = 0; i < 2000; ++i) words.push("word" + i);
+    const text = words.join(",");
+
+    // Far more distinct pieces than the VM caches, so cache entries get replaced while earlier results are still alive.
+    const pieces = text.split(",");
+    expect(pieces).toHaveLength(2000);
+    for (let i = 0; i < 2000; ++i) expect(pieces[i]).toBe(words[i]);
+
+    let offset = 0;
+    for (let i = 0; i < 2000; ++i) {
+        const word = words[i];
+        expect(text.substring(offset, offset + word.length)).toBe(word);
+        expect(text.substr(offset, word.length)).toBe(word);
+        expect(text.slice(offset, offset + word.length)).toBe(pieces[i]);
+        offset += word.length + 1;
+    }
+    expect(pieces.join(",")).toBe(text);
+    expect("héllo".substring(0, 3)).toBe("hé");
+});
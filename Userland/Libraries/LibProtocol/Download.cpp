@@ -64,6 +64,8 @@ void Download::stream_into(OutputStream& stream)
             // FIXME: What do we do here?
             TODO();
         }
+        if (nread > 0 && on_data_received)
+            on_data_received({ buf, nread });
 
         if (m_internal_stream_data->read_stream.eof() && m_internal_stream_data->download_done) {
             m_internal_stream_data->read_notifier->close();
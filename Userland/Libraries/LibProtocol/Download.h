@@ -66,6 +66,8 @@ public:
     /// Note: Must be set before `set_should_buffer_all_input(true)`.
     Function<void(bool success, u32 total_size, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> response_code, ReadonlyBytes payload)> on_buffered_download_finish;
     Function<void(bool success, u32 total_size)> on_finish;
+    /// Note: Called with every chunk of the payload as it is read, including when buffering all input.
+    Function<void(ReadonlyBytes)> on_data_received;
     Function<void(Optional<u32> total_size, u32 downloaded_size)> on_progress;
     Function<void(const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> response_code)> on_headers_received;
     Function<CertificateAndKey()> on_certificate_requested;
@@ -335,6 +335,19 @@ public:
 
     void insert_bytecode_alternation(ByteCode&& left, ByteCode&& right)
     {
+        // Alternatives that each match a single character from a plain set (e.g. a|b|[0-9])
+        // consume the same amount and continue at the same place, so one Compare can match them all.
+        if (is_single_character_set_compare(left) && is_single_character_set_compare(right)) {
+            empend(static_cast<ByteCodeValueType>(OpCodeId::Compare));
+            empend(left.at(1) + right.at(1)); // number of arguments
+            empend(left.at(2) + right.at(2)); // size of arguments
+            for (size_t i = 3; i < left.size(); ++i)
+                append(left.at(i));
+            for (size_t i = 3; i < right.size(); ++i)
+                append(right.at(i));
+            return;
+        }
+
 
         // FORKJUMP _ALT
         // REGEXP ALT2
@@ -462,6 +475,29 @@ public:
     OpCode* get_opcode(MatchState& state) const;
 
 private:
+    static bool is_single_character_set_compare(const ByteCode& bytecode)
+    {
+        if (bytecode.size() < 3 || bytecode.at(0) != static_cast<ByteCodeValueType>(OpCodeId::Compare) || bytecode.size() != bytecode.at(2) + 3)
+            return false;
+
+        size_t offset = 3;
+        for (size_t i = 0; i < bytecode.at(1); ++i) {
+            switch (static_cast<CharacterCompareType>(bytecode.at(offset++))) {
+            case CharacterCompareType::AnyChar:
+                break;
+            case CharacterCompareType::Char:
+            case CharacterCompareType::CharClass:
+            case CharacterCompareType::CharRange:
+                ++offset;
+                break;
+            default:
+                // Inversions apply to all following arguments, and the rest can match more than one character.
+                return false;
+            }
+        }
+        return true;
+    }
+
     void insert_string(const StringView& view)
     {
         empend((ByteCodeValueType)view.length());
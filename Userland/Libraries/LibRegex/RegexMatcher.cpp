@@ -28,6 +28,8 @@
 #include "RegexDebug.h"
 #include "RegexParser.h"
 #include <AK/Debug.h>
+#include <AK/MemMem.h>
+#include <AK/NumericLimits.h>
 #include <AK/ScopedValueRollback.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
@@ -38,6 +40,88 @@ namespace regex {
 static RegexDebug s_regex_dbg(stderr);
 #endif
 
+static constexpr size_t c_unset_capture_slot = NumericLimits<size_t>::max();
+
+struct PikeThread {
+    size_t instruction_position { 0 };
+    size_t string_compare_offset { 0 }; // Characters of a literal string compare matched so far.
+    size_t start_position { 0 };
+    Vector<size_t, 8> capture_slots;
+};
+
+// Literal strings are always emitted as a Compare with a single String argument.
+static Optional<size_t> string_compare_length(const ByteCode& bytecode, size_t instruction_position)
+{
+    if (bytecode.at(instruction_position + 1) != 1 || static_cast<CharacterCompareType>(bytecode.at(instruction_position + 3)) != CharacterCompareType::String)
+        return {};
+    return bytecode.at(instruction_position + 4);
+}
+
+static Optional<size_t> find_literal(const RegexStringView& view, const String& literal, size_t start_position)
+{
+    auto string = view.u8view();
+    if (start_position > string.length())
+        return {};
+    auto offset = AK::memmem_optional(string.characters_without_null_termination() + start_position, string.length() - start_position, literal.characters(), literal.length());
+    if (!offset.has_value())
+        return {};
+    return start_position + offset.value();
+}
+
+// Returns the text matched by a Compare that matches exactly one fixed string, if it is one.
+static Optional<String> literal_for_compare(const ByteCode& bytecode, size_t instruction_position)
+{
+    if (bytecode.at(instruction_position + 1) != 1)
+        return {};
+
+    switch (static_cast<CharacterCompareType>(bytecode.at(instruction_position + 3))) {
+    case CharacterCompareType::Char: {
+        auto ch = bytecode.at(instruction_position + 4);
+        // Anything else may not be encoded as a single byte in the subject.
+        if (ch >= 0x80)
+            return {};
+        return String::repeated(static_cast<char>(ch), 1);
+    }
+    case CharacterCompareType::String: {
+        auto length = bytecode.at(instruction_position + 4);
+        StringBuilder builder;
+        for (size_t i = 0; i < length; ++i)
+            builder.append(static_cast<char>(bytecode.at(instruction_position + 5 + i)));
+        return builder.to_string();
+    }
+    default:
+        return {};
+    }
+}
+
+static bool is_compare_supported_by_pike_vm(const ByteCode& bytecode, size_t instruction_position)
+{
+    auto arguments_count = bytecode.at(instruction_position + 1);
+    auto offset = instruction_position + 3;
+    for (size_t i = 0; i < arguments_count; ++i) {
+        switch (static_cast<CharacterCompareType>(bytecode.at(offset++))) {
+        case CharacterCompareType::Inverse:
+        case CharacterCompareType::TemporaryInverse:
+        case CharacterCompareType::AnyChar:
+            break;
+        case CharacterCompareType::Char:
+        case CharacterCompareType::CharClass:
+        case CharacterCompareType::CharRange:
+            ++offset;
+            break;
+        case CharacterCompareType::String:
+            if (arguments_count != 1)
+                return false;
+            offset += bytecode.at(offset) + 1;
+            break;
+        default:
+            // Backreferences can't be matched without backtracking.
+            return false;
+        }
+    }
+    return true;
+}
+
 template<class Parser>
 Regex<Parser>::Regex(StringView pattern, typename ParserTraits<Parser>::OptionsType regex_options)
 {
@@ -166,7 +250,11 @@ RegexResult Matcher<Parser>::match(const Vector<RegexStringView> views, Optional
             state.string_position = view_index;
             state.instruction_position = 0;
 
-            auto success = execute(input, state, temp_output, 0);
+            Optional<bool> success;
+            if (uses_pike_vm())
+                success = execute_pike_vm(input, state, temp_output, view_index, false);
+            else
+                success = execute(input, state, temp_output, 0);
             // This success is acceptable only if it doesn't read anything from the input (input length is 0).
             if (state.string_position <= view_index) {
                 if (success.value()) {
@@ -180,7 +268,23 @@ RegexResult Matcher<Parser>::match(const Vector<RegexStringView> views, Optional
             }
         }
 
+        Optional<size_t> required_literal_position;
+
         for (; view_index < view_length; ++view_index) {
+            if (!m_required_literal.is_empty() && can_use_literals(input)) {
+                if (!required_literal_position.has_value() || required_literal_position.value() < view_index) {
+                    required_literal_position = find_literal(input.view, m_required_literal, view_index);
+                    if (!required_literal_position.has_value())
+                        break;
+                }
+            }
+
+            if (auto next_start = find_next_possible_start(input, view_index); !next_start.has_value() || next_start.value() != view_index) {
+                if (!next_start.has_value() || (!continue_search && !input.regex_options.has_flag_set(AllFlags::Internal_Stateful)))
+                    break;
+                view_index = next_start.value();
+            }
+
             auto& match_length_minimum = m_pattern.parser_result.match_length_minimum;
             // FIXME: More performant would be to know the remaining minimum string
             //        length needed to match from the current position onwards within
@@ -197,7 +301,17 @@ RegexResult Matcher<Parser>::match(const Vector<RegexStringView> views, Optional
             state.string_position = view_index;
             state.instruction_position = 0;
 
-            auto success = execute(input, state, output, 0);
+            Optional<bool> success;
+            if (uses_pike_vm()) {
+                // When searching (including stateful searches, which stop at the first match), the Pike VM
+                // tries every start position at once, so a failure here means there are no more matches in this view.
+                bool search = continue_search || input.regex_options.has_flag_set(AllFlags::Internal_Stateful);
+                success = execute_pike_vm(input, state, output, view_index, search);
+                if (!success.value() && search)
+                    break;
+            } else {
+                success = execute(input, state, output, 0);
+            }
             if (!success.has_value())
                 return { false, 0, {}, {}, {}, output.operations };
 
@@ -382,6 +496,405 @@ ALWAYS_INLINE Optional<bool> Matcher<Parser>::execute_low_prio_forks(const Match
     return false;
 }
 
+template<class Parser>
+void Matcher<Parser>::extract_required_literals()
+{
+    if (m_pattern.parser_result.error != Error::NoError)
+        return;
+
+    auto& bytecode = m_pattern.parser_result.bytecode;
+
+    // An instruction is on every path through the bytecode unless some jump skips over it.
+    struct ForwardEdge {
+        size_t from;
+        size_t to;
+    };
+    Vector<ForwardEdge> forward_edges;
+
+    MatchState state;
+    while (state.instruction_position < bytecode.size()) {
+        auto* opcode = bytecode.get_opcode(state);
+        if (!opcode)
+            return;
+
+        ssize_t offset = 0;
+        switch (opcode->opcode_id()) {
+        case OpCodeId::Jump:
+            offset = static_cast<OpCode_Jump*>(opcode)->offset();
+            break;
+        case OpCodeId::ForkJump:
+            offset = static_cast<OpCode_ForkJump*>(opcode)->offset();
+            break;
+        case OpCodeId::ForkStay:
+            offset = static_cast<OpCode_ForkStay*>(opcode)->offset();
+            break;
+        case OpCodeId::GoBack:
+            // Lookbehinds may look at text in front of the position the match starts at.
+            return;
+        default:
+            break;
+        }
+        if (offset > 0)
+            forward_edges.append({ state.instruction_position, state.instruction_position + opcode->size() + offset });
+
+        state.instruction_position += opcode->size();
+    }
+
+    auto is_on_every_path = [&](size_t instruction_position) {
+        for (auto& edge : forward_edges) {
+            if (edge.from < instruction_position && instruction_position < edge.to)
+                return false;
+        }
+        return true;
+    };
+
+    StringBuilder run;
+    bool run_is_prefix = true;
+    auto finish_run = [&] {
+        auto literal = run.to_string();
+        if (run_is_prefix && !literal.is_empty())
+            m_literal_prefix = literal;
+        if (literal.length() > m_required_literal.length())
+            m_required_literal = literal;
+        run.clear();
+        run_is_prefix = false;
+    };
+
+    state.instruction_position = 0;
+    while (state.instruction_position < bytecode.size()) {
+        auto* opcode = bytecode.get_opcode(state);
+
+        switch (opcode->opcode_id()) {
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveLeftNamedCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+        case OpCodeId::CheckBegin:
+        case OpCodeId::CheckEnd:
+        case OpCodeId::CheckBoundary:
+            // These don't consume anything, so literals on either side of them are adjacent.
+            break;
+        case OpCodeId::Compare:
+            if (auto literal = literal_for_compare(bytecode, state.instruction_position); literal.has_value() && is_on_every_path(state.instruction_position)) {
+                run.append(literal.value());
+                break;
+            }
+            finish_run();
+            break;
+        default:
+            finish_run();
+            break;
+        }
+
+        state.instruction_position += opcode->size();
+    }
+    finish_run();
+
+    dbgln_if(REGEX_DEBUG, "[literals] prefix='{}', required='{}'", m_literal_prefix, m_required_literal);
+}
+
+template<class Parser>
+bool Matcher<Parser>::can_use_literals(const MatchInput& input) const
+{
+    return input.view.is_u8_view() && !(input.regex_options & AllFlags::Insensitive);
+}
+
+// Returns the first position at or after the given one where the literal prefix occurs.
+template<class Parser>
+Optional<size_t> Matcher<Parser>::find_next_possible_start(const MatchInput& input, size_t start_position) const
+{
+    if (m_literal_prefix.is_empty() || !can_use_literals(input))
+        return start_position;
+    return find_literal(input.view, m_literal_prefix, start_position);
+}
+
+template<class Parser>
+bool Matcher<Parser>::can_start_at(const MatchInput& input, size_t position) const
+{
+    auto view_length = input.view.length();
+    if (position > view_length || m_pattern.parser_result.match_length_minimum > view_length - position)
+        return false;
+    if (m_literal_prefix.is_empty() || !can_use_literals(input))
+        return true;
+    return input.view.u8view().substring_view(position).starts_with(m_literal_prefix);
+}
+
+template<class Parser>
+void Matcher<Parser>::analyze_bytecode_for_pike_vm()
+{
+    if (m_pattern.parser_result.error != Error::NoError)
+        return;
+
+    auto& bytecode = m_pattern.parser_result.bytecode;
+    auto named_capture_slot_base = (m_pattern.parser_result.capture_groups_count + 1) * 2;
+    HashMap<String, size_t> named_capture_slots_by_name;
+
+    MatchState state;
+    while (state.instruction_position < bytecode.size()) {
+        auto* opcode = bytecode.get_opcode(state);
+        if (!opcode)
+            return;
+
+        switch (opcode->opcode_id()) {
+        case OpCodeId::FailForks:
+        case OpCodeId::Save:
+        case OpCodeId::Restore:
+        case OpCodeId::GoBack:
+            // Lookarounds need to rewind the string position, which the Pike VM can't do.
+            return;
+        case OpCodeId::Compare:
+            if (!is_compare_supported_by_pike_vm(bytecode, state.instruction_position))
+                return;
+            break;
+        case OpCodeId::SaveLeftNamedCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup: {
+            auto name = opcode->opcode_id() == OpCodeId::SaveLeftNamedCaptureGroup
+                ? static_cast<OpCode_SaveLeftNamedCaptureGroup*>(opcode)->name()
+                : static_cast<OpCode_SaveRightNamedCaptureGroup*>(opcode)->name();
+            auto slot = named_capture_slots_by_name.get(name);
+            if (!slot.has_value()) {
+                slot = named_capture_slot_base + m_named_capture_names.size() * 2;
+                named_capture_slots_by_name.set(name, slot.value());
+                m_named_capture_names.append(name);
+            }
+            m_named_capture_slots.set(state.instruction_position, slot.value());
+            break;
+        }
+        default:
+            break;
+        }
+
+        state.instruction_position += opcode->size();
+    }
+
+    m_capture_slot_count = named_capture_slot_base + m_named_capture_names.size() * 2;
+    m_can_use_pike_vm = true;
+}
+
+template<class Parser>
+bool Matcher<Parser>::execute_pike_vm(const MatchInput& input, MatchState& state, MatchOutput& output, size_t& start_position, bool search) const
+{
+    // Every thread is a backtracking path that is still alive. Threads are kept in the order the
+    // backtracker would have tried them, and only the first thread to reach an instruction at a
+    // given string position survives, so the first thread to match is the match the backtracker
+    // would have found.
+    auto& bytecode = m_pattern.parser_result.bytecode;
+    auto view_length = input.view.length();
+
+    Vector<size_t> visited_generation;
+    visited_generation.ensure_capacity(bytecode.size() + 1);
+    for (size_t i = 0; i <= bytecode.size(); ++i)
+        visited_generation.unchecked_append(0);
+    size_t generation = 0;
+
+    Vector<PikeThread> current_threads;
+    Vector<PikeThread> next_threads;
+    Vector<PikeThread> pending_threads;
+
+    // Follows all non-consuming instructions from the given thread and appends the resulting
+    // threads to the list in priority order.
+    auto add_thread = [&](Vector<PikeThread>& threads, PikeThread&& initial_thread, size_t string_position) {
+        pending_threads.append(move(initial_thread));
+        while (!pending_threads.is_empty()) {
+            auto thread = pending_threads.take_last();
+            auto instruction_position = thread.instruction_position;
+            auto& visited = visited_generation[min(instruction_position, bytecode.size())];
+            if (visited == generation)
+                continue;
+            visited = generation;
+
+            if (instruction_position >= bytecode.size()) {
+                threads.append(move(thread));
+                continue;
+            }
+
+            MatchState opcode_state { string_position, instruction_position, 0 };
+            auto& opcode = *bytecode.get_opcode(opcode_state);
+            auto next_instruction_position = instruction_position + opcode.size();
+            thread.instruction_position = next_instruction_position;
+
+            switch (opcode.opcode_id()) {
+            case OpCodeId::Jump:
+                thread.instruction_position += static_cast<const OpCode_Jump&>(opcode).offset();
+                pending_threads.append(move(thread));
+                break;
+            case OpCodeId::ForkJump:
+            case OpCodeId::ForkStay: {
+                auto offset = opcode.opcode_id() == OpCodeId::ForkJump
+                    ? static_cast<const OpCode_ForkJump&>(opcode).offset()
+                    : static_cast<const OpCode_ForkStay&>(opcode).offset();
+                PikeThread jump_thread = thread;
+                jump_thread.instruction_position += offset;
+                // Pending threads are taken from the back, so the preferred path goes last.
+                if (opcode.opcode_id() == OpCodeId::ForkJump) {
+                    pending_threads.append(move(thread));
+                    pending_threads.append(move(jump_thread));
+                } else {
+                    pending_threads.append(move(jump_thread));
+                    pending_threads.append(move(thread));
+                }
+                break;
+            }
+            case OpCodeId::SaveLeftCaptureGroup:
+                thread.capture_slots[static_cast<const OpCode_SaveLeftCaptureGroup&>(opcode).id() * 2] = string_position;
+                pending_threads.append(move(thread));
+                break;
+            case OpCodeId::SaveRightCaptureGroup:
+                thread.capture_slots[static_cast<const OpCode_SaveRightCaptureGroup&>(opcode).id() * 2 + 1] = string_position;
+                pending_threads.append(move(thread));
+                break;
+            case OpCodeId::SaveLeftNamedCaptureGroup:
+                thread.capture_slots[m_named_capture_slots.get(instruction_position).value()] = string_position;
+                pending_threads.append(move(thread));
+                break;
+            case OpCodeId::SaveRightNamedCaptureGroup:
+                thread.capture_slots[m_named_capture_slots.get(instruction_position).value() + 1] = string_position;
+                pending_threads.append(move(thread));
+                break;
+            case OpCodeId::CheckBegin:
+            case OpCodeId::CheckEnd:
+            case OpCodeId::CheckBoundary:
+                if (opcode.execute(input, opcode_state, output) == ExecutionResult::Continue)
+                    pending_threads.append(move(thread));
+                break;
+            case OpCodeId::Compare:
+                if (auto string_length = string_compare_length(bytecode, instruction_position); string_length.has_value() && string_length.value() == 0) {
+                    // Empty strings only ever match in u8 views, without consuming anything.
+                    if (input.view.is_u8_view())
+                        pending_threads.append(move(thread));
+                    break;
+                }
+                thread.instruction_position = instruction_position;
+                threads.append(move(thread));
+                break;
+            default:
+                VERIFY_NOT_REACHED();
+            }
+        }
+    };
+
+    auto start_thread_at = [&](size_t position) {
+        PikeThread thread;
+        thread.start_position = position;
+        thread.capture_slots.resize(m_capture_slot_count);
+        for (auto& slot : thread.capture_slots)
+            slot = c_unset_capture_slot;
+        return thread;
+    };
+
+    Optional<PikeThread> matched_thread;
+    size_t match_end_position = 0;
+
+    auto position = start_position;
+    ++generation;
+    add_thread(current_threads, start_thread_at(position), position);
+
+    for (;; ++position) {
+        ++generation;
+        for (auto& thread : current_threads) {
+            ++output.operations;
+            auto instruction_position = thread.instruction_position;
+
+            if (instruction_position >= bytecode.size()) {
+                // All remaining threads have a lower priority than this one.
+                matched_thread = move(thread);
+                match_end_position = position;
+                break;
+            }
+
+            if (position >= view_length)
+                continue;
+
+            if (auto string_length = string_compare_length(bytecode, instruction_position); string_length.has_value()) {
+                // Literal strings are matched one character per step to keep all threads in lockstep.
+                if (!input.view.is_u8_view())
+                    continue;
+                u32 expected_character = static_cast<u8>(bytecode.at(instruction_position + 5 + thread.string_compare_offset));
+                u32 character = input.view[position];
+                if (input.regex_options & AllFlags::Insensitive) {
+                    expected_character = tolower(expected_character);
+                    character = tolower(character);
+                }
+                if (character != expected_character)
+                    continue;
+                if (++thread.string_compare_offset < string_length.value()) {
+                    next_threads.append(move(thread));
+                    continue;
+                }
+                thread.string_compare_offset = 0;
+                thread.instruction_position = instruction_position + 5 + string_length.value();
+                add_thread(next_threads, move(thread), position + 1);
+                continue;
+            }
+
+            MatchState compare_state { position, instruction_position, 0 };
+            auto& opcode = *bytecode.get_opcode(compare_state);
+            if (opcode.execute(input, compare_state, output) != ExecutionResult::Continue || compare_state.string_position != position + 1)
+                continue;
+            thread.instruction_position = instruction_position + opcode.size();
+            add_thread(next_threads, move(thread), position + 1);
+        }
+
+        if (search && !matched_thread.has_value() && position < view_length) {
+            if (next_threads.is_empty()) {
+                // Nothing is in flight, so skip straight to the next place a match could start.
+                auto next_start = find_next_possible_start(input, position + 1);
+                if (next_start.has_value() && can_start_at(input, next_start.value())) {
+                    add_thread(next_threads, start_thread_at(next_start.value()), next_start.value());
+                    position = next_start.value() - 1;
+                }
+            } else if (can_start_at(input, position + 1)) {
+                add_thread(next_threads, start_thread_at(position + 1), position + 1);
+            }
+        }
+
+        if (next_threads.is_empty() || position >= view_length)
+            break;
+
+        swap(current_threads, next_threads);
+        next_threads.clear_with_capacity();
+    }
+
+    if (!matched_thread.has_value())
+        return false;
+
+    dbgln_if(REGEX_DEBUG, "[pike] Found a match from {} to {}", matched_thread->start_position, match_end_position);
+
+    start_position = matched_thread->start_position;
+    state.string_position = match_end_position;
+
+    auto make_match = [&](size_t left, size_t right) -> Match {
+        auto view = input.view.substring_view(left, right - left);
+        if (input.regex_options & AllFlags::StringCopyMatches)
+            return { view.to_string(), input.line, left, input.global_offset + left }; // create a copy of the original string
+        return { view, input.line, left, input.global_offset + left }; // take view to original string
+    };
+
+    auto& slots = matched_thread->capture_slots;
+    auto named_capture_slot_base = (m_pattern.parser_result.capture_groups_count + 1) * 2;
+    for (size_t slot = 0; slot < m_capture_slot_count; slot += 2) {
+        auto left = slots[slot];
+        auto right = slots[slot + 1];
+        if (left == c_unset_capture_slot || right == c_unset_capture_slot || left > right)
+            continue;
+
+        if (slot < named_capture_slot_base) {
+            if (output.capture_group_matches.size() <= input.match_index)
+                output.capture_group_matches.resize(input.match_index + 1);
+            auto& matches = output.capture_group_matches.at(input.match_index);
+            if (matches.size() <= slot / 2)
+                matches.resize(slot / 2 + 1);
+            matches.at(slot / 2) = make_match(left, right);
+        } else {
+            if (output.named_capture_group_matches.size() <= input.match_index)
+                output.named_capture_group_matches.resize(input.match_index + 1);
+            output.named_capture_group_matches.at(input.match_index).set(m_named_capture_names[(slot - named_capture_slot_base) / 2], make_match(left, right));
+        }
+    }
+
+    return true;
+}
+
 template class Matcher<PosixExtendedParser>;
 template class Regex<PosixExtendedParser>;
 
@@ -68,6 +68,8 @@ public:
         : m_pattern(pattern)
         , m_regex_options(regex_options.value_or({}))
     {
+        analyze_bytecode_for_pike_vm();
+        extract_required_literals();
     }
     ~Matcher() = default;
 
@@ -79,12 +81,39 @@ public:
         return m_regex_options;
     }
 
+    // Patterns without backreferences or lookarounds are run on a Pike VM, which
+    // simulates all backtracking paths in lockstep and so runs in linear time.
+    bool can_use_pike_vm() const { return m_can_use_pike_vm; }
+    bool uses_pike_vm() const { return m_can_use_pike_vm && m_use_pike_vm; }
+    void set_use_pike_vm(bool use_pike_vm) { m_use_pike_vm = use_pike_vm; }
+
+    // Literal text every match has to start with, and the longest literal every match has to contain.
+    const String& literal_prefix() const { return m_literal_prefix; }
+    const String& required_literal() const { return m_required_literal; }
+
 private:
     Optional<bool> execute(const MatchInput& input, MatchState& state, MatchOutput& output, size_t recursion_level) const;
     ALWAYS_INLINE Optional<bool> execute_low_prio_forks(const MatchInput& input, MatchState& original_state, MatchOutput& output, Vector<MatchState> states, size_t recursion_level) const;
 
+    bool execute_pike_vm(const MatchInput& input, MatchState& state, MatchOutput& output, size_t& start_position, bool search) const;
+    void analyze_bytecode_for_pike_vm();
+    void extract_required_literals();
+
+    bool can_use_literals(const MatchInput& input) const;
+    Optional<size_t> find_next_possible_start(const MatchInput& input, size_t start_position) const;
+    bool can_start_at(const MatchInput& input, size_t position) const;
+
     const Regex<Parser>& m_pattern;
     const typename ParserTraits<Parser>::OptionsType m_regex_options;
+
+    bool m_can_use_pike_vm { false };
+    bool m_use_pike_vm { true };
+    size_t m_capture_slot_count { 0 };
+    HashMap<size_t, size_t> m_named_capture_slots; // Keyed by instruction position.
+    Vector<StringView> m_named_capture_names;       // Indexed by named capture group slot.
+
+    String m_literal_prefix { String::empty() };
+    String m_required_literal { String::empty() };
 };
 
 template<class Parser>
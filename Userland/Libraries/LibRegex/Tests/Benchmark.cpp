@@ -986,6 +986,56 @@ BENCHMARK_CASE(simple_notbol_noteol_benchmark_reference_stdcpp)
 }
 #    endif
 
+#    if defined(REGEX_BENCHMARK_OUR)
+// Compares the Pike VM against the backtracking engine on the same patterns.
+static void benchmark_engines(const char* pattern, const String& subject, bool expect_match, bool use_pike_vm, size_t iterations)
+{
+    Regex<ECMA262> re(pattern);
+    EXPECT(re.matcher->can_use_pike_vm());
+    re.matcher->set_use_pike_vm(use_pike_vm);
+    for (size_t i = 0; i < iterations; ++i)
+        EXPECT_EQ(re.has_match(subject), expect_match);
+}
+
+BENCHMARK_CASE(exponential_alternation_pike_vm_benchmark)
+{
+    benchmark_engines("(a|aa)*b", String::repeated('a', 22), false, true, 100);
+}
+
+BENCHMARK_CASE(exponential_alternation_backtracking_benchmark)
+{
+    benchmark_engines("(a|aa)*b", String::repeated('a', 22), false, false, 100);
+}
+
+BENCHMARK_CASE(long_subject_search_pike_vm_benchmark)
+{
+    auto subject = String::formatted("{}hello friends", String::repeated('x', 10000));
+    Regex<ECMA262> re("hel+o \\w+");
+    re.matcher->set_use_pike_vm(true);
+    for (size_t i = 0; i < 100; ++i)
+        EXPECT(re.search(subject).success);
+}
+
+BENCHMARK_CASE(long_subject_search_backtracking_benchmark)
+{
+    auto subject = String::formatted("{}hello friends", String::repeated('x', 10000));
+    Regex<ECMA262> re("hel+o \\w+");
+    re.matcher->set_use_pike_vm(false);
+    for (size_t i = 0; i < 100; ++i)
+        EXPECT(re.search(subject).success);
+}
+
+BENCHMARK_CASE(catch_all_pike_vm_benchmark)
+{
+    benchmark_engines("^.*$", "Hello World", true, true, BENCHMARK_LOOP_ITERATIONS);
+}
+
+BENCHMARK_CASE(catch_all_backtracking_benchmark)
+{
+    benchmark_engines("^.*$", "Hello World", true, false, BENCHMARK_LOOP_ITERATIONS);
+}
+#    endif
+
 #endif
 
 TEST_MAIN(Regex)
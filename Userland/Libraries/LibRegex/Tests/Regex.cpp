@@ -616,4 +616,140 @@ TEST_CASE(replace)
     }
 }
 
+TEST_CASE(pike_vm)
+{
+    Regex<ECMA262> exponential("(a|aa)*b");
+    EXPECT(exponential.matcher->uses_pike_vm());
+    EXPECT(!exponential.has_match(String::repeated('a', 1000)));
+    EXPECT(exponential.has_match(String::formatted("{}b", String::repeated('a', 1000))));
+
+    EXPECT(!Regex<ECMA262>("(a)\\1").matcher->can_use_pike_vm());
+    EXPECT(!Regex<ECMA262>("a(?=b)").matcher->can_use_pike_vm());
+
+    struct _test {
+        const char* pattern;
+        const char* subject;
+        ECMAScriptFlags options {};
+    };
+
+    constexpr _test tests[] {
+        { "(a|ab)(c|bcd)(d*)", "abcd" },
+        { "(a+)(a*)", "aaaa" },
+        { "(a+?)(a*)", "aaaa" },
+        { "((...)X)+", "fooXbarXbazX" },
+        { "^hel(?<LO>l.)1$", "hello1" },
+        { "\\bfoo\\b|bar", "a foo bar foobar", ECMAScriptFlags::Global },
+        { "x*", "axxb", ECMAScriptFlags::Global },
+        { "(\\w+)@(\\w+)\\.com", "mail alice@example.com and bob@example.com", ECMAScriptFlags::Global },
+        { "hello friends", "HELLO FRIENDS", ECMAScriptFlags::Insensitive },
+    };
+
+    for (auto& test : tests) {
+        Regex<ECMA262> pike_re(test.pattern, test.options);
+        Regex<ECMA262> backtracking_re(test.pattern, test.options);
+        EXPECT(pike_re.matcher->uses_pike_vm());
+        backtracking_re.matcher->set_use_pike_vm(false);
+        auto pike_result = pike_re.search(test.subject);
+        auto backtracking_result = backtracking_re.search(test.subject);
+
+        EXPECT_EQ(pike_result.success, backtracking_result.success);
+        EXPECT_EQ(pike_result.count, backtracking_result.count);
+        for (size_t i = 0; i < min(pike_result.matches.size(), backtracking_result.matches.size()); ++i) {
+            EXPECT_EQ(pike_result.matches[i].view.to_string(), backtracking_result.matches[i].view.to_string());
+            EXPECT_EQ(pike_result.matches[i].global_offset, backtracking_result.matches[i].global_offset);
+        }
+        for (size_t i = 0; i < min(pike_result.capture_group_matches.size(), backtracking_result.capture_group_matches.size()); ++i) {
+            auto& pike_groups = pike_result.capture_group_matches[i];
+            auto& backtracking_groups = backtracking_result.capture_group_matches[i];
+            EXPECT_EQ(pike_groups.size(), backtracking_groups.size());
+            for (size_t j = 0; j < min(pike_groups.size(), backtracking_groups.size()); ++j)
+                EXPECT_EQ(pike_groups[j].view.to_string(), backtracking_groups[j].view.to_string());
+        }
+    }
+
+    // Stateful searches (as done by RegExp.prototype.exec) return one match per call, picking up where the last one ended.
+    Regex<ECMA262> stateful_pike_re("(\\d+)-(\\w)", ECMAScriptFlags::Global);
+    Regex<ECMA262> stateful_backtracking_re("(\\d+)-(\\w)", ECMAScriptFlags::Global);
+    stateful_backtracking_re.matcher->set_use_pike_vm(false);
+    StringView stateful_subject = "12-a, x-y, 345-b and 6-c";
+    for (;;) {
+        auto pike_result = stateful_pike_re.match(stateful_subject);
+        auto backtracking_result = stateful_backtracking_re.match(stateful_subject);
+        EXPECT_EQ(pike_result.success, backtracking_result.success);
+        EXPECT_EQ(stateful_pike_re.start_offset, stateful_backtracking_re.start_offset);
+        if (!pike_result.success || !backtracking_result.success)
+            break;
+        EXPECT_EQ(pike_result.count, 1u);
+        EXPECT_EQ(pike_result.matches[0].view.to_string(), backtracking_result.matches[0].view.to_string());
+        EXPECT_EQ(pike_result.matches[0].column, backtracking_result.matches[0].column);
+        EXPECT_EQ(pike_result.capture_group_matches[0][0].view.to_string(), backtracking_result.capture_group_matches[0][0].view.to_string());
+        EXPECT_EQ(pike_result.capture_group_matches[0][1].view.to_string(), backtracking_result.capture_group_matches[0][1].view.to_string());
+    }
+
+    // A failing stateful search has to run in a single pass over the input, not once per start position.
+    auto long_subject = String::repeated('a', 10000);
+    Regex<ECMA262> stateful_search("a*[bc]", ECMAScriptFlags::Global);
+    auto stateful_result = stateful_search.match(long_subject);
+    EXPECT(!stateful_result.success);
+    EXPECT(stateful_result.n_operations < 10 * long_subject.length());
+
+    Regex<PosixExtended> posix("hello (friends|world)");
+    EXPECT(posix.matcher->uses_pike_vm());
+    RegexResult result;
+    EXPECT(posix.search("oh, hello world!", result));
+    EXPECT_EQ(result.matches[0].view, "hello world");
+    EXPECT_EQ(result.capture_group_matches[0][0].view, "world");
+}
+
+TEST_CASE(literal_prefilter)
+{
+    struct _test {
+        const char* pattern;
+        const char* prefix;
+        const char* required;
+    };
+
+    constexpr _test tests[] {
+        { "hello(foo|bar)+world", "hello", "hello" },
+        { "(x|y)z*needle[0-9]", "", "needle" },
+        { "a+bc", "a", "bc" },
+        { "foo|bar", "", "" },
+        { "(?:abc)?def", "", "def" },
+        { "ab(?!cd)ef", "ab", "ab" },
+        { "(?<=ab)cd", "", "" },
+    };
+
+    for (auto& test : tests) {
+        Regex<ECMA262> re(test.pattern);
+        EXPECT_EQ(re.parser_result.error, Error::NoError);
+        EXPECT_EQ(re.matcher->literal_prefix(), test.prefix);
+        EXPECT_EQ(re.matcher->required_literal(), test.required);
+    }
+
+    Regex<ECMA262> re("(x|y)z*needle[0-9]", ECMAScriptFlags::Global);
+    EXPECT(!re.match("xzzneedle, yneedle").success);
+    re.start_offset = 0;
+    auto result = re.match("xzzneedle, yneedle1");
+    EXPECT(result.success);
+    EXPECT_EQ(result.matches[0].view, "yneedle1");
+
+    Regex<PosixExtended> posix("hello friends");
+    EXPECT_EQ(posix.matcher->literal_prefix(), "hello friends");
+    EXPECT(posix.search("well, hello friends!").success);
+    EXPECT(!posix.match("well, hello friends!").success);
+    EXPECT(posix.search("HELLO FRIENDS", PosixFlags::Insensitive).success);
+}
+
+TEST_CASE(merged_character_alternatives)
+{
+    Regex<ECMA262> re("^(a|b|[0-9]|\\s)+$");
+    // The alternatives collapse into a single Compare, so the group is just captures around it.
+    EXPECT(re.parser_result.bytecode.size() < 30);
+    EXPECT(re.has_match("ab 01b"));
+    EXPECT(!re.has_match("abc"));
+    RegexResult result;
+    EXPECT(re.match("ba9", result));
+    EXPECT_EQ(result.capture_group_matches[0][0].view, "9");
+}
+
 TEST_MAIN(Regex)
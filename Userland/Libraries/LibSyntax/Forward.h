@@ -30,5 +30,6 @@ namespace Syntax {
 
 class Highlighter;
 class HighlighterClient;
+class IncrementalHighlighter;
 
 }
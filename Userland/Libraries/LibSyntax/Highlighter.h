@@ -66,6 +66,14 @@ public:
     void detach();
     void cursor_did_change();
 
+    // The client reports which lines of the document it edits and when it scrolls, so that a highlighter
+    // that can start lexing in the middle of the document only has to look at the lines that changed.
+    virtual void did_change_line(size_t) { }
+    virtual void did_insert_line(size_t) { }
+    virtual void did_remove_line(size_t) { }
+    virtual void did_change_all_lines() { }
+    virtual void visible_lines_did_change(const Palette&) { }
+
 protected:
     Highlighter() { }
 
@@ -42,6 +42,7 @@ public:
     virtual void highlighter_did_request_update() = 0;
     virtual GUI::TextDocument& highlighter_did_request_document() = 0;
     virtual GUI::TextPosition highlighter_did_request_cursor() const = 0;
+    virtual size_t highlighter_did_request_last_visible_line() const = 0;
     virtual void highlighter_did_set_spans(Vector<GUI::TextDocumentSpan>) = 0;
 
     void do_set_spans(Vector<GUI::TextDocumentSpan> spans) { highlighter_did_set_spans(move(spans)); }
@@ -50,6 +51,7 @@ public:
     String get_text() const { return highlighter_did_request_text(); }
     GUI::TextDocument& get_document() { return highlighter_did_request_document(); }
     GUI::TextPosition get_cursor() const { return highlighter_did_request_cursor(); }
+    size_t get_last_visible_line() const { return highlighter_did_request_last_visible_line(); }
 };
 
 }
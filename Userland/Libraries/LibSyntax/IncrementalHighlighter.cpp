@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <AK/Debug.h>
+#include <LibGUI/TextDocument.h>
+#include <LibSyntax/IncrementalHighlighter.h>
+
+namespace Syntax {
+
+// Lexing stops this far below the bottom of the view, so that scrolling a little doesn't need another round.
+static constexpr size_t lines_to_highlight_below_view = 64;
+
+static constexpr size_t initial_lines_per_round = 16;
+static constexpr size_t max_lines_per_round = 4096;
+
+IncrementalHighlighter::~IncrementalHighlighter()
+{
+}
+
+void IncrementalHighlighter::note_changed_lines(size_t first_line, size_t unchanged_lines_at_end)
+{
+    if (!m_has_changed_lines) {
+        m_has_changed_lines = true;
+        m_first_changed_line = first_line;
+        m_unchanged_lines_at_end = unchanged_lines_at_end;
+        return;
+    }
+    m_first_changed_line = min(m_first_changed_line, first_line);
+    m_unchanged_lines_at_end = min(m_unchanged_lines_at_end, unchanged_lines_at_end);
+}
+
+void IncrementalHighlighter::did_change_line(size_t line_index)
+{
+    auto line_count = m_client->get_document().line_count();
+    note_changed_lines(line_index, line_count - line_index - 1);
+}
+
+void IncrementalHighlighter::did_insert_line(size_t line_index)
+{
+    auto line_count = m_client->get_document().line_count();
+    note_changed_lines(line_index, line_count - line_index - 1);
+}
+
+void IncrementalHighlighter::did_remove_line(size_t line_index)
+{
+    auto line_count = m_client->get_document().line_count();
+    note_changed_lines(line_index, line_count - line_index);
+}
+
+void IncrementalHighlighter::did_change_all_lines()
+{
+    note_changed_lines(0, 0);
+}
+
+auto IncrementalHighlighter::apply_line_changes(size_t line_count) -> Optional<ChangedLines>
+{
+    size_t old_line_count = m_line_count_at_last_highlight;
+    m_line_count_at_last_highlight = line_count;
+    if (!m_has_changed_lines) {
+        if (line_count == old_line_count)
+            return {};
+        // Someone changed the lines without telling us which.
+        note_changed_lines(0, 0);
+    }
+    m_has_changed_lines = false;
+
+    size_t shorter_line_count = min(old_line_count, line_count);
+    size_t first = min(m_first_changed_line, shorter_line_count);
+    size_t unchanged_lines_at_end = min(m_unchanged_lines_at_end, shorter_line_count - first);
+    // If lines were only removed, count the one after them as changed, so that there is a line to remember the old state in.
+    if (line_count - unchanged_lines_at_end == first && unchanged_lines_at_end > 0)
+        --unchanged_lines_at_end;
+    size_t old_end = old_line_count - unchanged_lines_at_end;
+    size_t new_end = line_count - unchanged_lines_at_end;
+
+    if (first >= m_lines.size())
+        return {};
+    if (old_end >= m_lines.size()) {
+        m_lines.shrink(first);
+        return ChangedLines { first, new_end };
+    }
+
+    // The lexer's state at the start of the first unchanged line, for telling when lexing the changed lines has caught up with it.
+    Optional<LexerState> old_state = old_end == 0 ? initial_lexer_state() : m_lines[old_end - 1].state_at_end;
+
+    size_t old_count = old_end - first;
+    size_t new_count = new_end - first;
+    if (new_count < old_count) {
+        m_lines.remove(first + new_count, old_count - new_count);
+    } else if (new_count > old_count) {
+        size_t added_count = new_count - old_count;
+        size_t old_size = m_lines.size();
+        m_lines.resize(old_size + added_count);
+        for (size_t i = old_size; i-- > old_end;)
+            m_lines[i + added_count] = move(m_lines[i]);
+    }
+    for (size_t i = first; i < new_end; ++i)
+        m_lines[i] = {};
+    m_lines[new_end - 1].state_at_end = old_state;
+
+    return ChangedLines { first, new_end };
+}
+
+void IncrementalHighlighter::highlight_lines(size_t first_line, size_t end_of_changed_lines, size_t end_line)
+{
+    auto& document = m_client->get_document();
+    size_t line_count = document.line_count();
+
+    // Start at the last line before the change where the lexer can pick up.
+    size_t line_index = min(first_line, m_lines.size());
+    while (line_index > 0 && !m_lines[line_index - 1].state_at_end.has_value())
+        --line_index;
+    LexerState state = line_index == 0 ? initial_lexer_state() : m_lines[line_index - 1].state_at_end.value();
+    dbgln_if(SYNTAX_HIGHLIGHTING_DEBUG, "Highlighting from line {} (changed {} to {}, {} highlighted)", line_index, first_line, end_of_changed_lines, m_lines.size());
+
+    size_t lines_per_round = initial_lines_per_round;
+    Vector<Line> lexed_lines;
+    while (line_index < line_count) {
+        // Whatever is left below the view gets highlighted when it is scrolled into it.
+        if (line_index >= end_line) {
+            m_lines.shrink(line_index);
+            return;
+        }
+
+        // One line more than needed, as the last one of a round is lexed again in the next.
+        size_t end_of_round = min(min(line_count, end_line + 1), line_index + lines_per_round);
+        lexed_lines.clear_with_capacity();
+        lexed_lines.resize(end_of_round - line_index);
+        lex_lines(document.text_of_lines(line_index, end_of_round), state, lexed_lines);
+
+        // A token that continues past the last line lexed has been cut short, and may have left the newline at the
+        // end of the text to a token of its own. So unless this is the end of the document, the last line is no good,
+        // and neither are the ones before it up to one that ends where the lexer can restart.
+        size_t usable_count = lexed_lines.size();
+        if (end_of_round != line_count) {
+            --usable_count;
+            while (usable_count > 0 && !lexed_lines[usable_count - 1].state_at_end.has_value())
+                --usable_count;
+        } else if (usable_count >= 2 && document.line(line_count - 1).is_empty()) {
+            // The same goes for the newline at the very end of the document.
+            lexed_lines[usable_count - 2].state_at_end = {};
+        }
+        lines_per_round = min(lines_per_round * 2, max_lines_per_round);
+        if (usable_count == 0) {
+            // Find the end of the token in a bigger round, even if it goes below the view.
+            end_line = max(end_line, line_index + lines_per_round);
+            continue;
+        }
+
+        for (size_t i = 0; i < usable_count; ++i, ++line_index) {
+            Optional<LexerState> old_state_at_end;
+            if (line_index < m_lines.size()) {
+                old_state_at_end = m_lines[line_index].state_at_end;
+                m_lines[line_index] = move(lexed_lines[i]);
+            } else {
+                m_lines.append(move(lexed_lines[i]));
+            }
+
+            // Once the lexer is in the same state as it was before, after the changed lines, the rest comes out the same as before.
+            auto& state_at_end = m_lines[line_index].state_at_end;
+            if (line_index + 1 >= end_of_changed_lines && state_at_end.has_value() && state_at_end == old_state_at_end) {
+                dbgln_if(SYNTAX_HIGHLIGHTING_DEBUG, "Caught up with the old highlighting at line {}", line_index + 1);
+                return;
+            }
+        }
+        state = m_lines[line_index - 1].state_at_end.value_or(initial_lexer_state());
+    }
+}
+
+size_t IncrementalHighlighter::end_of_visible_lines() const
+{
+    auto line_count = m_client->get_document().line_count();
+    return min(m_client->get_last_visible_line(), line_count) + 1 + lines_to_highlight_below_view;
+}
+
+void IncrementalHighlighter::set_client_spans(const Palette& palette)
+{
+    size_t span_count = 0;
+    for (auto& line : m_lines)
+        span_count += line.spans.size();
+
+    Vector<GUI::TextDocumentSpan> spans;
+    spans.ensure_capacity(span_count);
+    for (size_t line_index = 0; line_index < m_lines.size(); ++line_index) {
+        for (auto& line_span : m_lines[line_index].spans) {
+            GUI::TextDocumentSpan span;
+            span.range.set_start({ line_index + line_span.range.start().line(), line_span.range.start().column() });
+            span.range.set_end({ line_index + line_span.range.end().line(), line_span.range.end().column() });
+            auto style = style_for_span(line_span.data, palette);
+            span.attributes.color = style.color;
+            span.attributes.bold = style.bold;
+            span.data = line_span.data;
+            span.is_skippable = line_span.is_skippable;
+            spans.unchecked_append(move(span));
+        }
+    }
+    m_client->do_set_spans(move(spans));
+}
+
+void IncrementalHighlighter::rehighlight(const Palette& palette)
+{
+    auto line_count = m_client->get_document().line_count();
+    auto end_line = end_of_visible_lines();
+    if (auto changed_lines = apply_line_changes(line_count); changed_lines.has_value())
+        highlight_lines(changed_lines->first, changed_lines->end, end_line);
+    if (m_lines.size() < min(line_count, end_line))
+        highlight_lines(m_lines.size(), m_lines.size(), end_line);
+
+    set_client_spans(palette);
+
+    m_has_brace_buddies = false;
+    highlight_matching_token_pair();
+
+    m_client->do_update();
+}
+
+void IncrementalHighlighter::visible_lines_did_change(const Palette& palette)
+{
+    auto line_count = m_client->get_document().line_count();
+    if (m_lines.size() < min(line_count, end_of_visible_lines()))
+        rehighlight(palette);
+}
+
+}
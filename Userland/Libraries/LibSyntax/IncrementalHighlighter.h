@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibGUI/TextRange.h>
+#include <LibSyntax/Highlighter.h>
+
+namespace Syntax {
+
+// A highlighter for languages whose lexer can be restarted at the start of most lines. It keeps the spans of
+// each line together with the lexer's state at the end of it, so that after an edit only the lines from the
+// last restart point before it up to where the lexer's state is the same as before have to be lexed again.
+// Lines below the bottom of the client's view are only lexed once they are scrolled into it.
+class IncrementalHighlighter : public Highlighter {
+public:
+    virtual ~IncrementalHighlighter() override;
+
+    virtual void rehighlight(const Palette&) override;
+
+    virtual void did_change_line(size_t) override;
+    virtual void did_insert_line(size_t) override;
+    virtual void did_remove_line(size_t) override;
+    virtual void did_change_all_lines() override;
+    virtual void visible_lines_did_change(const Palette&) override;
+
+protected:
+    IncrementalHighlighter() { }
+
+    // Whatever the lexer needs to know to pick up at the start of a line.
+    using LexerState = u32;
+
+    struct LineSpan {
+        // Line numbers are relative to the line the span starts on.
+        GUI::TextRange range;
+        void* data { nullptr };
+        bool is_skippable { false };
+    };
+
+    struct Line {
+        Vector<LineSpan> spans;
+        // The lexer's state at the start of the next line, if it can be restarted there.
+        Optional<LexerState> state_at_end;
+    };
+
+    // Lexes the text of whole lines, starting in the given state, and fills in one Line for each of them.
+    // The last line of the text only ends in a newline if it isn't the last line of the document.
+    virtual void lex_lines(const StringView& text, LexerState, Vector<Line>&) const = 0;
+    virtual LexerState initial_lexer_state() const { return 0; }
+    virtual TextStyle style_for_span(void* data, const Palette&) const = 0;
+
+private:
+    struct ChangedLines {
+        size_t first;
+        size_t end;
+    };
+    void note_changed_lines(size_t first_line, size_t unchanged_lines_at_end);
+    Optional<ChangedLines> apply_line_changes(size_t line_count);
+    void highlight_lines(size_t first_line, size_t end_of_changed_lines, size_t end_line);
+    size_t end_of_visible_lines() const;
+    void set_client_spans(const Palette&);
+
+    // The lines that have been highlighted so far, from the top of the document.
+    Vector<Line> m_lines;
+    size_t m_line_count_at_last_highlight { 0 };
+
+    // The lines edited since the last highlight, merged like a diff hunk: everything before the first changed
+    // line and the given number of lines at the end of the document are the same as before.
+    bool m_has_changed_lines { true };
+    size_t m_first_changed_line { 0 };
+    size_t m_unchanged_lines_at_end { 0 };
+};
+
+}
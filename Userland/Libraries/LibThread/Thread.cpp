@@ -55,7 +55,7 @@ void LibThread::Thread::start()
             Thread* self = static_cast<Thread*>(arg);
             int exit_code = self->m_action();
             self->m_tid = 0;
-            return (void*)exit_code;
+            return reinterpret_cast<void*>(static_cast<intptr_t>(exit_code));
         },
         static_cast<void*>(this));
 
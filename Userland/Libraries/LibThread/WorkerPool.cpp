@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <LibThread/WorkerPool.h>
+
+namespace LibThread {
+
+WorkerPool::WorkerPool(size_t thread_count, StringView thread_name)
+{
+    pthread_mutex_init(&m_mutex, nullptr);
+    pthread_cond_init(&m_work_available, nullptr);
+    pthread_cond_init(&m_work_finished, nullptr);
+
+    for (size_t i = 0; i < thread_count; ++i) {
+        auto thread = Thread::construct([this] {
+            worker_main();
+            return 0;
+        },
+            thread_name);
+        thread->start();
+        m_threads.append(move(thread));
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    pthread_mutex_lock(&m_mutex);
+    m_shutting_down = true;
+    pthread_cond_broadcast(&m_work_available);
+    pthread_mutex_unlock(&m_mutex);
+
+    for (auto& thread : m_threads)
+        (void)thread.join();
+
+    pthread_cond_destroy(&m_work_finished);
+    pthread_cond_destroy(&m_work_available);
+    pthread_mutex_destroy(&m_mutex);
+}
+
+void WorkerPool::for_each(size_t count, Function<void(size_t)> job)
+{
+    if (m_threads.is_empty() || count <= 1) {
+        for (size_t i = 0; i < count; ++i)
+            job(i);
+        return;
+    }
+
+    pthread_mutex_lock(&m_mutex);
+    VERIFY(!m_job);
+    m_job = &job;
+    m_job_count = count;
+    m_next_job_index = 0;
+    m_unfinished_job_count = count;
+    pthread_cond_broadcast(&m_work_available);
+
+    run_pending_jobs();
+    while (m_unfinished_job_count)
+        pthread_cond_wait(&m_work_finished, &m_mutex);
+
+    m_job = nullptr;
+    m_job_count = 0;
+    m_next_job_index = 0;
+    pthread_mutex_unlock(&m_mutex);
+}
+
+// Must be called with m_mutex held; the mutex is dropped while each job runs.
+void WorkerPool::run_pending_jobs()
+{
+    while (m_next_job_index < m_job_count) {
+        auto& job = *m_job;
+        auto index = m_next_job_index++;
+        pthread_mutex_unlock(&m_mutex);
+        job(index);
+        pthread_mutex_lock(&m_mutex);
+        if (--m_unfinished_job_count == 0)
+            pthread_cond_signal(&m_work_finished);
+    }
+}
+
+void WorkerPool::worker_main()
+{
+    pthread_mutex_lock(&m_mutex);
+    for (;;) {
+        while (!m_shutting_down && m_next_job_index >= m_job_count)
+            pthread_cond_wait(&m_work_available, &m_mutex);
+        if (m_shutting_down)
+            break;
+        run_pending_jobs();
+    }
+    pthread_mutex_unlock(&m_mutex);
+}
+
+}
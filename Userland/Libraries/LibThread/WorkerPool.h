@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/StringView.h>
+#include <LibThread/Thread.h>
+#include <pthread.h>
+
+namespace LibThread {
+
+// A fixed set of threads that split up batches of independent jobs between them.
+// The thread calling for_each() works on the batch as well, so a pool with zero
+// threads simply runs every job on the caller.
+class WorkerPool {
+    AK_MAKE_NONCOPYABLE(WorkerPool);
+    AK_MAKE_NONMOVABLE(WorkerPool);
+
+public:
+    WorkerPool(size_t thread_count, StringView thread_name = nullptr);
+    ~WorkerPool();
+
+    size_t thread_count() const { return m_threads.size(); }
+
+    // Calls job(index) for every index in [0, count) and returns once all of them have finished.
+    void for_each(size_t count, Function<void(size_t)> job);
+
+private:
+    void worker_main();
+    void run_pending_jobs();
+
+    NonnullRefPtrVector<Thread> m_threads;
+
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_work_available;
+    pthread_cond_t m_work_finished;
+
+    // All of these are protected by m_mutex.
+    Function<void(size_t)>* m_job { nullptr };
+    size_t m_job_count { 0 };
+    size_t m_next_job_index { 0 };
+    size_t m_unfinished_job_count { 0 };
+    bool m_shutting_down { false };
+};
+
+}
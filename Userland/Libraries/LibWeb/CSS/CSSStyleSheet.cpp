@@ -37,4 +37,11 @@ CSSStyleSheet::~CSSStyleSheet()
 {
 }
 
+const RuleCache& CSSStyleSheet::rule_cache() const
+{
+    if (!m_rule_cache)
+        m_rule_cache = RuleCache::create(*this);
+    return *m_rule_cache;
+}
+
 }
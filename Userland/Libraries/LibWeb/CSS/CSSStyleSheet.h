@@ -27,9 +27,11 @@
 #pragma once
 
 #include <AK/NonnullRefPtrVector.h>
+#include <AK/OwnPtr.h>
 #include <AK/TypeCasts.h>
 #include <LibWeb/CSS/CSSImportRule.h>
 #include <LibWeb/CSS/CSSRule.h>
+#include <LibWeb/CSS/RuleCache.h>
 #include <LibWeb/CSS/StyleSheet.h>
 #include <LibWeb/Loader/Resource.h>
 
@@ -64,6 +66,10 @@ public:
             }
     }
 
+    // Built on first use. Must be invalidated whenever the effective rules change.
+    const RuleCache& rule_cache() const;
+    void invalidate_rule_cache() { m_rule_cache = nullptr; }
+
     template<typename Callback>
     bool for_first_not_loaded_import_rule(Callback callback)
     {
@@ -87,6 +93,7 @@ private:
     explicit CSSStyleSheet(NonnullRefPtrVector<CSSRule>);
 
     NonnullRefPtrVector<CSSRule> m_rules;
+    mutable OwnPtr<RuleCache> m_rule_cache;
 };
 
 }
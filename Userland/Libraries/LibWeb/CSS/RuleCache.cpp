@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/HashFunctions.h>
+#include <LibWeb/CSS/CSSStyleSheet.h>
+#include <LibWeb/CSS/RuleCache.h>
+#include <LibWeb/DOM/Element.h>
+#include <LibWeb/HTML/AttributeNames.h>
+
+namespace Web::CSS {
+
+// Ids, classes and tag names live in separate namespaces, so "div" the class
+// must not collide with "div" the tag name.
+u32 AncestorFilter::hash_for_id(const FlyString& id)
+{
+    return pair_int_hash(id.hash(), 1);
+}
+
+u32 AncestorFilter::hash_for_class(const FlyString& class_name)
+{
+    return pair_int_hash(class_name.hash(), 2);
+}
+
+u32 AncestorFilter::hash_for_tag_name(const FlyString& tag_name)
+{
+    return pair_int_hash(tag_name.hash(), 3);
+}
+
+void AncestorFilter::add(u32 hash)
+{
+    auto first_bit = hash % bit_count;
+    auto second_bit = (hash >> 16) % bit_count;
+    m_bits[first_bit / 32] |= 1u << (first_bit % 32);
+    m_bits[second_bit / 32] |= 1u << (second_bit % 32);
+}
+
+bool AncestorFilter::may_contain(u32 hash) const
+{
+    auto first_bit = hash % bit_count;
+    auto second_bit = (hash >> 16) % bit_count;
+    return (m_bits[first_bit / 32] & (1u << (first_bit % 32)))
+        && (m_bits[second_bit / 32] & (1u << (second_bit % 32)));
+}
+
+void AncestorFilter::add_element(const DOM::Element& element)
+{
+    add(hash_for_tag_name(element.local_name()));
+    auto id = element.attribute(HTML::AttributeNames::id);
+    if (!id.is_null())
+        add(hash_for_id(id));
+    for (auto& class_name : element.class_names())
+        add(hash_for_class(class_name));
+}
+
+static void add_ancestor_hashes(const Selector::ComplexSelector::CompoundSelector& compound_selector, Vector<u32, 4>& hashes)
+{
+    for (auto& simple_selector : compound_selector) {
+        switch (simple_selector.type) {
+        case Selector::SimpleSelector::Type::Id:
+            hashes.append(AncestorFilter::hash_for_id(simple_selector.value));
+            break;
+        case Selector::SimpleSelector::Type::Class:
+            hashes.append(AncestorFilter::hash_for_class(simple_selector.value));
+            break;
+        case Selector::SimpleSelector::Type::TagName:
+            hashes.append(AncestorFilter::hash_for_tag_name(simple_selector.value));
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+NonnullOwnPtr<RuleCache> RuleCache::create(const CSSStyleSheet& sheet)
+{
+    auto rule_cache = adopt_own(*new RuleCache);
+
+    size_t rule_index = 0;
+    sheet.for_each_effective_style_rule([&](auto& rule) {
+        size_t selector_index = 0;
+        for (auto& selector : rule.selectors()) {
+            Entry entry { rule, rule_index, selector_index, {} };
+
+            // Walk leftwards for as long as we're looking at ancestors of the subject.
+            // Anything past a sibling combinator can't be checked against the filter.
+            auto& complex_selectors = selector.complex_selectors();
+            for (size_t i = complex_selectors.size() - 1; i > 0; --i) {
+                auto relation = complex_selectors[i].relation;
+                if (relation != Selector::ComplexSelector::Relation::Descendant && relation != Selector::ComplexSelector::Relation::ImmediateChild)
+                    break;
+                add_ancestor_hashes(complex_selectors[i - 1].compound_selector, entry.ancestor_hashes);
+            }
+
+            rule_cache->add_invalidation_sets(selector);
+            rule_cache->add(move(entry));
+            ++selector_index;
+        }
+        ++rule_index;
+    });
+
+    return rule_cache;
+}
+
+void RuleCache::add(Entry&& entry)
+{
+    auto& selector = entry.rule->selectors()[entry.selector_index];
+    auto& rightmost_compound_selector = selector.complex_selectors().last().compound_selector;
+
+    // Prefer the most selective bucket: ids are rarer than classes, which are rarer than tag names.
+    const Selector::SimpleSelector* key = nullptr;
+    for (auto& simple_selector : rightmost_compound_selector) {
+        if (simple_selector.type == Selector::SimpleSelector::Type::Id) {
+            key = &simple_selector;
+            break;
+        }
+        if (simple_selector.type == Selector::SimpleSelector::Type::Class && (!key || key->type == Selector::SimpleSelector::Type::TagName))
+            key = &simple_selector;
+        else if (simple_selector.type == Selector::SimpleSelector::Type::TagName && !key)
+            key = &simple_selector;
+    }
+
+    auto add_to_bucket = [&](HashMap<FlyString, Vector<Entry>>& buckets) {
+        auto it = buckets.find(key->value);
+        if (it == buckets.end()) {
+            buckets.set(key->value, {});
+            it = buckets.find(key->value);
+        }
+        it->value.append(move(entry));
+    };
+
+    if (!key)
+        m_other_rules.append(move(entry));
+    else if (key->type == Selector::SimpleSelector::Type::Id)
+        add_to_bucket(m_rules_by_id);
+    else if (key->type == Selector::SimpleSelector::Type::Class)
+        add_to_bucket(m_rules_by_class);
+    else
+        add_to_bucket(m_rules_by_tag_name);
+}
+
+void RuleCache::add_invalidation_sets(const Selector& selector)
+{
+    auto& complex_selectors = selector.complex_selectors();
+    for (size_t i = 0; i < complex_selectors.size(); ++i) {
+        // A change to an element that matches this compound selector affects whichever
+        // elements the combinators to its right lead to.
+        InvalidationSet invalidation_set;
+        if (i == complex_selectors.size() - 1) {
+            invalidation_set.invalidate_self = true;
+        } else {
+            auto relation = complex_selectors[i + 1].relation;
+            if (relation == Selector::ComplexSelector::Relation::AdjacentSibling || relation == Selector::ComplexSelector::Relation::GeneralSibling)
+                invalidation_set.invalidate_siblings = true;
+            else
+                invalidation_set.invalidate_descendants = true;
+        }
+
+        auto include_in = [&](HashMap<FlyString, InvalidationSet>& sets, const FlyString& key) {
+            auto it = sets.find(key);
+            if (it == sets.end())
+                sets.set(key, invalidation_set);
+            else
+                it->value.include(invalidation_set);
+        };
+
+        for (auto& simple_selector : complex_selectors[i].compound_selector) {
+            if (simple_selector.type == Selector::SimpleSelector::Type::Id)
+                include_in(m_invalidation_sets_by_id, simple_selector.value);
+            else if (simple_selector.type == Selector::SimpleSelector::Type::Class)
+                include_in(m_invalidation_sets_by_class, simple_selector.value);
+
+            if (simple_selector.attribute_match_type != Selector::SimpleSelector::AttributeMatchType::None)
+                include_in(m_invalidation_sets_by_attribute, simple_selector.attribute_name);
+
+            // Whether an element is a link depends on its href attribute.
+            if (simple_selector.pseudo_class == Selector::SimpleSelector::PseudoClass::Link || simple_selector.pseudo_class == Selector::SimpleSelector::PseudoClass::Visited)
+                include_in(m_invalidation_sets_by_attribute, HTML::AttributeNames::href);
+        }
+    }
+}
+
+static InvalidationSet find_invalidation_set(const HashMap<FlyString, InvalidationSet>& sets, const FlyString& key)
+{
+    auto it = sets.find(key);
+    if (it == sets.end())
+        return {};
+    return it->value;
+}
+
+InvalidationSet RuleCache::invalidation_set_for_id(const FlyString& id) const
+{
+    return find_invalidation_set(m_invalidation_sets_by_id, id);
+}
+
+InvalidationSet RuleCache::invalidation_set_for_class(const FlyString& class_name) const
+{
+    return find_invalidation_set(m_invalidation_sets_by_class, class_name);
+}
+
+InvalidationSet RuleCache::invalidation_set_for_attribute(const FlyString& attribute_name) const
+{
+    return find_invalidation_set(m_invalidation_sets_by_attribute, attribute_name);
+}
+
+void RuleCache::collect_candidates(const DOM::Element& element, Vector<const Entry*>& candidates) const
+{
+    auto add_bucket = [&](const Vector<Entry>& bucket) {
+        for (auto& entry : bucket)
+            candidates.append(&entry);
+    };
+    auto add_bucket_for_key = [&](const HashMap<FlyString, Vector<Entry>>& buckets, const FlyString& key) {
+        auto it = buckets.find(key);
+        if (it != buckets.end())
+            add_bucket(it->value);
+    };
+
+    auto id = element.attribute(HTML::AttributeNames::id);
+    if (!id.is_null())
+        add_bucket_for_key(m_rules_by_id, id);
+    for (auto& class_name : element.class_names())
+        add_bucket_for_key(m_rules_by_class, class_name);
+    add_bucket_for_key(m_rules_by_tag_name, element.local_name());
+    add_bucket(m_other_rules);
+}
+
+}
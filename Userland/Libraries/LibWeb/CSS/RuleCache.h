@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/FlyString.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Vector.h>
+#include <LibWeb/CSS/CSSStyleRule.h>
+#include <LibWeb/Forward.h>
+
+namespace Web::CSS {
+
+// A Bloom filter over the ids, classes and tag names of an element's ancestors.
+// It never answers "no" for something that is present, so it can safely reject
+// selectors whose descendant/child parts could not possibly match.
+class AncestorFilter {
+public:
+    static u32 hash_for_id(const FlyString&);
+    static u32 hash_for_class(const FlyString&);
+    static u32 hash_for_tag_name(const FlyString&);
+
+    void add_element(const DOM::Element&);
+    bool may_contain(u32 hash) const;
+
+private:
+    void add(u32 hash);
+
+    static constexpr size_t bit_count = 2048;
+    u32 m_bits[bit_count / 32] {};
+};
+
+// Which elements may change match state when an element gains or loses some id, class or attribute.
+struct InvalidationSet {
+    bool invalidate_self { false };
+    bool invalidate_descendants { false };
+    bool invalidate_siblings { false };
+
+    bool is_empty() const { return !invalidate_self && !invalidate_descendants && !invalidate_siblings; }
+    void include(const InvalidationSet& other)
+    {
+        invalidate_self |= other.invalidate_self;
+        invalidate_descendants |= other.invalidate_descendants;
+        invalidate_siblings |= other.invalidate_siblings;
+    }
+};
+
+// The style rules of one style sheet, bucketed by the id, class or tag name in
+// their rightmost compound selector. An element only has to be matched against
+// the buckets for its own id, classes and tag name, plus the rules that have
+// none of those.
+class RuleCache {
+public:
+    struct Entry {
+        NonnullRefPtr<CSSStyleRule> rule;
+        size_t rule_index { 0 };
+        size_t selector_index { 0 };
+
+        // Every one of these has to be in the element's AncestorFilter for the selector to match.
+        Vector<u32, 4> ancestor_hashes;
+    };
+
+    static NonnullOwnPtr<RuleCache> create(const CSSStyleSheet&);
+
+    void collect_candidates(const DOM::Element&, Vector<const Entry*>&) const;
+
+    InvalidationSet invalidation_set_for_id(const FlyString&) const;
+    InvalidationSet invalidation_set_for_class(const FlyString&) const;
+    InvalidationSet invalidation_set_for_attribute(const FlyString&) const;
+
+private:
+    RuleCache() = default;
+
+    void add(Entry&&);
+    void add_invalidation_sets(const Selector&);
+
+    HashMap<FlyString, Vector<Entry>> m_rules_by_id;
+    HashMap<FlyString, Vector<Entry>> m_rules_by_class;
+    HashMap<FlyString, Vector<Entry>> m_rules_by_tag_name;
+    Vector<Entry> m_other_rules;
+
+    HashMap<FlyString, InvalidationSet> m_invalidation_sets_by_id;
+    HashMap<FlyString, InvalidationSet> m_invalidation_sets_by_class;
+    HashMap<FlyString, InvalidationSet> m_invalidation_sets_by_attribute;
+};
+
+}
@@ -24,52 +24,76 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include <LibWeb/CSS/CSSStyleRule.h>
 #include <LibWeb/CSS/StyleInvalidator.h>
+#include <LibWeb/CSS/StyleResolver.h>
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Element.h>
+#include <LibWeb/HTML/AttributeNames.h>
 
 namespace Web::CSS {
 
-StyleInvalidator::StyleInvalidator(DOM::Document& document)
-    : m_document(document)
+StyleInvalidator::StyleInvalidator(DOM::Element& element, const FlyString& attribute_name)
+    : m_element(element)
+    , m_attribute_name(attribute_name)
 {
-    if (!m_document.should_invalidate_styles_on_attribute_changes())
-        return;
-    auto& style_resolver = m_document.style_resolver();
-    m_document.for_each_in_inclusive_subtree_of_type<DOM::Element>([&](auto& element) {
-        m_elements_and_matching_rules_before.set(&element, style_resolver.collect_matching_rules(element));
+    m_enabled = m_element.document().should_invalidate_styles_on_attribute_changes();
+    if (m_enabled)
+        m_old_value = m_element.attribute(m_attribute_name);
+}
+
+static void invalidate_inclusive_subtree(DOM::Element& element)
+{
+    element.for_each_in_inclusive_subtree_of_type<DOM::Element>([&](auto& inclusive_descendant) {
+        inclusive_descendant.set_needs_style_update(true);
         return IterationDecision::Continue;
     });
 }
 
 StyleInvalidator::~StyleInvalidator()
 {
-    if (!m_document.should_invalidate_styles_on_attribute_changes())
+    if (!m_enabled)
         return;
-    auto& style_resolver = m_document.style_resolver();
-    m_document.for_each_in_inclusive_subtree_of_type<DOM::Element>([&](auto& element) {
-        auto maybe_matching_rules_before = m_elements_and_matching_rules_before.get(&element);
-        if (!maybe_matching_rules_before.has_value()) {
-            element.set_needs_style_update(true);
-            return IterationDecision::Continue;
-        }
-        auto& matching_rules_before = maybe_matching_rules_before.value();
-        auto matching_rules_after = style_resolver.collect_matching_rules(element);
-        if (matching_rules_before.size() != matching_rules_after.size()) {
-            element.set_needs_style_update(true);
-            return IterationDecision::Continue;
+
+    auto new_value = m_element.attribute(m_attribute_name);
+    if (new_value == m_old_value)
+        return;
+
+    auto& style_resolver = m_element.document().style_resolver();
+    auto invalidation_set = style_resolver.invalidation_set_for_attribute(m_attribute_name);
+
+    if (m_attribute_name == HTML::AttributeNames::id) {
+        if (!m_old_value.is_null())
+            invalidation_set.include(style_resolver.invalidation_set_for_id(m_old_value));
+        if (!new_value.is_null())
+            invalidation_set.include(style_resolver.invalidation_set_for_id(new_value));
+    } else if (m_attribute_name == HTML::AttributeNames::class_) {
+        // Only the classes that were added or removed can change anything.
+        auto old_classes = m_old_value.split_view(' ');
+        auto new_classes = new_value.split_view(' ');
+        for (auto& class_name : old_classes) {
+            if (!new_classes.contains_slow(class_name))
+                invalidation_set.include(style_resolver.invalidation_set_for_class(class_name));
         }
-        style_resolver.sort_matching_rules(matching_rules_before);
-        style_resolver.sort_matching_rules(matching_rules_after);
-        for (size_t i = 0; i < matching_rules_before.size(); ++i) {
-            if (matching_rules_before[i].rule != matching_rules_after[i].rule) {
-                element.set_needs_style_update(true);
-                break;
-            }
+        for (auto& class_name : new_classes) {
+            if (!old_classes.contains_slow(class_name))
+                invalidation_set.include(style_resolver.invalidation_set_for_class(class_name));
         }
-        return IterationDecision::Continue;
-    });
+    }
+
+    if (invalidation_set.invalidate_self)
+        m_element.set_needs_style_update(true);
+
+    if (invalidation_set.invalidate_descendants) {
+        m_element.for_each_child_of_type<DOM::Element>([&](auto& child) {
+            invalidate_inclusive_subtree(child);
+        });
+    }
+
+    // Sibling combinators only look backwards, so only the following siblings can be affected.
+    if (invalidation_set.invalidate_siblings) {
+        for (auto* sibling = m_element.next_element_sibling(); sibling; sibling = sibling->next_element_sibling())
+            invalidate_inclusive_subtree(*sibling);
+    }
 }
 
 }
@@ -26,21 +26,24 @@
 
 #pragma once
 
-#include <AK/HashMap.h>
-#include <LibWeb/CSS/StyleResolver.h>
-#include <LibWeb/DOM/Document.h>
-#include <LibWeb/DOM/Element.h>
+#include <AK/FlyString.h>
+#include <AK/String.h>
+#include <LibWeb/Forward.h>
 
 namespace Web::CSS {
 
+// Compares an element's attribute before and after a change, and marks only the
+// elements whose matching style rules might be affected by it.
 class StyleInvalidator {
 public:
-    explicit StyleInvalidator(DOM::Document&);
+    StyleInvalidator(DOM::Element&, const FlyString& attribute_name);
     ~StyleInvalidator();
 
 private:
-    DOM::Document& m_document;
-    HashMap<DOM::Element*, Vector<MatchingRule>> m_elements_and_matching_rules_before;
+    DOM::Element& m_element;
+    FlyString m_attribute_name;
+    String m_old_value;
+    bool m_enabled { false };
 };
 
 }
@@ -25,9 +25,11 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <AK/AllOf.h>
 #include <AK/QuickSort.h>
 #include <LibWeb/CSS/CSSStyleRule.h>
 #include <LibWeb/CSS/Parser/DeprecatedCSSParser.h>
+#include <LibWeb/CSS/RuleCache.h>
 #include <LibWeb/CSS/SelectorEngine.h>
 #include <LibWeb/CSS/StyleResolver.h>
 #include <LibWeb/CSS/StyleSheet.h>
@@ -84,29 +86,93 @@ void StyleResolver::for_each_stylesheet(Callback callback) const
 Vector<MatchingRule> StyleResolver::collect_matching_rules(const DOM::Element& element) const
 {
     Vector<MatchingRule> matching_rules;
+    Vector<const RuleCache::Entry*> candidates;
+    Optional<AncestorFilter> ancestor_filter;
+
+    auto may_match_ancestors = [&](const RuleCache::Entry& candidate) {
+        if (candidate.ancestor_hashes.is_empty())
+            return true;
+        if (!ancestor_filter.has_value()) {
+            ancestor_filter = AncestorFilter {};
+            for (auto* ancestor = element.parent(); ancestor; ancestor = ancestor->parent()) {
+                if (is<DOM::Element>(*ancestor))
+                    ancestor_filter->add_element(downcast<DOM::Element>(*ancestor));
+            }
+        }
+        return all_of(candidate.ancestor_hashes.begin(), candidate.ancestor_hashes.end(), [&](u32 hash) {
+            return ancestor_filter->may_contain(hash);
+        });
+    };
+
+    ++m_statistics.elements;
 
     size_t style_sheet_index = 0;
     for_each_stylesheet([&](auto& sheet) {
         if (!is<CSSStyleSheet>(sheet))
             return;
-        size_t rule_index = 0;
-        static_cast<const CSSStyleSheet&>(sheet).for_each_effective_style_rule([&](auto& rule) {
-            size_t selector_index = 0;
-            for (auto& selector : rule.selectors()) {
-                if (SelectorEngine::matches(selector, element)) {
-                    matching_rules.append({ rule, style_sheet_index, rule_index, selector_index });
-                    break;
-                }
-                ++selector_index;
-            }
-            ++rule_index;
+
+        candidates.clear_with_capacity();
+        static_cast<const CSSStyleSheet&>(sheet).rule_cache().collect_candidates(element, candidates);
+
+        // The candidates come out bucket by bucket, so put them back in style sheet order.
+        // Like before, a rule only matches once, through the first of its selectors that matches.
+        quick_sort(candidates, [](auto* a, auto* b) {
+            if (a->rule_index == b->rule_index)
+                return a->selector_index < b->selector_index;
+            return a->rule_index < b->rule_index;
         });
+
+        const RuleCache::Entry* last_match = nullptr;
+        for (auto* candidate : candidates) {
+            if (last_match && last_match->rule_index == candidate->rule_index)
+                continue;
+            ++m_statistics.candidate_selectors;
+            if (!may_match_ancestors(*candidate)) {
+                ++m_statistics.selectors_rejected_by_ancestor_filter;
+                continue;
+            }
+            if (SelectorEngine::matches(candidate->rule->selectors()[candidate->selector_index], element)) {
+                matching_rules.append({ candidate->rule, style_sheet_index, candidate->rule_index, candidate->selector_index });
+                last_match = candidate;
+            }
+        }
         ++style_sheet_index;
     });
 
+    m_statistics.matched_rules += matching_rules.size();
     return matching_rules;
 }
 
+InvalidationSet StyleResolver::invalidation_set_for_id(const FlyString& id) const
+{
+    InvalidationSet invalidation_set;
+    for_each_stylesheet([&](auto& sheet) {
+        if (is<CSSStyleSheet>(sheet))
+            invalidation_set.include(static_cast<const CSSStyleSheet&>(sheet).rule_cache().invalidation_set_for_id(id));
+    });
+    return invalidation_set;
+}
+
+InvalidationSet StyleResolver::invalidation_set_for_class(const FlyString& class_name) const
+{
+    InvalidationSet invalidation_set;
+    for_each_stylesheet([&](auto& sheet) {
+        if (is<CSSStyleSheet>(sheet))
+            invalidation_set.include(static_cast<const CSSStyleSheet&>(sheet).rule_cache().invalidation_set_for_class(class_name));
+    });
+    return invalidation_set;
+}
+
+InvalidationSet StyleResolver::invalidation_set_for_attribute(const FlyString& attribute_name) const
+{
+    InvalidationSet invalidation_set;
+    for_each_stylesheet([&](auto& sheet) {
+        if (is<CSSStyleSheet>(sheet))
+            invalidation_set.include(static_cast<const CSSStyleSheet&>(sheet).rule_cache().invalidation_set_for_attribute(attribute_name));
+    });
+    return invalidation_set;
+}
+
 void StyleResolver::sort_matching_rules(Vector<MatchingRule>& matching_rules) const
 {
     quick_sort(matching_rules, [&](MatchingRule& a, MatchingRule& b) {
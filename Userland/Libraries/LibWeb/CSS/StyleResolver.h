@@ -28,6 +28,7 @@
 
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/OwnPtr.h>
+#include <LibWeb/CSS/RuleCache.h>
 #include <LibWeb/CSS/StyleProperties.h>
 #include <LibWeb/Forward.h>
 
@@ -53,13 +54,27 @@ public:
     Vector<MatchingRule> collect_matching_rules(const DOM::Element&) const;
     void sort_matching_rules(Vector<MatchingRule>&) const;
 
+    // What has to be restyled when an element's id, classes or attributes change, across all style sheets.
+    InvalidationSet invalidation_set_for_id(const FlyString&) const;
+    InvalidationSet invalidation_set_for_class(const FlyString&) const;
+    InvalidationSet invalidation_set_for_attribute(const FlyString&) const;
+
     static bool is_inherited_property(CSS::PropertyID);
 
+    struct Statistics {
+        size_t elements { 0 };
+        size_t candidate_selectors { 0 };
+        size_t selectors_rejected_by_ancestor_filter { 0 };
+        size_t matched_rules { 0 };
+    };
+    const Statistics& statistics() const { return m_statistics; }
+
 private:
     template<typename Callback>
     void for_each_stylesheet(Callback) const;
 
     DOM::Document& m_document;
+    mutable Statistics m_statistics;
 };
 
 }
@@ -26,6 +26,7 @@
 
 #include <LibWeb/DOM/CharacterData.h>
 #include <LibWeb/DOM/Document.h>
+#include <LibWeb/Layout/Node.h>
 
 namespace Web::DOM {
 
@@ -44,8 +45,13 @@ void CharacterData::set_data(String data)
     if (m_data == data)
         return;
     m_data = move(data);
-    // FIXME: This is definitely too aggressive.
-    document().schedule_forced_layout();
+    // Text layout nodes read their text straight from the DOM, so relaying them out is enough.
+    if (auto* layout_node = this->layout_node()) {
+        layout_node->set_needs_layout();
+        document().schedule_layout_update();
+    } else if (is_text() && parent()) {
+        parent()->set_needs_layout_tree_update(true);
+    }
 }
 
 }
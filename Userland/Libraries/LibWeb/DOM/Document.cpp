@@ -60,6 +60,9 @@
 #include <LibWeb/InProcessWebView.h>
 #include <LibWeb/Layout/BlockFormattingContext.h>
 #include <LibWeb/Layout/InitialContainingBlockBox.h>
+#include <LibWeb/Layout/ListItemBox.h>
+#include <LibWeb/Layout/TableBox.h>
+#include <LibWeb/Layout/TableRowGroupBox.h>
 #include <LibWeb/Layout/TreeBuilder.h>
 #include <LibWeb/Namespace.h>
 #include <LibWeb/Origin.h>
@@ -82,6 +85,10 @@ Document::Document(const URL& url)
         update_style();
     });
 
+    m_layout_update_timer = Core::Timer::create_single_shot(0, [this] {
+        update_layout();
+    });
+
     m_forced_layout_timer = Core::Timer::create_single_shot(0, [this] {
         force_layout();
     });
@@ -163,6 +170,13 @@ void Document::schedule_style_update()
     m_style_update_timer->start();
 }
 
+void Document::schedule_layout_update()
+{
+    if (m_layout_update_timer->is_active())
+        return;
+    m_layout_update_timer->start();
+}
+
 void Document::schedule_forced_layout()
 {
     if (m_forced_layout_timer->is_active())
@@ -406,19 +420,116 @@ void Document::force_layout()
     update_layout();
 }
 
+static void collect_nodes_needing_layout_tree_update(Node& node, Vector<Node*>& nodes)
+{
+    node.for_each_child([&](auto& child) {
+        if (child.needs_layout_tree_update()) {
+            nodes.append(&child);
+            child.set_needs_layout_tree_update(false);
+        }
+        if (child.child_needs_layout_tree_update()) {
+            collect_nodes_needing_layout_tree_update(child, nodes);
+            child.set_child_needs_layout_tree_update(false);
+        }
+        return IterationDecision::Continue;
+    });
+    if (is<Element>(node)) {
+        if (auto* shadow_root = downcast<Element>(node).shadow_root(); shadow_root && shadow_root->child_needs_layout_tree_update()) {
+            collect_nodes_needing_layout_tree_update(*shadow_root, nodes);
+            shadow_root->set_child_needs_layout_tree_update(false);
+        }
+    }
+}
+
+static bool can_rebuild_layout_children_of(const Layout::Node& layout_node)
+{
+    // We regenerate the children of the nearest block container, since that's where anonymous
+    // wrappers and line boxes live. Boxes whose children are generated or fixed up specially
+    // are left to an ancestor.
+    if (!is<Layout::BlockBox>(layout_node))
+        return false;
+    if (layout_node.is_inline() && !layout_node.is_inline_block())
+        return false;
+    return !is<Layout::InitialContainingBlockBox>(layout_node)
+        && !is<Layout::TableBox>(layout_node)
+        && !is<Layout::TableRowGroupBox>(layout_node)
+        && !is<Layout::ListItemBox>(layout_node);
+}
+
+void Document::update_layout_tree()
+{
+    Vector<Node*> nodes;
+    bool needs_full_rebuild = !m_layout_root || needs_layout_tree_update();
+    collect_nodes_needing_layout_tree_update(*this, nodes);
+    set_needs_layout_tree_update(false);
+    set_child_needs_layout_tree_update(false);
+
+    Vector<Node*> roots;
+    for (auto* node : nodes) {
+        if (needs_full_rebuild)
+            break;
+        // If the node itself isn't rendered, neither are its children.
+        if (!node->layout_node())
+            continue;
+        Node* root = node;
+        while (root && !(root->layout_node() && can_rebuild_layout_children_of(*root->layout_node())))
+            root = root->parent_or_shadow_host();
+        if (!root || root->is_document()) {
+            needs_full_rebuild = true;
+            break;
+        }
+        if (roots.first_matching([&](auto* other) { return other->layout_node()->is_inclusive_ancestor_of(*root->layout_node()); }).has_value())
+            continue;
+        roots.remove_all_matching([&](auto* other) { return root->layout_node()->is_inclusive_ancestor_of(*other->layout_node()); });
+        roots.append(root);
+    }
+
+    if (needs_full_rebuild) {
+        tear_down_layout_tree();
+        Layout::TreeBuilder tree_builder;
+        m_layout_root = static_ptr_cast<Layout::InitialContainingBlockBox>(tree_builder.build(*this));
+        return;
+    }
+
+    if (roots.is_empty())
+        return;
+
+    for (auto* root : roots) {
+        Layout::TreeBuilder tree_builder;
+        tree_builder.rebuild_children(*root);
+    }
+
+    // The stacking contexts and the selection may refer to layout nodes we just threw away.
+    m_layout_root->invalidate_stacking_context_tree();
+    m_layout_root->set_selection({});
+}
+
 void Document::update_layout()
 {
     if (!frame())
         return;
 
-    if (!m_layout_root) {
-        Layout::TreeBuilder tree_builder;
-        m_layout_root = static_ptr_cast<Layout::InitialContainingBlockBox>(tree_builder.build(*this));
+    update_layout_tree();
+
+    auto viewport_size = frame()->viewport_rect().size();
+    if (m_viewport_size_at_last_layout != viewport_size) {
+        m_viewport_size_at_last_layout = viewport_size;
+        m_layout_root->for_each_in_inclusive_subtree([](auto& layout_node) {
+            layout_node.set_needs_layout();
+            return IterationDecision::Continue;
+        });
     }
 
+    if (!m_layout_root->needs_layout() && !m_layout_root->child_needs_layout())
+        return;
+
     Layout::BlockFormattingContext root_formatting_context(*m_layout_root, nullptr);
     root_formatting_context.run(*m_layout_root, Layout::LayoutMode::Default);
 
+    m_layout_root->clear_needs_layout();
+
+    // Anything may have moved, including content outside of the initial containing block.
+    frame()->tile_cache().invalidate_all();
     m_layout_root->set_needs_display();
 
     if (frame()->is_main_frame()) {
@@ -154,6 +154,7 @@ public:
     Layout::InitialContainingBlockBox* layout_node();
 
     void schedule_style_update();
+    void schedule_layout_update();
     void schedule_forced_layout();
 
     NonnullRefPtrVector<Element> get_elements_by_name(const String&) const;
@@ -266,6 +267,7 @@ private:
     virtual EventTarget& global_event_handlers_to_event_target() final { return *this; }
 
     void tear_down_layout_tree();
+    void update_layout_tree();
 
     void increment_referencing_node_count()
     {
@@ -296,12 +298,14 @@ private:
     RefPtr<Window> m_window;
 
     RefPtr<Layout::InitialContainingBlockBox> m_layout_root;
+    Gfx::IntSize m_viewport_size_at_last_layout;
 
     Optional<Color> m_link_color;
     Optional<Color> m_active_link_color;
     Optional<Color> m_visited_link_color;
 
     RefPtr<Core::Timer> m_style_update_timer;
+    RefPtr<Core::Timer> m_layout_update_timer;
     RefPtr<Core::Timer> m_forced_layout_timer;
 
     String m_source;
@@ -44,7 +44,6 @@
 #include <LibWeb/Layout/TableCellBox.h>
 #include <LibWeb/Layout/TableRowBox.h>
 #include <LibWeb/Layout/TableRowGroupBox.h>
-#include <LibWeb/Layout/TreeBuilder.h>
 #include <LibWeb/Namespace.h>
 
 namespace Web::DOM {
@@ -90,7 +89,7 @@ ExceptionOr<void> Element::set_attribute(const FlyString& name, const String& va
     if (name.is_empty())
         return InvalidCharacterError::create("Attribute name must not be empty");
 
-    CSS::StyleInvalidator style_invalidator(document());
+    CSS::StyleInvalidator style_invalidator(*this, name);
 
     if (auto* attribute = find_attribute(name))
         attribute->set_value(value);
@@ -103,7 +102,7 @@ ExceptionOr<void> Element::set_attribute(const FlyString& name, const String& va
 
 void Element::remove_attribute(const FlyString& name)
 {
-    CSS::StyleInvalidator style_invalidator(document());
+    CSS::StyleInvalidator style_invalidator(*this, name);
 
     m_attributes.remove_first_matching([&](auto& attribute) { return attribute.name() == name; });
 }
@@ -221,9 +220,8 @@ void Element::recompute_style()
     if (!layout_node()) {
         if (new_specified_css_values->display() == CSS::Display::None)
             return;
-        // We need a new layout tree here!
-        Layout::TreeBuilder tree_builder;
-        tree_builder.build(*this);
+        // We need a new layout node here, so let our parent regenerate its layout children.
+        parent()->set_needs_layout_tree_update(true);
         return;
     }
 
@@ -232,11 +230,13 @@ void Element::recompute_style()
         diff = compute_style_difference(*old_specified_css_values, *new_specified_css_values, document());
     if (diff == StyleDifference::None)
         return;
-    layout_node()->apply_style(*new_specified_css_values);
     if (diff == StyleDifference::NeedsRelayout) {
-        document().schedule_forced_layout();
+        // The display type changed, so the layout node itself has to be replaced.
+        parent()->set_needs_layout_tree_update(true);
         return;
     }
+    layout_node()->apply_style(*new_specified_css_values);
+    layout_node()->set_needs_layout();
     if (diff == StyleDifference::NeedsRepaint) {
         layout_node()->set_needs_display();
     }
@@ -279,7 +279,6 @@ void Element::set_inner_html(StringView markup)
     }
 
     set_needs_style_update(true);
-    document().invalidate_layout();
 }
 
 String Element::inner_html() const
@@ -109,7 +109,6 @@ void Node::set_text_content(const String& content)
     }
 
     set_needs_style_update(true);
-    document().invalidate_layout();
 }
 
 RefPtr<Layout::Node> Node::create_layout_node()
@@ -278,6 +277,8 @@ void Node::insert_before(NonnullRefPtr<Node> node, RefPtr<Node> child, bool supp
         // FIXME: queue a tree mutation record for parent with nodes, « », previousSibling, and child.
     }
 
+    set_needs_layout_tree_update(true);
+
     children_changed();
 }
 
@@ -331,6 +332,7 @@ void Node::remove(bool suppress_observers)
     // FIXME: Let oldPreviousSibling be node’s previous sibling. (Currently unused so not included)
     // FIXME: Let oldNextSibling be node’s next sibling. (Currently unused so not included)
 
+    parent->set_needs_layout_tree_update(true);
     parent->remove_child(*this);
 
     // FIXME: If node is assigned, then run assign slottables for node’s assigned slot.
@@ -343,6 +345,13 @@ void Node::remove(bool suppress_observers)
 
     removed_from(parent);
 
+    // The layout tree update flags of a disconnected subtree would only go stale.
+    for_each_in_inclusive_subtree([&](Node& inclusive_descendant) {
+        inclusive_descendant.m_needs_layout_tree_update = false;
+        inclusive_descendant.m_child_needs_layout_tree_update = false;
+        return IterationDecision::Continue;
+    });
+
     // FIXME: Let isParentConnected be parent’s connected. (Currently unused so not included)
 
     // FIXME: If node is custom and isParentConnected is true, then enqueue a custom element callback reaction with node,
@@ -487,6 +496,24 @@ void Node::set_needs_style_update(bool value)
     }
 }
 
+void Node::set_needs_layout_tree_update(bool value)
+{
+    if (m_needs_layout_tree_update == value)
+        return;
+
+    // Disconnected nodes have no layout tree to update. Whoever inserts them takes care of it.
+    if (value && !is_connected())
+        return;
+
+    m_needs_layout_tree_update = value;
+
+    if (m_needs_layout_tree_update) {
+        for (auto* ancestor = parent_or_shadow_host(); ancestor; ancestor = ancestor->parent_or_shadow_host())
+            ancestor->m_child_needs_layout_tree_update = true;
+        document().schedule_layout_update();
+    }
+}
+
 void Node::inserted()
 {
     set_needs_style_update(true);
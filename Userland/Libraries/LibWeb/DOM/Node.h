@@ -165,6 +165,13 @@ public:
 
     void invalidate_style();
 
+    // Set on a node whose layout children no longer match its DOM children.
+    bool needs_layout_tree_update() const { return m_needs_layout_tree_update; }
+    void set_needs_layout_tree_update(bool);
+
+    bool child_needs_layout_tree_update() const { return m_child_needs_layout_tree_update; }
+    void set_child_needs_layout_tree_update(bool b) { m_child_needs_layout_tree_update = b; }
+
     bool is_link() const;
 
     void set_document(Badge<Document>, Document&);
@@ -186,6 +193,8 @@ protected:
     NodeType m_type { NodeType::INVALID };
     bool m_needs_style_update { false };
     bool m_child_needs_style_update { false };
+    bool m_needs_layout_tree_update { false };
+    bool m_child_needs_layout_tree_update { false };
 };
 
 }
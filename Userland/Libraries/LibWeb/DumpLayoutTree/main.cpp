@@ -27,6 +27,8 @@
 #include <LibCore/ArgsParser.h>
 #include <LibGUI/Application.h>
 #include <LibGUI/Window.h>
+#include <LibWeb/CSS/StyleResolver.h>
+#include <LibWeb/DOM/Document.h>
 #include <LibWeb/Dump.h>
 #include <LibWeb/InProcessWebView.h>
 #include <LibWeb/Layout/InitialContainingBlockBox.h>
@@ -34,13 +36,21 @@
 
 int main(int argc, char** argv)
 {
+    const char* path = nullptr;
+    bool dump_style_statistics = false;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(dump_style_statistics, "Print selector matching statistics to stderr", "style-statistics", 's');
+    args_parser.add_positional_argument(path, "HTML file to lay out", "file");
+    args_parser.parse(argc, argv);
+
     auto app = GUI::Application::construct(argc, argv);
     auto window = GUI::Window::construct();
     window->set_title("DumpLayoutTree");
     window->resize(800, 600);
     window->show();
     auto& web_view = window->set_main_widget<Web::InProcessWebView>();
-    web_view.load(URL::create_with_file_protocol(argv[1]));
+    web_view.load(URL::create_with_file_protocol(path));
     web_view.on_load_finish = [&](auto&) {
         auto* document = web_view.document();
         if (!document) {
@@ -55,6 +65,13 @@ int main(int argc, char** argv)
         StringBuilder builder;
         Web::dump_tree(builder, *layout_root);
         write(STDOUT_FILENO, builder.string_view().characters_without_null_termination(), builder.length());
+        if (dump_style_statistics) {
+            auto& statistics = document->style_resolver().statistics();
+            warnln("Elements matched: {}", statistics.elements);
+            warnln("Candidate selectors: {}", statistics.candidate_selectors);
+            warnln("Rejected by ancestor filter: {}", statistics.selectors_rejected_by_ancestor_filter);
+            warnln("Matched rules: {}", statistics.matched_rules);
+        }
         _exit(0);
     };
     return app->exec();
@@ -41,16 +41,34 @@ HTMLImageElement::HTMLImageElement(DOM::Document& document, QualifiedName qualif
     , m_image_loader(*this)
 {
     m_image_loader.on_load = [this] {
+        if (layout_node())
+            layout_node()->set_needs_layout();
         this->document().update_layout();
         dispatch_event(DOM::Event::create(EventNames::load));
     };
 
     m_image_loader.on_fail = [this] {
         dbgln("HTMLImageElement: Resource did fail: {}", src());
+        if (layout_node())
+            layout_node()->set_needs_layout();
         this->document().update_layout();
         dispatch_event(DOM::Event::create(EventNames::error));
     };
 
+    m_image_loader.on_partial_load = [this] {
+        // The first partial image gives us our intrinsic size, after that we only need to repaint.
+        if (is<Layout::ImageBox>(layout_node())) {
+            auto& image_box = downcast<Layout::ImageBox>(*layout_node());
+            if (image_box.intrinsic_width() == m_image_loader.width() && image_box.intrinsic_height() == m_image_loader.height()) {
+                image_box.set_needs_display();
+                return;
+            }
+        }
+        if (layout_node())
+            layout_node()->set_needs_layout();
+        this->document().update_layout();
+    };
+
     m_image_loader.on_animate = [this] {
         if (layout_node())
             layout_node()->set_needs_display();
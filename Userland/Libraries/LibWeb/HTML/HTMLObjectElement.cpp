@@ -40,12 +40,16 @@ HTMLObjectElement::HTMLObjectElement(DOM::Document& document, QualifiedName qual
 {
     m_image_loader.on_load = [this] {
         m_should_show_fallback_content = false;
-        this->document().force_layout();
+        if (parent())
+            parent()->set_needs_layout_tree_update(true);
+        this->document().update_layout();
     };
 
     m_image_loader.on_fail = [this] {
         m_should_show_fallback_content = true;
-        this->document().force_layout();
+        if (parent())
+            parent()->set_needs_layout_tree_update(true);
+        this->document().update_layout();
     };
 }
 
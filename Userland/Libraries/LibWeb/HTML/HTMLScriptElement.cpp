@@ -228,19 +228,15 @@ void HTMLScriptElement::prepare_script()
 
             // FIXME: This load should be made asynchronous and the parser should spin an event loop etc.
             m_script_filename = url.basename();
-            ResourceLoader::the().load_sync(
-                request,
-                [this, url](auto data, auto&, auto) {
-                    if (data.is_null()) {
-                        dbgln("HTMLScriptElement: Failed to load {}", url);
-                        return;
-                    }
-                    m_script_source = String::copy(data);
-                    script_became_ready();
-                },
-                [this](auto&, auto) {
-                    m_failed_to_load = true;
-                });
+            auto resource = ResourceLoader::the().load_resource_sync(Resource::Type::Generic, request);
+            if (!resource || resource->is_failed()) {
+                m_failed_to_load = true;
+            } else if (!resource->has_encoded_data()) {
+                dbgln("HTMLScriptElement: Failed to load {}", url);
+            } else {
+                m_script_source = String::copy(resource->encoded_data());
+                script_became_ready();
+            }
         } else {
             TODO();
         }
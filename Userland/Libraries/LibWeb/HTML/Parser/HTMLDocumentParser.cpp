@@ -25,7 +25,10 @@
  */
 
 #include <AK/Debug.h>
+#include <AK/TemporaryChange.h>
 #include <AK/Utf32View.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/Timer.h>
 #include <LibTextCodec/Decoder.h>
 #include <LibWeb/DOM/Comment.h>
 #include <LibWeb/DOM/Document.h>
@@ -41,6 +44,7 @@
 #include <LibWeb/HTML/HTMLTableElement.h>
 #include <LibWeb/HTML/HTMLTemplateElement.h>
 #include <LibWeb/HTML/Parser/HTMLDocumentParser.h>
+#include <LibWeb/HTML/Parser/HTMLPreloadScanner.h>
 #include <LibWeb/HTML/Parser/HTMLToken.h>
 #include <LibWeb/Namespace.h>
 #include <LibWeb/SVG/TagNames.h>
@@ -133,36 +137,107 @@ HTMLDocumentParser::~HTMLDocumentParser()
 
 void HTMLDocumentParser::run(const URL& url)
 {
-    m_document->set_url(url);
-    m_document->set_source(m_tokenizer.source());
+    begin(url);
+    while (process_next_token()) { }
+    the_end();
+}
+
+void HTMLDocumentParser::run_incrementally(const URL& url, Function<void()> on_finish)
+{
+    begin(url);
+    m_on_incremental_parsing_finished = move(on_finish);
+    m_incremental_parsing_timer = Core::Timer::create_single_shot(0, [this] {
+        run_incremental_parsing_slice();
+    });
+    run_incremental_parsing_slice();
+}
+
+void HTMLDocumentParser::abort()
+{
+    m_aborted = true;
+    m_stop_parsing = true;
+    m_on_incremental_parsing_finished = nullptr;
+    if (m_incremental_parsing_timer)
+        m_incremental_parsing_timer->stop();
+    m_document->set_should_invalidate_styles_on_attribute_changes(true);
+}
+
+void HTMLDocumentParser::run_incremental_parsing_slice()
+{
+    TemporaryChange running_slice_change(m_running_slice, true);
+
+    // Style invalidation is only suppressed while we're building the tree ourselves,
+    // other changes to the document in between slices still need to invalidate.
+    m_document->set_should_invalidate_styles_on_attribute_changes(false);
+
+    Core::ElapsedTimer elapsed_timer;
+    elapsed_timer.start();
 
     for (;;) {
-        auto optional_token = m_tokenizer.next_token();
-        if (!optional_token.has_value())
-            break;
-        auto& token = optional_token.value();
-
-        dbgln_if(PARSER_DEBUG, "[{}] {}", insertion_mode_name(), token.to_string());
-
-        // FIXME: If the adjusted current node is a MathML text integration point and the token is a start tag whose tag name is neither "mglyph" nor "malignmark"
-        // FIXME: If the adjusted current node is a MathML text integration point and the token is a character token
-        // FIXME: If the adjusted current node is a MathML annotation-xml element and the token is a start tag whose tag name is "svg"
-        // FIXME: If the adjusted current node is an HTML integration point and the token is a start tag
-        // FIXME: If the adjusted current node is an HTML integration point and the token is a character token
-        if (m_stack_of_open_elements.is_empty()
-            || adjusted_current_node().namespace_() == Namespace::HTML
-            || token.is_end_of_file()) {
-            process_using_the_rules_for(m_insertion_mode, token);
-        } else {
-            process_using_the_rules_for_foreign_content(token);
+        if (!process_next_token()) {
+            if (m_aborted)
+                return;
+            the_end();
+            // NOTE: Finishing may abort us as a side effect (e.g. by navigating), so take the callback out first.
+            if (auto on_finish = move(m_on_incremental_parsing_finished))
+                on_finish();
+            return;
         }
-
-        if (m_stop_parsing) {
-            dbgln_if(PARSER_DEBUG, "Stop parsing{}! :^)", m_parsing_fragment ? " fragment" : "");
+        if (elapsed_timer.elapsed() >= incremental_parsing_time_budget_ms)
             break;
-        }
     }
 
+    if (m_aborted)
+        return;
+
+    dbgln_if(PARSER_DEBUG, "Yielding to the event loop after {} ms of parsing", elapsed_timer.elapsed());
+
+    // Make the text parsed so far visible. The document may change before the next slice,
+    // so the insertion node has to be looked up again afterwards.
+    flush_character_insertions();
+    m_character_insertion_node = nullptr;
+
+    m_document->set_should_invalidate_styles_on_attribute_changes(true);
+    m_incremental_parsing_timer->start();
+}
+
+void HTMLDocumentParser::begin(const URL& url)
+{
+    m_document->set_url(url);
+    m_document->set_source(m_tokenizer.source());
+}
+
+bool HTMLDocumentParser::process_next_token()
+{
+    auto optional_token = m_tokenizer.next_token();
+    if (!optional_token.has_value())
+        return false;
+    auto& token = optional_token.value();
+
+    dbgln_if(PARSER_DEBUG, "[{}] {}", insertion_mode_name(), token.to_string());
+
+    // FIXME: If the adjusted current node is a MathML text integration point and the token is a start tag whose tag name is neither "mglyph" nor "malignmark"
+    // FIXME: If the adjusted current node is a MathML text integration point and the token is a character token
+    // FIXME: If the adjusted current node is a MathML annotation-xml element and the token is a start tag whose tag name is "svg"
+    // FIXME: If the adjusted current node is an HTML integration point and the token is a start tag
+    // FIXME: If the adjusted current node is an HTML integration point and the token is a character token
+    if (m_stack_of_open_elements.is_empty()
+        || adjusted_current_node().namespace_() == Namespace::HTML
+        || token.is_end_of_file()) {
+        process_using_the_rules_for(m_insertion_mode, token);
+    } else {
+        process_using_the_rules_for_foreign_content(token);
+    }
+
+    if (m_stop_parsing) {
+        dbgln_if(PARSER_DEBUG, "Stop parsing{}! :^)", m_parsing_fragment ? " fragment" : "");
+        return false;
+    }
+    return true;
+}
+
+void HTMLDocumentParser::the_end()
+{
     flush_character_insertions();
 
     // "The end"
@@ -193,6 +268,8 @@ void HTMLDocumentParser::run(const URL& url)
 
     m_document->set_ready_for_post_load_tasks(true);
     m_document->completely_finish_loading();
+
+    m_document->set_should_invalidate_styles_on_attribute_changes(true);
 }
 
 void HTMLDocumentParser::process_using_the_rules_for(InsertionMode mode, HTMLToken& token)
@@ -732,8 +809,14 @@ void HTMLDocumentParser::flush_character_insertions()
 {
     if (m_character_insertion_builder.is_empty())
         return;
-    m_character_insertion_node->set_data(m_character_insertion_builder.to_string());
-    m_character_insertion_node->parent()->children_changed();
+    // The node already has text in it if we flushed in the middle of a run of characters, e.g. when yielding to the event loop.
+    auto& existing_data = m_character_insertion_node->data();
+    if (existing_data.is_empty())
+        m_character_insertion_node->set_data(m_character_insertion_builder.to_string());
+    else
+        m_character_insertion_node->set_data(String::formatted("{}{}", existing_data, m_character_insertion_builder.string_view()));
+    if (auto* parent = m_character_insertion_node->parent())
+        parent->children_changed();
     m_character_insertion_builder.clear();
 }
 
@@ -1884,6 +1967,18 @@ void HTMLDocumentParser::decrement_script_nesting_level()
     --m_script_nesting_level;
 }
 
+void HTMLDocumentParser::run_the_preload_scanner_if_needed()
+{
+    // The whole input is available up front, so a single pass over the rest of it is enough.
+    if (m_did_run_preload_scanner || m_parsing_fragment)
+        return;
+    m_did_run_preload_scanner = true;
+
+    // Fetching the script will block the parser, so get the loads for everything after it going in the meantime.
+    HTMLPreloadScanner preload_scanner(document(), m_tokenizer.remaining_source());
+    preload_scanner.run();
+}
+
 void HTMLDocumentParser::handle_text(HTMLToken& token)
 {
     if (token.is_character()) {
@@ -1907,6 +2002,8 @@ void HTMLDocumentParser::handle_text(HTMLToken& token)
         m_stack_of_open_elements.pop();
         m_insertion_mode = m_original_insertion_mode;
         // FIXME: Handle tokenizer insertion point stuff here.
+        if (script->has_attribute(HTML::AttributeNames::src))
+            run_the_preload_scanner_if_needed();
         increment_script_nesting_level();
         script->prepare_script({});
         decrement_script_nesting_level();
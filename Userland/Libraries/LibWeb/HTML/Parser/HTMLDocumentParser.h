@@ -26,7 +26,9 @@
 
 #pragma once
 
+#include <AK/Function.h>
 #include <AK/NonnullRefPtrVector.h>
+#include <LibCore/Forward.h>
 #include <LibWeb/DOM/Node.h>
 #include <LibWeb/HTML/Parser/HTMLTokenizer.h>
 #include <LibWeb/HTML/Parser/ListOfActiveFormattingElements.h>
@@ -68,6 +70,17 @@ public:
 
     void run(const URL&);
 
+    // Parses the document in slices of a few milliseconds, returning to the event loop in between
+    // so that the page can paint and handle input while it's loading. on_finish is called once
+    // the whole document has been parsed.
+    void run_incrementally(const URL&, Function<void()> on_finish);
+
+    // Stops an incremental parse without running "the end" of it.
+    void abort();
+
+    // Whether we're in the middle of a slice of an incremental parse, e.g. waiting for a script to load.
+    bool is_running_slice() const { return m_running_slice; }
+
     DOM::Document& document();
 
     static NonnullRefPtrVector<DOM::Node> parse_html_fragment(DOM::Element& context_element, const StringView&);
@@ -83,8 +96,15 @@ public:
     static bool is_special_tag(const FlyString& tag_name, const FlyString& namespace_);
 
 private:
+    static constexpr int incremental_parsing_time_budget_ms = 10;
+
     const char* insertion_mode_name() const;
 
+    void begin(const URL&);
+    bool process_next_token();
+    void run_incremental_parsing_slice();
+    void the_end();
+
     DOM::QuirksMode which_quirks_mode(const HTMLToken&) const;
 
     void handle_initial(HTMLToken&);
@@ -143,6 +163,7 @@ private:
     void decrement_script_nesting_level();
     size_t script_nesting_level() const { return m_script_nesting_level; }
     void reset_the_insertion_mode_appropriately();
+    void run_the_preload_scanner_if_needed();
 
     void adjust_mathml_attributes(HTMLToken&);
     void adjust_svg_tag_names(HTMLToken&);
@@ -177,6 +198,11 @@ private:
     bool m_aborted { false };
     bool m_parser_pause_flag { false };
     bool m_stop_parsing { false };
+    bool m_did_run_preload_scanner { false };
+
+    bool m_running_slice { false };
+    RefPtr<Core::Timer> m_incremental_parsing_timer;
+    Function<void()> m_on_incremental_parsing_finished;
     size_t m_script_nesting_level { 0 };
 
     NonnullRefPtr<DOM::Document> m_document;
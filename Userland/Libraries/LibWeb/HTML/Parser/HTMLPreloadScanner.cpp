@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/Debug.h>
+#include <LibWeb/DOM/Document.h>
+#include <LibWeb/HTML/AttributeNames.h>
+#include <LibWeb/HTML/Parser/HTMLPreloadScanner.h>
+#include <LibWeb/HTML/TagNames.h>
+#include <LibWeb/Loader/LoadRequest.h>
+#include <LibWeb/Loader/ResourceLoader.h>
+
+namespace Web::HTML {
+
+HTMLPreloadScanner::HTMLPreloadScanner(DOM::Document& document, const StringView& input)
+    : m_document(document)
+    , m_tokenizer(input, "utf-8")
+{
+}
+
+void HTMLPreloadScanner::run()
+{
+    for (auto& preload : scan()) {
+        dbgln_if(PARSER_DEBUG, "Preload scanner: Fetching {}", preload.url);
+        ResourceLoader::the().load_resource(preload.type, LoadRequest::create_for_url_on_page(preload.url, m_document.page()));
+    }
+}
+
+Vector<HTMLPreloadScanner::Preload> HTMLPreloadScanner::scan()
+{
+    for (;;) {
+        auto optional_token = m_tokenizer.next_token();
+        if (!optional_token.has_value())
+            break;
+        auto& token = optional_token.value();
+        if (token.is_end_of_file())
+            break;
+        if (!token.is_start_tag())
+            continue;
+        if (token.tag_name() == HTML::TagNames::plaintext)
+            break;
+        handle_start_tag(token);
+    }
+    return move(m_preloads);
+}
+
+void HTMLPreloadScanner::handle_start_tag(HTMLToken& token)
+{
+    auto tag_name = token.tag_name();
+
+    if (tag_name == HTML::TagNames::script) {
+        if (token.has_attribute(HTML::AttributeNames::src))
+            preload(Resource::Type::Generic, token.attribute(HTML::AttributeNames::src));
+        m_tokenizer.preload_scanner_switch_to({}, HTMLTokenizer::State::ScriptData);
+        return;
+    }
+
+    if (tag_name == HTML::TagNames::link) {
+        bool is_stylesheet = false;
+        bool is_alternate = false;
+        for (auto& part : token.attribute(HTML::AttributeNames::rel).split_view(' ')) {
+            if (part == "stylesheet")
+                is_stylesheet = true;
+            else if (part == "alternate")
+                is_alternate = true;
+        }
+        if (is_stylesheet && !is_alternate)
+            preload(Resource::Type::Generic, token.attribute(HTML::AttributeNames::href));
+        return;
+    }
+
+    if (tag_name == HTML::TagNames::img) {
+        preload(Resource::Type::Image, token.attribute(HTML::AttributeNames::src));
+        return;
+    }
+
+    // Keep the tokenizer in step with the tree builder so that the contents of
+    // these elements aren't mistaken for markup.
+    if (tag_name == HTML::TagNames::title || tag_name == HTML::TagNames::textarea) {
+        m_tokenizer.preload_scanner_switch_to({}, HTMLTokenizer::State::RCDATA);
+        return;
+    }
+
+    if (tag_name.is_one_of(HTML::TagNames::style, HTML::TagNames::xmp, HTML::TagNames::iframe, HTML::TagNames::noembed, HTML::TagNames::noframes, HTML::TagNames::noscript))
+        m_tokenizer.preload_scanner_switch_to({}, HTMLTokenizer::State::RAWTEXT);
+}
+
+void HTMLPreloadScanner::preload(Resource::Type type, const StringView& url_string)
+{
+    if (url_string.is_empty())
+        return;
+
+    auto url = m_document.complete_url(url_string);
+    if (!url.is_valid())
+        return;
+
+    // Local files aren't kept in the resource cache, so fetching them early would only mean loading them twice.
+    if (url.protocol() == "file")
+        return;
+
+    m_preloads.append({ type, move(url) });
+}
+
+}
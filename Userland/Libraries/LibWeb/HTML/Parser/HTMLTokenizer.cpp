@@ -2632,6 +2632,12 @@ void HTMLTokenizer::switch_to(Badge<HTMLDocumentParser>, State new_state)
     m_state = new_state;
 }
 
+void HTMLTokenizer::preload_scanner_switch_to(Badge<HTMLPreloadScanner>, State new_state)
+{
+    dbgln_if(TOKENIZER_TRACE_DEBUG, "[{}] Preload scanner switches tokenizer state to {}", state_name(m_state), state_name(new_state));
+    m_state = new_state;
+}
+
 void HTMLTokenizer::will_emit(HTMLToken& token)
 {
     if (token.is_start_tag())
@@ -130,12 +130,16 @@ public:
     Optional<HTMLToken> next_token();
 
     void switch_to(Badge<HTMLDocumentParser>, State new_state);
+    void preload_scanner_switch_to(Badge<HTMLPreloadScanner>, State new_state);
 
     void set_blocked(bool b) { m_blocked = b; }
     bool is_blocked() const { return m_blocked; }
 
     String source() const { return m_decoded_input; }
 
+    // The part of the input that has not been consumed yet.
+    StringView remaining_source() const { return m_decoded_input.substring_view(m_utf8_view.byte_offset_of(m_utf8_iterator)); }
+
 private:
     Optional<u32> next_code_point();
     Optional<u32> peek_code_point(size_t offset) const;
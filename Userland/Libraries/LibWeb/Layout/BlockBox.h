@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <AK/Optional.h>
 #include <LibWeb/Layout/Box.h>
 #include <LibWeb/Layout/LineBox.h>
 
@@ -57,6 +58,21 @@ public:
     const Gfx::FloatPoint& scroll_offset() const { return m_scroll_offset; }
     void set_scroll_offset(const Gfx::FloatPoint&);
 
+    struct IntrinsicWidths {
+        float preferred_width { 0 };
+        float preferred_minimum_width { 0 };
+    };
+
+    // The intrinsic widths are only valid while this box (and its subtree) doesn't need layout.
+    const Optional<IntrinsicWidths>& cached_intrinsic_widths() const { return m_cached_intrinsic_widths; }
+    void set_cached_intrinsic_widths(const IntrinsicWidths& widths) { m_cached_intrinsic_widths = widths; }
+    void invalidate_cached_intrinsic_widths() { m_cached_intrinsic_widths = {}; }
+
+    // The containing block size this box was last laid out against in LayoutMode::Default.
+    // A clean box whose containing block size hasn't changed can keep its previous geometry.
+    const Optional<Gfx::FloatSize>& containing_block_size_at_last_layout() const { return m_containing_block_size_at_last_layout; }
+    void set_containing_block_size_at_last_layout(Optional<Gfx::FloatSize> size) { m_containing_block_size_at_last_layout = size; }
+
 private:
     virtual bool is_block_box() const final { return true; }
     virtual bool wants_mouse_events() const override { return true; }
@@ -65,6 +81,9 @@ private:
     bool should_clip_overflow() const;
 
     Gfx::FloatPoint m_scroll_offset;
+
+    Optional<IntrinsicWidths> m_cached_intrinsic_widths;
+    Optional<Gfx::FloatSize> m_containing_block_size_at_last_layout;
 };
 
 template<>
@@ -348,6 +348,49 @@ void BlockFormattingContext::layout_inline_children(Box& box, LayoutMode layout_
     context.run(box, layout_mode);
 }
 
+// Whether laying out this subtree may read the height of a containing block. Only the box whose
+// style changed is marked as needing layout, so a clean subtree like this could end up with stale geometry.
+static bool may_depend_on_containing_block_height(const Box& box)
+{
+    bool depends = false;
+    box.for_each_in_inclusive_subtree_of_type<Box>([&](auto& descendant) {
+        auto& computed_values = descendant.computed_values();
+        if (descendant.is_absolutely_positioned()
+            || computed_values.height().is_percentage()
+            || computed_values.min_height().is_percentage()
+            || computed_values.max_height().is_percentage()) {
+            depends = true;
+            return IterationDecision::Break;
+        }
+        return IterationDecision::Continue;
+    });
+    return depends;
+}
+
+static Gfx::FloatSize containing_block_size(const Box& box)
+{
+    auto* containing_block = box.containing_block();
+    VERIFY(containing_block);
+    return { containing_block->width(), containing_block->height() };
+}
+
+bool BlockFormattingContext::can_reuse_previous_layout(const Box& child_box, LayoutMode layout_mode) const
+{
+    if (layout_mode != LayoutMode::Default)
+        return false;
+    if (!is<BlockBox>(child_box))
+        return false;
+    if (child_box.needs_layout() || child_box.child_needs_layout())
+        return false;
+
+    // Floats earlier in this formatting context may affect the child's line boxes.
+    if (!m_left_floating_boxes.is_empty() || !m_right_floating_boxes.is_empty())
+        return false;
+
+    auto& previous_size = downcast<BlockBox>(child_box).containing_block_size_at_last_layout();
+    return previous_size.has_value() && previous_size.value() == containing_block_size(child_box);
+}
+
 void BlockFormattingContext::layout_block_level_children(Box& box, LayoutMode layout_mode)
 {
     float content_height = 0;
@@ -362,9 +405,22 @@ void BlockFormattingContext::layout_block_level_children(Box& box, LayoutMode la
             return IterationDecision::Continue;
         }
 
-        compute_width(child_box);
-        layout_inside(child_box, layout_mode);
-        compute_height(child_box);
+        if (!can_reuse_previous_layout(child_box, layout_mode)) {
+            auto float_count_before = m_left_floating_boxes.size() + m_right_floating_boxes.size();
+
+            compute_width(child_box);
+            layout_inside(child_box, layout_mode);
+            compute_height(child_box);
+
+            if (is<BlockBox>(child_box)) {
+                // If the child placed floats into this formatting context, skipping it next time would lose them.
+                bool added_floats = m_left_floating_boxes.size() + m_right_floating_boxes.size() != float_count_before;
+                if (layout_mode == LayoutMode::Default && !added_floats && !may_depend_on_containing_block_height(child_box))
+                    downcast<BlockBox>(child_box).set_containing_block_size_at_last_layout(containing_block_size(child_box));
+                else
+                    downcast<BlockBox>(child_box).set_containing_block_size_at_last_layout({});
+            }
+        }
 
         if (child_box.computed_values().position() == CSS::Position::Relative)
             compute_position(child_box);
@@ -59,6 +59,7 @@ private:
     void layout_initial_containing_block(LayoutMode);
 
     void layout_block_level_children(Box&, LayoutMode);
+    bool can_reuse_previous_layout(const Box& child, LayoutMode) const;
     void layout_inline_children(Box&, LayoutMode);
 
     void place_block_level_replaced_element_in_normal_flow(Box& child, Box& container);
@@ -25,6 +25,7 @@
  */
 
 #include <LibWeb/Dump.h>
+#include <LibWeb/Layout/BlockBox.h>
 #include <LibWeb/Layout/BlockFormattingContext.h>
 #include <LibWeb/Layout/Box.h>
 #include <LibWeb/Layout/FlexFormattingContext.h>
@@ -128,6 +129,13 @@ static float greatest_child_width(const Box& box)
 
 FormattingContext::ShrinkToFitResult FormattingContext::calculate_shrink_to_fit_widths(Box& box)
 {
+    // The intrinsic widths only depend on the box contents, so a clean block can reuse them from its last layout.
+    auto* block = is<BlockBox>(box) ? &downcast<BlockBox>(box) : nullptr;
+    if (block && !block->needs_layout() && !block->child_needs_layout() && block->cached_intrinsic_widths().has_value()) {
+        auto& cached = block->cached_intrinsic_widths().value();
+        return { cached.preferred_width, cached.preferred_minimum_width };
+    }
+
     // Calculate the preferred width by formatting the content without breaking lines
     // other than where explicit line breaks occur.
     layout_inside(box, LayoutMode::OnlyRequiredLineBreaks);
@@ -139,6 +147,9 @@ FormattingContext::ShrinkToFitResult FormattingContext::calculate_shrink_to_fit_
     layout_inside(box, LayoutMode::AllPossibleLineBreaks);
     float preferred_minimum_width = greatest_child_width(box);
 
+    if (block)
+        block->set_cached_intrinsic_widths({ preferred_width, preferred_minimum_width });
+
     return { preferred_width, preferred_minimum_width };
 }
 
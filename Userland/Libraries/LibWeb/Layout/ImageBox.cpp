@@ -56,7 +56,7 @@ int ImageBox::preferred_height() const
 
 void ImageBox::prepare_for_replaced_layout()
 {
-    if (!m_image_loader.has_loaded_or_failed()) {
+    if (!m_image_loader.has_loaded_or_failed() && !m_image_loader.has_image()) {
         set_has_intrinsic_width(true);
         set_has_intrinsic_height(true);
         set_intrinsic_width(0);
@@ -116,7 +116,18 @@ void ImageBox::paint(PaintContext& context, PaintPhase phase)
                 alt = image_element.src();
             context.painter().draw_text(enclosing_int_rect(absolute_rect()), alt, Gfx::TextAlignment::Center, computed_values().color(), Gfx::TextElision::Right);
         } else if (auto bitmap = m_image_loader.bitmap(m_image_loader.current_frame_index())) {
-            context.painter().draw_scaled_bitmap(enclosing_int_rect(absolute_rect()), *bitmap, bitmap->rect());
+            auto rect = enclosing_int_rect(absolute_rect());
+            auto source_rect = bitmap->rect();
+
+            // Only paint the part of a still loading image that has been decoded.
+            auto available_rows = m_image_loader.available_rows(m_image_loader.current_frame_index());
+            if (available_rows < bitmap->height()) {
+                rect.set_height(rect.height() * available_rows / bitmap->height());
+                source_rect.set_height(available_rows);
+            }
+
+            if (!rect.is_empty())
+                context.painter().draw_scaled_bitmap(rect, *bitmap, source_rect);
         }
     }
 }
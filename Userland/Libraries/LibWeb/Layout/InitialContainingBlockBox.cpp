@@ -47,6 +47,7 @@ void InitialContainingBlockBox::build_stacking_context_tree()
         return;
 
     set_stacking_context(make<StackingContext>(*this, nullptr));
+    m_has_fixed_position_boxes = false;
 
     for_each_in_inclusive_subtree_of_type<Box>([&](Box& box) {
         if (&box == this)
@@ -55,11 +56,23 @@ void InitialContainingBlockBox::build_stacking_context_tree()
             VERIFY(!box.stacking_context());
             return IterationDecision::Continue;
         }
+        if (box.is_fixed_position())
+            m_has_fixed_position_boxes = true;
         auto* parent_context = box.enclosing_stacking_context();
         VERIFY(parent_context);
         box.set_stacking_context(make<StackingContext>(box, parent_context));
         return IterationDecision::Continue;
     });
+
+    stacking_context()->sort();
+}
+
+void InitialContainingBlockBox::invalidate_stacking_context_tree()
+{
+    for_each_in_inclusive_subtree_of_type<Box>([&](Box& box) {
+        box.clear_stacking_context();
+        return IterationDecision::Continue;
+    });
 }
 
 void InitialContainingBlockBox::paint_document_background(PaintContext& context)
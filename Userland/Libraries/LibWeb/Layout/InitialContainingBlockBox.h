@@ -50,11 +50,15 @@ public:
     void set_selection_end(const LayoutPosition&);
 
     void build_stacking_context_tree();
+    void invalidate_stacking_context_tree();
+
+    bool has_fixed_position_boxes() const { return m_has_fixed_position_boxes; }
 
     void recompute_selection_states();
 
 private:
     LayoutRange m_selection;
+    bool m_has_fixed_position_boxes { false };
 };
 
 }
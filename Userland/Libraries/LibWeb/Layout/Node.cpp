@@ -145,6 +145,12 @@ void Node::split_into_lines(InlineFormattingContext& context, LayoutMode layout_
 
 void Node::set_needs_display()
 {
+    // Block-level boxes don't live in line boxes, so there are no fragments to go by.
+    if (is<Box>(*this) && !is_inline()) {
+        frame().set_needs_display(enclosing_int_rect(downcast<Box>(*this).absolute_rect()));
+        return;
+    }
+
     if (auto* block = containing_block()) {
         block->for_each_fragment([&](auto& fragment) {
             if (&fragment.layout_node() == this || is_ancestor_of(fragment.layout_node())) {
@@ -155,6 +161,39 @@ void Node::set_needs_display()
     }
 }
 
+void Node::set_needs_layout()
+{
+    m_needs_layout = true;
+    if (is<BlockBox>(*this))
+        downcast<BlockBox>(*this).invalidate_cached_intrinsic_widths();
+
+    for (auto* ancestor = parent(); ancestor; ancestor = ancestor->parent()) {
+        if (is<BlockBox>(*ancestor))
+            downcast<BlockBox>(*ancestor).invalidate_cached_intrinsic_widths();
+        if (ancestor->m_child_needs_layout)
+            break;
+        ancestor->m_child_needs_layout = true;
+    }
+}
+
+void Node::clear_needs_layout()
+{
+    if (m_needs_layout) {
+        for_each_in_inclusive_subtree([](auto& node) {
+            node.m_needs_layout = false;
+            node.m_child_needs_layout = false;
+            return IterationDecision::Continue;
+        });
+        return;
+    }
+    if (!m_child_needs_layout)
+        return;
+    m_child_needs_layout = false;
+    for_each_child([](auto& child) {
+        child.clear_needs_layout();
+    });
+}
+
 Gfx::FloatPoint Node::box_type_agnostic_position() const
 {
     if (is<Box>(*this))
@@ -151,6 +151,15 @@ public:
 
     virtual void set_needs_display();
 
+    bool needs_layout() const { return m_needs_layout; }
+    bool child_needs_layout() const { return m_child_needs_layout; }
+
+    // Marks this node for relayout and flags all ancestors as having a dirty descendant.
+    void set_needs_layout();
+
+    // Clears the layout dirty bits in the parts of this subtree that were flagged.
+    void clear_needs_layout();
+
     bool children_are_inline() const { return m_children_are_inline; }
     void set_children_are_inline(bool value) { m_children_are_inline = value; }
 
@@ -199,6 +208,8 @@ private:
     bool m_has_style { false };
     bool m_visible { true };
     bool m_children_are_inline { false };
+    bool m_needs_layout { true };
+    bool m_child_needs_layout { false };
     SelectionState m_selection_state { SelectionState::None };
 };
 
@@ -152,6 +152,43 @@ RefPtr<Node> TreeBuilder::build(DOM::Node& dom_node)
     return move(m_layout_root);
 }
 
+void TreeBuilder::rebuild_children(DOM::Node& dom_node)
+{
+    auto* layout_node = dom_node.layout_node();
+    VERIFY(layout_node);
+    VERIFY(layout_node->can_have_children());
+
+    // Keep the old children alive until we're done, so their DOM nodes don't lose track of
+    // them in the middle of the rebuild.
+    NonnullRefPtrVector<Layout::Node> old_children;
+    while (RefPtr<Layout::Node> child = layout_node->first_child()) {
+        layout_node->remove_child(*child);
+        old_children.append(child.release_nonnull());
+    }
+    layout_node->set_children_are_inline(false);
+
+    // The line boxes refer to the old children, so they have to go as well.
+    if (is<Box>(*layout_node))
+        downcast<Box>(*layout_node).line_boxes().clear();
+
+    for (auto* ancestor = layout_node; ancestor; ancestor = ancestor->parent())
+        m_parent_stack.prepend(downcast<NodeWithStyle>(ancestor));
+
+    auto* shadow_root = is<DOM::Element>(dom_node) ? downcast<DOM::Element>(dom_node).shadow_root() : nullptr;
+    if (shadow_root)
+        create_layout_tree(*shadow_root);
+    downcast<DOM::ParentNode>(dom_node).for_each_child([&](auto& dom_child) {
+        create_layout_tree(dom_child);
+    });
+
+    m_parent_stack.clear();
+
+    if (auto* root = dom_node.document().layout_node())
+        fixup_tables(*root);
+
+    layout_node->set_needs_layout();
+}
+
 template<CSS::Display display, typename Callback>
 void TreeBuilder::for_each_in_tree_with_display(NodeWithStyle& root, Callback callback)
 {
@@ -38,6 +38,9 @@ public:
 
     RefPtr<Layout::Node> build(DOM::Node&);
 
+    // Throws away the layout children of the DOM node's layout box and generates them anew from the DOM.
+    void rebuild_children(DOM::Node&);
+
 private:
     void create_layout_tree(DOM::Node&);
 
@@ -85,6 +85,7 @@ void CSSLoader::resource_did_load()
     if (!was_imported) {
         m_style_sheet->rules() = sheet->rules();
     }
+    m_style_sheet->invalidate_rule_cache();
 
     if (on_load)
         on_load();
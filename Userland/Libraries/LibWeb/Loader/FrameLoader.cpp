@@ -134,20 +134,27 @@ bool FrameLoader::parse_document(DOM::Document& document, const ByteBuffer& data
 {
     auto& mime_type = document.content_type();
     if (mime_type == "text/html" || mime_type == "image/svg+xml") {
-        HTML::HTMLDocumentParser parser(document, data, document.encoding());
-        parser.run(document.url());
+        // Parse in slices so that the page can paint and handle input while a large document is loading.
+        m_parser = make<HTML::HTMLDocumentParser>(document, data, document.encoding());
+        m_parser->run_incrementally(document.url(), [this, &document] {
+            document_did_finish_parsing(document);
+        });
         return true;
     }
+
+    bool success = false;
     if (mime_type.starts_with("image/"))
-        return build_image_document(document, data);
-    if (mime_type == "text/plain" || mime_type == "application/json")
-        return build_text_document(document, data);
-    if (mime_type == "text/markdown")
-        return build_markdown_document(document, data);
-    if (mime_type == "text/gemini")
-        return build_gemini_document(document, data);
-
-    return false;
+        success = build_image_document(document, data);
+    else if (mime_type == "text/plain" || mime_type == "application/json")
+        success = build_text_document(document, data);
+    else if (mime_type == "text/markdown")
+        success = build_markdown_document(document, data);
+    else if (mime_type == "text/gemini")
+        success = build_gemini_document(document, data);
+
+    if (success)
+        document_did_finish_parsing(document);
+    return success;
 }
 
 bool FrameLoader::load(const LoadRequest& request, Type type)
@@ -210,6 +217,7 @@ bool FrameLoader::load(const URL& url, Type type)
 
 void FrameLoader::load_html(const StringView& html, const URL& url)
 {
+    stop_parsing();
     auto document = DOM::Document::create(url);
     HTML::HTMLDocumentParser parser(document, html, "utf-8");
     parser.run(url);
@@ -260,22 +268,45 @@ void FrameLoader::resource_did_load()
 
     dbgln("I believe this content has MIME type '{}', , encoding '{}'", resource()->mime_type(), resource()->encoding());
 
+    stop_parsing();
+
     auto document = DOM::Document::create();
     document->set_url(url);
     document->set_encoding(resource()->encoding());
     document->set_content_type(resource()->mime_type());
 
+    // FIXME: Support multiple instances of the Set-Cookie response header.
+    auto set_cookie = resource()->response_headers().get("Set-Cookie");
+    if (set_cookie.has_value())
+        document->set_cookie(set_cookie.value(), Cookie::Source::Http);
+
     frame().set_document(document);
 
-    if (!parse_document(*document, resource()->encoded_data())) {
+    if (!parse_document(*document, resource()->encoded_data()))
         load_error_page(url, "Failed to parse content.");
+}
+
+void FrameLoader::stop_parsing()
+{
+    // A parser that was stopped from inside one of its slices (e.g. while a script was loading) can only go away once that has unwound.
+    m_stopped_parsers.remove_all_matching([](auto& parser) { return !parser->is_running_slice(); });
+
+    if (!m_parser)
         return;
-    }
+    m_parser->abort();
+    if (m_parser->is_running_slice())
+        m_stopped_parsers.append(m_parser.release_nonnull());
+    else
+        m_parser = nullptr;
+}
 
-    // FIXME: Support multiple instances of the Set-Cookie response header.
-    auto set_cookie = resource()->response_headers().get("Set-Cookie");
-    if (set_cookie.has_value())
-        document->set_cookie(set_cookie.value(), Cookie::Source::Http);
+void FrameLoader::document_did_finish_parsing(DOM::Document& document)
+{
+    // Another document may have been loaded into the frame while this one was being parsed.
+    if (frame().document() != &document)
+        return;
+
+    auto url = document.url();
 
     if (!url.fragment().is_empty())
         frame().scroll_to_anchor(url.fragment());
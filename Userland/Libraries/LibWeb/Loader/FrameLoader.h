@@ -27,6 +27,8 @@
 #pragma once
 
 #include <AK/Forward.h>
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/OwnPtr.h>
 #include <LibWeb/Forward.h>
 #include <LibWeb/Loader/Resource.h>
 
@@ -59,8 +61,12 @@ private:
 
     void load_error_page(const URL& failed_url, const String& error_message);
     bool parse_document(DOM::Document&, const ByteBuffer& data);
+    void document_did_finish_parsing(DOM::Document&);
+    void stop_parsing();
 
     Frame& m_frame;
+    OwnPtr<HTML::HTMLDocumentParser> m_parser;
+    NonnullOwnPtrVector<HTML::HTMLDocumentParser> m_stopped_parsers;
 };
 
 }
@@ -123,6 +123,12 @@ void ImageLoader::resource_did_fail()
         on_fail();
 }
 
+void ImageLoader::resource_did_receive_data()
+{
+    if (on_partial_load)
+        on_partial_load();
+}
+
 bool ImageLoader::has_image() const
 {
     if (!resource())
@@ -151,4 +157,11 @@ const Gfx::Bitmap* ImageLoader::bitmap(size_t frame_index) const
     return resource()->bitmap(frame_index);
 }
 
+int ImageLoader::available_rows(size_t frame_index) const
+{
+    if (!resource())
+        return 0;
+    return resource()->available_rows(frame_index);
+}
+
 }
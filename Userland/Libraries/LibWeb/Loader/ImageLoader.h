@@ -39,6 +39,7 @@ public:
     void load(const URL&);
 
     const Gfx::Bitmap* bitmap(size_t index) const;
+    int available_rows(size_t index) const;
     size_t current_frame_index() const { return m_current_frame_index; }
 
     bool has_image() const;
@@ -52,12 +53,14 @@ public:
 
     Function<void()> on_load;
     Function<void()> on_fail;
+    Function<void()> on_partial_load;
     Function<void()> on_animate;
 
 private:
     // ^ImageResourceClient
     virtual void resource_did_load() override;
     virtual void resource_did_fail() override;
+    virtual void resource_did_receive_data() override;
     virtual bool is_visible_in_viewport() const override { return m_visible_in_viewport; }
 
     void animate();
@@ -38,6 +38,7 @@ ImageResource::ImageResource(const LoadRequest& request)
 
 ImageResource::~ImageResource()
 {
+    end_streaming_decode();
 }
 
 int ImageResource::frame_duration(size_t frame_index) const
@@ -74,28 +75,99 @@ void ImageResource::decode_if_needed() const
     NonnullRefPtr decoder = image_decoder_client();
     auto image = decoder->decode_image(encoded_data());
 
-    if (image.has_value()) {
-        m_loop_count = image.value().loop_count;
-        m_animated = image.value().is_animated;
-        m_decoded_frames.resize(image.value().frames.size());
-        for (size_t i = 0; i < m_decoded_frames.size(); ++i) {
-            auto& frame = m_decoded_frames[i];
-            frame.bitmap = image.value().frames[i].bitmap;
-            frame.duration = image.value().frames[i].duration;
-        }
-    }
+    if (image.has_value())
+        set_decoded_image(image.value());
 
     m_has_attempted_decode = true;
 }
 
+void ImageResource::set_decoded_image(const ImageDecoderClient::DecodedImage& image) const
+{
+    m_loop_count = image.loop_count;
+    m_animated = image.is_animated;
+    m_decoded_frames.resize(image.frames.size());
+    for (size_t i = 0; i < m_decoded_frames.size(); ++i) {
+        auto& frame = m_decoded_frames[i];
+        frame.bitmap = image.frames[i].bitmap;
+        frame.duration = image.frames[i].duration;
+    }
+}
+
 const Gfx::Bitmap* ImageResource::bitmap(size_t frame_index) const
 {
     decode_if_needed();
+    if (!m_has_attempted_decode && frame_index == 0)
+        return m_partial_bitmap;
     if (frame_index >= m_decoded_frames.size())
         return nullptr;
     return m_decoded_frames[frame_index].bitmap;
 }
 
+int ImageResource::available_rows(size_t frame_index) const
+{
+    decode_if_needed();
+    if (!m_has_attempted_decode && frame_index == 0)
+        return m_partial_available_rows;
+    if (frame_index >= m_decoded_frames.size() || !m_decoded_frames[frame_index].bitmap)
+        return 0;
+    return m_decoded_frames[frame_index].bitmap->height();
+}
+
+void ImageResource::did_receive_data(Badge<ResourceLoader>, ReadonlyBytes data)
+{
+    // Only bother the decoder once we have a decent amount of new data.
+    static constexpr size_t streaming_decode_batch_size = 16 * KiB;
+    m_pending_streaming_data.append(data.data(), data.size());
+    if (m_pending_streaming_data.size() < streaming_decode_batch_size)
+        return;
+
+    if (!m_streaming_decode_id.has_value()) {
+        m_streaming_decode_id = image_decoder_client().start_streaming_decode([this](auto& partial_image) {
+            m_partial_bitmap = partial_image.bitmap;
+            m_partial_available_rows = partial_image.available_rows;
+            for_each_client([](auto& client) {
+                client.resource_did_receive_data();
+            });
+        });
+    }
+
+    image_decoder_client().append_streaming_data(m_streaming_decode_id.value(), m_pending_streaming_data.span());
+    m_pending_streaming_data.clear_with_capacity();
+}
+
+void ImageResource::did_finish_receiving_data()
+{
+    if (!is_loaded() || !m_streaming_decode_id.has_value()) {
+        end_streaming_decode();
+        return;
+    }
+
+    // The decoder has most of the data already, so let it decode the image from that instead of sending all of it again.
+    // If that doesn't work out (e.g. because the decoder was restarted on the way), decode_if_needed() will start over.
+    NonnullRefPtr decoder = image_decoder_client();
+    decoder->append_streaming_data(m_streaming_decode_id.value(), m_pending_streaming_data.span());
+    auto image = decoder->finish_streaming_decode(m_streaming_decode_id.value());
+    m_streaming_decode_id = {};
+    end_streaming_decode();
+
+    if (image.has_value()) {
+        set_decoded_image(image.value());
+        m_has_attempted_decode = true;
+    }
+}
+
+void ImageResource::end_streaming_decode()
+{
+    m_partial_bitmap = nullptr;
+    m_partial_available_rows = 0;
+    m_pending_streaming_data.clear();
+
+    if (!m_streaming_decode_id.has_value())
+        return;
+    image_decoder_client().end_streaming_decode(m_streaming_decode_id.value());
+    m_streaming_decode_id = {};
+}
+
 void ImageResource::update_volatility()
 {
     bool visible_in_viewport = false;
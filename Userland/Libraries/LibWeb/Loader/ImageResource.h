@@ -28,6 +28,10 @@
 
 #include <LibWeb/Loader/Resource.h>
 
+namespace ImageDecoderClient {
+struct DecodedImage;
+}
+
 namespace Web {
 
 class ImageResource final : public Resource {
@@ -42,6 +46,8 @@ public:
     };
 
     const Gfx::Bitmap* bitmap(size_t frame_index = 0) const;
+    // The number of rows of bitmap() that can be painted. While the image is still loading, this may be less than its height.
+    int available_rows(size_t frame_index = 0) const;
     int frame_duration(size_t frame_index) const;
     size_t frame_count() const
     {
@@ -61,15 +67,26 @@ public:
 
     void update_volatility();
 
+    virtual void did_receive_data(Badge<ResourceLoader>, ReadonlyBytes) override;
+
 private:
     explicit ImageResource(const LoadRequest&);
 
+    virtual void did_finish_receiving_data() override;
+
     void decode_if_needed() const;
+    void set_decoded_image(const ImageDecoderClient::DecodedImage&) const;
+    void end_streaming_decode();
 
     mutable bool m_animated { false };
     mutable int m_loop_count { 0 };
     mutable Vector<Frame> m_decoded_frames;
     mutable bool m_has_attempted_decode { false };
+
+    Optional<i32> m_streaming_decode_id;
+    Vector<u8> m_pending_streaming_data;
+    RefPtr<Gfx::Bitmap> m_partial_bitmap;
+    int m_partial_available_rows { 0 };
 };
 
 class ImageResourceClient : public ResourceClient {
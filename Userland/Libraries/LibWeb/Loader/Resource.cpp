@@ -112,6 +112,8 @@ void Resource::did_load(Badge<ResourceLoader>, ReadonlyBytes data, const HashMap
         m_mime_type = Core::guess_mime_type_based_on_filename(url().path());
     }
 
+    did_finish_receiving_data();
+
     for_each_client([](auto& client) {
         client.resource_did_load();
     });
@@ -123,6 +125,8 @@ void Resource::did_fail(Badge<ResourceLoader>, const String& error, Optional<u32
     m_status_code = move(status_code);
     m_failed = true;
 
+    did_finish_receiving_data();
+
     for_each_client([](auto& client) {
         client.resource_did_fail();
     });
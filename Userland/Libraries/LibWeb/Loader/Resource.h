@@ -68,6 +68,7 @@ public:
     const ByteBuffer& encoded_data() const { return m_encoded_data; }
 
     const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers() const { return m_response_headers; }
+    Optional<u32> status_code() const { return m_status_code; }
 
     void register_client(Badge<ResourceClient>, ResourceClient&);
     void unregister_client(Badge<ResourceClient>, ResourceClient&);
@@ -80,9 +81,15 @@ public:
     void did_load(Badge<ResourceLoader>, ReadonlyBytes data, const HashMap<String, String, CaseInsensitiveStringTraits>& headers, Optional<u32> status_code);
     void did_fail(Badge<ResourceLoader>, const String& error, Optional<u32> status_code);
 
+    // Called with each chunk of data as it arrives, before did_load() gets all of it.
+    virtual void did_receive_data(Badge<ResourceLoader>, ReadonlyBytes) { }
+
 protected:
     explicit Resource(Type, const LoadRequest&);
 
+    // Called once the load has either finished or failed, before the clients are told about it.
+    virtual void did_finish_receiving_data() { }
+
 private:
     LoadRequest m_request;
     ByteBuffer m_encoded_data;
@@ -103,6 +110,7 @@ public:
 
     virtual void resource_did_load() { }
     virtual void resource_did_fail() { }
+    virtual void resource_did_receive_data() { }
 
 protected:
     virtual Resource::Type client_type() const { return Resource::Type::Generic; }
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/Debug.h>
+#include <LibHTTP/Caching.h>
+#include <LibWeb/Loader/ResourceCache.h>
+
+namespace Web {
+
+RefPtr<Resource> ResourceCache::get(const LoadRequest& request)
+{
+    auto it = m_entries.find(request);
+    if (it == m_entries.end())
+        return nullptr;
+    it->value.last_use = ++m_use_counter;
+    return it->value.resource;
+}
+
+bool ResourceCache::is_fresh(const LoadRequest& request, time_t now) const
+{
+    auto it = m_entries.find(request);
+    if (it == m_entries.end())
+        return false;
+    if (!it->value.loaded)
+        return true;
+    return now < it->value.fresh_until;
+}
+
+void ResourceCache::add_revalidation_headers(LoadRequest& request, const HashMap<String, String, CaseInsensitiveStringTraits>& headers)
+{
+    if (auto etag = headers.get("ETag"); etag.has_value())
+        request.set_header("If-None-Match", etag.value());
+    if (auto last_modified = headers.get("Last-Modified"); last_modified.has_value())
+        request.set_header("If-Modified-Since", last_modified.value());
+}
+
+void ResourceCache::set(const LoadRequest& request, Resource& resource)
+{
+    remove(request);
+    m_entries.set(request, Entry { resource, false, 0, 0, ++m_use_counter });
+}
+
+void ResourceCache::did_load(const LoadRequest& request, const Resource& resource, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code, size_t size_in_bytes, time_t response_time)
+{
+    auto it = m_entries.find(request);
+    if (it == m_entries.end() || it->value.resource.ptr() != &resource)
+        return;
+
+    // Only successful responses are worth keeping around (data: URLs don't have a status code).
+    if (status_code.has_value() && status_code.value() != 200) {
+        remove(request);
+        return;
+    }
+
+    if (HTTP::CacheControl::from_headers(response_headers).no_store) {
+        dbgln_if(CACHE_DEBUG, "Not caching {} because of Cache-Control: no-store", request.url());
+        remove(request);
+        return;
+    }
+
+    auto& entry = it->value;
+    entry.loaded = true;
+    // data: URLs can never change, so there is nothing to revalidate.
+    if (request.url().protocol() == "data")
+        entry.fresh_until = NumericLimits<time_t>::max();
+    else
+        entry.fresh_until = HTTP::fresh_until(response_headers, response_time);
+    entry.size_in_bytes = size_in_bytes;
+    m_size_in_bytes += entry.size_in_bytes;
+
+    evict_if_needed();
+}
+
+void ResourceCache::did_fail(const LoadRequest& request, const Resource& resource)
+{
+    auto it = m_entries.find(request);
+    if (it != m_entries.end() && it->value.resource.ptr() == &resource)
+        remove(request);
+}
+
+void ResourceCache::clear()
+{
+    m_entries.clear();
+    m_size_in_bytes = 0;
+}
+
+void ResourceCache::remove(const LoadRequest& request)
+{
+    auto it = m_entries.find(request);
+    if (it == m_entries.end())
+        return;
+    m_size_in_bytes -= it->value.size_in_bytes;
+    m_entries.remove(it);
+}
+
+void ResourceCache::evict_if_needed()
+{
+    while (m_size_in_bytes > m_capacity) {
+        Optional<LoadRequest> least_recently_used;
+        u64 oldest_use = NumericLimits<u64>::max();
+        for (auto& it : m_entries) {
+            // Resources that are still loading don't count towards the size yet.
+            if (!it.value.loaded)
+                continue;
+            if (it.value.last_use < oldest_use) {
+                oldest_use = it.value.last_use;
+                least_recently_used = it.key;
+            }
+        }
+        if (!least_recently_used.has_value())
+            break;
+        dbgln_if(CACHE_DEBUG, "Evicting {} from the resource cache", least_recently_used->url());
+        remove(least_recently_used.value());
+    }
+}
+
+}
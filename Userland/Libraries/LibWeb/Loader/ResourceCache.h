@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/RefPtr.h>
+#include <LibWeb/Forward.h>
+#include <LibWeb/Loader/LoadRequest.h>
+#include <LibWeb/Loader/Resource.h>
+#include <time.h>
+
+namespace Web {
+
+// An in-memory cache of loaded resources, bounded by the total size of their encoded data.
+// Entries are evicted in least-recently-used order, and responses are only reused for as long
+// as their headers say they are fresh (see HTTP::fresh_until()). Stale entries with a validator
+// (ETag or Last-Modified) can be revalidated with a conditional request instead of being fetched again.
+class ResourceCache {
+public:
+    static constexpr size_t default_capacity = 32 * MiB;
+
+    explicit ResourceCache(size_t capacity = default_capacity)
+        : m_capacity(capacity)
+    {
+    }
+
+    // Returns the cached resource for the request (loaded or still in flight), if any.
+    RefPtr<Resource> get(const LoadRequest&);
+
+    // A loaded resource that is no longer fresh must be revalidated before it can be reused.
+    bool is_fresh(const LoadRequest&, time_t now) const;
+
+    // Adds the conditional request headers needed to revalidate a stale response.
+    static void add_revalidation_headers(LoadRequest&, const HashMap<String, String, CaseInsensitiveStringTraits>& stale_response_headers);
+
+    void set(const LoadRequest&, Resource&);
+    void did_load(const LoadRequest&, const Resource&, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code, size_t size_in_bytes, time_t response_time);
+    void did_fail(const LoadRequest&, const Resource&);
+
+    void clear();
+
+    size_t size() const { return m_entries.size(); }
+    size_t size_in_bytes() const { return m_size_in_bytes; }
+
+private:
+    struct Entry {
+        NonnullRefPtr<Resource> resource;
+        bool loaded { false };
+        time_t fresh_until { 0 };
+        size_t size_in_bytes { 0 };
+        u64 last_use { 0 };
+    };
+
+    void remove(const LoadRequest&);
+    void evict_if_needed();
+
+    HashMap<LoadRequest, Entry> m_entries;
+    size_t m_capacity { 0 };
+    size_t m_size_in_bytes { 0 };
+    u64 m_use_counter { 0 };
+};
+
+}
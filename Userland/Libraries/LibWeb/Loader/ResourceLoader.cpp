@@ -71,8 +71,6 @@ void ResourceLoader::load_sync(const LoadRequest& request, Function<void(Readonl
     loop.exec();
 }
 
-static HashMap<LoadRequest, NonnullRefPtr<Resource>> s_resource_cache;
-
 RefPtr<Resource> ResourceLoader::load_resource(Resource::Type type, const LoadRequest& request)
 {
     if (!request.is_valid())
@@ -80,14 +78,17 @@ RefPtr<Resource> ResourceLoader::load_resource(Resource::Type type, const LoadRe
 
     bool use_cache = request.url().protocol() != "file";
 
+    RefPtr<Resource> stale_resource;
     if (use_cache) {
-        auto it = s_resource_cache.find(request);
-        if (it != s_resource_cache.end()) {
-            if (it->value->type() != type) {
+        if (auto cached_resource = m_cache.get(request)) {
+            if (cached_resource->type() != type) {
                 dbgln("FIXME: Not using cached resource for {} since there's a type mismatch.", request.url());
-            } else {
+            } else if (m_cache.is_fresh(request, time(nullptr))) {
                 dbgln_if(CACHE_DEBUG, "Reusing cached resource for: {}", request.url());
-                return it->value;
+                return cached_resource;
+            } else {
+                dbgln_if(CACHE_DEBUG, "Revalidating stale cached resource for: {}", request.url());
+                stale_resource = move(cached_resource);
             }
         }
     }
@@ -95,21 +96,75 @@ RefPtr<Resource> ResourceLoader::load_resource(Resource::Type type, const LoadRe
     auto resource = Resource::create({}, type, request);
 
     if (use_cache)
-        s_resource_cache.set(request, resource);
+        m_cache.set(request, resource);
+
+    auto load_request = request;
+    if (stale_resource)
+        ResourceCache::add_revalidation_headers(load_request, stale_resource->response_headers());
 
     load(
-        request,
-        [=](auto data, auto& headers, auto status_code) {
-            const_cast<Resource&>(*resource).did_load({}, data, headers, status_code);
+        load_request,
+        [this, request, resource, stale_resource](auto data, auto& headers, auto status_code) {
+            if (stale_resource && status_code.has_value() && status_code.value() == 304) {
+                // Not modified, so we can keep using the data we already have, along with any updated headers.
+                dbgln_if(CACHE_DEBUG, "Cached resource for {} is still valid", request.url());
+                auto merged_headers = stale_resource->response_headers();
+                for (auto& it : headers)
+                    merged_headers.set(it.key, it.value);
+                const_cast<Resource&>(*resource).did_load({}, stale_resource->encoded_data(), merged_headers, stale_resource->status_code());
+            } else {
+                const_cast<Resource&>(*resource).did_load({}, data, headers, status_code);
+            }
+            m_cache.did_load(request, *resource, resource->response_headers(), resource->status_code(), resource->encoded_data().size(), time(nullptr));
         },
-        [=](auto& error, auto status_code) {
+        [this, request, resource](auto& error, auto status_code) {
+            m_cache.did_fail(request, *resource);
             const_cast<Resource&>(*resource).did_fail({}, error, status_code);
+        },
+        [=](auto data) {
+            const_cast<Resource&>(*resource).did_receive_data({}, data);
         });
 
     return resource;
 }
 
-void ResourceLoader::load(const LoadRequest& request, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> success_callback, Function<void(const String&, Optional<u32> status_code)> error_callback)
+namespace {
+
+class SyncResourceClient final : public ResourceClient {
+public:
+    SyncResourceClient(Resource& resource, Core::EventLoop& loop)
+        : m_type(resource.type())
+        , m_loop(loop)
+    {
+        set_resource(&resource);
+    }
+
+    virtual void resource_did_load() override { m_loop.quit(0); }
+    virtual void resource_did_fail() override { m_loop.quit(0); }
+
+private:
+    virtual Resource::Type client_type() const override { return m_type; }
+
+    Resource::Type m_type;
+    Core::EventLoop& m_loop;
+};
+
+}
+
+RefPtr<Resource> ResourceLoader::load_resource_sync(Resource::Type type, const LoadRequest& request)
+{
+    auto resource = load_resource(type, request);
+    if (!resource || resource->is_loaded() || resource->is_failed())
+        return resource;
+
+    // The resource may already be in flight (e.g. started by the preload scanner), in which case we only wait for it.
+    Core::EventLoop loop;
+    SyncResourceClient client(*resource, loop);
+    loop.exec();
+    return resource;
+}
+
+void ResourceLoader::load(const LoadRequest& request, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> success_callback, Function<void(const String&, Optional<u32> status_code)> error_callback, Function<void(ReadonlyBytes)> partial_data_callback)
 {
     auto& url = request.url();
 
@@ -203,6 +258,7 @@ void ResourceLoader::load(const LoadRequest& request, Function<void(ReadonlyByte
             success_callback(payload, response_headers, status_code);
         };
         download->set_should_buffer_all_input(true);
+        download->on_data_received = move(partial_data_callback);
         download->on_certificate_requested = []() -> Protocol::Download::CertificateAndKey {
             return {};
         };
@@ -238,8 +294,8 @@ bool ResourceLoader::is_port_blocked(int port)
 
 void ResourceLoader::clear_cache()
 {
-    dbgln("Clearing {} items from ResourceLoader cache", s_resource_cache.size());
-    s_resource_cache.clear();
+    dbgln("Clearing {} items from ResourceLoader cache", m_cache.size());
+    m_cache.clear();
 }
 
 }
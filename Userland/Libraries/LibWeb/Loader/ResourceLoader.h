@@ -30,6 +30,7 @@
 #include <AK/URL.h>
 #include <LibCore/Object.h>
 #include <LibWeb/Loader/Resource.h>
+#include <LibWeb/Loader/ResourceCache.h>
 
 namespace Protocol {
 class Client;
@@ -45,8 +46,9 @@ public:
     static ResourceLoader& the();
 
     RefPtr<Resource> load_resource(Resource::Type, const LoadRequest&);
+    RefPtr<Resource> load_resource_sync(Resource::Type, const LoadRequest&);
 
-    void load(const LoadRequest&, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> success_callback, Function<void(const String&, Optional<u32> status_code)> error_callback = nullptr);
+    void load(const LoadRequest&, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> success_callback, Function<void(const String&, Optional<u32> status_code)> error_callback = nullptr, Function<void(ReadonlyBytes)> partial_data_callback = nullptr);
     void load(const URL&, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> success_callback, Function<void(const String&, Optional<u32> status_code)> error_callback = nullptr);
     void load_sync(const LoadRequest&, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> success_callback, Function<void(const String&, Optional<u32> status_code)> error_callback = nullptr);
 
@@ -67,6 +69,8 @@ private:
 
     int m_pending_loads { 0 };
 
+    ResourceCache m_cache;
+
     RefPtr<Protocol::Client> m_protocol_client;
     String m_user_agent;
 };
@@ -99,6 +99,7 @@ void Frame::set_document(DOM::Document* document)
         m_document->detach_from_frame({}, *this);
 
     m_document = document;
+    m_tile_cache.invalidate_all();
 
     if (m_document) {
         m_document->attach_to_frame({}, *this);
@@ -160,6 +161,9 @@ void Frame::set_viewport_scroll_offset(const Gfx::IntPoint& offset)
 
 void Frame::set_needs_display(const Gfx::IntRect& rect)
 {
+    // Even if it's not visible right now, it might have been painted into a tile.
+    m_tile_cache.invalidate(rect);
+
     if (!viewport_rect().intersects(rect))
         return;
 
@@ -189,8 +193,7 @@ void Frame::scroll_to_anchor(const String& fragment)
         }
     }
 
-    // FIXME: This is overly aggressive and should be something more like a "update_layout_if_needed()"
-    document()->force_layout();
+    document()->update_layout();
 
     if (!element || !element->layout_node())
         return;
@@ -37,6 +37,7 @@
 #include <LibWeb/DOM/Position.h>
 #include <LibWeb/Loader/FrameLoader.h>
 #include <LibWeb/Page/EventHandler.h>
+#include <LibWeb/Painting/TileCache.h>
 #include <LibWeb/TreeNode.h>
 
 namespace Web {
@@ -71,6 +72,8 @@ public:
 
     void set_needs_display(const Gfx::IntRect&);
 
+    Painting::TileCache& tile_cache() { return m_tile_cache; }
+
     void set_viewport_scroll_offset(const Gfx::IntPoint&);
     Gfx::IntRect viewport_rect() const { return { m_viewport_scroll_offset, m_size }; }
     void set_viewport_rect(const Gfx::IntRect&);
@@ -120,6 +123,8 @@ private:
     Gfx::IntSize m_size;
     Gfx::IntPoint m_viewport_scroll_offset;
 
+    Painting::TileCache m_tile_cache;
+
     DOM::Position m_cursor_position;
     RefPtr<Core::Timer> m_cursor_blink_timer;
     bool m_cursor_blink_state { false };
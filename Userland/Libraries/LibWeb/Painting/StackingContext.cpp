@@ -38,14 +38,17 @@ StackingContext::StackingContext(Box& box, StackingContext* parent)
     , m_parent(parent)
 {
     VERIFY(m_parent != this);
-    if (m_parent) {
+    if (m_parent)
         m_parent->m_children.append(this);
+}
 
-        // FIXME: Don't sort on every append..
-        quick_sort(m_parent->m_children, [](auto& a, auto& b) {
-            return a->m_box.computed_values().z_index().value_or(0) < b->m_box.computed_values().z_index().value_or(0);
-        });
-    }
+void StackingContext::sort()
+{
+    quick_sort(m_children, [](auto& a, auto& b) {
+        return a->m_box.computed_values().z_index().value_or(0) < b->m_box.computed_values().z_index().value_or(0);
+    });
+    for (auto* child : m_children)
+        child->sort();
 }
 
 void StackingContext::paint(PaintContext& context, PaintPhase phase)
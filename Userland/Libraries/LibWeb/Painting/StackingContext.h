@@ -38,6 +38,9 @@ public:
     StackingContext* parent() { return m_parent; }
     const StackingContext* parent() const { return m_parent; }
 
+    // Puts the child contexts in z-index order. Called once the whole tree has been built.
+    void sort();
+
     void paint(PaintContext&, PaintPhase);
     HitTestResult hit_test(const Gfx::IntPoint&, HitTestType) const;
 
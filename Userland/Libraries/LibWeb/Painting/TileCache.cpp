@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Painter.h>
+#include <LibWeb/Painting/TileCache.h>
+
+namespace Web::Painting {
+
+static int tile_index_for(int coordinate)
+{
+    if (coordinate >= 0)
+        return coordinate / TileCache::tile_size;
+    return -((-coordinate + TileCache::tile_size - 1) / TileCache::tile_size);
+}
+
+template<typename Callback>
+void TileCache::for_each_tile_intersecting(const Gfx::IntRect& rect, Callback callback)
+{
+    if (rect.is_empty())
+        return;
+    for (int tile_y = tile_index_for(rect.top()); tile_y <= tile_index_for(rect.bottom()); ++tile_y) {
+        for (int tile_x = tile_index_for(rect.left()); tile_x <= tile_index_for(rect.right()); ++tile_x)
+            callback(tile_x, tile_y);
+    }
+}
+
+template<typename Callback>
+void TileCache::evict_tiles_matching(Callback callback)
+{
+    Vector<u64> keys_to_remove;
+    for (auto& it : m_tiles) {
+        if (callback(tile_rect((i32)(it.key >> 32), (i32)(u32)it.key)))
+            keys_to_remove.append(it.key);
+    }
+    for (auto key : keys_to_remove)
+        m_tiles.remove(key);
+}
+
+void TileCache::paint(Gfx::Painter& painter, const Gfx::IntRect& content_rect, RasterizeCallback rasterize)
+{
+    for_each_tile_intersecting(content_rect, [&](int tile_x, int tile_y) {
+        auto rect = tile_rect(tile_x, tile_y);
+        auto destination = rect.location() - content_rect.location();
+
+        auto key = tile_key(tile_x, tile_y);
+        auto it = m_tiles.find(key);
+        if (it == m_tiles.end()) {
+            auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, rect.size());
+            if (!bitmap) {
+                // We couldn't allocate a tile, so paint this part directly instead.
+                Gfx::PainterStateSaver saver(painter);
+                painter.add_clip_rect({ destination, rect.size() });
+                painter.translate(destination);
+                rasterize(painter, rect);
+                return;
+            }
+            Gfx::Painter tile_painter(*bitmap);
+            rasterize(tile_painter, rect);
+            m_tiles.set(key, bitmap.release_nonnull());
+            it = m_tiles.find(key);
+        }
+        painter.blit(destination, *it->value, it->value->rect(), 1.0f, false);
+    });
+
+    // Only keep the tiles that are within a screenful of what we just painted.
+    auto retained_rect = content_rect.inflated(content_rect.width() * 2, content_rect.height() * 2);
+    evict_tiles_matching([&](const Gfx::IntRect& rect) {
+        return !rect.intersects(retained_rect);
+    });
+}
+
+void TileCache::invalidate(const Gfx::IntRect& content_rect)
+{
+    evict_tiles_matching([&](const Gfx::IntRect& rect) {
+        return rect.intersects(content_rect);
+    });
+}
+
+void TileCache::invalidate_all()
+{
+    m_tiles.clear();
+}
+
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Forward.h>
+#include <LibGfx/Rect.h>
+
+namespace Web::Painting {
+
+// Keeps the page content rasterized in fixed-size tiles, so that repainting something
+// that was painted before (most commonly after scrolling) is just a matter of blitting.
+// Tiles are thrown away when their part of the page is invalidated, or when they end up
+// far outside of what is being painted.
+class TileCache {
+public:
+    static constexpr int tile_size = 256;
+
+    // Called to rasterize the given rect of the page content into a painter whose origin is the rect's top left.
+    using RasterizeCallback = Function<void(Gfx::Painter&, const Gfx::IntRect& content_rect)>;
+
+    // Paints the given rect of the page content at the painter's origin.
+    void paint(Gfx::Painter&, const Gfx::IntRect& content_rect, RasterizeCallback);
+
+    void invalidate(const Gfx::IntRect& content_rect);
+    void invalidate_all();
+
+    size_t tile_count() const { return m_tiles.size(); }
+
+private:
+    static u64 tile_key(int tile_x, int tile_y) { return ((u64)(u32)tile_x << 32) | (u32)tile_y; }
+    static Gfx::IntRect tile_rect(int tile_x, int tile_y) { return { tile_x * tile_size, tile_y * tile_size, tile_size, tile_size }; }
+
+    template<typename Callback>
+    static void for_each_tile_intersecting(const Gfx::IntRect&, Callback);
+
+    template<typename Callback>
+    void evict_tiles_matching(Callback);
+
+    HashMap<u64, NonnullRefPtr<Gfx::Bitmap>> m_tiles;
+};
+
+}
@@ -0,0 +1,52 @@
+loadPage("file:///res/html/misc/blank.html");
+
+afterInitialPageLoad(() => {
+    test("Scripts, stylesheets and images are preloaded in document order", () => {
+        const urls = libweb_tester.preloadScan(`
+            <script src="http://example.com/first.js"></script>
+            <link rel="stylesheet" href="http://example.com/style.css">
+            <p>Some text <img src="http://example.com/image.png"></p>
+            <LINK REL="stylesheet icon" HREF="https://example.com:8080/other.css?v=2">
+            <script src="http://example.com/second.js"></script>
+        `);
+        expect(urls).toEqual([
+            "http://example.com/first.js",
+            "http://example.com/style.css",
+            "http://example.com/image.png",
+            "https://example.com:8080/other.css?v=2",
+            "http://example.com/second.js",
+        ]);
+    });
+
+    test("Markup inside raw text elements isn't mistaken for tags", () => {
+        const urls = libweb_tester.preloadScan(`
+            <script>document.write('<img src="http://example.com/in-script.png">');</script>
+            <style>p::after { content: '<img src="http://example.com/in-style.png">'; }</style>
+            <textarea><img src="http://example.com/in-textarea.png"></textarea>
+            <title><script src="http://example.com/in-title.js"></script></title>
+            <img src="http://example.com/after.png">
+        `);
+        expect(urls).toEqual(["http://example.com/after.png"]);
+    });
+
+    test("Nothing after <plaintext> is preloaded", () => {
+        const urls = libweb_tester.preloadScan(`
+            <img src="http://example.com/before.png">
+            <plaintext><img src="http://example.com/after.png">
+        `);
+        expect(urls).toEqual(["http://example.com/before.png"]);
+    });
+
+    test("Alternate stylesheets, other links and local files are skipped", () => {
+        const urls = libweb_tester.preloadScan(`
+            <link rel="alternate stylesheet" href="http://example.com/alternate.css">
+            <link rel="icon" href="http://example.com/favicon.png">
+            <link rel="stylesheet" href="local.css">
+            <img src="file:///res/icons/16x16/app-browser.png">
+            <img src="">
+            <img>
+            <script src="http://example.com/remote.js"></script>
+        `);
+        expect(urls).toEqual(["http://example.com/remote.js"]);
+    });
+});
@@ -0,0 +1,92 @@
+loadPage("file:///home/anon/web-tests/Pages/Layout.html");
+
+afterInitialPageLoad(() => {
+    // Each mutation is laid out incrementally first, then compared with a layout built from scratch.
+    const expectIncrementalLayoutToMatchRebuild = () => {
+        const incremental = libweb_tester.dumpLayoutTree();
+        expect(incremental).not.toBe("");
+        expect(incremental).toBe(libweb_tester.rebuildAndDumpLayoutTree());
+    };
+
+    libweb_tester.rebuildAndDumpLayoutTree();
+
+    test("Inserting and removing block children", () => {
+        const container = document.getElementById("container");
+        const box = document.createElement("div");
+        box.className = "box";
+        box.textContent = "Inserted";
+        container.insertBefore(box, document.getElementById("second"));
+        expectIncrementalLayoutToMatchRebuild();
+
+        container.removeChild(box);
+        expectIncrementalLayoutToMatchRebuild();
+
+        container.appendChild(document.createElement("p")).textContent = "Appended";
+        expectIncrementalLayoutToMatchRebuild();
+    });
+
+    test("Inserting into inline content", () => {
+        const bold = document.getElementById("bold");
+        bold.appendChild(document.createTextNode(" and more"));
+        expectIncrementalLayoutToMatchRebuild();
+
+        const block = document.createElement("div");
+        block.textContent = "A block inside an inline";
+        bold.appendChild(block);
+        expectIncrementalLayoutToMatchRebuild();
+
+        bold.removeChild(block);
+        expectIncrementalLayoutToMatchRebuild();
+    });
+
+    test("Changing text", () => {
+        document.getElementById("first").firstChild.data = "First, now long enough to wrap onto more than one line of the container";
+        expectIncrementalLayoutToMatchRebuild();
+
+        document.getElementById("paragraph").firstChild.data = "";
+        expectIncrementalLayoutToMatchRebuild();
+    });
+
+    test("Changing style", () => {
+        const second = document.getElementById("second");
+        second.setAttribute("style", "height: 100px");
+        expectIncrementalLayoutToMatchRebuild();
+
+        second.setAttribute("style", "display: none");
+        expectIncrementalLayoutToMatchRebuild();
+
+        second.setAttribute("style", "display: inline");
+        expectIncrementalLayoutToMatchRebuild();
+
+        second.removeAttribute("style");
+        expectIncrementalLayoutToMatchRebuild();
+
+        document.getElementById("container").setAttribute("style", "width: 300px");
+        expectIncrementalLayoutToMatchRebuild();
+    });
+
+    test("Changing floats and inline-blocks", () => {
+        document.getElementById("float").setAttribute("style", "width: 120px");
+        expectIncrementalLayoutToMatchRebuild();
+
+        document.getElementById("inline-block").textContent = "a much wider inline-block";
+        expectIncrementalLayoutToMatchRebuild();
+
+        document.getElementById("floats").appendChild(document.createElement("p")).textContent = "More text";
+        expectIncrementalLayoutToMatchRebuild();
+    });
+
+    test("Changing the height of an ancestor", () => {
+        // Neither #half (height: 50%) nor #wrapper, which holds an absolutely positioned box pinned to the
+        // bottom of #sized, needs layout itself when only the style of #sized changes.
+        const sized = document.getElementById("sized");
+        sized.setAttribute("style", "height: 300px");
+        expectIncrementalLayoutToMatchRebuild();
+
+        sized.setAttribute("style", "height: 120px; width: 200px");
+        expectIncrementalLayoutToMatchRebuild();
+
+        sized.removeAttribute("style");
+        expectIncrementalLayoutToMatchRebuild();
+    });
+});
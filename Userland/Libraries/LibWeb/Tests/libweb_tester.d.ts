@@ -6,6 +6,25 @@ interface LibwebTester {
      * @param url Page to load.
      */
     changePage(url: string): void;
+
+    /**
+     * Brings the layout tree up to date, rebuilding and relaying out only what changed.
+     * @returns A dump of the layout tree, including the box model of each box.
+     */
+    dumpLayoutTree(): string;
+
+    /**
+     * Throws away the layout tree, then builds and lays it out again from scratch.
+     * @returns A dump of the layout tree, in the same format as dumpLayoutTree().
+     */
+    rebuildAndDumpLayoutTree(): string;
+
+    /**
+     * Runs the HTML preload scanner over the given markup, with URLs resolved against the current page.
+     * @param markup HTML source that follows a parser-blocking script.
+     * @returns The URLs the scanner would start fetching, in document order.
+     */
+    preloadScan(markup: string): string[];
 }
 
 interface Window {
@@ -56,6 +56,25 @@ OwnPtr<Messages::ImageDecoderServer::GreetResponse> ClientConnection::handle(con
     return make<Messages::ImageDecoderServer::GreetResponse>();
 }
 
+static void decode_frames(const Gfx::ImageDecoder& decoder, Vector<Gfx::ShareableBitmap>& bitmaps, Vector<u32>& durations)
+{
+    for (size_t i = 0; i < decoder.frame_count(); ++i) {
+        // FIXME: All image decoder plugins should be rewritten to return frame() instead of bitmap().
+        //        Non-animated images can simply return 1 frame.
+        Gfx::ImageFrameDescriptor frame;
+        if (decoder.is_animated()) {
+            frame = decoder.frame(i);
+        } else {
+            frame.image = decoder.bitmap();
+        }
+        if (frame.image)
+            bitmaps.append(frame.image->to_shareable_bitmap());
+        else
+            bitmaps.append(Gfx::ShareableBitmap {});
+        durations.append(frame.duration);
+    }
+}
+
 OwnPtr<Messages::ImageDecoderServer::DecodeImageResponse> ClientConnection::handle(const Messages::ImageDecoderServer::DecodeImage& message)
 {
     auto encoded_buffer = message.data();
@@ -77,23 +96,58 @@ OwnPtr<Messages::ImageDecoderServer::DecodeImageResponse> ClientConnection::hand
 
     Vector<Gfx::ShareableBitmap> bitmaps;
     Vector<u32> durations;
-    for (size_t i = 0; i < decoder->frame_count(); ++i) {
-        // FIXME: All image decoder plugins should be rewritten to return frame() instead of bitmap().
-        //        Non-animated images can simply return 1 frame.
-        Gfx::ImageFrameDescriptor frame;
-        if (decoder->is_animated()) {
-            frame = decoder->frame(i);
-        } else {
-            frame.image = decoder->bitmap();
-        }
-        if (frame.image)
-            bitmaps.append(frame.image->to_shareable_bitmap());
-        else
-            bitmaps.append(Gfx::ShareableBitmap {});
-        durations.append(frame.duration);
+    decode_frames(*decoder, bitmaps, durations);
+    return make<Messages::ImageDecoderServer::DecodeImageResponse>(decoder->is_animated(), decoder->loop_count(), bitmaps, durations);
+}
+
+void ClientConnection::handle(const Messages::ImageDecoderServer::AppendStreamingData& message)
+{
+    auto& encoded_buffer = message.data();
+    if (!encoded_buffer.is_valid()) {
+        dbgln_if(IMAGE_DECODER_DEBUG, "Encoded data is invalid");
+        return;
     }
 
-    return make<Messages::ImageDecoderServer::DecodeImageResponse>(decoder->is_animated(), decoder->loop_count(), bitmaps, durations);
+    auto it = m_streaming_decoders.find(message.stream_id());
+    if (it == m_streaming_decoders.end()) {
+        m_streaming_decoders.set(message.stream_id(), Gfx::StreamingImageDecoder::create());
+        it = m_streaming_decoders.find(message.stream_id());
+    }
+
+    auto& decoder = it->value;
+    decoder->append({ encoded_buffer.data<u8>(), encoded_buffer.size() });
+
+    if (!decoder->update())
+        return;
+
+    auto& partial_image = decoder->partial_image();
+    post_message(Messages::ImageDecoderClient::DidDecodePartialImage(message.stream_id(), partial_image.image->to_shareable_bitmap(), partial_image.available_rows));
+}
+
+OwnPtr<Messages::ImageDecoderServer::FinishStreamingDecodeResponse> ClientConnection::handle(const Messages::ImageDecoderServer::FinishStreamingDecode& message)
+{
+    auto it = m_streaming_decoders.find(message.stream_id());
+    if (it == m_streaming_decoders.end())
+        return make<Messages::ImageDecoderServer::FinishStreamingDecodeResponse>(false, false, 0, Vector<Gfx::ShareableBitmap> {}, Vector<u32> {});
+    auto streaming_decoder = it->value;
+    m_streaming_decoders.remove(it);
+
+    // The decoder works on the data that has been streamed already, which is why streaming_decoder is kept alive while it's in use.
+    auto decoder = streaming_decoder->finish();
+    if (!decoder->frame_count()) {
+        dbgln_if(IMAGE_DECODER_DEBUG, "Could not decode image from streamed data");
+        return make<Messages::ImageDecoderServer::FinishStreamingDecodeResponse>(false, false, 0, Vector<Gfx::ShareableBitmap> {}, Vector<u32> {});
+    }
+
+    Vector<Gfx::ShareableBitmap> bitmaps;
+    Vector<u32> durations;
+    decode_frames(*decoder, bitmaps, durations);
+    return make<Messages::ImageDecoderServer::FinishStreamingDecodeResponse>(true, decoder->is_animated(), decoder->loop_count(), bitmaps, durations);
+}
+
+void ClientConnection::handle(const Messages::ImageDecoderServer::EndStreamingDecode& message)
+{
+    m_streaming_decoders.remove(message.stream_id());
 }
 
 }
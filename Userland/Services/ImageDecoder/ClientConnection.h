@@ -30,6 +30,7 @@
 #include <ImageDecoder/Forward.h>
 #include <ImageDecoder/ImageDecoderClientEndpoint.h>
 #include <ImageDecoder/ImageDecoderServerEndpoint.h>
+#include <LibGfx/StreamingImageDecoder.h>
 #include <LibIPC/ClientConnection.h>
 #include <LibWeb/Forward.h>
 
@@ -49,6 +50,11 @@ public:
 private:
     virtual OwnPtr<Messages::ImageDecoderServer::GreetResponse> handle(const Messages::ImageDecoderServer::Greet&) override;
     virtual OwnPtr<Messages::ImageDecoderServer::DecodeImageResponse> handle(const Messages::ImageDecoderServer::DecodeImage&) override;
+    virtual void handle(const Messages::ImageDecoderServer::AppendStreamingData&) override;
+    virtual OwnPtr<Messages::ImageDecoderServer::FinishStreamingDecodeResponse> handle(const Messages::ImageDecoderServer::FinishStreamingDecode&) override;
+    virtual void handle(const Messages::ImageDecoderServer::EndStreamingDecode&) override;
+
+    HashMap<i32, NonnullRefPtr<Gfx::StreamingImageDecoder>> m_streaming_decoders;
 };
 
 }
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <LibCore/Notifier.h>
+#include <ProtocolServer/CachedDownload.h>
+#include <errno.h>
+#include <stdio.h>
+#include <unistd.h>
+
+namespace ProtocolServer {
+
+CachedDownload::CachedDownload(ClientConnection& client, DiskCache::Response&& response, int write_fd, NonnullOwnPtr<OutputFileStream>&& output_stream)
+    : Download(client, move(output_stream))
+    , m_response(move(response))
+    , m_write_fd(write_fd)
+{
+    // The client doesn't know about this download until StartDownload has returned, so everything
+    // happens from the event loop. The pipe is non-blocking, so the body goes out as the client reads it.
+    m_notifier = Core::Notifier::construct(m_write_fd, Core::Notifier::Write);
+    m_notifier->on_ready_to_write = [this] { write_more(); };
+}
+
+CachedDownload::~CachedDownload()
+{
+    m_notifier->on_ready_to_write = nullptr;
+}
+
+NonnullOwnPtr<CachedDownload> CachedDownload::create(ClientConnection& client, DiskCache::Response&& response, int write_fd, NonnullOwnPtr<OutputFileStream>&& output_stream)
+{
+    return adopt_own(*new CachedDownload(client, move(response), write_fd, move(output_stream)));
+}
+
+void CachedDownload::write_more()
+{
+    if (!m_sent_headers) {
+        set_status_code(m_response.status_code);
+        set_response_headers(m_response.headers);
+        m_sent_headers = true;
+    }
+
+    auto remaining = m_response.body.bytes().slice(m_written_size);
+    while (!remaining.is_empty()) {
+        auto nwritten = ::write(m_write_fd, remaining.data(), remaining.size());
+        if (nwritten < 0) {
+            if (errno == EAGAIN)
+                return;
+            perror("write");
+            finish(false);
+            return;
+        }
+        m_written_size += nwritten;
+        remaining = remaining.slice(nwritten);
+    }
+    finish(true);
+}
+
+void CachedDownload::finish(bool success)
+{
+    m_notifier->set_enabled(false);
+    set_downloaded_size(m_written_size);
+    // Finishing destroys the download, so let the notifier callback return first.
+    m_notifier->deferred_invoke([this, success](auto&) {
+        did_progress(m_response.body.size(), m_written_size);
+        did_finish(success);
+    });
+}
+
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#pragma once
+
+#include <AK/NonnullOwnPtr.h>
+#include <LibCore/Forward.h>
+#include <ProtocolServer/DiskCache.h>
+#include <ProtocolServer/Download.h>
+
+namespace ProtocolServer {
+
+// A download that is answered from the disk cache instead of the network.
+class CachedDownload final : public Download {
+public:
+    virtual ~CachedDownload() override;
+    static NonnullOwnPtr<CachedDownload> create(ClientConnection&, DiskCache::Response&&, int write_fd, NonnullOwnPtr<OutputFileStream>&&);
+
+private:
+    explicit CachedDownload(ClientConnection&, DiskCache::Response&&, int write_fd, NonnullOwnPtr<OutputFileStream>&&);
+
+    void write_more();
+    void finish(bool success);
+
+    DiskCache::Response m_response;
+    size_t m_written_size { 0 };
+    bool m_sent_headers { false };
+    int m_write_fd { -1 };
+    RefPtr<Core::Notifier> m_notifier;
+};
+
+}
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <AK/Debug.h>
+#include <AK/GenericLexer.h>
+#include <AK/QuickSort.h>
+#include <AK/StringBuilder.h>
+#include <LibCore/DirIterator.h>
+#include <LibCore/File.h>
+#include <LibHTTP/Caching.h>
+#include <ProtocolServer/DiskCache.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+namespace ProtocolServer {
+
+// An entry is stored as the URL, the time the response arrived and its status code, one per line,
+// followed by the response headers, an empty line and the body.
+struct StoredEntry {
+    String url;
+    time_t response_time { 0 };
+    DiskCache::Response response;
+};
+
+static ByteBuffer encode_entry(const URL& url, const DiskCache::Response& response, time_t response_time)
+{
+    StringBuilder builder;
+    builder.appendff("{}\n{}\n{}\n", url, response_time, response.status_code);
+    for (auto& it : response.headers)
+        builder.appendff("{}: {}\n", it.key, it.value);
+    builder.append('\n');
+    builder.append(StringView(response.body));
+    return builder.to_byte_buffer();
+}
+
+static Optional<StoredEntry> decode_entry(const ByteBuffer& data)
+{
+    GenericLexer lexer { StringView(data) };
+    StoredEntry entry;
+    entry.url = lexer.consume_line();
+    auto response_time = lexer.consume_line().to_uint<u64>();
+    auto status_code = lexer.consume_line().to_uint();
+    if (!response_time.has_value() || !status_code.has_value())
+        return {};
+    entry.response_time = response_time.value();
+    entry.response.status_code = status_code.value();
+
+    for (;;) {
+        // A file without the empty line after the headers has been cut short.
+        if (lexer.is_eof())
+            return {};
+        auto line = lexer.consume_line();
+        if (line.is_empty())
+            break;
+        auto colon = line.find(':');
+        if (!colon.has_value())
+            return {};
+        entry.response.headers.set(line.substring_view(0, colon.value()), line.substring_view(colon.value() + 1).trim_whitespace());
+    }
+
+    entry.response.body = ByteBuffer::copy(data.bytes().slice(lexer.tell()));
+    return entry;
+}
+
+DiskCache& DiskCache::the()
+{
+    static DiskCache cache(directory(), default_capacity);
+    return cache;
+}
+
+DiskCache::DiskCache(String directory, size_t capacity)
+    : m_directory(move(directory))
+    , m_capacity(capacity)
+{
+}
+
+bool DiskCache::can_use_for(const String& method, const HashMap<String, String>& request_headers)
+{
+    // Anything but a POST is sent as a GET (see Detail::start_download()).
+    if (method.equals_ignoring_case("post"))
+        return false;
+
+    for (auto& it : request_headers) {
+        // https://tools.ietf.org/html/rfc7234#section-3.2
+        if (it.key.equals_ignoring_case("Authorization"))
+            return false;
+        // Reloading asks for a response straight from the server.
+        if (it.key.equals_ignoring_case("Cache-Control") || it.key.equals_ignoring_case("Pragma")) {
+            if (it.value.contains("no-cache", CaseSensitivity::CaseInsensitive) || it.value.contains("no-store", CaseSensitivity::CaseInsensitive))
+                return false;
+        }
+    }
+    return true;
+}
+
+String DiskCache::path_for(const URL& url) const
+{
+    // Entries also record their URL, so a hash collision only costs a cache miss.
+    return String::formatted("{}/{:08x}", m_directory, url.to_string().hash());
+}
+
+Optional<DiskCache::Response> DiskCache::lookup(const URL& url, time_t now)
+{
+    auto path = path_for(url);
+    auto file_or_error = Core::File::open(path, Core::IODevice::ReadOnly);
+    if (file_or_error.is_error())
+        return {};
+
+    auto entry = decode_entry(file_or_error.value()->read_all());
+    if (!entry.has_value() || entry->url != url.to_string())
+        return {};
+
+    auto& response = entry->response;
+    if (now >= HTTP::fresh_until(response.headers, entry->response_time, HTTP::CacheType::Shared)) {
+        dbgln_if(CACHE_DEBUG, "Not using stale disk cache entry for {}", url);
+        return {};
+    }
+
+    // Eviction goes by modification time, so this makes the entry recently used.
+    utime(path.characters(), nullptr);
+
+    response.headers.set("Age", String::number(HTTP::current_age(response.headers, entry->response_time, now)));
+    return move(response);
+}
+
+void DiskCache::store(const URL& url, const Response& response, time_t response_time)
+{
+    if (response.status_code != 200 || response.body.size() > max_entry_size)
+        return;
+
+    auto cache_control = HTTP::CacheControl::from_headers(response.headers);
+    if (cache_control.no_store || cache_control.is_private || response.headers.contains("Set-Cookie"))
+        return;
+
+    // All requests send the same Accept-Encoding, but we can't tell responses that vary on anything else apart.
+    if (auto vary = response.headers.get("Vary"); vary.has_value() && !vary.value().equals_ignoring_case("Accept-Encoding"))
+        return;
+
+    // Stale entries are never used, so there's no point in storing one.
+    if (HTTP::fresh_until(response.headers, response_time, HTTP::CacheType::Shared) <= response_time)
+        return;
+
+    auto path = path_for(url);
+    auto temporary_path = String::formatted("{}.{}", path, getpid());
+    auto file_or_error = Core::File::open(temporary_path, Core::IODevice::WriteOnly, 0600);
+    if (file_or_error.is_error()) {
+        dbgln_if(CACHE_DEBUG, "Can't store {} in the disk cache: {}", url, file_or_error.error());
+        return;
+    }
+
+    auto data = encode_entry(url, response, response_time);
+    auto& file = *file_or_error.value();
+    if (!file.write(data.data(), data.size()) || !file.close()) {
+        unlink(temporary_path.characters());
+        return;
+    }
+
+    // Other instances see either the old entry or the new one, never half of one.
+    if (rename(temporary_path.characters(), path.characters()) < 0) {
+        perror("rename");
+        unlink(temporary_path.characters());
+        return;
+    }
+
+    dbgln_if(CACHE_DEBUG, "Stored {} in the disk cache", url);
+    if (m_size_in_bytes.has_value())
+        m_size_in_bytes.value() += data.size();
+    evict_if_needed();
+}
+
+void DiskCache::evict_if_needed()
+{
+    if (m_size_in_bytes.has_value() && m_size_in_bytes.value() <= m_capacity)
+        return;
+
+    struct CachedFile {
+        String path;
+        size_t size { 0 };
+        time_t last_use { 0 };
+    };
+    Vector<CachedFile> files;
+    size_t size_in_bytes = 0;
+
+    Core::DirIterator iterator(m_directory, Core::DirIterator::SkipDots);
+    while (iterator.has_next()) {
+        auto path = iterator.next_full_path();
+        struct stat st;
+        if (stat(path.characters(), &st) < 0 || !S_ISREG(st.st_mode))
+            continue;
+        files.append({ path, (size_t)st.st_size, st.st_mtime });
+        size_in_bytes += st.st_size;
+    }
+
+    if (size_in_bytes > m_capacity) {
+        quick_sort(files, [](auto& a, auto& b) { return a.last_use < b.last_use; });
+
+        // Make some room, so that the next few stores don't have to scan the directory again.
+        for (auto& file : files) {
+            if (size_in_bytes <= m_capacity / 4 * 3)
+                break;
+            dbgln_if(CACHE_DEBUG, "Evicting {} from the disk cache", file.path);
+            if (unlink(file.path.characters()) == 0)
+                size_in_bytes -= file.size;
+        }
+    }
+
+    m_size_in_bytes = size_in_bytes;
+}
+
+DiskCacheWriter::DiskCacheWriter(const URL& url, OutputStream& client_stream)
+    : m_url(url)
+    , m_client_stream(client_stream)
+{
+}
+
+size_t DiskCacheWriter::write(ReadonlyBytes bytes)
+{
+    auto nwritten = m_client_stream.write(bytes);
+    if (!m_too_large) {
+        if (m_body.size() + nwritten > DiskCache::max_entry_size) {
+            m_too_large = true;
+            m_body.clear();
+        } else {
+            m_body.append(bytes.data(), nwritten);
+        }
+    }
+    return nwritten;
+}
+
+bool DiskCacheWriter::write_or_error(ReadonlyBytes bytes)
+{
+    if (write(bytes) < bytes.size()) {
+        set_recoverable_error();
+        return false;
+    }
+    return true;
+}
+
+void DiskCacheWriter::did_finish(u32 status_code, const HashMap<String, String, CaseInsensitiveStringTraits>& headers)
+{
+    if (m_too_large)
+        return;
+    DiskCache::the().store(m_url, { status_code, headers, m_body }, time(nullptr));
+}
+
+}
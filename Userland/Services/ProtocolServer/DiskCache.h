@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/Optional.h>
+#include <AK/Stream.h>
+#include <AK/String.h>
+#include <AK/URL.h>
+#include <time.h>
+
+namespace ProtocolServer {
+
+// Responses to GET requests, kept on disk so that they are shared between all ProtocolServer instances
+// (there is one per client). A resource fetched by one WebContent process can then be reused by the next
+// one without going to the network. Since the cache is shared, it behaves like one: private responses,
+// responses that set cookies and requests with credentials are left out, and s-maxage is honored.
+// Entries are only handed out while they are fresh. Revalidating stale ones is left to the clients,
+// which send conditional requests for the resources they still have in memory.
+class DiskCache {
+public:
+    static constexpr size_t default_capacity = 64 * MiB;
+    static constexpr size_t max_entry_size = 4 * MiB;
+
+    struct Response {
+        u32 status_code { 0 };
+        HashMap<String, String, CaseInsensitiveStringTraits> headers;
+        ByteBuffer body;
+    };
+
+    static DiskCache& the();
+    static const char* directory() { return "/var/cache/ProtocolServer"; }
+
+    // Whether a request may be answered from the cache, and whether its response may be stored.
+    static bool can_use_for(const String& method, const HashMap<String, String>& request_headers);
+
+    // Returns a copy of the stored response, with its Age brought up to date, if it is still fresh.
+    Optional<Response> lookup(const URL&, time_t now);
+
+    void store(const URL&, const Response&, time_t response_time);
+
+private:
+    DiskCache(String directory, size_t capacity);
+
+    String path_for(const URL&) const;
+    void evict_if_needed();
+
+    String m_directory;
+    size_t m_capacity { 0 };
+
+    // Other instances write to the cache too, so this is only a lower bound until the next eviction scan.
+    Optional<size_t> m_size_in_bytes;
+};
+
+// Passes a response body through to the client, while keeping a copy to store in the disk cache
+// once the download has finished.
+class DiskCacheWriter final : public OutputStream {
+public:
+    DiskCacheWriter(const URL&, OutputStream& client_stream);
+
+    virtual size_t write(ReadonlyBytes) override;
+    virtual bool write_or_error(ReadonlyBytes) override;
+
+    void did_finish(u32 status_code, const HashMap<String, String, CaseInsensitiveStringTraits>& headers);
+
+private:
+    URL m_url;
+    OutputStream& m_client_stream;
+    ByteBuffer m_body;
+    bool m_too_large { false };
+};
+
+}
@@ -26,6 +26,7 @@
 
 #include <AK/Badge.h>
 #include <ProtocolServer/ClientConnection.h>
+#include <ProtocolServer/DiskCache.h>
 #include <ProtocolServer/Download.h>
 
 namespace ProtocolServer {
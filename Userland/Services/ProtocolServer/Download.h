@@ -30,6 +30,7 @@
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/Optional.h>
+#include <AK/OwnPtr.h>
 #include <AK/RefCounted.h>
 #include <AK/URL.h>
 #include <ProtocolServer/Forward.h>
@@ -63,6 +64,10 @@ public:
     void set_downloaded_size(size_t size) { m_downloaded_size = size; }
     const OutputFileStream& output_stream() const { return *m_output_stream; }
 
+    // Set when the response is to be stored in the disk cache once it has been received.
+    DiskCacheWriter* disk_cache_writer() { return m_disk_cache_writer.ptr(); }
+    void set_disk_cache_writer(OwnPtr<DiskCacheWriter>&& writer) { m_disk_cache_writer = move(writer); }
+
 protected:
     explicit Download(ClientConnection&, NonnullOwnPtr<OutputFileStream>&&);
 
@@ -75,6 +80,7 @@ private:
     Optional<u32> m_total_size {};
     size_t m_downloaded_size { 0 };
     NonnullOwnPtr<OutputFileStream> m_output_stream;
+    OwnPtr<DiskCacheWriter> m_disk_cache_writer;
     HashMap<String, String, CaseInsensitiveStringTraits> m_response_headers;
 };
 
@@ -28,7 +28,10 @@
 
 namespace ProtocolServer {
 
+class CachedDownload;
 class ClientConnection;
+class DiskCache;
+class DiskCacheWriter;
 class Download;
 class GeminiProtocol;
 class HttpDownload;
@@ -27,6 +27,7 @@
 #pragma once
 
 #include <AK/ByteBuffer.h>
+#include <AK/Debug.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/Optional.h>
@@ -34,7 +35,9 @@
 #include <AK/String.h>
 #include <AK/Types.h>
 #include <LibHTTP/HttpRequest.h>
+#include <ProtocolServer/CachedDownload.h>
 #include <ProtocolServer/ClientConnection.h>
+#include <ProtocolServer/DiskCache.h>
 #include <ProtocolServer/Download.h>
 
 namespace ProtocolServer::Detail {
@@ -53,6 +56,10 @@ void init(TSelf* self, TJob job)
             self->set_status_code(response->code());
             self->set_response_headers(response->headers());
             self->set_downloaded_size(self->output_stream().size());
+            if (success) {
+                if (auto* disk_cache_writer = self->disk_cache_writer())
+                    disk_cache_writer->did_finish(response->code(), response->headers());
+            }
         }
 
         // if we didn't know the total size, pretend that the download finished successfully
@@ -82,6 +89,17 @@ OwnPtr<Download> start_download(TBadgedProtocol&& protocol, ClientConnection& cl
         return {};
     }
 
+    bool use_disk_cache = DiskCache::can_use_for(method, headers);
+    if (use_disk_cache) {
+        if (auto response = DiskCache::the().lookup(url, time(nullptr)); response.has_value()) {
+            dbgln_if(CACHE_DEBUG, "Answering {} from the disk cache", url);
+            auto output_stream = make<OutputFileStream>(pipe_result.value().write_fd);
+            auto download = CachedDownload::create(client, response.release_value(), pipe_result.value().write_fd, move(output_stream));
+            download->set_download_fd(pipe_result.value().read_fd);
+            return download;
+        }
+    }
+
     HTTP::HttpRequest request;
     if (method.equals_ignoring_case("post"))
         request.set_method(HTTP::HttpRequest::Method::POST);
@@ -93,9 +111,13 @@ OwnPtr<Download> start_download(TBadgedProtocol&& protocol, ClientConnection& cl
 
     auto output_stream = make<OutputFileStream>(pipe_result.value().write_fd);
     output_stream->make_unbuffered();
-    auto job = TJob::construct(request, *output_stream);
+    OwnPtr<DiskCacheWriter> disk_cache_writer;
+    if (use_disk_cache)
+        disk_cache_writer = make<DiskCacheWriter>(url, *output_stream);
+    auto job = TJob::construct(request, disk_cache_writer ? static_cast<OutputStream&>(*disk_cache_writer) : *output_stream);
     auto download = TDownload::create_with_job(forward<TBadgedProtocol>(protocol), client, (TJob&)*job, move(output_stream));
     download->set_download_fd(pipe_result.value().read_fd);
+    download->set_disk_cache_writer(move(disk_cache_writer));
     job->start();
     return download;
 }
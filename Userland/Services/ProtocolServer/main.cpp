@@ -29,13 +29,14 @@
 #include <LibIPC/ClientConnection.h>
 #include <LibTLS/Certificate.h>
 #include <ProtocolServer/ClientConnection.h>
+#include <ProtocolServer/DiskCache.h>
 #include <ProtocolServer/GeminiProtocol.h>
 #include <ProtocolServer/HttpProtocol.h>
 #include <ProtocolServer/HttpsProtocol.h>
 
 int main(int, char**)
 {
-    if (pledge("stdio inet accept unix rpath cpath fattr sendfd recvfd", nullptr) < 0) {
+    if (pledge("stdio inet accept unix rpath wpath cpath fattr sendfd recvfd", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
@@ -45,7 +46,8 @@ int main(int, char**)
 
     Core::EventLoop event_loop;
     // FIXME: Establish a connection to LookupServer and then drop "unix"?
-    if (pledge("stdio inet accept unix sendfd recvfd", nullptr) < 0) {
+    // The disk cache needs rpath, wpath, cpath and fattr.
+    if (pledge("stdio inet accept unix rpath wpath cpath fattr sendfd recvfd", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
@@ -53,6 +55,10 @@ int main(int, char**)
         perror("unveil");
         return 1;
     }
+    if (unveil(ProtocolServer::DiskCache::directory(), "rwc") < 0) {
+        perror("unveil");
+        return 1;
+    }
     if (unveil(nullptr, nullptr) < 0) {
         perror("unveil");
         return 1;
@@ -64,6 +64,13 @@ Gfx::Palette PageHost::palette() const
 void PageHost::set_palette_impl(const Gfx::PaletteImpl& impl)
 {
     m_palette_impl = impl;
+    page().main_frame().tile_cache().invalidate_all();
+}
+
+void PageHost::set_should_show_line_box_borders(bool b)
+{
+    m_should_show_line_box_borders = b;
+    page().main_frame().tile_cache().invalidate_all();
 }
 
 Web::Layout::InitialContainingBlockBox* PageHost::layout_root()
@@ -85,10 +92,22 @@ void PageHost::paint(const Gfx::IntRect& content_rect, Gfx::Bitmap& target)
         return;
     }
 
-    Web::PaintContext context(painter, palette(), content_rect.top_left());
-    context.set_should_show_line_box_borders(m_should_show_line_box_borders);
-    context.set_viewport_rect(content_rect);
-    layout_root->paint_all_phases(context);
+    auto paint_content = [&](Gfx::Painter& content_painter, const Gfx::IntRect& rect) {
+        Web::PaintContext context(content_painter, palette(), rect.top_left());
+        context.set_should_show_line_box_borders(m_should_show_line_box_borders);
+        context.set_viewport_rect(rect);
+        layout_root->paint_all_phases(context);
+    };
+
+    // Fixed position boxes move along with the viewport, so they can't be painted into tiles.
+    auto& tile_cache = page().main_frame().tile_cache();
+    if (layout_root->has_fixed_position_boxes()) {
+        tile_cache.invalidate_all();
+        paint_content(painter, content_rect);
+        return;
+    }
+
+    tile_cache.paint(painter, content_rect, move(paint_content));
 }
 
 void PageHost::set_viewport_rect(const Gfx::IntRect& rect)
@@ -103,6 +122,7 @@ void PageHost::page_did_invalidate(const Gfx::IntRect& content_rect)
 
 void PageHost::page_did_change_selection()
 {
+    page().main_frame().tile_cache().invalidate_all();
     m_client.post_message(Messages::WebContentClient::DidChangeSelection());
 }
 
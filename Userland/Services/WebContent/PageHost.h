@@ -50,7 +50,7 @@ public:
     void set_viewport_rect(const Gfx::IntRect&);
     void set_screen_rect(const Gfx::IntRect& rect) { m_screen_rect = rect; };
 
-    void set_should_show_line_box_borders(bool b) { m_should_show_line_box_borders = b; }
+    void set_should_show_line_box_borders(bool);
 
 private:
     // ^PageClient
@@ -39,6 +39,8 @@
 #include <LibGfx/Painter.h>
 #include <LibGfx/StylePainter.h>
 #include <LibThread/BackgroundAction.h>
+#include <time.h>
+#include <unistd.h>
 
 namespace WindowServer {
 
@@ -48,6 +50,16 @@ Compositor& Compositor::the()
     return s_the;
 }
 
+// FIXME: Ask the display for its actual refresh rate.
+static constexpr i64 frame_interval_us = 1'000'000 / 60;
+
+static Time monotonic_now()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return Time::from_timespec(now);
+}
+
 static WallpaperMode mode_to_enum(const String& name)
 {
     if (name == "simple")
@@ -76,12 +88,17 @@ Compositor::Compositor()
         },
         this);
 
-    m_immediate_compose_timer = Core::Timer::create_single_shot(
-        0,
-        [this] {
-            compose();
-        },
-        this);
+    m_frame_origin = monotonic_now();
+
+    register_property("composed_frame_count", [this] { return JsonValue { m_composed_frame_count }; });
+    register_property("dropped_frame_count", [this] { return JsonValue { m_dropped_frame_count }; });
+    register_property("last_compose_time_us", [this] { return JsonValue { m_last_compose_time_us }; });
+    register_property("estimated_compose_time_us", [this] { return JsonValue { m_estimated_compose_time_us }; });
+    register_property("last_flushed_pixel_count", [this] { return JsonValue { m_last_flushed_pixel_count }; });
+
+    // The thread running compose() renders tiles as well, so we only need one worker per additional processor.
+    auto processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+    m_tile_workers = make<LibThread::WorkerPool>(processor_count > 1 ? processor_count - 1 : 0, "Compositor");
 
     m_screen_can_set_buffer = Screen::the().can_set_buffer();
     init_bitmaps();
@@ -138,6 +155,8 @@ void Compositor::compose()
         return;
     }
 
+    auto compose_start_time = monotonic_now();
+
     if (m_occlusions_dirty) {
         m_occlusions_dirty = false;
         recompute_occlusions();
@@ -209,7 +228,9 @@ void Compositor::compose()
     bool need_to_draw_cursor = false;
 
     auto back_painter = *m_back_painter;
-    auto temp_painter = *m_temp_painter;
+
+    // Window and wallpaper painting is only recorded here, and then replayed in parallel by render_tiles().
+    Vector<PaintCommand> paint_commands;
 
     auto check_restore_cursor_back = [&](const Gfx::IntRect& rect) {
         if (!need_to_draw_cursor && rect.intersects(cursor_rect)) {
@@ -269,7 +290,9 @@ void Compositor::compose()
     m_opaque_wallpaper_rects.for_each_intersected(dirty_screen_rects, [&](const Gfx::IntRect& render_rect) {
         dbgln_if(COMPOSE_DEBUG, "  render wallpaper opaque: {}", render_rect);
         prepare_rect(render_rect);
-        paint_wallpaper(back_painter, render_rect);
+        paint_commands.append({ PaintTarget::BackBuffer, render_rect, [&paint_wallpaper, render_rect](Gfx::Painter& painter) {
+                                   paint_wallpaper(painter, render_rect);
+                               } });
         return IterationDecision::Continue;
     });
 
@@ -282,8 +305,13 @@ void Compositor::compose()
 
         dbgln_if(COMPOSE_DEBUG, "  window {} frame rect: {}", window.title(), frame_rect);
 
+        // The frame caches can't be updated while tiles are being rendered.
+        if (!window.is_fullscreen())
+            window.frame().render_to_cache();
+
+        // This outlives compose_window(), so anything local to it is captured by value.
         RefPtr<Gfx::Bitmap> backing_store = window.backing_store();
-        auto compose_window_rect = [&](Gfx::Painter& painter, const Gfx::IntRect& rect) {
+        auto compose_window_rect = [&, &window = window, backing_store, window_rect, frame_rects](Gfx::Painter& painter, const Gfx::IntRect& rect) {
             if (!window.is_fullscreen()) {
                 rect.for_each_intersected(frame_rects, [&](const Gfx::IntRect& intersected_rect) {
                     Gfx::PainterStateSaver saver(painter);
@@ -386,9 +414,9 @@ void Compositor::compose()
                 dbgln_if(COMPOSE_DEBUG, "    render opaque: {}", render_rect);
 
                 prepare_rect(render_rect);
-                Gfx::PainterStateSaver saver(back_painter);
-                back_painter.add_clip_rect(render_rect);
-                compose_window_rect(back_painter, render_rect);
+                paint_commands.append({ PaintTarget::BackBuffer, render_rect, [compose_window_rect, render_rect](Gfx::Painter& painter) {
+                                           compose_window_rect(painter, render_rect);
+                                       } });
                 return IterationDecision::Continue;
             });
         }
@@ -401,7 +429,9 @@ void Compositor::compose()
                 dbgln_if(COMPOSE_DEBUG, "    render wallpaper: {}", render_rect);
 
                 prepare_transparency_rect(render_rect);
-                paint_wallpaper(temp_painter, render_rect);
+                paint_commands.append({ PaintTarget::TempBuffer, render_rect, [&paint_wallpaper, render_rect](Gfx::Painter& painter) {
+                                           paint_wallpaper(painter, render_rect);
+                                       } });
                 return IterationDecision::Continue;
             });
         }
@@ -411,9 +441,9 @@ void Compositor::compose()
                 dbgln_if(COMPOSE_DEBUG, "    render transparent: {}", render_rect);
 
                 prepare_transparency_rect(render_rect);
-                Gfx::PainterStateSaver saver(temp_painter);
-                temp_painter.add_clip_rect(render_rect);
-                compose_window_rect(temp_painter, render_rect);
+                paint_commands.append({ PaintTarget::TempBuffer, render_rect, [compose_window_rect, render_rect](Gfx::Painter& painter) {
+                                           compose_window_rect(painter, render_rect);
+                                       } });
                 return IterationDecision::Continue;
             });
         }
@@ -445,11 +475,11 @@ void Compositor::compose()
             }
             return false;
         }());
+    }
 
-        // Copy anything rendered to the temporary buffer to the back buffer
-        for (auto& rect : flush_transparent_rects.rects())
-            back_painter.blit(rect.location(), *m_temp_bitmap, rect);
+    render_tiles(paint_commands, flush_transparent_rects);
 
+    if (m_invalidated_window) {
         Gfx::IntRect geometry_label_damage_rect;
         if (draw_geometry_label(geometry_label_damage_rect))
             flush_special_rects.add(geometry_label_damage_rect);
@@ -514,12 +544,96 @@ void Compositor::compose()
     if (m_screen_can_set_buffer)
         flip_buffers();
 
-    for (auto& rect : flush_rects.rects())
+    size_t flushed_pixel_count = 0;
+    auto flush_and_count = [&](const Gfx::IntRect& rect) {
         flush(rect);
+        flushed_pixel_count += rect.intersected(ws.rect()).size().area();
+    };
+    for (auto& rect : flush_rects.rects())
+        flush_and_count(rect);
     for (auto& rect : flush_transparent_rects.rects())
-        flush(rect);
+        flush_and_count(rect);
     for (auto& rect : flush_special_rects.rects())
-        flush(rect);
+        flush_and_count(rect);
+
+    did_compose_frame(compose_start_time, flushed_pixel_count);
+}
+
+void Compositor::did_compose_frame(const Time& compose_start_time, size_t flushed_pixel_count)
+{
+    auto now = monotonic_now();
+    auto compose_time_us = (now - compose_start_time).to_microseconds();
+
+    // A running average keeps one slow frame from throwing off the schedule.
+    if (m_estimated_compose_time_us)
+        m_estimated_compose_time_us = (7 * m_estimated_compose_time_us + compose_time_us) / 8;
+    else
+        m_estimated_compose_time_us = compose_time_us;
+
+    // The frame is shown at the first refresh boundary after we finished it.
+    auto frame_index = (now - m_frame_origin).to_microseconds() / frame_interval_us + 1;
+    if (m_scheduled_frame_index && frame_index > m_scheduled_frame_index) {
+        m_dropped_frame_count += frame_index - m_scheduled_frame_index;
+        dbgln_if(COMPOSE_DEBUG, "COMPOSE: frame {} missed its refresh by {} interval(s)", m_scheduled_frame_index, frame_index - m_scheduled_frame_index);
+    }
+    m_last_frame_index = frame_index;
+    if (!m_compose_timer->is_active())
+        m_scheduled_frame_index = 0;
+
+    ++m_composed_frame_count;
+    m_last_compose_time_us = compose_time_us;
+    m_last_flushed_pixel_count = flushed_pixel_count;
+
+    dbgln_if(COMPOSE_DEBUG, "COMPOSE: frame {} took {}us (estimate {}us), flushed {} pixels", frame_index, compose_time_us, m_estimated_compose_time_us, flushed_pixel_count);
+}
+
+void Compositor::render_tiles(const Vector<PaintCommand>& paint_commands, const Gfx::DisjointRectSet& flush_transparent_rects)
+{
+    if (paint_commands.is_empty())
+        return;
+
+    // Small updates (a hovered button, a blinking caret) are cheaper to paint
+    // directly than to hand out to the workers.
+    static constexpr size_t parallel_render_threshold = 256 * 256;
+    size_t dirty_area = 0;
+    for (auto& command : paint_commands)
+        dirty_area += command.rect.width() * command.rect.height();
+
+    size_t tile_count = 1;
+    if (dirty_area >= parallel_render_threshold)
+        tile_count = m_tile_workers->thread_count() + 1;
+
+    // The tiles are horizontal bands of the screen, so every one of them touches
+    // a disjoint set of scanlines in both buffers and needs no further locking.
+    auto screen_rect = Screen::the().rect();
+    int tile_height = ceil_div(screen_rect.height(), static_cast<int>(tile_count));
+
+    m_tile_workers->for_each(tile_count, [&](size_t tile_index) {
+        Gfx::IntRect tile_rect { 0, static_cast<int>(tile_index) * tile_height, screen_rect.width(), tile_height };
+        tile_rect.intersect(screen_rect);
+        if (tile_rect.is_empty())
+            return;
+
+        auto back_painter = *m_back_painter;
+        auto temp_painter = *m_temp_painter;
+        back_painter.add_clip_rect(tile_rect);
+        temp_painter.add_clip_rect(tile_rect);
+
+        for (auto& command : paint_commands) {
+            if (!command.rect.intersects(tile_rect))
+                continue;
+            auto& painter = command.target == PaintTarget::BackBuffer ? back_painter : temp_painter;
+            Gfx::PainterStateSaver saver(painter);
+            painter.add_clip_rect(command.rect);
+            command.paint(painter);
+        }
+
+        // Copy anything rendered to the temporary buffer to the back buffer
+        for (auto& rect : flush_transparent_rects.rects()) {
+            if (rect.intersects(tile_rect))
+                back_painter.blit(rect.location(), *m_temp_bitmap, rect);
+        }
+    });
 }
 
 void Compositor::flush(const Gfx::IntRect& a_rect)
@@ -590,13 +704,20 @@ void Compositor::invalidate_window()
 
 void Compositor::start_compose_async_timer()
 {
-    // We delay composition by a timer interval, but to not affect latency too
-    // much, if a pending compose is not already scheduled, we also schedule an
-    // immediate compose the next spin of the event loop.
-    if (!m_compose_timer->is_active()) {
-        m_compose_timer->start();
-        m_immediate_compose_timer->start();
-    }
+    // Any damage arriving while a frame is already scheduled is batched into that frame.
+    if (m_compose_timer->is_active())
+        return;
+
+    // We compose at most once per refresh interval, and start each frame just
+    // early enough that it is expected to be done by the next refresh boundary.
+    // When composing takes longer than an interval, this skips to the first
+    // boundary we can actually make, coalescing all damage up to that point.
+    auto now_us = (monotonic_now() - m_frame_origin).to_microseconds();
+    auto frame_index = max(m_last_frame_index + 1, (now_us + m_estimated_compose_time_us) / frame_interval_us + 1);
+    auto start_us = frame_index * frame_interval_us - m_estimated_compose_time_us;
+
+    m_scheduled_frame_index = frame_index;
+    m_compose_timer->start(max<i64>(0, (start_us - now_us) / 1000));
 }
 
 bool Compositor::set_background_color(const String& background_color)
@@ -28,9 +28,11 @@
 
 #include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
+#include <AK/Time.h>
 #include <LibCore/Object.h>
 #include <LibGfx/Color.h>
 #include <LibGfx/DisjointRectSet.h>
+#include <LibThread/WorkerPool.h>
 
 namespace WindowServer {
 
@@ -79,13 +81,26 @@ public:
     const Gfx::Bitmap& front_bitmap_for_screenshot(Badge<ClientConnection>) const { return *m_front_bitmap; }
 
 private:
+    enum class PaintTarget {
+        BackBuffer,
+        TempBuffer,
+    };
+
+    struct PaintCommand {
+        PaintTarget target;
+        Gfx::IntRect rect;
+        Function<void(Gfx::Painter&)> paint;
+    };
+
     Compositor();
     void init_bitmaps();
+    void render_tiles(const Vector<PaintCommand>&, const Gfx::DisjointRectSet& flush_transparent_rects);
     void flip_buffers();
     void flush(const Gfx::IntRect&);
     void run_animations(Gfx::DisjointRectSet&);
     void notify_display_links();
     void start_compose_async_timer();
+    void did_compose_frame(const Time& compose_start_time, size_t flushed_pixel_count);
     void recompute_occlusions();
     bool any_opaque_window_above_this_one_contains_rect(const Window&, const Gfx::IntRect&);
     void change_cursor(const Cursor*);
@@ -94,7 +109,6 @@ private:
     bool draw_geometry_label(Gfx::IntRect&);
 
     RefPtr<Core::Timer> m_compose_timer;
-    RefPtr<Core::Timer> m_immediate_compose_timer;
     bool m_flash_flush { false };
     bool m_buffers_are_flipped { false };
     bool m_screen_can_set_buffer { false };
@@ -110,6 +124,8 @@ private:
     OwnPtr<Gfx::Painter> m_front_painter;
     OwnPtr<Gfx::Painter> m_temp_painter;
 
+    OwnPtr<LibThread::WorkerPool> m_tile_workers;
+
     Gfx::DisjointRectSet m_dirty_screen_rects;
     Gfx::DisjointRectSet m_opaque_wallpaper_rects;
 
@@ -131,6 +147,17 @@ private:
     size_t m_display_link_count { 0 };
 
     Optional<Gfx::Color> m_custom_background_color;
+
+    // Frames are numbered by the refresh interval they are shown in, counting from m_frame_origin.
+    Time m_frame_origin;
+    i64 m_last_frame_index { 0 };
+    i64 m_scheduled_frame_index { 0 };
+    i64 m_estimated_compose_time_us { 0 };
+
+    u64 m_composed_frame_count { 0 };
+    u64 m_dropped_frame_count { 0 };
+    i64 m_last_compose_time_us { 0 };
+    size_t m_last_flushed_pixel_count { 0 };
 };
 
 }
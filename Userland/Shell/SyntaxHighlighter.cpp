@@ -552,6 +552,10 @@ bool SyntaxHighlighter::is_navigatable(void*) const
 
 void SyntaxHighlighter::rehighlight(const Palette& palette)
 {
+    // FIXME: This reparses the whole document on every change. To derive from Syntax::IncrementalHighlighter instead,
+    //        the parser would have to be able to start at a line and tell, at the end of each line, whether it is at
+    //        the top level (outside any string, block, subshell, heredoc or line continuation), which would then be
+    //        the state that lexing resumes from.
     auto text = m_client->get_text();
 
     Parser parser(text);
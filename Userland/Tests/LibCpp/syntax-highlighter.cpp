@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/NumericLimits.h>
+#include <AK/StringBuilder.h>
+#include <AK/TestSuite.h>
+
+#include <LibCore/AnonymousBuffer.h>
+#include <LibCore/EventLoop.h>
+#include <LibCpp/SyntaxHighlighter.h>
+#include <LibGUI/TextDocument.h>
+#include <LibGfx/Palette.h>
+#include <LibGfx/SystemTheme.h>
+
+static NonnullRefPtr<GUI::TextDocument> create_document()
+{
+    // TextDocument starts a timer, so there has to be an event loop.
+    static Core::EventLoop event_loop;
+    return GUI::TextDocument::create();
+}
+
+// Keeps its spans in a TextDocument and tells the highlighter about the document's edits, like TextEditor does.
+class TestClient final
+    : public Syntax::HighlighterClient
+    , public GUI::TextDocument::Client {
+public:
+    TestClient() { m_document->register_client(*this); }
+    virtual ~TestClient() override { m_document->unregister_client(*this); }
+
+    Syntax::Highlighter* highlighter { nullptr };
+    GUI::TextPosition cursor;
+    size_t last_visible_line { NumericLimits<size_t>::max() };
+
+    GUI::TextDocument& document() { return m_document; }
+
+    virtual Vector<GUI::TextDocumentSpan>& spans() override { return m_document->spans(); }
+    virtual const Vector<GUI::TextDocumentSpan>& spans() const override { return m_document->spans(); }
+    virtual void set_span_at_index(size_t index, GUI::TextDocumentSpan span) override { m_document->set_span_at_index(index, move(span)); }
+    virtual String highlighter_did_request_text() const override { return m_document->text(); }
+    virtual void highlighter_did_request_update() override { }
+    virtual GUI::TextDocument& highlighter_did_request_document() override { return m_document; }
+    virtual GUI::TextPosition highlighter_did_request_cursor() const override { return cursor; }
+    virtual size_t highlighter_did_request_last_visible_line() const override { return last_visible_line; }
+    virtual void highlighter_did_set_spans(Vector<GUI::TextDocumentSpan> spans) override { m_document->set_spans(move(spans)); }
+
+    virtual void document_did_append_line() override
+    {
+        if (highlighter)
+            highlighter->did_insert_line(m_document->line_count() - 1);
+    }
+    virtual void document_did_insert_line(size_t line_index) override
+    {
+        if (highlighter)
+            highlighter->did_insert_line(line_index);
+    }
+    virtual void document_did_remove_line(size_t line_index) override
+    {
+        if (highlighter)
+            highlighter->did_remove_line(line_index);
+    }
+    virtual void document_did_remove_all_lines() override
+    {
+        if (highlighter)
+            highlighter->did_change_all_lines();
+    }
+    virtual void document_did_change_line(size_t line_index) override
+    {
+        if (highlighter)
+            highlighter->did_change_line(line_index);
+    }
+    virtual void document_did_change() override { }
+    virtual void document_did_set_text() override
+    {
+        if (highlighter)
+            highlighter->did_change_all_lines();
+    }
+    virtual void document_did_set_cursor(const GUI::TextPosition&) override { }
+    virtual bool is_automatic_indentation_enabled() const override { return false; }
+    virtual int soft_tab_width() const override { return 4; }
+
+private:
+    NonnullRefPtr<GUI::TextDocument> m_document { create_document() };
+};
+
+static Gfx::Palette& test_palette()
+{
+    static auto palette_impl = Gfx::PaletteImpl::create_with_anonymous_buffer(Core::AnonymousBuffer::create_with_size(sizeof(Gfx::SystemTheme)));
+    static Gfx::Palette palette(*palette_impl);
+    return palette;
+}
+
+static bool span_is_equal(const GUI::TextDocumentSpan& a, const GUI::TextDocumentSpan& b)
+{
+    return a.range == b.range && a.data == b.data && a.is_skippable == b.is_skippable
+        && a.attributes.color == b.attributes.color && a.attributes.bold == b.attributes.bold
+        && a.attributes.background_color == b.attributes.background_color;
+}
+
+// Whether the spans are the same as the first ones of the reference spans, and there are as many as there
+// have to be to cover all the lines up to the given one.
+static bool spans_are_prefix_of(const Vector<GUI::TextDocumentSpan>& spans, const Vector<GUI::TextDocumentSpan>& reference, size_t last_line)
+{
+    if (spans.size() > reference.size())
+        return false;
+    for (size_t i = 0; i < spans.size(); ++i) {
+        if (!span_is_equal(spans[i], reference[i]))
+            return false;
+    }
+    return spans.size() == reference.size() || reference[spans.size()].range.start().line() > last_line;
+}
+
+static GUI::TextPosition position_at_offset(const StringView& text, size_t offset)
+{
+    GUI::TextPosition position { 0, 0 };
+    for (size_t i = 0; i < offset; ++i) {
+        if (text[i] == '\n')
+            position = { position.line() + 1, 0 };
+        else
+            position.set_column(position.column() + 1);
+    }
+    return position;
+}
+
+// Highlights a sequence of texts as edits of one document, and checks that each time the spans
+// are the same as what a new highlighter makes of the text from scratch.
+class HighlightChecker {
+public:
+    HighlightChecker()
+    {
+        m_client.highlighter = &m_highlighter;
+        m_highlighter.attach(m_client);
+    }
+
+    void set_last_visible_line(size_t line) { m_client.last_visible_line = line; }
+
+    bool edit(String text, GUI::TextPosition cursor = {})
+    {
+        apply_edit(text);
+        m_client.cursor = cursor;
+        m_highlighter.rehighlight(test_palette());
+        return spans_are_correct();
+    }
+
+    bool scroll_to(size_t last_visible_line)
+    {
+        m_client.last_visible_line = last_visible_line;
+        m_highlighter.visible_lines_did_change(test_palette());
+        return spans_are_correct();
+    }
+
+    const String& text() const { return m_text; }
+    const Vector<GUI::TextDocumentSpan>& spans() const { return m_client.spans(); }
+
+private:
+    // Turns the change from the current text into the given one into a removal and an insertion
+    // in the document, so that the highlighter only hears about the lines that changed.
+    void apply_edit(const String& text)
+    {
+        size_t prefix = 0;
+        while (prefix < m_text.length() && prefix < text.length() && m_text[prefix] == text[prefix])
+            ++prefix;
+        size_t suffix = 0;
+        while (suffix < m_text.length() - prefix && suffix < text.length() - prefix
+            && m_text[m_text.length() - suffix - 1] == text[text.length() - suffix - 1])
+            ++suffix;
+
+        auto start = position_at_offset(m_text, prefix);
+        if (prefix + suffix < m_text.length())
+            m_client.document().remove({ start, position_at_offset(m_text, m_text.length() - suffix) });
+        if (prefix + suffix < text.length())
+            m_client.document().insert_at(start, text.substring_view(prefix, text.length() - prefix - suffix));
+        m_text = text;
+        VERIFY(m_client.document().text() == m_text);
+    }
+
+    bool spans_are_correct()
+    {
+        TestClient reference_client;
+        // set_text() would drop a trailing newline, so the text is inserted like an edit before there is a highlighter.
+        reference_client.document().insert_at({ 0, 0 }, m_text);
+        reference_client.cursor = m_client.cursor;
+        Cpp::SyntaxHighlighter reference_highlighter;
+        reference_highlighter.attach(reference_client);
+        reference_highlighter.rehighlight(test_palette());
+
+        return spans_are_prefix_of(m_client.spans(), reference_client.spans(), m_client.last_visible_line);
+    }
+
+    String m_text { "" };
+    TestClient m_client;
+    Cpp::SyntaxHighlighter m_highlighter;
+};
+
+TEST_CASE(block_comments)
+{
+    HighlightChecker checker;
+    EXPECT(checker.edit("int a;\nint b;\nint c;\nint d;\n"));
+    EXPECT(checker.edit("int a;\n/* int b;\nint c;\nint d;\n"));
+    EXPECT(checker.edit("int a;\n/* int b;\nint c; */\nint d;\n"));
+    EXPECT(checker.edit("int a;\n/* int b;\nint c; \nint d;\n"));
+    EXPECT(checker.edit("int a;\n int b;\nint c; \nint d;\n"));
+    EXPECT(checker.edit("/*\nint a;\n int b;\nint c; \nint d;\n"));
+    EXPECT(checker.edit("/*\nint a;\n int b;\nint c; \nint d;\n*/"));
+}
+
+TEST_CASE(string_continued_on_next_line)
+{
+    // The escape sequence at the start of the second line is part of the string, so lexing can't restart there.
+    HighlightChecker checker;
+    EXPECT(checker.edit("char* s = \"abc\n\\tdef\";\nint x;\nint y;\n"));
+    EXPECT(checker.edit("char* s = \"abc\n\\tdeg\";\nint x;\nint y;\n"));
+    EXPECT(checker.edit("char* s = \"abc\n\\tdeg\n\";\nint x;\nint y;\n"));
+}
+
+TEST_CASE(include_path_on_next_line)
+{
+    HighlightChecker checker;
+    EXPECT(checker.edit("#include\n<foo.h>\nint x;\n"));
+    EXPECT(checker.edit("#include\n<foo/bar.h>\nint x;\n"));
+    EXPECT(checker.edit("#include\n\n<foo/bar.h>\nint x;\n"));
+    EXPECT(checker.edit("#include \n\n<foo/bar.h>\nint x;\n"));
+    EXPECT(checker.edit("#include \n<foo/bar.h>\nint x;\n"));
+    EXPECT(checker.edit("#includ \n<foo/bar.h>\nint x;\n"));
+}
+
+TEST_CASE(edits_at_end_of_text)
+{
+    HighlightChecker checker;
+    EXPECT(checker.edit("int x = 1;\n"));
+    EXPECT(checker.edit("int x = 1;\nin"));
+    EXPECT(checker.edit("int x = 1;\nint"));
+    EXPECT(checker.edit("int x = 1;\nint y = 12"));
+    EXPECT(checker.edit("int x = 1;\nint y = 12."));
+    EXPECT(checker.edit("int x = 1;\nint y = \"12"));
+    EXPECT(checker.edit("int x = 1;\nint y = \"12\""));
+    EXPECT(checker.edit("int x = 1;\n//"));
+    EXPECT(checker.edit("int x = 1;\n"));
+    EXPECT(checker.edit("int x = 1;"));
+    EXPECT(checker.edit("int x = 1"));
+}
+
+TEST_CASE(matching_braces)
+{
+    // The highlighting of matching braces around the cursor must not be carried over into later edits.
+    HighlightChecker checker;
+    EXPECT(checker.edit("void f()\n{\n    g();\n}\n", { 1, 0 }));
+    EXPECT(checker.edit("void f()\n{\n    g(1);\n}\n", { 2, 6 }));
+    EXPECT(checker.edit("void f()\n{\n    g(12);\n}\n", { 0, 0 }));
+}
+
+TEST_CASE(whitespace_is_split_into_lines)
+{
+    TestClient client;
+    client.document().set_text("int x;  \n\n  int y;");
+    Cpp::SyntaxHighlighter highlighter;
+    highlighter.attach(client);
+    highlighter.rehighlight(test_palette());
+
+    auto has_span = [&](GUI::TextRange range, bool is_skippable) {
+        for (auto& span : client.spans()) {
+            if (span.range == range)
+                return span.is_skippable == is_skippable;
+        }
+        return false;
+    };
+    EXPECT(has_span({ { 0, 0 }, { 0, 2 } }, false));
+    EXPECT(has_span({ { 0, 6 }, { 0, 8 } }, true));
+    EXPECT(has_span({ { 1, 0 }, { 1, 0 } }, true));
+    EXPECT(has_span({ { 2, 0 }, { 2, 1 } }, true));
+    EXPECT(has_span({ { 2, 2 }, { 2, 4 } }, false));
+}
+
+TEST_CASE(only_lines_in_view_are_highlighted)
+{
+    StringBuilder builder;
+    for (int i = 0; i < 1000; ++i)
+        builder.appendff("int x{} = {};\n", i, i);
+
+    auto text = builder.to_string();
+
+    HighlightChecker checker;
+    checker.set_last_visible_line(20);
+    EXPECT(checker.edit(text));
+    EXPECT(checker.spans().size() < 1000);
+    EXPECT(checker.edit(String::formatted("/*{}", text)));
+    EXPECT(checker.spans().size() < 1000);
+    EXPECT(checker.scroll_to(500));
+    EXPECT(checker.edit(text));
+    EXPECT(checker.scroll_to(999));
+    EXPECT(checker.edit(String::formatted("{}/*\n{}", text.substring_view(0, 5000), text.substring_view(5000))));
+    EXPECT(checker.scroll_to(10));
+}
+
+TEST_CASE(random_edits)
+{
+    static const char* snippets[] = {
+        "/*", "*/", "\n", "#include <foo.h>\n", "#include\n", "<bar.h>", "\"", "'", "x", " ", "int y = 5;\n", "//c\n",
+        "R\"(", ")\"", "{", "}", "\\", "#define X 1\n", "1.5f", "0x1f",
+    };
+    constexpr size_t snippet_count = sizeof(snippets) / sizeof(snippets[0]);
+
+    u32 seed = 1;
+    auto random = [&](size_t limit) {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 8) % limit;
+    };
+
+    for (int run = 0; run < 10; ++run) {
+        HighlightChecker checker;
+        // Half of the runs only look at the top of the text, and sometimes scroll.
+        bool has_small_view = run % 2;
+        if (has_small_view)
+            checker.set_last_visible_line(random(10));
+        StringBuilder builder;
+        for (int i = 0; i < 100; ++i)
+            builder.append(snippets[random(snippet_count)]);
+        EXPECT(checker.edit(builder.to_string()));
+
+        for (int edit = 0; edit < 200; ++edit) {
+            auto& text = checker.text();
+            size_t position = random(text.length() + 1);
+            // Every so often, edit right at the end of the text.
+            if (random(8) == 0)
+                position = text.length();
+            StringBuilder edited;
+            edited.append(text.substring_view(0, position));
+            if (random(2) && position < text.length()) {
+                edited.append(text.substring_view(position + min(random(20) + 1, text.length() - position)));
+            } else {
+                edited.append(snippets[random(snippet_count)]);
+                edited.append(text.substring_view(position));
+            }
+            bool spans_match = checker.edit(edited.to_string(), { random(20), random(20) });
+            if (has_small_view && random(10) == 0)
+                spans_match = spans_match && checker.scroll_to(random(40));
+            EXPECT(spans_match);
+            if (!spans_match) {
+                warnln("Spans differ after edit {} of run {}", edit, run);
+                break;
+            }
+        }
+    }
+}
+
+TEST_MAIN(SyntaxHighlighter)
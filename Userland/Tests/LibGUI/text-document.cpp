@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/TestSuite.h>
+
+#include <LibCore/EventLoop.h>
+#include <LibGUI/TextDocument.h>
+
+static NonnullRefPtr<GUI::TextDocument> create_document(const StringView& text)
+{
+    // TextDocument starts a timer, so there has to be an event loop.
+    static Core::EventLoop event_loop;
+    auto document = GUI::TextDocument::create();
+    EXPECT(document->set_text(text));
+    return document;
+}
+
+static GUI::TextRange range(size_t start_line, size_t start_column, size_t end_line, size_t end_column)
+{
+    return { { start_line, start_column }, { end_line, end_column } };
+}
+
+TEST_CASE(lines_are_decoded_on_first_use)
+{
+    auto document = create_document("hello\n\ngrüße, naïve café\nlast\n");
+    EXPECT_EQ(document->line_count(), 4u);
+
+    EXPECT(!document->line(0).is_materialized());
+    EXPECT_EQ(document->line(0).length(), 5u);
+    EXPECT(document->line(1).is_empty());
+    EXPECT_EQ(document->line(2).length(), 17u);
+    EXPECT(!document->line(2).is_materialized());
+    EXPECT_EQ(document->text(), "hello\n\ngrüße, naïve café\nlast");
+
+    EXPECT_EQ(document->line(2).code_points()[2], 0xfcu);
+    EXPECT(document->line(2).is_materialized());
+    EXPECT_EQ(document->line(2).length(), 17u);
+    EXPECT_EQ(document->line(2).to_utf8(), "grüße, naïve café");
+    EXPECT(!document->line(3).is_materialized());
+
+    document->line(3).insert(document, 0, 0xe9);
+    EXPECT_EQ(document->line(3).to_utf8(), "élast");
+    document->line(0).truncate(document, 2);
+    EXPECT_EQ(document->text(), "he\n\ngrüße, naïve café\nélast");
+}
+
+TEST_CASE(invalid_utf8_is_rejected)
+{
+    auto document = create_document("valid");
+    EXPECT(!document->set_text("abc\n\xc3\x28\n"));
+    EXPECT_EQ(document->line_count(), 1u);
+    EXPECT(document->line(0).is_empty());
+}
+
+TEST_CASE(find_next_wraps_around)
+{
+    auto document = create_document("foo bar\nbaz foo\n");
+    EXPECT_EQ(document->find_next("foo", { 0, 1 }), range(1, 4, 1, 7));
+    EXPECT_EQ(document->find_next("foo", { 1, 5 }), range(0, 0, 0, 3));
+    EXPECT(!document->find_next("foo", { 1, 5 }, GUI::TextDocument::SearchShouldWrap::No).is_valid());
+    EXPECT_EQ(document->find_next("bar", { 0, 4 }), range(0, 4, 0, 7));
+    EXPECT(!document->find_next("qux").is_valid());
+}
+
+TEST_CASE(find_previous_wraps_around)
+{
+    auto document = create_document("foo bar\nbaz foo\n");
+    EXPECT_EQ(document->find_previous("foo", { 1, 4 }), range(0, 0, 0, 3));
+    EXPECT_EQ(document->find_previous("foo", { 0, 2 }), range(1, 4, 1, 7));
+    EXPECT(!document->find_previous("foo", { 0, 2 }, GUI::TextDocument::SearchShouldWrap::No).is_valid());
+}
+
+TEST_CASE(matches_ending_at_end_of_line)
+{
+    auto document = create_document("abc\nxyzabc\nabc");
+    EXPECT_EQ(document->find_next("abc", { 0, 1 }), range(1, 3, 1, 6));
+    EXPECT_EQ(document->find_next("abc", { 1, 4 }), range(2, 0, 2, 3));
+    EXPECT_EQ(document->find_previous("abc", { 2, 0 }), range(1, 3, 1, 6));
+    EXPECT_EQ(document->find_previous("abc", { 1, 3 }), range(0, 0, 0, 3));
+    EXPECT_EQ(document->find_next("c\nx", { 0, 0 }), range(0, 2, 1, 1));
+}
+
+TEST_CASE(non_ascii_needles)
+{
+    auto document = create_document("grüße\nnaïve café, café\n");
+    EXPECT_EQ(document->find_next("café"), range(1, 6, 1, 10));
+    EXPECT_EQ(document->find_next("café", { 1, 7 }), range(1, 12, 1, 16));
+    EXPECT_EQ(document->find_next("café", { 1, 13 }), range(1, 6, 1, 10));
+    EXPECT_EQ(document->find_previous("ü", { 1, 0 }), range(0, 2, 0, 3));
+    EXPECT_EQ(document->find_previous("café", { 1, 12 }), range(1, 6, 1, 10));
+    EXPECT_EQ(document->find_next("ße\nna"), range(0, 3, 1, 2));
+    EXPECT(!document->find_next("cafe").is_valid());
+}
+
+TEST_CASE(searching_does_not_decode_lines)
+{
+    auto document = create_document("Foo bar\nnaïve FOO\nbaz\nfoo");
+    EXPECT_EQ(document->find_next("foo", { 0, 1 }, GUI::TextDocument::SearchShouldWrap::Yes, false, false), range(1, 6, 1, 9));
+    EXPECT_EQ(document->find_previous("FOO", { 1, 6 }, GUI::TextDocument::SearchShouldWrap::Yes, false, false), range(0, 0, 0, 3));
+    EXPECT_EQ(document->find_previous("foo", { 0, 2 }), range(3, 0, 3, 3));
+    EXPECT_EQ(document->find_next("ïve foo\nbaz\nf", {}, GUI::TextDocument::SearchShouldWrap::Yes, false, false), range(1, 2, 3, 1));
+    EXPECT_EQ(document->find_previous("baz\nfoo", { 0, 0 }), range(2, 0, 3, 3));
+    EXPECT(!document->find_previous("baz\nfoo", { 3, 2 }, GUI::TextDocument::SearchShouldWrap::No).is_valid());
+    EXPECT_EQ(document->find_previous("baz\nfoo", { 3, 2 }), range(2, 0, 3, 3));
+    EXPECT(!document->find_next("bar\nbaz").is_valid());
+    EXPECT_EQ(document->find_all("foo").size(), 1u);
+    for (size_t i = 0; i < document->line_count(); ++i)
+        EXPECT(!document->line(i).is_materialized());
+
+    // Regular expressions only have to decode lines that aren't plain ASCII.
+    document->update_regex_matches("ba[rz]");
+    EXPECT_EQ(document->find_next("ba[rz]", {}, GUI::TextDocument::SearchShouldWrap::Yes, true), range(0, 4, 0, 7));
+    EXPECT_EQ(document->find_next("ba[rz]", {}, GUI::TextDocument::SearchShouldWrap::Yes, true), range(2, 0, 2, 3));
+    EXPECT(!document->line(0).is_materialized());
+    EXPECT(document->line(1).is_materialized());
+    EXPECT(!document->line(2).is_materialized());
+}
+
+TEST_CASE(text_buffers_are_adopted)
+{
+    auto document = create_document({});
+    auto buffer = ByteBuffer::copy("one\ntwo\n", 8);
+    auto* data = buffer.data();
+    EXPECT(document->set_text(move(buffer)));
+    EXPECT_EQ(document->line_count(), 2u);
+    EXPECT_EQ(document->line(1).unmaterialized_text().characters_without_null_termination(), reinterpret_cast<const char*>(data) + 4);
+    EXPECT_EQ(document->text(), "one\ntwo");
+}
+
+TEST_MAIN(TextDocument)
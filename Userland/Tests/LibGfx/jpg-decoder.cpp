@@ -0,0 +1,477 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/Array.h>
+#include <AK/MappedFile.h>
+#include <AK/TestSuite.h>
+
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/JPGLoader.h>
+#include <math.h>
+#include <stdio.h>
+
+static const char* jpg_corpus[] = {
+    "/res/html/misc/jpgsuite_files/non-subsampled-lena.jpg",
+    "/res/html/misc/jpgsuite_files/horizontally-halved-lena.jpg",
+    "/res/html/misc/jpgsuite_files/vertically-halved-lena.jpg",
+    "/res/html/misc/jpgsuite_files/chroma-quartered-lena.jpg",
+    "/res/html/misc/jpgsuite_files/oh-lena.jpg",
+    "/res/html/misc/bmpsuite_files/rgb24.jpg",
+};
+
+static constexpr u8 zigzag_to_natural[64] = {
+    0, 1, 8, 16, 9, 2, 3, 10,
+    17, 24, 32, 25, 18, 11, 4, 5,
+    12, 19, 26, 33, 40, 48, 41, 34,
+    27, 20, 13, 6, 7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36,
+    29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46,
+    53, 60, 61, 54, 47, 55, 62, 63
+};
+
+// Writes a baseline JPEG with 4:4:4 sampling and a quantization table of all ones, so the coefficients
+// that go in are exactly the ones the decoder's IDCT sees. Every huffman code is a fixed-length index
+// into the symbol list: 4 bits for DC size categories, 8 bits for AC run/size symbols.
+class BaselineJPGWriter {
+public:
+    using Block = Array<i16, 64>; // In zigzag order.
+
+    BaselineJPGWriter()
+    {
+        m_ac_symbols.append(0x00);
+        m_ac_symbols.append(0xf0);
+        for (u8 run = 0; run < 16; ++run) {
+            for (u8 size = 1; size <= 10; ++size)
+                m_ac_symbols.append((run << 4) | size);
+        }
+    }
+
+    ByteBuffer encode(u16 width, u16 height, const Vector<Block>& blocks)
+    {
+        write_marker(0xd8);
+
+        write_marker(0xdb);
+        write_u16(67);
+        m_data.append(0);
+        for (size_t i = 0; i < 64; ++i)
+            m_data.append(1);
+
+        write_marker(0xc0);
+        write_u16(17);
+        m_data.append(8);
+        write_u16(height);
+        write_u16(width);
+        m_data.append(3);
+        for (u8 component_id = 1; component_id <= 3; ++component_id) {
+            m_data.append(component_id);
+            m_data.append(0x11);
+            m_data.append(0);
+        }
+
+        write_marker(0xc4);
+        write_u16(2 + 17 + 12 + 17 + m_ac_symbols.size());
+        m_data.append(0x00);
+        for (size_t length = 1; length <= 16; ++length)
+            m_data.append(length == 4 ? 12 : 0);
+        for (u8 category = 0; category < 12; ++category)
+            m_data.append(category);
+        m_data.append(0x10);
+        for (size_t length = 1; length <= 16; ++length)
+            m_data.append(length == 8 ? m_ac_symbols.size() : 0);
+        m_data.append(m_ac_symbols.data(), m_ac_symbols.size());
+
+        write_marker(0xda);
+        write_u16(12);
+        m_data.append(3);
+        for (u8 component_id = 1; component_id <= 3; ++component_id) {
+            m_data.append(component_id);
+            m_data.append(0x00);
+        }
+        m_data.append(0);
+        m_data.append(63);
+        m_data.append(0);
+
+        i16 previous_dc[3] = { 0, 0, 0 };
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            auto& block = blocks[i];
+            auto& dc = previous_dc[i % 3];
+            write_value(block[0] - dc, 4, 0);
+            dc = block[0];
+
+            u8 run = 0;
+            for (size_t k = 1; k < 64; ++k) {
+                if (block[k] == 0) {
+                    ++run;
+                    continue;
+                }
+                for (; run >= 16; run -= 16)
+                    write_bits(symbol_index(0xf0), 8);
+                write_value(block[k], 8, run << 4);
+                run = 0;
+            }
+            if (run)
+                write_bits(symbol_index(0x00), 8);
+        }
+        if (m_bit_count)
+            write_bits(0xff >> m_bit_count, 8 - m_bit_count);
+
+        write_marker(0xd9);
+        return ByteBuffer::copy(m_data.data(), m_data.size());
+    }
+
+private:
+    void write_marker(u8 marker)
+    {
+        m_data.append(0xff);
+        m_data.append(marker);
+    }
+
+    void write_u16(u16 value)
+    {
+        m_data.append(value >> 8);
+        m_data.append(value & 0xff);
+    }
+
+    void write_bits(u32 bits, u8 count)
+    {
+        for (u8 i = count; i > 0; --i) {
+            m_current_byte = (m_current_byte << 1) | ((bits >> (i - 1)) & 1);
+            if (++m_bit_count < 8)
+                continue;
+            m_data.append(m_current_byte);
+            if (m_current_byte == 0xff)
+                m_data.append(0);
+            m_current_byte = 0;
+            m_bit_count = 0;
+        }
+    }
+
+    size_t symbol_index(u8 symbol)
+    {
+        auto index = m_ac_symbols.find_first_index(symbol);
+        VERIFY(index.has_value());
+        return index.value();
+    }
+
+    // Writes the huffman code for (symbol | size category) followed by the value's extra bits.
+    void write_value(i16 value, u8 code_length, u8 symbol)
+    {
+        u8 size = 0;
+        for (u16 magnitude = abs(value); magnitude; magnitude >>= 1)
+            ++size;
+        write_bits(code_length == 4 ? size : symbol_index(symbol | size), code_length);
+        if (size)
+            write_bits(value > 0 ? value : value + (1 << size) - 1, size);
+    }
+
+    Vector<u8> m_data;
+    Vector<u8> m_ac_symbols;
+    u8 m_current_byte { 0 };
+    u8 m_bit_count { 0 };
+};
+
+// The IDCT and color conversion exactly as ITU T.81 and JFIF define them, in double precision.
+static u8 reference_sample(const BaselineJPGWriter::Block& block, int x, int y)
+{
+    double sum = 0;
+    for (int k = 0; k < 64; ++k) {
+        int u = zigzag_to_natural[k] % 8;
+        int v = zigzag_to_natural[k] / 8;
+        double cu = u == 0 ? M_SQRT1_2 : 1;
+        double cv = v == 0 ? M_SQRT1_2 : 1;
+        sum += cu * cv * block[k] * cos((2 * x + 1) * u * M_PI / 16) * cos((2 * y + 1) * v * M_PI / 16);
+    }
+    return clamp(round(sum / 4 + 128), 0.0, 255.0);
+}
+
+static Color reference_color(u8 y, u8 cb, u8 cr)
+{
+    auto to_channel = [](double value) { return (u8)clamp(round(value), 0.0, 255.0); };
+    return Color(
+        to_channel(y + 1.402 * (cr - 128)),
+        to_channel(y - 0.344136 * (cb - 128) - 0.714136 * (cr - 128)),
+        to_channel(y + 1.772 * (cb - 128)));
+}
+
+// Encodes the blocks (Y, Cb and Cr for each 8x8 tile, left to right and top to bottom), decodes them again
+// and returns how far the decoder's output is from the reference decode at worst, or -1 if decoding failed.
+static int max_error_against_reference(u16 width, u16 height, const Vector<BaselineJPGWriter::Block>& blocks)
+{
+    auto data = BaselineJPGWriter().encode(width, height, blocks);
+    auto bitmap = Gfx::load_jpg_from_memory(data.data(), data.size());
+    if (!bitmap || bitmap->size() != Gfx::IntSize(width, height))
+        return -1;
+
+    int max_error = 0;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            auto block_index = ((y / 8) * (width / 8) + x / 8) * 3;
+            auto expected = reference_color(
+                reference_sample(blocks[block_index], x % 8, y % 8),
+                reference_sample(blocks[block_index + 1], x % 8, y % 8),
+                reference_sample(blocks[block_index + 2], x % 8, y % 8));
+            auto actual = bitmap->get_pixel(x, y);
+            max_error = max(max_error, abs(expected.red() - actual.red()));
+            max_error = max(max_error, abs(expected.green() - actual.green()));
+            max_error = max(max_error, abs(expected.blue() - actual.blue()));
+        }
+    }
+    return max_error;
+}
+
+static constexpr u16 reference_width = 32;
+static constexpr u16 reference_height = 16;
+
+// Mostly smooth blocks with some strong edges, and a few that saturate to make the clamping matter.
+static Vector<BaselineJPGWriter::Block> make_random_blocks(u32 seed, bool with_chroma)
+{
+    auto random = [&](int min, int max) {
+        seed = seed * 1103515245 + 12345;
+        return min + (int)((seed >> 8) % (max - min + 1));
+    };
+
+    Vector<BaselineJPGWriter::Block> blocks;
+    blocks.resize((reference_width / 8) * (reference_height / 8) * 3);
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        auto& block = blocks[i];
+        block.fill(0);
+        if (i % 3 != 0 && !with_chroma)
+            continue;
+        block[0] = random(-900, 900);
+        for (size_t k = 1; k < 64; ++k) {
+            int limit = k < 10 ? 200 : 40;
+            block[k] = random(0, 2) ? 0 : random(-limit, limit);
+        }
+    }
+    return blocks;
+}
+
+TEST_CASE(decode_idct_matches_reference)
+{
+    // Without chroma every channel is just the luma sample, so this checks the IDCT and its clamping by themselves.
+    for (u32 seed = 1; seed <= 10; ++seed) {
+        auto max_error = max_error_against_reference(reference_width, reference_height, make_random_blocks(seed, false));
+        EXPECT(max_error >= 0 && max_error <= 1);
+    }
+}
+
+TEST_CASE(decode_color_conversion_matches_reference)
+{
+    // With flat blocks the IDCT is exact, so this checks the color conversion by itself, over the whole range of each component.
+    Vector<BaselineJPGWriter::Block> blocks;
+    blocks.resize((reference_width / 8) * (reference_height / 8) * 3);
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        blocks[i].fill(0);
+        blocks[i][0] = (((i * 37) % 32) * 8 - 128) * 8;
+    }
+    auto max_error = max_error_against_reference(reference_width, reference_height, blocks);
+    EXPECT(max_error >= 0 && max_error <= 1);
+}
+
+TEST_CASE(decode_matches_reference)
+{
+    // An IDCT that's off by one in a chroma sample gets amplified by up to 1.772 in the color conversion.
+    for (u32 seed = 1; seed <= 10; ++seed) {
+        auto max_error = max_error_against_reference(reference_width, reference_height, make_random_blocks(seed, true));
+        EXPECT(max_error >= 0 && max_error <= 2);
+    }
+}
+
+TEST_CASE(decode_corpus)
+{
+    for (auto* path : jpg_corpus) {
+        auto bitmap = Gfx::load_jpg(path);
+        EXPECT(bitmap);
+        if (bitmap)
+            EXPECT(!bitmap->size().is_empty());
+    }
+}
+
+TEST_CASE(decode_corpus_downscaled)
+{
+    const Gfx::IntSize bounding_size { 32, 32 };
+
+    for (auto* path : jpg_corpus) {
+        auto full_bitmap = Gfx::load_jpg(path);
+        EXPECT(full_bitmap);
+        if (!full_bitmap)
+            continue;
+
+        auto file_or_error = MappedFile::map(path);
+        EXPECT(!file_or_error.is_error());
+        if (file_or_error.is_error())
+            continue;
+        Gfx::JPGImageDecoderPlugin plugin((const u8*)file_or_error.value()->data(), file_or_error.value()->size());
+        auto bitmap = plugin.downscaled_bitmap(bounding_size);
+        EXPECT(bitmap);
+        if (!bitmap)
+            continue;
+
+        auto factor = Gfx::downscale_factor_for_fitting(full_bitmap->size(), bounding_size, 8);
+        EXPECT(factor > 1);
+        EXPECT_EQ(bitmap->width(), (full_bitmap->width() + factor - 1) / factor);
+        EXPECT_EQ(bitmap->height(), (full_bitmap->height() + factor - 1) / factor);
+    }
+}
+
+// Compares each pixel of a downscaled decode with the average of the block of the full-size decode it covers.
+TEST_CASE(decode_downscaled_matches_box_filter)
+{
+    for (auto* path : jpg_corpus) {
+        auto full_bitmap = Gfx::load_jpg(path);
+        EXPECT(full_bitmap);
+        if (!full_bitmap)
+            continue;
+        auto file_or_error = MappedFile::map(path);
+        EXPECT(!file_or_error.is_error());
+        if (file_or_error.is_error())
+            continue;
+
+        for (int factor : { 2, 4, 8 }) {
+            const Gfx::IntSize bounding_size { full_bitmap->width() / factor, full_bitmap->height() / factor };
+            if (Gfx::downscale_factor_for_fitting(full_bitmap->size(), bounding_size, 8) != factor)
+                continue;
+            Gfx::JPGImageDecoderPlugin plugin((const u8*)file_or_error.value()->data(), file_or_error.value()->size());
+            auto bitmap = plugin.downscaled_bitmap(bounding_size);
+            EXPECT(bitmap);
+            if (!bitmap)
+                continue;
+
+            int max_error = 0;
+            u64 total_error = 0;
+            for (int y = 0; y < bitmap->height(); y++) {
+                for (int x = 0; x < bitmap->width(); x++) {
+                    int sums[3] = {};
+                    int count = 0;
+                    for (int block_y = y * factor; block_y < min(full_bitmap->height(), (y + 1) * factor); block_y++) {
+                        for (int block_x = x * factor; block_x < min(full_bitmap->width(), (x + 1) * factor); block_x++) {
+                            auto color = full_bitmap->get_pixel(block_x, block_y);
+                            sums[0] += color.red();
+                            sums[1] += color.green();
+                            sums[2] += color.blue();
+                            count++;
+                        }
+                    }
+                    auto color = bitmap->get_pixel(x, y);
+                    int channels[3] = { color.red(), color.green(), color.blue() };
+                    for (int i = 0; i < 3; i++) {
+                        int error = abs(channels[i] - (sums[i] + count / 2) / count);
+                        max_error = max(max_error, error);
+                        total_error += error;
+                    }
+                }
+            }
+
+            // Dropping the high frequencies of a block only approximates averaging its pixels, and the
+            // two differ most at sharp edges, so only the mean error is held tight.
+            EXPECT(max_error <= 96);
+            EXPECT(total_error <= 6u * bitmap->width() * bitmap->height() * 3);
+        }
+    }
+}
+
+// Feeds the data to the decoder piece_size bytes at a time, and checks that each partial image shows at least as many
+// rows as the one before, and that they match the full decode.
+static void expect_streamed_decode_matches(ReadonlyBytes data, size_t piece_size)
+{
+    auto bitmap = Gfx::load_jpg_from_memory(data.data(), data.size());
+    EXPECT(bitmap);
+    if (!bitmap)
+        return;
+
+    auto rows_are_equal = [&](const Gfx::Bitmap& partial_bitmap, int rows) {
+        if (partial_bitmap.size() != bitmap->size())
+            return false;
+        for (int y = 0; y < rows; ++y) {
+            if (memcmp(partial_bitmap.scanline(y), bitmap->scanline(y), bitmap->width() * sizeof(Gfx::RGBA32)))
+                return false;
+        }
+        return true;
+    };
+
+    Gfx::JPGImageDecoderPlugin plugin(data.data(), data.size());
+    int available_rows = 0;
+    for (size_t size = piece_size; size < data.size() + piece_size; size += piece_size) {
+        auto partial_image = plugin.partial_bitmap(data.trim(size));
+        if (!partial_image.image) {
+            EXPECT_EQ(available_rows, 0);
+            continue;
+        }
+        EXPECT(partial_image.available_rows >= available_rows);
+        available_rows = partial_image.available_rows;
+        EXPECT(rows_are_equal(*partial_image.image, available_rows));
+    }
+    EXPECT_EQ(available_rows, bitmap->height());
+}
+
+TEST_CASE(decode_streamed)
+{
+    auto data = BaselineJPGWriter().encode(reference_width, reference_height, make_random_blocks(1, true));
+    for (size_t piece_size : { 1, 5, 64 })
+        expect_streamed_decode_matches(data, piece_size);
+}
+
+TEST_CASE(decode_streamed_corpus)
+{
+    for (auto* path : jpg_corpus) {
+        auto file_or_error = MappedFile::map(path);
+        EXPECT(!file_or_error.is_error());
+        if (file_or_error.is_error())
+            continue;
+        expect_streamed_decode_matches({ file_or_error.value()->data(), file_or_error.value()->size() }, 1000);
+    }
+}
+
+BENCHMARK_CASE(decode_corpus_throughput)
+{
+    const int run_count = 50;
+
+    for (int run = 0; run < run_count; run++) {
+        for (auto* path : jpg_corpus) {
+            auto bitmap = Gfx::load_jpg(path);
+            EXPECT(bitmap);
+        }
+    }
+}
+
+BENCHMARK_CASE(decode_corpus_thumbnail_throughput)
+{
+    const int run_count = 50;
+
+    for (int run = 0; run < run_count; run++) {
+        for (auto* path : jpg_corpus) {
+            auto file_or_error = MappedFile::map(path);
+            EXPECT(!file_or_error.is_error());
+            if (file_or_error.is_error())
+                continue;
+            Gfx::JPGImageDecoderPlugin plugin((const u8*)file_or_error.value()->data(), file_or_error.value()->size());
+            EXPECT(plugin.downscaled_bitmap({ 32, 32 }));
+        }
+    }
+}
+
+TEST_MAIN(JPGDecoder)
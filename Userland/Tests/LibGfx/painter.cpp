@@ -26,10 +26,110 @@
 
 #include <AK/TestSuite.h>
 
+#include <LibCore/ElapsedTimer.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/Painter.h>
 #include <stdio.h>
 
+static void print_pixel_throughput(const char* name, const Core::ElapsedTimer& timer, u64 pixel_count)
+{
+    auto elapsed_ms = max(timer.elapsed(), 1);
+    printf("%s: %.1f Mpixels/s\n", name, pixel_count / (elapsed_ms * 1000.0));
+}
+
+// Fills the bitmap with pseudo-random pixels. Unless opaque is set, about one in three pixels gets a random alpha.
+static void fill_with_noise(Gfx::Bitmap& bitmap, u32 seed, bool opaque)
+{
+    for (int y = 0; y < bitmap.height(); y++) {
+        for (int x = 0; x < bitmap.width(); x++) {
+            seed = seed * 1103515245 + 12345;
+            u32 value = seed ^ (seed >> 16) * 2654435761u;
+            if (opaque || (seed >> 8) % 3)
+                value |= 0xff000000;
+            bitmap.scanline(y)[x] = value;
+        }
+    }
+}
+
+// The blend loops handle four pixels at a time and the rest one by one, so the rects cover every width
+// up to a few vectors, at every alignment, and check each pixel against Color::blend().
+static constexpr int blend_test_max_width = 13;
+
+TEST_CASE(fill_translucent_matches_scalar_blend)
+{
+    for (u8 alpha : { 1, 128, 254 }) {
+        Color color(40, 150, 220, alpha);
+        for (int width = 1; width <= blend_test_max_width; width++) {
+            for (int offset = 0; offset < 4; offset++) {
+                auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { blend_test_max_width + 4, 3 });
+                fill_with_noise(*bitmap, width * 4 + offset, false);
+                auto original = bitmap->clone();
+
+                Gfx::Painter painter(*bitmap);
+                Gfx::IntRect rect { offset, 0, width, bitmap->height() };
+                painter.fill_rect(rect, color);
+
+                for (int y = 0; y < bitmap->height(); y++) {
+                    for (int x = 0; x < bitmap->width(); x++) {
+                        auto expected = original->scanline(y)[x];
+                        if (rect.contains(x, y))
+                            expected = Color::from_rgba(expected).blend(color).value();
+                        EXPECT_EQ(bitmap->scanline(y)[x], expected);
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void expect_blit_matches_scalar_blend(Gfx::BitmapFormat source_format, Gfx::BitmapFormat target_format, float opacity)
+{
+    for (int width = 1; width <= blend_test_max_width; width++) {
+        for (int offset = 0; offset < 4; offset++) {
+            auto source = Gfx::Bitmap::create(source_format, { blend_test_max_width, 3 });
+            fill_with_noise(*source, width, false);
+            auto bitmap = Gfx::Bitmap::create(target_format, { blend_test_max_width + 4, 3 });
+            fill_with_noise(*bitmap, width * 4 + offset, target_format == Gfx::BitmapFormat::BGRx8888);
+            auto original = bitmap->clone();
+
+            Gfx::Painter painter(*bitmap);
+            painter.blit({ offset, 0 }, *source, { 0, 0, width, source->height() }, opacity);
+
+            for (int y = 0; y < bitmap->height(); y++) {
+                for (int x = 0; x < bitmap->width(); x++) {
+                    auto expected = original->scanline(y)[x];
+                    if (x >= offset && x < offset + width) {
+                        auto source_pixel = source->scanline(y)[x - offset];
+                        u8 alpha = opacity * 255;
+                        if (source->has_alpha_channel()) {
+                            float pixel_opacity = (source_pixel >> 24) / 255.0;
+                            alpha = 255 * (opacity * pixel_opacity);
+                        }
+                        expected = Color::from_rgba(expected).blend(Color::from_rgb(source_pixel).with_alpha(alpha)).value();
+                    }
+                    EXPECT_EQ(bitmap->scanline(y)[x], expected);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE(blit_with_opacity_matches_scalar_blend)
+{
+    for (float opacity : { 0.25f, 0.5f, 0.9f }) {
+        expect_blit_matches_scalar_blend(Gfx::BitmapFormat::BGRx8888, Gfx::BitmapFormat::BGRx8888, opacity);
+        expect_blit_matches_scalar_blend(Gfx::BitmapFormat::BGRx8888, Gfx::BitmapFormat::BGRA8888, opacity);
+    }
+}
+
+TEST_CASE(blit_with_alpha_matches_scalar_blend)
+{
+    for (float opacity : { 0.5f, 1.0f }) {
+        expect_blit_matches_scalar_blend(Gfx::BitmapFormat::BGRA8888, Gfx::BitmapFormat::BGRx8888, opacity);
+        expect_blit_matches_scalar_blend(Gfx::BitmapFormat::BGRA8888, Gfx::BitmapFormat::BGRA8888, opacity);
+    }
+}
+
 BENCHMARK_CASE(diagonal_lines)
 {
     const int run_count = 50;
@@ -72,4 +172,94 @@ BENCHMARK_CASE(fill_with_gradient)
     }
 }
 
+BENCHMARK_CASE(fill_translucent)
+{
+    const int run_count = 100;
+    const int bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size });
+    bitmap->fill(Color::White);
+    Gfx::Painter painter(*bitmap);
+
+    Core::ElapsedTimer timer;
+    timer.start();
+    for (int run = 0; run < run_count; run++) {
+        painter.fill_rect(bitmap->rect(), Color(Color::Blue).with_alpha(128));
+    }
+    print_pixel_throughput("fill_translucent", timer, (u64)run_count * bitmap_size * bitmap_size);
+}
+
+BENCHMARK_CASE(fill_xor)
+{
+    const int run_count = 100;
+    const int bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size });
+    Gfx::Painter painter(*bitmap);
+    painter.set_draw_op(Gfx::Painter::DrawOp::Xor);
+
+    Core::ElapsedTimer timer;
+    timer.start();
+    for (int run = 0; run < run_count; run++) {
+        painter.fill_rect(bitmap->rect(), Color::Blue);
+    }
+    print_pixel_throughput("fill_xor", timer, (u64)run_count * bitmap_size * bitmap_size);
+}
+
+BENCHMARK_CASE(blit_opaque)
+{
+    const int run_count = 100;
+    const int bitmap_size = 2000;
+
+    auto source = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size });
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size });
+    Gfx::Painter painter(*bitmap);
+
+    Core::ElapsedTimer timer;
+    timer.start();
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({}, *source, source->rect());
+    }
+    print_pixel_throughput("blit_opaque", timer, (u64)run_count * bitmap_size * bitmap_size);
+}
+
+BENCHMARK_CASE(blit_with_opacity)
+{
+    const int run_count = 100;
+    const int bitmap_size = 2000;
+
+    auto source = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size });
+    source->fill(Color::Red);
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size });
+    Gfx::Painter painter(*bitmap);
+
+    Core::ElapsedTimer timer;
+    timer.start();
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({}, *source, source->rect(), 0.5f);
+    }
+    print_pixel_throughput("blit_with_opacity", timer, (u64)run_count * bitmap_size * bitmap_size);
+}
+
+BENCHMARK_CASE(blit_with_alpha)
+{
+    const int run_count = 100;
+    const int bitmap_size = 2000;
+
+    auto source = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { bitmap_size, bitmap_size });
+    for (int y = 0; y < bitmap_size; y++) {
+        for (int x = 0; x < bitmap_size; x++)
+            source->set_pixel(x, y, Color(x, y, x + y, x ^ y));
+    }
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size });
+    Gfx::Painter painter(*bitmap);
+
+    Core::ElapsedTimer timer;
+    timer.start();
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({}, *source, source->rect());
+    }
+    print_pixel_throughput("blit_with_alpha", timer, (u64)run_count * bitmap_size * bitmap_size);
+}
+
 TEST_MAIN(Painter)
@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/MappedFile.h>
+#include <AK/TestSuite.h>
+
+#include <LibCompress/Deflate.h>
+#include <LibCrypto/Checksum/Adler32.h>
+#include <LibCrypto/Checksum/CRC32.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/PNGLoader.h>
+#include <LibGfx/StreamingImageDecoder.h>
+#include <stdlib.h>
+
+static const char* png_corpus[] = {
+    "/res/graphics/buggie.png",
+    "/res/graphics/brand-banner.png",
+    "/res/html/misc/ppmsuite_files/buggie.png",
+};
+
+static constexpr int adam7_starty[8] = { 0, 0, 0, 4, 0, 2, 0, 1 };
+static constexpr int adam7_startx[8] = { 0, 0, 4, 0, 2, 0, 1, 0 };
+static constexpr int adam7_stepy[8] = { 1, 8, 8, 8, 4, 4, 2, 2 };
+static constexpr int adam7_stepx[8] = { 1, 8, 8, 4, 4, 2, 2, 1 };
+
+// Writes bitmap as an 8-bit RGBA PNG. Consecutive rows use each of the filter types in turn, and the image data
+// is split over IDAT chunks of idat_size bytes, so that decoding it exercises everything that can be streamed.
+class PNGTestWriter {
+public:
+    static ByteBuffer encode(const Gfx::Bitmap& bitmap, bool interlaced, size_t idat_size = 1000)
+    {
+        Vector<u8> raw_data;
+        if (interlaced) {
+            for (int pass = 1; pass <= 7; ++pass)
+                append_filtered_rows(bitmap, raw_data, adam7_startx[pass], adam7_starty[pass], adam7_stepx[pass], adam7_stepy[pass]);
+        } else {
+            append_filtered_rows(bitmap, raw_data, 0, 0, 1, 1);
+        }
+
+        Vector<u8> zlib_data;
+        zlib_data.append(0x78);
+        zlib_data.append(0x9c);
+        auto compressed = Compress::DeflateCompressor::compress_all(raw_data.span());
+        VERIFY(compressed.has_value());
+        zlib_data.append(compressed->data(), compressed->size());
+        append_u32(zlib_data, Crypto::Checksum::Adler32(raw_data.span()).digest());
+
+        PNGTestWriter writer;
+        static constexpr u8 png_header[8] = { 0x89, 'P', 'N', 'G', 13, 10, 26, 10 };
+        writer.m_data.append(png_header, sizeof(png_header));
+
+        Vector<u8> header;
+        append_u32(header, bitmap.width());
+        append_u32(header, bitmap.height());
+        header.append(8);
+        header.append(6);
+        header.append(0);
+        header.append(0);
+        header.append(interlaced ? 1 : 0);
+        writer.add_chunk("IHDR", header.span());
+
+        for (size_t offset = 0; offset < zlib_data.size(); offset += idat_size)
+            writer.add_chunk("IDAT", zlib_data.span().slice(offset, min(idat_size, zlib_data.size() - offset)));
+        writer.add_chunk("IEND", {});
+        return ByteBuffer::copy(writer.m_data.data(), writer.m_data.size());
+    }
+
+private:
+    static void append_u32(Vector<u8>& data, u32 value)
+    {
+        data.append(value >> 24);
+        data.append(value >> 16);
+        data.append(value >> 8);
+        data.append(value);
+    }
+
+    static void append_filtered_rows(const Gfx::Bitmap& bitmap, Vector<u8>& data, int startx, int starty, int stepx, int stepy)
+    {
+        Vector<u8> previous_row;
+        Vector<u8> row;
+        for (int y = starty; y < bitmap.height(); y += stepy) {
+            row.clear();
+            for (int x = startx; x < bitmap.width(); x += stepx) {
+                auto color = bitmap.get_pixel(x, y);
+                row.append(color.red());
+                row.append(color.green());
+                row.append(color.blue());
+                row.append(color.alpha());
+            }
+            if (row.is_empty())
+                return;
+            if (previous_row.is_empty())
+                previous_row.resize(row.size());
+
+            u8 filter = (y / stepy) % 5;
+            data.append(filter);
+            for (size_t i = 0; i < row.size(); ++i) {
+                int a = i >= 4 ? row[i - 4] : 0;
+                int b = previous_row[i];
+                int c = i >= 4 ? previous_row[i - 4] : 0;
+                int predictor = 0;
+                if (filter == 1) {
+                    predictor = a;
+                } else if (filter == 2) {
+                    predictor = b;
+                } else if (filter == 3) {
+                    predictor = (a + b) / 2;
+                } else if (filter == 4) {
+                    int p = a + b - c;
+                    int pa = abs(p - a);
+                    int pb = abs(p - b);
+                    int pc = abs(p - c);
+                    predictor = pa <= pb && pa <= pc ? a : (pb <= pc ? b : c);
+                }
+                data.append(row[i] - predictor);
+            }
+            swap(previous_row, row);
+        }
+    }
+
+    void add_chunk(const char* type, ReadonlyBytes data)
+    {
+        Vector<u8> type_and_data;
+        type_and_data.append((const u8*)type, 4);
+        type_and_data.append(data.data(), data.size());
+        append_u32(m_data, data.size());
+        m_data.append(type_and_data.data(), type_and_data.size());
+        append_u32(m_data, Crypto::Checksum::CRC32(type_and_data.span()).digest());
+    }
+
+    Vector<u8> m_data;
+};
+
+// A smooth gradient with some noise and transparency, so that neither the filters nor the compression have it too easy.
+static RefPtr<Gfx::Bitmap> make_test_bitmap(int width, int height)
+{
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { width, height });
+    u32 seed = 1;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            seed = seed * 1103515245 + 12345;
+            u8 noise = (seed >> 16) % 16;
+            bitmap->set_pixel(x, y, Color(x * 255 / width, y * 255 / height, (x + y + noise) % 256, 128 + noise * 8));
+        }
+    }
+    return bitmap;
+}
+
+static bool rows_are_equal(const Gfx::Bitmap& a, const Gfx::Bitmap& b, int rows)
+{
+    if (a.size() != b.size())
+        return false;
+    for (int y = 0; y < rows; ++y) {
+        if (memcmp(a.scanline(y), b.scanline(y), a.width() * sizeof(Gfx::RGBA32)))
+            return false;
+    }
+    return true;
+}
+
+// Feeds data to the decoder piece_size bytes at a time, and checks that each partial image shows at least as many
+// rows as the one before, and that the rows that are final match the full decode.
+static void expect_streamed_decode_matches(ReadonlyBytes data, size_t piece_size)
+{
+    auto bitmap = Gfx::load_png_from_memory(data.data(), data.size());
+    EXPECT(bitmap);
+    if (!bitmap)
+        return;
+
+    Gfx::PNGImageDecoderPlugin plugin(data.data(), data.size());
+    bool is_interlaced = data[28] == 1;
+    int available_rows = 0;
+    for (size_t size = piece_size; size < data.size() + piece_size; size += piece_size) {
+        auto partial_image = plugin.partial_bitmap(data.trim(size));
+        if (!partial_image.image) {
+            EXPECT_EQ(available_rows, 0);
+            continue;
+        }
+        EXPECT(partial_image.available_rows >= available_rows);
+        available_rows = partial_image.available_rows;
+        if (!is_interlaced)
+            EXPECT(rows_are_equal(*partial_image.image, *bitmap, available_rows));
+    }
+    EXPECT_EQ(available_rows, bitmap->height());
+    auto partial_image = plugin.partial_bitmap(data);
+    EXPECT(partial_image.image && rows_are_equal(*partial_image.image, *bitmap, bitmap->height()));
+}
+
+// Averages each factor x factor block of the bitmap into one pixel, the same way the decoder does.
+static RefPtr<Gfx::Bitmap> box_filter(const Gfx::Bitmap& bitmap, int factor)
+{
+    auto result = Gfx::Bitmap::create(bitmap.format(), { (bitmap.width() + factor - 1) / factor, (bitmap.height() + factor - 1) / factor });
+    for (int y = 0; y < result->height(); ++y) {
+        for (int x = 0; x < result->width(); ++x) {
+            u32 sums[4] = {};
+            u32 count = 0;
+            for (int block_y = y * factor; block_y < min(bitmap.height(), (y + 1) * factor); ++block_y) {
+                for (int block_x = x * factor; block_x < min(bitmap.width(), (x + 1) * factor); ++block_x) {
+                    auto* pixel = reinterpret_cast<const u8*>(bitmap.scanline(block_y) + block_x);
+                    for (int i = 0; i < 4; ++i)
+                        sums[i] += pixel[i];
+                    ++count;
+                }
+            }
+            auto* pixel = reinterpret_cast<u8*>(result->scanline(y) + x);
+            for (int i = 0; i < 4; ++i)
+                pixel[i] = (sums[i] + count / 2) / count;
+        }
+    }
+    return result;
+}
+
+static void expect_downscaled_decode_matches(const Gfx::Bitmap& bitmap, bool interlaced)
+{
+    auto data = PNGTestWriter::encode(bitmap, interlaced);
+    for (int scale : { 2, 4, 8 }) {
+        Gfx::IntSize bounding_size { max(1, bitmap.width() / scale), max(1, bitmap.height() / scale) };
+        auto factor = Gfx::downscale_factor_for_fitting(bitmap.size(), bounding_size, 8);
+        EXPECT(factor > 1);
+
+        Gfx::PNGImageDecoderPlugin plugin(data.data(), data.size());
+        auto downscaled_bitmap = plugin.downscaled_bitmap(bounding_size);
+        auto expected_bitmap = box_filter(bitmap, factor);
+        EXPECT(downscaled_bitmap && rows_are_equal(*downscaled_bitmap, *expected_bitmap, expected_bitmap->height()));
+    }
+}
+
+TEST_CASE(decode_downscaled)
+{
+    // The odd sizes leave partial blocks at the right and bottom edges.
+    expect_downscaled_decode_matches(*make_test_bitmap(61, 47), false);
+    expect_downscaled_decode_matches(*make_test_bitmap(64, 64), false);
+    expect_downscaled_decode_matches(*make_test_bitmap(17, 9), false);
+}
+
+TEST_CASE(decode_downscaled_interlaced)
+{
+    expect_downscaled_decode_matches(*make_test_bitmap(61, 47), true);
+    expect_downscaled_decode_matches(*make_test_bitmap(64, 64), true);
+    // Narrower and shorter than an Adam7 block, so later passes reach past the edge of the first block.
+    expect_downscaled_decode_matches(*make_test_bitmap(17, 9), true);
+    expect_downscaled_decode_matches(*make_test_bitmap(3, 2), true);
+}
+
+TEST_CASE(decode_streamed)
+{
+    auto bitmap = make_test_bitmap(61, 47);
+    auto data = PNGTestWriter::encode(*bitmap, false);
+    auto decoded_bitmap = Gfx::load_png_from_memory(data.data(), data.size());
+    EXPECT(decoded_bitmap && rows_are_equal(*decoded_bitmap, *bitmap, bitmap->height()));
+
+    for (size_t piece_size : { 1, 7, 100, 1000 })
+        expect_streamed_decode_matches(data, piece_size);
+}
+
+TEST_CASE(decode_streamed_interlaced)
+{
+    auto bitmap = make_test_bitmap(61, 47);
+    auto data = PNGTestWriter::encode(*bitmap, true);
+    auto decoded_bitmap = Gfx::load_png_from_memory(data.data(), data.size());
+    EXPECT(decoded_bitmap && rows_are_equal(*decoded_bitmap, *bitmap, bitmap->height()));
+
+    for (size_t piece_size : { 1, 7, 100, 1000 })
+        expect_streamed_decode_matches(data, piece_size);
+
+    // Images that are smaller than an Adam7 block have empty passes.
+    auto tiny_bitmap = make_test_bitmap(3, 2);
+    expect_streamed_decode_matches(PNGTestWriter::encode(*tiny_bitmap, true), 1);
+}
+
+TEST_CASE(decode_streamed_corpus)
+{
+    for (auto* path : png_corpus) {
+        auto file_or_error = MappedFile::map(path);
+        EXPECT(!file_or_error.is_error());
+        if (file_or_error.is_error())
+            continue;
+        expect_streamed_decode_matches({ file_or_error.value()->data(), file_or_error.value()->size() }, 512);
+    }
+}
+
+TEST_CASE(decode_streamed_rejects_invalid_data)
+{
+    auto bitmap = make_test_bitmap(61, 47);
+    auto data = PNGTestWriter::encode(*bitmap, false);
+    // Corrupt the zlib header, which comes right after the IHDR chunk and the IDAT chunk's header.
+    data[8 + 25 + 8] = 0;
+    Gfx::PNGImageDecoderPlugin plugin(data.data(), data.size());
+    EXPECT(!plugin.partial_bitmap(data).image);
+    EXPECT(!plugin.partial_bitmap(data).image);
+}
+
+TEST_CASE(streaming_decoder)
+{
+    auto bitmap = make_test_bitmap(300, 200);
+    auto data = PNGTestWriter::encode(*bitmap, false);
+
+    auto decoder = Gfx::StreamingImageDecoder::create();
+    int updates = 0;
+    for (size_t offset = 0; offset < data.size(); offset += 4096) {
+        decoder->append(data.span().slice(offset, min<size_t>(4096, data.size() - offset)));
+        if (!decoder->update())
+            continue;
+        ++updates;
+        auto& partial_image = decoder->partial_image();
+        EXPECT(rows_are_equal(*partial_image.image, *bitmap, partial_image.available_rows));
+    }
+    EXPECT(updates > 1);
+
+    auto image_decoder = decoder->finish();
+    auto decoded_bitmap = image_decoder->bitmap();
+    EXPECT(decoded_bitmap && rows_are_equal(*decoded_bitmap, *bitmap, bitmap->height()));
+}
+
+TEST_MAIN(PNGDecoder)
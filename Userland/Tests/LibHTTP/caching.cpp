@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <AK/TestSuite.h>
+
+#include <LibHTTP/Caching.h>
+
+using Headers = HashMap<String, String, CaseInsensitiveStringTraits>;
+
+// Sun, 06 Nov 1994 08:49:37 GMT
+static constexpr time_t example_date = 784111777;
+
+struct Header {
+    const char* name;
+    const char* value;
+};
+
+static Headers headers(std::initializer_list<Header> list)
+{
+    Headers result;
+    for (auto& header : list)
+        result.set(header.name, header.value);
+    return result;
+}
+
+TEST_CASE(parse_http_date_formats)
+{
+    EXPECT_EQ(HTTP::parse_http_date("Sun, 06 Nov 1994 08:49:37 GMT").value_or(-1), example_date);
+    EXPECT_EQ(HTTP::parse_http_date("Sunday, 06-Nov-94 08:49:37 GMT").value_or(-1), example_date);
+    EXPECT_EQ(HTTP::parse_http_date("Sun Nov  6 08:49:37 1994").value_or(-1), example_date);
+    EXPECT_EQ(HTTP::parse_http_date("Thu, 01 Jan 1970 00:00:00 GMT").value_or(-1), 0);
+    EXPECT_EQ(HTTP::parse_http_date("Thu, 29 Feb 2024 23:59:59 GMT").value_or(-1), 1709251199);
+}
+
+TEST_CASE(parse_http_date_rejects_garbage)
+{
+    EXPECT(!HTTP::parse_http_date("0").has_value());
+    EXPECT(!HTTP::parse_http_date("-1").has_value());
+    EXPECT(!HTTP::parse_http_date("").has_value());
+    EXPECT(!HTTP::parse_http_date("Sun, 06 Foo 1994 08:49:37 GMT").has_value());
+    EXPECT(!HTTP::parse_http_date("Thu, 29 Feb 2023 12:00:00 GMT").has_value());
+    EXPECT(!HTTP::parse_http_date("Sun, 06 Nov 1994 24:00:00 GMT").has_value());
+    EXPECT(!HTTP::parse_http_date("Sun, 06 Nov 1994 08:49 GMT").has_value());
+}
+
+TEST_CASE(cache_control_directives)
+{
+    auto cache_control = HTTP::CacheControl::from_headers(headers({ { "cache-control", "public, Max-Age=60, no-store" } }));
+    EXPECT(cache_control.no_store);
+    EXPECT(!cache_control.no_cache);
+    EXPECT_EQ(cache_control.max_age.value_or(0), 60);
+
+    EXPECT(HTTP::CacheControl::from_headers(headers({ { "Cache-Control", "no-cache=\"Set-Cookie\"" } })).no_cache);
+    EXPECT(!HTTP::CacheControl::from_headers(headers({ { "Cache-Control", "must-revalidate" } })).no_cache);
+
+    // Pragma only counts when there is no Cache-Control.
+    EXPECT(HTTP::CacheControl::from_headers(headers({ { "Pragma", "no-cache" } })).no_cache);
+    EXPECT(!HTTP::CacheControl::from_headers(headers({ { "Pragma", "no-cache" }, { "Cache-Control", "max-age=60" } })).no_cache);
+}
+
+TEST_CASE(max_age_wins_over_expires)
+{
+    auto response = headers({ { "Cache-Control", "max-age=60" }, { "Expires", "Sun, 06 Nov 1994 09:49:37 GMT" }, { "Date", "Sun, 06 Nov 1994 08:49:37 GMT" } });
+    EXPECT_EQ(HTTP::fresh_until(response, example_date), example_date + 60);
+}
+
+TEST_CASE(must_revalidate_does_not_shorten_freshness)
+{
+    auto response = headers({ { "Cache-Control", "max-age=60, must-revalidate" } });
+    EXPECT_EQ(HTTP::fresh_until(response, example_date), example_date + 60);
+}
+
+TEST_CASE(no_cache_is_stale_immediately)
+{
+    EXPECT_EQ(HTTP::fresh_until(headers({ { "Cache-Control", "no-cache, max-age=60" } }), example_date), example_date);
+    EXPECT_EQ(HTTP::fresh_until(headers({ { "Pragma", "no-cache" }, { "Expires", "Sun, 06 Nov 1994 09:49:37 GMT" } }), example_date), example_date);
+}
+
+TEST_CASE(expires_is_relative_to_date)
+{
+    // The server's clock is an hour ahead of ours, which mustn't matter.
+    auto response = headers({ { "Date", "Sun, 06 Nov 1994 09:49:37 GMT" }, { "Expires", "Sun, 06 Nov 1994 09:59:37 GMT" } });
+    EXPECT_EQ(HTTP::fresh_until(response, example_date), example_date + 10 * 60);
+
+    // Without a Date, it's relative to when the response arrived.
+    EXPECT_EQ(HTTP::fresh_until(headers({ { "Expires", "Sun, 06 Nov 1994 08:59:37 GMT" } }), example_date), example_date + 10 * 60);
+}
+
+TEST_CASE(invalid_or_past_expires_is_stale)
+{
+    EXPECT(HTTP::fresh_until(headers({ { "Expires", "0" } }), example_date) <= example_date);
+    EXPECT(HTTP::fresh_until(headers({ { "Expires", "-1" }, { "Last-Modified", "Sat, 01 Jan 1994 00:00:00 GMT" } }), example_date) <= example_date);
+    EXPECT(HTTP::fresh_until(headers({ { "Expires", "Thu, 01 Jan 1970 00:00:00 GMT" } }), example_date) <= example_date);
+}
+
+TEST_CASE(heuristic_freshness_needs_last_modified)
+{
+    EXPECT(HTTP::fresh_until(headers({}), example_date) <= example_date);
+    EXPECT(HTTP::fresh_until(headers({ { "ETag", "\"abc\"" } }), example_date) <= example_date);
+
+    // A tenth of the time since the last modification...
+    auto response = headers({ { "Date", "Sun, 06 Nov 1994 08:49:37 GMT" }, { "Last-Modified", "Sun, 06 Nov 1994 08:39:37 GMT" } });
+    EXPECT_EQ(HTTP::fresh_until(response, example_date), example_date + 60);
+
+    // ...but no more than a day.
+    response.set("Last-Modified", "Sat, 01 Jan 1994 00:00:00 GMT");
+    EXPECT_EQ(HTTP::fresh_until(response, example_date), example_date + HTTP::max_heuristic_freshness_lifetime);
+}
+
+TEST_CASE(age_is_subtracted)
+{
+    auto response = headers({ { "Cache-Control", "max-age=60" }, { "Age", "45" } });
+    EXPECT_EQ(HTTP::fresh_until(response, example_date), example_date + 15);
+
+    // A Date in the past also means the response has been around for a while.
+    response = headers({ { "Cache-Control", "max-age=60" }, { "Date", "Sun, 06 Nov 1994 08:49:07 GMT" } });
+    EXPECT_EQ(HTTP::fresh_until(response, example_date), example_date + 30);
+}
+
+TEST_CASE(shared_caches_honor_s_maxage)
+{
+    auto response = headers({ { "Cache-Control", "public, max-age=600, s-maxage=60" } });
+    EXPECT_EQ(HTTP::fresh_until(response, example_date), example_date + 600);
+    EXPECT_EQ(HTTP::fresh_until(response, example_date, HTTP::CacheType::Shared), example_date + 60);
+
+    EXPECT(HTTP::CacheControl::from_headers(headers({ { "Cache-Control", "private, max-age=60" } })).is_private);
+    EXPECT(!HTTP::CacheControl::from_headers(headers({ { "Cache-Control", "max-age=60" } })).is_private);
+}
+
+TEST_CASE(current_age_includes_time_spent_in_the_cache)
+{
+    EXPECT_EQ(HTTP::current_age(headers({}), example_date, example_date + 10), 10);
+    EXPECT_EQ(HTTP::current_age(headers({ { "Age", "5" } }), example_date, example_date + 10), 15);
+    EXPECT_EQ(HTTP::current_age(headers({ { "Date", "Sun, 06 Nov 1994 08:49:07 GMT" } }), example_date, example_date + 10), 40);
+}
+
+TEST_MAIN(Caching)
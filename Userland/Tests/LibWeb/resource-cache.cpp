@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <AK/TestSuite.h>
+
+#include <LibWeb/Loader/ResourceCache.h>
+
+using Headers = HashMap<String, String, CaseInsensitiveStringTraits>;
+
+static constexpr time_t now = 1000000;
+
+class TestResource final : public Web::Resource {
+public:
+    static NonnullRefPtr<TestResource> create(const Web::LoadRequest& request)
+    {
+        return adopt(*new TestResource(request));
+    }
+
+private:
+    explicit TestResource(const Web::LoadRequest& request)
+        : Resource(Type::Generic, request)
+    {
+    }
+};
+
+static Web::LoadRequest request(const StringView& path)
+{
+    Web::LoadRequest request;
+    request.set_url(URL(String::formatted("http://www.example.com/{}", path)));
+    return request;
+}
+
+static Headers headers(const StringView& cache_control)
+{
+    Headers headers;
+    headers.set("Cache-Control", cache_control);
+    return headers;
+}
+
+static NonnullRefPtr<Web::Resource> load(Web::ResourceCache& cache, const Web::LoadRequest& request, size_t size, const Headers& response_headers = headers("max-age=60"), Optional<u32> status_code = 200)
+{
+    auto resource = TestResource::create(request);
+    cache.set(request, resource);
+    cache.did_load(request, resource, response_headers, status_code, size, now);
+    return resource;
+}
+
+TEST_CASE(size_accounting)
+{
+    Web::ResourceCache cache(100);
+    load(cache, request("a"), 10);
+    load(cache, request("b"), 20);
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.size_in_bytes(), 30u);
+
+    // Replacing an entry drops the size of the old one.
+    load(cache, request("a"), 5);
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.size_in_bytes(), 25u);
+
+    // In-flight resources don't count until they have loaded.
+    auto pending = TestResource::create(request("c"));
+    cache.set(request("c"), pending);
+    EXPECT_EQ(cache.size(), 3u);
+    EXPECT_EQ(cache.size_in_bytes(), 25u);
+
+    cache.did_fail(request("c"), pending);
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.size_in_bytes(), 25u);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.size_in_bytes(), 0u);
+}
+
+TEST_CASE(evicts_least_recently_used_first)
+{
+    Web::ResourceCache cache(100);
+    load(cache, request("a"), 40);
+    load(cache, request("b"), 40);
+
+    // Touching "a" makes "b" the least recently used entry.
+    EXPECT(cache.get(request("a")));
+
+    load(cache, request("c"), 40);
+    EXPECT(cache.get(request("a")));
+    EXPECT(!cache.get(request("b")));
+    EXPECT(cache.get(request("c")));
+    EXPECT_EQ(cache.size_in_bytes(), 80u);
+
+    // Resources that are still loading are never evicted.
+    auto pending = TestResource::create(request("d"));
+    cache.set(request("d"), pending);
+    load(cache, request("e"), 90);
+    EXPECT_EQ(cache.get(request("d")).ptr(), pending.ptr());
+    EXPECT(!cache.get(request("a")));
+    EXPECT(!cache.get(request("c")));
+    EXPECT_EQ(cache.size_in_bytes(), 90u);
+
+    // A resource that is larger than the whole cache isn't kept at all.
+    load(cache, request("f"), 200);
+    EXPECT(!cache.get(request("f")));
+    EXPECT(!cache.get(request("e")));
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_EQ(cache.size_in_bytes(), 0u);
+}
+
+TEST_CASE(freshness)
+{
+    Web::ResourceCache cache;
+
+    auto pending = TestResource::create(request("pending"));
+    cache.set(request("pending"), pending);
+    EXPECT(cache.is_fresh(request("pending"), now));
+
+    load(cache, request("max-age"), 1);
+    EXPECT(cache.is_fresh(request("max-age"), now));
+    EXPECT(cache.is_fresh(request("max-age"), now + 59));
+    EXPECT(!cache.is_fresh(request("max-age"), now + 60));
+
+    load(cache, request("must-revalidate"), 1, headers("max-age=60, must-revalidate"));
+    EXPECT(cache.is_fresh(request("must-revalidate"), now + 59));
+    EXPECT(!cache.is_fresh(request("must-revalidate"), now + 60));
+
+    load(cache, request("no-cache"), 1, headers("no-cache"));
+    EXPECT(cache.get(request("no-cache")));
+    EXPECT(!cache.is_fresh(request("no-cache"), now));
+
+    // Without an expiration time or a Last-Modified, there is no heuristic freshness.
+    load(cache, request("no-headers"), 1, {});
+    EXPECT(cache.get(request("no-headers")));
+    EXPECT(!cache.is_fresh(request("no-headers"), now));
+
+    EXPECT(!cache.is_fresh(request("missing"), now));
+}
+
+TEST_CASE(uncacheable_responses_are_dropped)
+{
+    Web::ResourceCache cache;
+    load(cache, request("no-store"), 10, headers("no-store"));
+    EXPECT(!cache.get(request("no-store")));
+
+    load(cache, request("not-found"), 10, headers("max-age=60"), 404);
+    EXPECT(!cache.get(request("not-found")));
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.size_in_bytes(), 0u);
+}
+
+TEST_CASE(replaced_resources_are_ignored)
+{
+    Web::ResourceCache cache;
+    auto old_resource = TestResource::create(request("a"));
+    cache.set(request("a"), old_resource);
+    auto new_resource = load(cache, request("a"), 10);
+
+    // The old load finishing (or failing) late mustn't affect the new entry.
+    cache.did_load(request("a"), old_resource, headers("no-store"), 200, 50, now);
+    cache.did_fail(request("a"), old_resource);
+    EXPECT_EQ(cache.get(request("a")).ptr(), new_resource.ptr());
+    EXPECT_EQ(cache.size_in_bytes(), 10u);
+}
+
+TEST_CASE(revalidation_headers)
+{
+    Headers stale_headers;
+    stale_headers.set("etag", "\"v1\"");
+    stale_headers.set("Last-Modified", "Sun, 06 Nov 1994 08:49:37 GMT");
+
+    auto revalidation_request = request("a");
+    Web::ResourceCache::add_revalidation_headers(revalidation_request, stale_headers);
+    EXPECT_EQ(revalidation_request.header("If-None-Match"), "\"v1\"");
+    EXPECT_EQ(revalidation_request.header("If-Modified-Since"), "Sun, 06 Nov 1994 08:49:37 GMT");
+
+    auto unvalidated_request = request("b");
+    Web::ResourceCache::add_revalidation_headers(unvalidated_request, headers("max-age=60"));
+    EXPECT(unvalidated_request.headers().is_empty());
+}
+
+TEST_MAIN(ResourceCache)
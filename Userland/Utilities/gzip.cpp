@@ -35,10 +35,12 @@ int main(int argc, char** argv)
     Vector<const char*> filenames;
     bool keep_input_files { false };
     bool write_to_stdout { false };
+    int thread_count = sysconf(_SC_NPROCESSORS_ONLN);
 
     Core::ArgsParser args_parser;
     args_parser.add_option(keep_input_files, "Keep (don't delete) input files", "keep", 'k');
     args_parser.add_option(write_to_stdout, "Write to stdout, keep original files unchanged", "stdout", 'c');
+    args_parser.add_option(thread_count, "Number of threads to compress with", "jobs", 'j', "count");
     args_parser.add_positional_argument(filenames, "File to compress", "FILE");
     args_parser.parse(argc, argv);
 
@@ -57,7 +59,7 @@ int main(int argc, char** argv)
         }
         auto file = file_or_error.value();
 
-        auto compressed_file = Compress::GzipCompressor::compress_all(file->bytes());
+        auto compressed_file = Compress::GzipCompressor::compress_all(file->bytes(), max(thread_count, 1));
         if (!compressed_file.has_value()) {
             warnln("Failed gzip compressing input file");
             return 1;
@@ -178,6 +178,92 @@ TEST_CASE(deflate_compress_literals)
     EXPECT(compressed.has_value());
 }
 
+TEST_CASE(deflate_decompress_leaves_trailing_data)
+{
+    const Array<u8, 32> input {
+        0x0B, 0xC9, 0xC8, 0x2C, 0x56, 0x00, 0xA2, 0x44, 0x85, 0xE2, 0xCC, 0xDC,
+        0x82, 0x9C, 0x54, 0x85, 0x92, 0xD4, 0x8A, 0x12, 0x85, 0xB4, 0x4C, 0x20,
+        0xCB, 0x4A, 0x13, 0x00, 0xDE, 0xAD, 0xBE, 0xEF
+    };
+
+    const u8 uncompressed[] = "This is a simple text file :)";
+
+    auto memory_stream = InputMemoryStream { input };
+    auto deflate_stream = Compress::DeflateDecompressor { memory_stream };
+
+    Array<u8, sizeof(uncompressed) - 1> decompressed;
+    EXPECT(deflate_stream.read_or_error(decompressed));
+    EXPECT(decompressed == ReadonlyBytes({ uncompressed, sizeof(uncompressed) - 1 }));
+
+    u8 byte;
+    EXPECT_EQ(deflate_stream.read({ &byte, sizeof(byte) }), 0u);
+    EXPECT(deflate_stream.unreliable_eof());
+
+    // The decompressor must not have consumed anything past the end of the deflate stream.
+    LittleEndian<u32> trailer;
+    memory_stream >> trailer;
+    EXPECT(!memory_stream.has_any_error());
+    EXPECT_EQ(static_cast<u32>(trailer), 0xEFBEADDEu);
+}
+
+static void expect_streaming_deflate_decompression(Compress::DeflateCompressor::CompressionLevel level)
+{
+    auto original = ByteBuffer::create_uninitialized(256 * KiB);
+    for (size_t i = 0; i < original.size(); ++i)
+        original[i] = (i * 7 + i / 1000) % 251;
+    auto compressed = Compress::DeflateCompressor::compress_all(original, level);
+    EXPECT(compressed.has_value());
+
+    // Odd piece sizes, so that the pieces end in the middle of symbols, block headers and stored blocks.
+    for (size_t piece_size : { 1, 3, 1000, 4099 }) {
+        Compress::StreamingDeflateDecompressor decompressor;
+        Vector<u8> output;
+        for (size_t offset = 0; offset < compressed.value().size(); offset += piece_size) {
+            auto piece = compressed.value().bytes().slice(offset, min(piece_size, compressed.value().size() - offset));
+            const auto previous_size = output.size();
+            EXPECT(decompressor.append(piece, output));
+            EXPECT(output.size() <= original.size());
+            EXPECT(output.span().slice(previous_size) == original.bytes().slice(previous_size, output.size() - previous_size));
+        }
+        EXPECT(decompressor.is_finished());
+        EXPECT(output.span() == original.bytes());
+    }
+}
+
+TEST_CASE(deflate_decompress_in_pieces)
+{
+    expect_streaming_deflate_decompression(Compress::DeflateCompressor::CompressionLevel::STORE);
+    expect_streaming_deflate_decompression(Compress::DeflateCompressor::CompressionLevel::FAST);
+    expect_streaming_deflate_decompression(Compress::DeflateCompressor::CompressionLevel::GOOD);
+}
+
+TEST_CASE(deflate_decompress_in_pieces_keeps_up_with_input)
+{
+    auto original = ByteBuffer::create_uninitialized(64 * KiB);
+    for (size_t i = 0; i < original.size(); ++i)
+        original[i] = (i * 7 + i / 1000) % 251;
+    auto compressed = Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::FAST);
+    EXPECT(compressed.has_value());
+
+    // Half of the data should give us something, without having to wait for the rest.
+    Compress::StreamingDeflateDecompressor decompressor;
+    Vector<u8> output;
+    EXPECT(decompressor.append(compressed.value().bytes().slice(0, compressed.value().size() / 2), output));
+    EXPECT(output.size() > 0);
+    EXPECT(output.size() < original.size());
+    EXPECT(!decompressor.is_finished());
+}
+
+TEST_CASE(deflate_decompress_in_pieces_rejects_invalid_data)
+{
+    // A block of the reserved type 0b11.
+    const Array<u8, 2> invalid { 0x07, 0x00 };
+    Compress::StreamingDeflateDecompressor decompressor;
+    Vector<u8> output;
+    EXPECT(!decompressor.append(invalid, output));
+    EXPECT(!decompressor.append(invalid, output));
+}
+
 TEST_CASE(zlib_decompress_simple)
 {
     const Array<u8, 40> compressed {
@@ -193,6 +279,25 @@ TEST_CASE(zlib_decompress_simple)
     EXPECT(decompressed.value().bytes() == (ReadonlyBytes { uncompressed, sizeof(uncompressed) - 1 }));
 }
 
+TEST_CASE(zlib_decompress_in_pieces)
+{
+    const Array<u8, 40> compressed {
+        0x78, 0x01, 0x01, 0x1D, 0x00, 0xE2, 0xFF, 0x54, 0x68, 0x69, 0x73, 0x20,
+        0x69, 0x73, 0x20, 0x61, 0x20, 0x73, 0x69, 0x6D, 0x70, 0x6C, 0x65, 0x20,
+        0x74, 0x65, 0x78, 0x74, 0x20, 0x66, 0x69, 0x6C, 0x65, 0x20, 0x3A, 0x29,
+        0x99, 0x5E, 0x09, 0xE8
+    };
+
+    const u8 uncompressed[] = "This is a simple text file :)";
+
+    Compress::StreamingZlibDecompressor decompressor;
+    Vector<u8> output;
+    for (size_t i = 0; i < compressed.size(); ++i)
+        EXPECT(decompressor.append(compressed.span().slice(i, 1), output));
+    EXPECT(decompressor.is_finished());
+    EXPECT(output.span() == (ReadonlyBytes { uncompressed, sizeof(uncompressed) - 1 }));
+}
+
 TEST_CASE(gzip_decompress_simple)
 {
     const Array<u8, 33> compressed {
@@ -279,4 +384,94 @@ TEST_CASE(gzip_round_trip)
     EXPECT(uncompressed.value() == original);
 }
 
+TEST_CASE(gzip_round_trip_parallel)
+{
+    auto size = Compress::GzipCompressor::parallel_chunk_size * 5 + 1234;
+    auto original = ByteBuffer::create_uninitialized(size);
+    fill_with_random(original.data(), size / 2);
+    // Repeat the first half, so that back references across chunk boundaries get used as well
+    memcpy(original.offset_pointer(size / 2), original.data(), size - size / 2);
+    auto compressed = Compress::GzipCompressor::compress_all(original, 4);
+    EXPECT(compressed.has_value());
+    EXPECT(compressed.value().size() < size / 2 + 4 * KiB);
+    auto uncompressed = Compress::GzipDecompressor::decompress_all(compressed.value());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value() == original);
+}
+
+TEST_CASE(crc32_combine)
+{
+    auto data = ByteBuffer::create_uninitialized(1000);
+    fill_with_random(data.data(), data.size());
+    auto expected = Crypto::Checksum::CRC32 { data }.digest();
+    for (size_t split : { 0, 1, 100, 999, 1000 }) {
+        auto first = Crypto::Checksum::CRC32 { data.bytes().slice(0, split) }.digest();
+        auto second = Crypto::Checksum::CRC32 { data.bytes().slice(split) }.digest();
+        EXPECT_EQ(Crypto::Checksum::CRC32::combine(first, second, data.size() - split), expected);
+    }
+}
+
+// A few MiB of text-like data, so that the dynamic huffman codes get long enough to need the secondary lookup tables.
+static ByteBuffer generate_large_corpus(size_t size)
+{
+    static constexpr const char* words[] = {
+        "the", "of", "and", "to", "in", "is", "was", "that", "for", "on", "with", "as", "by", "at", "from",
+        "window", "server", "kernel", "process", "thread", "memory", "stream", "buffer", "inflate", "symbol",
+        "0123456789", "SerenityOS", "\n", ", ", ". ", "{", "}", "();", "  ", "\t"
+    };
+
+    auto corpus = ByteBuffer::create_uninitialized(size);
+    u32 state = 0x2545f491;
+    size_t offset = 0;
+    while (offset < size) {
+        state = state * 1103515245 + 12345;
+        const auto* word = words[(state >> 16) % (sizeof(words) / sizeof(words[0]))];
+        if (((state >> 8) & 0xff) < 8)
+            word = "\x01\x7f\xfe\x80";
+
+        for (; *word && offset < size; ++word)
+            corpus[offset++] = *word;
+        if (offset < size)
+            corpus[offset++] = ' ';
+    }
+    return corpus;
+}
+
+BENCHMARK_CASE(deflate_decompress_throughput)
+{
+    const auto original = generate_large_corpus(4 * MiB);
+    const auto compressed = Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::FAST);
+    EXPECT(compressed.has_value());
+
+    for (size_t idx = 0; idx < 8; ++idx) {
+        const auto uncompressed = Compress::DeflateDecompressor::decompress_all(compressed.value());
+        EXPECT(uncompressed.has_value());
+        EXPECT(uncompressed.value() == original);
+    }
+}
+
+BENCHMARK_CASE(gzip_decompress_throughput)
+{
+    auto original = generate_large_corpus(4 * MiB);
+    fill_with_random(original.offset_pointer(3 * MiB), 1 * MiB); // and some incompressible data at the end
+    const auto compressed = Compress::GzipCompressor::compress_all(original);
+    EXPECT(compressed.has_value());
+
+    for (size_t idx = 0; idx < 8; ++idx) {
+        const auto uncompressed = Compress::GzipDecompressor::decompress_all(compressed.value());
+        EXPECT(uncompressed.has_value());
+        EXPECT(uncompressed.value() == original);
+    }
+}
+
+BENCHMARK_CASE(gzip_compress_parallel_throughput)
+{
+    const auto original = generate_large_corpus(4 * MiB);
+    const auto compressed = Compress::GzipCompressor::compress_all(original, 4);
+    EXPECT(compressed.has_value());
+    const auto uncompressed = Compress::GzipDecompressor::decompress_all(compressed.value());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value() == original);
+}
+
 TEST_MAIN(Compress)
@@ -2134,6 +2134,25 @@ static void tls_test_client_hello()
     loop.exec();
 }
 
+// Long enough to go through the vectorized paths, with a tail that doesn't fit into them.
+static ByteBuffer long_checksum_test_input(size_t variant)
+{
+    StringBuilder builder;
+    if (variant == 0) {
+        for (size_t i = 0; i < 200; ++i)
+            builder.append("The quick brown fox jumps over the lazy dog");
+    } else if (variant == 1) {
+        for (size_t i = 0; i < 40; ++i) {
+            for (size_t byte = 0; byte < 256; ++byte)
+                builder.append(static_cast<char>(byte));
+        }
+        builder.append("abc");
+    } else {
+        builder.append(String::repeated('\xff', 100000));
+    }
+    return builder.to_byte_buffer();
+}
+
 static int adler32_tests()
 {
     auto do_test = [](ReadonlyBytes input, u32 expected_result) {
@@ -2153,6 +2172,9 @@ static int adler32_tests()
     do_test(String("abc").bytes(), 0x024d0127);
     do_test(String("message digest").bytes(), 0x29750586);
     do_test(String("abcdefghijklmnopqrstuvwxyz").bytes(), 0x90860b20);
+    do_test(long_checksum_test_input(0), 0xf005623d);
+    do_test(long_checksum_test_input(1), 0xbe46ee44);
+    do_test(long_checksum_test_input(2), 0x149a302c);
 
     return g_some_test_failed ? 1 : 0;
 }
@@ -2174,6 +2196,9 @@ static int crc32_tests()
     do_test(String("").bytes(), 0x0);
     do_test(String("The quick brown fox jumps over the lazy dog").bytes(), 0x414FA339);
     do_test(String("various CRC algorithms input data").bytes(), 0x9BD366AE);
+    do_test(long_checksum_test_input(0), 0x2948c53b);
+    do_test(long_checksum_test_input(1), 0x80816a55);
+    do_test(long_checksum_test_input(2), 0x68c6cec4);
 
     return g_some_test_failed ? 1 : 0;
 }
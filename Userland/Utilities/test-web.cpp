@@ -28,6 +28,7 @@
 #include <AK/JsonObject.h>
 #include <AK/JsonValue.h>
 #include <AK/QuickSort.h>
+#include <AK/StringBuilder.h>
 #include <AK/URL.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/DirIterator.h>
@@ -42,8 +43,14 @@
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/JSONObject.h>
 #include <LibTest/Results.h>
+#include <LibWeb/Bindings/WindowObject.h>
+#include <LibWeb/DOM/Document.h>
+#include <LibWeb/DOM/Window.h>
+#include <LibWeb/Dump.h>
 #include <LibWeb/HTML/Parser/HTMLDocumentParser.h>
+#include <LibWeb/HTML/Parser/HTMLPreloadScanner.h>
 #include <LibWeb/InProcessWebView.h>
+#include <LibWeb/Layout/InitialContainingBlockBox.h>
 #include <LibWeb/Loader/ResourceLoader.h>
 #include <signal.h>
 #include <sys/time.h>
@@ -78,6 +85,9 @@ public:
 
 private:
     JS_DECLARE_NATIVE_FUNCTION(change_page);
+    JS_DECLARE_NATIVE_FUNCTION(dump_layout_tree);
+    JS_DECLARE_NATIVE_FUNCTION(rebuild_and_dump_layout_tree);
+    JS_DECLARE_NATIVE_FUNCTION(preload_scan);
 };
 
 TestRunnerObject::TestRunnerObject(JS::GlobalObject& global_object)
@@ -89,6 +99,9 @@ void TestRunnerObject::initialize(JS::GlobalObject& global_object)
 {
     Object::initialize(global_object);
     define_native_function("changePage", change_page, 1);
+    define_native_function("dumpLayoutTree", dump_layout_tree, 0);
+    define_native_function("rebuildAndDumpLayoutTree", rebuild_and_dump_layout_tree, 0);
+    define_native_function("preloadScan", preload_scan, 1);
 }
 
 TestRunnerObject::~TestRunnerObject()
@@ -107,6 +120,45 @@ JS_DEFINE_NATIVE_FUNCTION(TestRunnerObject::change_page)
     return JS::js_undefined();
 }
 
+static String layout_tree_dump(const Web::DOM::Document& document)
+{
+    if (!document.layout_node())
+        return {};
+    StringBuilder builder;
+    Web::dump_tree(builder, *document.layout_node(), true);
+    return builder.to_string();
+}
+
+JS_DEFINE_NATIVE_FUNCTION(TestRunnerObject::dump_layout_tree)
+{
+    auto& document = static_cast<Web::Bindings::WindowObject&>(global_object).impl().document();
+    document.update_style();
+    document.update_layout();
+    return JS::js_string(vm, layout_tree_dump(document));
+}
+
+JS_DEFINE_NATIVE_FUNCTION(TestRunnerObject::rebuild_and_dump_layout_tree)
+{
+    auto& document = static_cast<Web::Bindings::WindowObject&>(global_object).impl().document();
+    document.update_style();
+    document.force_layout();
+    return JS::js_string(vm, layout_tree_dump(document));
+}
+
+JS_DEFINE_NATIVE_FUNCTION(TestRunnerObject::preload_scan)
+{
+    auto markup = vm.argument(0).to_string(global_object);
+    if (vm.exception())
+        return {};
+
+    auto& document = static_cast<Web::Bindings::WindowObject&>(global_object).impl().document();
+    Web::HTML::HTMLPreloadScanner preload_scanner(document, markup);
+    auto* urls = JS::Array::create(global_object);
+    for (auto& preload : preload_scanner.scan())
+        urls->indexed_properties().append(JS::js_string(vm, preload.url.to_string()));
+    return urls;
+}
+
 class TestRunner {
 public:
     TestRunner(String web_test_root, String js_test_root, Web::InProcessWebView& page_view, bool print_times)